@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Throughput benchmark for the Shift-JIS decoder.
+// Build and run with `make bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/ShiftJISConverter.h"
+
+namespace {
+constexpr size_t InputSize = 4 << 20;
+constexpr int Rounds = 20;
+
+void PushChar(std::vector<unsigned char> &out, unsigned char lead,
+              unsigned char trail) {
+  out.push_back(lead);
+  out.push_back(trail);
+}
+
+unsigned char RandomTrail(std::mt19937 &rng) {
+  // 0x40-0xFC without 0x7F
+  unsigned char trail = 0x40 + rng() % 0xBC;
+  return trail >= 0x7F ? trail + 1 : trail;
+}
+
+std::vector<unsigned char> RandomKanji(std::mt19937 &rng) {
+  std::vector<unsigned char> out;
+  while (out.size() < InputSize) {
+    const unsigned char lead =
+        rng() % 2 ? 0x88 + rng() % 0x18 : 0xE0 + rng() % 0x0B;
+    PushChar(out, lead, RandomTrail(rng));
+  }
+  return out;
+}
+
+std::vector<unsigned char> Hiragana(std::mt19937 &rng) {
+  std::vector<unsigned char> out;
+  while (out.size() < InputSize) {
+    PushChar(out, 0x82, 0x9F + rng() % 0x53);
+  }
+  return out;
+}
+
+// header-like lines: a short ASCII key followed by a few words of Japanese
+// text, with ASCII separators in between
+std::vector<unsigned char> Mixed(std::mt19937 &rng) {
+  static const char *const keys[] = {"#TITLE ", "#ARTIST ", "#GENRE ",
+                                     "#SUBTITLE "};
+  std::vector<unsigned char> out;
+  while (out.size() < InputSize) {
+    const char *key = keys[rng() % 4];
+    out.insert(out.end(), key, key + std::char_traits<char>::length(key));
+    const int words = 1 + rng() % 4;
+    for (int w = 0; w < words; ++w) {
+      const int chars = 1 + rng() % 6;
+      for (int c = 0; c < chars; ++c) {
+        if (rng() % 2) {
+          PushChar(out, 0x82, 0x9F + rng() % 0x53);
+        } else {
+          PushChar(out, 0x88 + rng() % 0x18, RandomTrail(rng));
+        }
+      }
+      out.push_back(rng() % 3 ? ' ' : '-');
+    }
+    out.push_back('\r');
+    out.push_back('\n');
+  }
+  return out;
+}
+
+std::vector<unsigned char> FromFile(const char *path) {
+  std::ifstream file(path, std::ios::binary);
+  const std::vector<unsigned char> bytes(
+      (std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  std::vector<unsigned char> out;
+  if (bytes.empty()) {
+    return out;
+  }
+  while (out.size() < InputSize) {
+    out.insert(out.end(), bytes.begin(), bytes.end());
+  }
+  return out;
+}
+
+void Run(const char *name, const std::vector<unsigned char> &input) {
+  if (input.empty()) {
+    std::printf("%-20s (input missing)\n", name);
+    return;
+  }
+  std::string result;
+  double best = 0;
+  for (int round = 0; round < Rounds; ++round) {
+    const auto start = std::chrono::steady_clock::now();
+    bms_parser::ShiftJISConverter::BytesToUTF8(input.data(), input.size(),
+                                               result);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::max(best, input.size() / elapsed.count() / 1e6);
+  }
+  std::printf("%-20s %8.0f MB/s\n", name, best);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::mt19937 rng(12345);
+  Run("random kanji", RandomKanji(rng));
+  Run("hiragana only", Hiragana(rng));
+  Run("mixed SJIS/ASCII", Mixed(rng));
+  Run("aleph0_another.bme",
+      FromFile(argc > 1 ? argv[1]
+                        : "test/testcases/aleph0_another.bme"));
+  return 0;
+}
@@ -0,0 +1,6712 @@
+#include "bms_parser.hpp"
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+namespace {
+constexpr size_t PairsPerWord = 64;
+
+constexpr int Radix(PairBase base) {
+  return base == PairBase::Hex ? 16 : base == PairBase::Base36 ? 36 : 62;
+}
+
+// digit value of every byte, or -1
+constexpr std::array<int8_t, 256> BuildDigitTable(PairBase base) {
+  // base 62 is case sensitive, the others aren't
+  const int lowerBase = base == PairBase::Base62 ? 36 : 10;
+  std::array<int8_t, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    int value = -1;
+    if (c >= '0' && c <= '9') {
+      value = c - '0';
+    } else if (c >= 'A' && c <= 'Z') {
+      value = c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'z') {
+      value = c - 'a' + lowerBase;
+    }
+    table[c] = static_cast<int8_t>(value < Radix(base) ? value : -1);
+  }
+  return table;
+}
+
+constexpr auto HexDigits = BuildDigitTable(PairBase::Hex);
+constexpr auto Base36Digits = BuildDigitTable(PairBase::Base36);
+constexpr auto Base62Digits = BuildDigitTable(PairBase::Base62);
+
+// Each of these handles whole words of 64 pairs (128 bytes) and stores the
+// non-"00" mask of each.
+void NonZeroWordsScalar(const char *data, size_t words, uint64_t *nonZero) {
+  for (size_t w = 0; w < words; ++w) {
+    uint64_t mask = 0;
+    const char *pairs = data + w * PairsPerWord * 2;
+    for (size_t j = 0; j < PairsPerWord; ++j) {
+      if (pairs[j * 2] != '0' || pairs[j * 2 + 1] != '0') {
+        mask |= uint64_t{1} << j;
+      }
+    }
+    nonZero[w] = mask;
+  }
+}
+
+#if BMS_PARSER_X86
+BMS_PARSER_TARGET("sse2")
+void NonZeroWordsSse2(const char *data, size_t words, uint64_t *nonZero) {
+  // a pair is one 16-bit lane; "00" is 0x3030 whichever the byte order
+  const __m128i zeroPair = _mm_set1_epi16(0x3030);
+  for (size_t w = 0; w < words; ++w) {
+    const char *pairs = data + w * PairsPerWord * 2;
+    uint64_t zero = 0;
+    for (size_t k = 0; k < 4; ++k) {
+      const __m128i a =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(pairs + k * 32));
+      const __m128i b = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(pairs + k * 32 + 16));
+      // narrow the 16-bit results to one byte, so one bit per pair
+      const __m128i packed = _mm_packs_epi16(_mm_cmpeq_epi16(a, zeroPair),
+                                             _mm_cmpeq_epi16(b, zeroPair));
+      zero |= static_cast<uint64_t>(
+                  static_cast<uint32_t>(_mm_movemask_epi8(packed)))
+              << (k * 16);
+    }
+    nonZero[w] = ~zero;
+  }
+}
+
+BMS_PARSER_TARGET("avx2")
+void NonZeroWordsAvx2(const char *data, size_t words, uint64_t *nonZero) {
+  const __m256i zeroPair = _mm256_set1_epi16(0x3030);
+  for (size_t w = 0; w < words; ++w) {
+    const char *pairs = data + w * PairsPerWord * 2;
+    uint64_t zero = 0;
+    for (size_t k = 0; k < 2; ++k) {
+      const __m256i a =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pairs + k * 64));
+      const __m256i b = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(pairs + k * 64 + 32));
+      const __m256i packed = _mm256_packs_epi16(
+          _mm256_cmpeq_epi16(a, zeroPair), _mm256_cmpeq_epi16(b, zeroPair));
+      // packs works per 128-bit lane; put the quarters back in order
+      const __m256i ordered = _mm256_permute4x64_epi64(packed, 0xD8);
+      zero |= static_cast<uint64_t>(
+                  static_cast<uint32_t>(_mm256_movemask_epi8(ordered)))
+              << (k * 32);
+    }
+    nonZero[w] = ~zero;
+  }
+}
+#endif
+
+using NonZeroWordsFn = void (*)(const char *, size_t, uint64_t *);
+
+NonZeroWordsFn SelectNonZeroWords() {
+#if BMS_PARSER_X86
+  if (CpuFeatures::HasAVX2()) {
+    return NonZeroWordsAvx2;
+  }
+  if (CpuFeatures::HasSSE2()) {
+    return NonZeroWordsSse2;
+  }
+#endif
+  return NonZeroWordsScalar;
+}
+} // namespace
+
+size_t ChannelData::Decode(std::string_view data, PairBase base,
+                           std::vector<int> &ids,
+                           std::vector<uint64_t> &nonZero) {
+  static const NonZeroWordsFn nonZeroWords = SelectNonZeroWords();
+  const size_t count = data.size() / 2;
+  const size_t fullWords = count / PairsPerWord;
+  ids.resize(count);
+  nonZero.resize((count + PairsPerWord - 1) / PairsPerWord);
+
+  nonZeroWords(data.data(), fullWords, nonZero.data());
+  if (fullWords != nonZero.size()) {
+    // the tail is too short for a vector
+    uint64_t mask = 0;
+    for (size_t j = fullWords * PairsPerWord; j < count; ++j) {
+      if (data[j * 2] != '0' || data[j * 2 + 1] != '0') {
+        mask |= uint64_t{1} << (j % PairsPerWord);
+      }
+    }
+    nonZero[fullWords] = mask;
+  }
+
+  const auto &digits = base == PairBase::Hex      ? HexDigits
+                       : base == PairBase::Base36 ? Base36Digits
+                                                  : Base62Digits;
+  const int radix = Radix(base);
+  for (size_t j = NextNonZero(nonZero, 0, count); j < count;
+       j = NextNonZero(nonZero, j + 1, count)) {
+    const int high = digits[static_cast<unsigned char>(data[j * 2])];
+    const int low = digits[static_cast<unsigned char>(data[j * 2 + 1])];
+    ids[j] = (high | low) < 0 ? Undecoded : high * radix + low;
+  }
+  return count;
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+namespace bms_parser {
+namespace {
+NoteRecord MakeRecord(const Note *note, NoteKind kind, uint32_t timeline) {
+  NoteRecord record{};
+  record.Wav = note->Wav;
+  record.Timeline = timeline;
+  record.Partner = NoNoteId;
+  record.Lane = static_cast<uint8_t>(note->Lane);
+  record.Kind = kind;
+  return record;
+}
+} // namespace
+
+Chart::Chart() = default;
+
+Chart::~Chart() {
+  for (const auto &measure : Measures) {
+    measure->~Measure();
+  }
+
+  Measures.clear();
+}
+
+const std::string &Chart::GetMD5() {
+  std::call_once(MD5Once, [this] {
+    if (Meta.MD5.empty() && HasSource) {
+      MD5 md5;
+      md5.update(SourceBytes, static_cast<MD5::size_type>(SourceSize));
+      md5.finalize();
+      Meta.MD5 = md5.hexdigest();
+    }
+  });
+  return Meta.MD5;
+}
+
+const std::string &Chart::GetSHA256() {
+  std::call_once(SHA256Once, [this] {
+    if (Meta.SHA256.empty() && HasSource) {
+      Meta.SHA256 = sha256(SourceBytes, SourceSize);
+    }
+  });
+  return Meta.SHA256;
+}
+
+uint64_t Chart::GetContentHash() {
+  std::call_once(ContentHashOnce, [this] {
+    if (Meta.ContentHash == 0 && HasSource) {
+      Meta.ContentHash = XXHash64(SourceBytes, SourceSize);
+    }
+  });
+  return Meta.ContentHash;
+}
+
+void Chart::SetDigestSource(const unsigned char *bytes, size_t size) {
+  HasSource = true;
+  SourceBytes = bytes;
+  SourceSize = size;
+}
+
+void Chart::ClearDigestSource() {
+  HasSource = false;
+  SourceBytes = nullptr;
+  SourceSize = 0;
+}
+
+void Chart::BuildNoteRecords() {
+  TimeLines.clear();
+  Notes.clear();
+  // the note behind each record; Ids left over from an earlier build are
+  // stale, so a head's Id only counts if it points back at that head
+  std::vector<const Note *> numbered;
+  const auto add = [this, &numbered](Note *note, NoteKind kind) {
+    note->Kind = kind;
+    note->Id = static_cast<uint32_t>(Notes.size());
+    numbered.push_back(note);
+    Notes.push_back(
+        MakeRecord(note, kind, static_cast<uint32_t>(TimeLines.size() - 1)));
+    return &Notes.back();
+  };
+  for (const auto &measure : Measures) {
+    for (const auto &timeline : measure->TimeLines) {
+      TimeLines.push_back(timeline);
+      timeline->Notes.ForEach([&](int, Note *note) {
+        if (note->IsLandmineNote()) {
+          add(note, NoteKind::Landmine)->Damage =
+              static_cast<LandmineNote *>(note)->Damage;
+          return;
+        }
+        if (!note->IsLongNote()) {
+          add(note, NoteKind::Normal);
+          return;
+        }
+        auto ln = static_cast<LongNote *>(note);
+        if (ln->Head == nullptr) {
+          // the tail links the pair once it is reached
+          add(ln, NoteKind::LongHead);
+          return;
+        }
+        auto record = add(ln, NoteKind::LongTail);
+        // heads sit on earlier timelines and are numbered by now, unless a
+        // later note took their slot or they were removed from the chart;
+        // then their Id is stale and may name some other note
+        const auto headId = ln->Head->Id;
+        if (headId < ln->Id && numbered[headId] == ln->Head &&
+            Notes[headId].Kind == NoteKind::LongHead) {
+          record->Partner = headId;
+          Notes[headId].Partner = ln->Id;
+        }
+      });
+      timeline->LandmineNotes.ForEach([&](int, LandmineNote *note) {
+        add(note, NoteKind::Landmine)->Damage = note->Damage;
+      });
+      timeline->InvisibleNotes.ForEach(
+          [&](int, Note *note) { add(note, NoteKind::Invisible); });
+      for (const auto &note : timeline->BackgroundNotes) {
+        add(note, NoteKind::Background);
+      }
+    }
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace bms_parser {
+ChartArena::~ChartArena() {
+  while (Blocks != nullptr) {
+    Block *next = Blocks->Next;
+    std::free(Blocks);
+    Blocks = next;
+  }
+}
+
+void ChartArena::Adopt(ChartArena &other) {
+  if (other.Blocks == nullptr || &other == this) {
+    return;
+  }
+  Block *last = other.Blocks;
+  while (last->Next != nullptr) {
+    last = last->Next;
+  }
+  // keep allocating from the current block, which has to stay in front
+  if (Blocks == nullptr) {
+    Blocks = other.Blocks;
+    Cursor = other.Cursor;
+    Limit = other.Limit;
+  } else {
+    last->Next = Blocks->Next;
+    Blocks->Next = other.Blocks;
+  }
+  Reserved += other.Reserved;
+  other.Blocks = nullptr;
+  other.Cursor = 0;
+  other.Limit = 0;
+  other.Reserved = 0;
+}
+
+void *ChartArena::AllocateSlow(size_t size, size_t align) {
+  // blocks double up to MaxBlockSize; anything bigger gets a block of its own
+  size_t blockSize =
+      Blocks == nullptr ? FirstBlockSize
+                        : std::min(Blocks->Size * 2, MaxBlockSize);
+  blockSize = std::max(blockSize, sizeof(Block) + size + align);
+  auto block = static_cast<Block *>(std::malloc(blockSize));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  block->Next = Blocks;
+  block->Size = blockSize;
+  Blocks = block;
+  Reserved += blockSize;
+  Cursor = reinterpret_cast<uintptr_t>(block + 1);
+  Limit = reinterpret_cast<uintptr_t>(block) + blockSize;
+  return Allocate(size, align);
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <system_error>
+#include <unordered_map>
+
+namespace bms_parser {
+namespace {
+// every section starts on a multiple of this, so that its records can be
+// read in place
+constexpr size_t SectionAlign = 8;
+
+size_t AlignSection(size_t offset) {
+  return (offset + SectionAlign - 1) & ~(SectionAlign - 1);
+}
+
+// the string section, built while the other sections are laid out
+class SnapshotStrings {
+public:
+  std::string Chars;
+  bool Overflowed = false;
+
+  SnapshotString Add(std::string_view value) {
+    if (value.size() > UINT32_MAX - Chars.size()) {
+      Overflowed = true;
+      return {0, 0};
+    }
+    const SnapshotString string{static_cast<uint32_t>(Chars.size()),
+                                static_cast<uint32_t>(value.size())};
+    Chars.append(value);
+    return string;
+  }
+  SnapshotString AddPath(const std::filesystem::path &value) {
+    return Add(value.u8string());
+  }
+};
+
+SnapshotMeta ToSnapshotMeta(const ChartMeta &meta, SnapshotStrings &strings) {
+  SnapshotMeta snapshot;
+  std::memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.SHA256 = strings.Add(meta.SHA256);
+  snapshot.MD5 = strings.Add(meta.MD5);
+  snapshot.BmsPath = strings.AddPath(meta.BmsPath);
+  snapshot.Folder = strings.AddPath(meta.Folder);
+  snapshot.Artist = strings.Add(meta.Artist);
+  snapshot.SubArtist = strings.Add(meta.SubArtist);
+  snapshot.Genre = strings.Add(meta.Genre);
+  snapshot.Title = strings.Add(meta.Title);
+  snapshot.SubTitle = strings.Add(meta.SubTitle);
+  snapshot.Banner = strings.AddPath(meta.Banner);
+  snapshot.StageFile = strings.AddPath(meta.StageFile);
+  snapshot.BackBmp = strings.AddPath(meta.BackBmp);
+  snapshot.Preview = strings.AddPath(meta.Preview);
+  snapshot.ContentHash = meta.ContentHash;
+  snapshot.Bpm = meta.Bpm;
+  snapshot.Total = meta.Total;
+  snapshot.PlayLevel = meta.PlayLevel;
+  snapshot.MinBpm = meta.MinBpm;
+  snapshot.MaxBpm = meta.MaxBpm;
+  snapshot.PlayLength = meta.PlayLength;
+  snapshot.TotalLength = meta.TotalLength;
+  snapshot.Rank = meta.Rank;
+  snapshot.Difficulty = meta.Difficulty;
+  snapshot.Player = meta.Player;
+  snapshot.KeyMode = meta.KeyMode;
+  snapshot.TotalNotes = meta.TotalNotes;
+  snapshot.TotalLongNotes = meta.TotalLongNotes;
+  snapshot.TotalScratchNotes = meta.TotalScratchNotes;
+  snapshot.TotalBackSpinNotes = meta.TotalBackSpinNotes;
+  snapshot.TotalLandmineNotes = meta.TotalLandmineNotes;
+  snapshot.LnMode = meta.LnMode;
+  snapshot.BgaPoorDefault = meta.BgaPoorDefault;
+  snapshot.IsDP = meta.IsDP;
+  snapshot.HasRandom = meta.HasRandom;
+  snapshot.Encoding = static_cast<uint8_t>(meta.Encoding);
+  return snapshot;
+}
+
+// The snapshot's resource table for table, by ascending id. Ids are unique,
+// so sorting by them alone gives the same bytes every time.
+std::vector<SnapshotResource>
+ToSnapshotTable(const std::unordered_map<int, std::string> &table,
+                SnapshotStrings &strings) {
+  std::vector<SnapshotResource> resources;
+  resources.reserve(table.size());
+  for (const auto &[id, name] : table) {
+    resources.push_back({id, {0, 0}});
+  }
+  std::sort(resources.begin(), resources.end(),
+            [](const SnapshotResource &a, const SnapshotResource &b) {
+              return a.Id < b.Id;
+            });
+  for (auto &resource : resources) {
+    resource.Name = strings.Add(table.at(resource.Id));
+  }
+  return resources;
+}
+
+template <typename T>
+bool InSection(const SnapshotSection &section, size_t size) {
+  return section.Offset % alignof(T) == 0 && section.Offset <= size &&
+         section.Count <= (size - section.Offset) / sizeof(T);
+}
+
+// a section of bytes that InSection has accepted
+template <typename T>
+SnapshotArray<T> SectionAt(const unsigned char *bytes,
+                           const SnapshotSection &section) {
+  return {reinterpret_cast<const T *>(bytes + section.Offset),
+          static_cast<size_t>(section.Count)};
+}
+
+bool InStrings(const SnapshotString &string, uint64_t stringsSize) {
+  return string.Offset <= stringsSize &&
+         string.Size <= stringsSize - string.Offset;
+}
+
+uint64_t SnapshotChecksum(const unsigned char *bytes, size_t size) {
+  const auto header = XXHash64(bytes, offsetof(SnapshotHeader, Checksum));
+  return XXHash64(bytes + sizeof(SnapshotHeader),
+                  size - sizeof(SnapshotHeader), header);
+}
+
+// reads the whole source, mapped if the parser would map it
+bool ReadSource(const std::filesystem::path &path, bool useMemoryMap,
+                MappedFile &mapped, std::vector<unsigned char> &buffer,
+                const unsigned char *&data, size_t &size) {
+  if (useMemoryMap && mapped.Open(path)) {
+    data = mapped.GetData();
+    size = mapped.GetSize();
+    return true;
+  }
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cout << "Failed to open file: " << path << std::endl;
+    return false;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+  data = buffer.data();
+  size = buffer.size();
+  return true;
+}
+} // namespace
+
+bool ChartSnapshot::Serialize(const Chart &chart, bool addReadyMeasure,
+                              std::vector<unsigned char> &bytes) {
+  const auto noteCount = chart.Notes.size();
+  if (noteCount >= NoNoteId / 2 || chart.TimeLines.size() >= NoNoteId) {
+    return false;
+  }
+  // the notes in record order, walked the way BuildNoteRecords numbers them
+  std::vector<const Note *> notes;
+  std::vector<SnapshotNoteLink> links;
+  notes.reserve(noteCount);
+  links.reserve(noteCount);
+  const auto add = [&](const Note *note, SnapshotSlot slot) {
+    SnapshotNoteLink link;
+    std::memset(&link, 0, sizeof(link));
+    link.Link = NoNoteId;
+    link.Slot = slot;
+    notes.push_back(note);
+    links.push_back(link);
+  };
+  std::vector<SnapshotMeasure> measures;
+  std::vector<SnapshotTimeLine> timelines;
+  measures.reserve(chart.Measures.size());
+  timelines.reserve(chart.TimeLines.size());
+  for (const auto &measure : chart.Measures) {
+    SnapshotMeasure m;
+    std::memset(&m, 0, sizeof(m));
+    m.Scale = measure->Scale;
+    m.Pos = measure->Pos;
+    m.Timing = measure->Timing;
+    m.FirstTimeLine = static_cast<uint32_t>(timelines.size());
+    m.TimeLineCount = static_cast<uint32_t>(measure->TimeLines.size());
+    for (const auto &timeline : measure->TimeLines) {
+      if (timelines.size() >= chart.TimeLines.size() ||
+          chart.TimeLines[timelines.size()] != timeline) {
+        return false; // TimeLines is out of date
+      }
+      SnapshotTimeLine t;
+      std::memset(&t, 0, sizeof(t));
+      t.Bpm = timeline->Bpm;
+      t.StopLength = timeline->StopLength;
+      t.Scroll = timeline->Scroll;
+      t.BeatPosition = timeline->BeatPosition;
+      t.Timing = timeline->Timing;
+      t.BgaBase = timeline->BgaBase;
+      t.BgaLayer = timeline->BgaLayer;
+      t.BgaPoor = timeline->BgaPoor;
+      t.BpmChange = timeline->BpmChange;
+      t.BpmChangeApplied = timeline->BpmChangeApplied;
+      t.IsFirstInMeasure = timeline->IsFirstInMeasure;
+      t.FirstNote = static_cast<uint32_t>(notes.size());
+      timeline->Notes.ForEach(
+          [&](int, const Note *note) { add(note, SnapshotSlot::Note); });
+      timeline->LandmineNotes.ForEach([&](int, const LandmineNote *note) {
+        add(note, SnapshotSlot::Landmine);
+      });
+      timeline->InvisibleNotes.ForEach(
+          [&](int, const Note *note) { add(note, SnapshotSlot::Invisible); });
+      for (const auto &note : timeline->BackgroundNotes) {
+        add(note, SnapshotSlot::Background);
+      }
+      t.NoteCount = static_cast<uint32_t>(notes.size() - t.FirstNote);
+      timelines.push_back(t);
+    }
+    measures.push_back(m);
+  }
+  if (timelines.size() != chart.TimeLines.size() ||
+      notes.size() != noteCount) {
+    return false;
+  }
+  for (size_t i = 0; i < noteCount; ++i) {
+    if (notes[i]->Id != i) {
+      return false; // the note records are out of date
+    }
+  }
+
+  // where each long note's Head or Tail points
+  std::vector<SnapshotDetachedNote> detached;
+  std::unordered_map<const Note *, uint32_t> detachedIds;
+  std::unordered_map<const TimeLine *, uint32_t> timelineIds;
+  for (size_t i = 0; i < noteCount; ++i) {
+    const auto &record = chart.Notes[i];
+    if (!record.IsLongNote()) {
+      continue;
+    }
+    const auto ln = static_cast<const LongNote *>(notes[i]);
+    const Note *other = record.Kind == NoteKind::LongHead ? ln->Tail : ln->Head;
+    if (other == nullptr) {
+      continue;
+    }
+    if (other->Id < noteCount && notes[other->Id] == other &&
+        chart.Notes[other->Id].IsLongNote()) {
+      links[i].Link = other->Id;
+      continue;
+    }
+    const auto found = detachedIds.find(other);
+    if (found != detachedIds.end()) {
+      links[i].Link = found->second;
+      continue;
+    }
+    if (timelineIds.empty()) {
+      for (size_t t = 0; t < chart.TimeLines.size(); ++t) {
+        timelineIds.emplace(chart.TimeLines[t], static_cast<uint32_t>(t));
+      }
+    }
+    SnapshotDetachedNote entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.Wav = other->Wav;
+    const auto timeline = timelineIds.find(other->Timeline);
+    entry.TimeLine =
+        timeline != timelineIds.end() ? timeline->second : NoNoteId;
+    entry.Link = static_cast<uint32_t>(i);
+    entry.Lane = static_cast<uint8_t>(other->Lane);
+    entry.Kind = other->Kind;
+    const auto id = static_cast<uint32_t>(noteCount + detached.size());
+    detachedIds.emplace(other, id);
+    detached.push_back(entry);
+    links[i].Link = id;
+  }
+
+  SnapshotStrings strings;
+  const auto meta = ToSnapshotMeta(chart.Meta, strings);
+  const auto wavs = ToSnapshotTable(chart.WavTable, strings);
+  const auto bmps = ToSnapshotTable(chart.BmpTable, strings);
+  if (strings.Overflowed) {
+    return false;
+  }
+
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.Magic = Magic;
+  header.Format = Format;
+  header.ParserVersion = Parser::Version;
+  header.Flags = addReadyMeasure ? SnapshotReadyMeasure : 0;
+  header.SourceHash = chart.Meta.ContentHash;
+  size_t offset = sizeof(SnapshotHeader);
+  const auto place = [&offset](SnapshotSection &section, size_t count,
+                               size_t elementSize) {
+    offset = AlignSection(offset);
+    section.Offset = offset;
+    section.Count = count;
+    offset += count * elementSize;
+  };
+  place(header.Meta, 1, sizeof(SnapshotMeta));
+  place(header.Measures, measures.size(), sizeof(SnapshotMeasure));
+  place(header.TimeLines, timelines.size(), sizeof(SnapshotTimeLine));
+  place(header.Notes, noteCount, sizeof(NoteRecord));
+  place(header.Links, links.size(), sizeof(SnapshotNoteLink));
+  place(header.Detached, detached.size(), sizeof(SnapshotDetachedNote));
+  place(header.Wavs, wavs.size(), sizeof(SnapshotResource));
+  place(header.Bmps, bmps.size(), sizeof(SnapshotResource));
+  place(header.Strings, strings.Chars.size(), 1);
+  header.TotalSize = offset;
+
+  bytes.assign(offset, 0);
+  const auto copy = [&bytes](const SnapshotSection &section, const void *data,
+                             size_t size) {
+    if (size != 0) {
+      std::memcpy(bytes.data() + section.Offset, data, size);
+    }
+  };
+  copy(header.Meta, &meta, sizeof(meta));
+  copy(header.Measures, measures.data(),
+       measures.size() * sizeof(SnapshotMeasure));
+  copy(header.TimeLines, timelines.data(),
+       timelines.size() * sizeof(SnapshotTimeLine));
+  // field by field, so that the padding of the records is written as zeros
+  auto records = bytes.data() + header.Notes.Offset;
+  for (const auto &note : chart.Notes) {
+    NoteRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.Wav = note.Wav;
+    record.Timeline = note.Timeline;
+    record.Partner = note.Partner;
+    record.Damage = note.Damage;
+    record.Lane = note.Lane;
+    record.Kind = note.Kind;
+    std::memcpy(records, &record, sizeof(record));
+    records += sizeof(record);
+  }
+  copy(header.Links, links.data(), links.size() * sizeof(SnapshotNoteLink));
+  copy(header.Detached, detached.data(),
+       detached.size() * sizeof(SnapshotDetachedNote));
+  copy(header.Wavs, wavs.data(), wavs.size() * sizeof(SnapshotResource));
+  copy(header.Bmps, bmps.data(), bmps.size() * sizeof(SnapshotResource));
+  copy(header.Strings, strings.Chars.data(), strings.Chars.size());
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  header.Checksum = SnapshotChecksum(bytes.data(), bytes.size());
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  return true;
+}
+
+bool ChartSnapshot::Write(const Chart &chart, bool addReadyMeasure,
+                          const std::filesystem::path &file) {
+  std::vector<unsigned char> bytes;
+  if (!Serialize(chart, addReadyMeasure, bytes)) {
+    return false;
+  }
+  auto temporary = file;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    if (!out.good()) {
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(temporary, file, ec);
+  return !ec;
+}
+
+bool ChartSnapshot::Validate(const unsigned char *bytes, size_t size) {
+  if (bytes == nullptr || reinterpret_cast<uintptr_t>(bytes) % SectionAlign ||
+      size < sizeof(SnapshotHeader)) {
+    return false;
+  }
+  const auto &header = *reinterpret_cast<const SnapshotHeader *>(bytes);
+  if (header.Magic != Magic || header.Format != Format ||
+      header.ParserVersion != Parser::Version ||
+      (header.Flags & ~SnapshotReadyMeasure) != 0 ||
+      header.TotalSize != size ||
+      header.Checksum != SnapshotChecksum(bytes, size)) {
+    return false;
+  }
+  if (header.Meta.Count != 1 || !InSection<SnapshotMeta>(header.Meta, size) ||
+      !InSection<SnapshotMeasure>(header.Measures, size) ||
+      !InSection<SnapshotTimeLine>(header.TimeLines, size) ||
+      !InSection<NoteRecord>(header.Notes, size) ||
+      !InSection<SnapshotNoteLink>(header.Links, size) ||
+      !InSection<SnapshotDetachedNote>(header.Detached, size) ||
+      !InSection<SnapshotResource>(header.Wavs, size) ||
+      !InSection<SnapshotResource>(header.Bmps, size) ||
+      !InSection<char>(header.Strings, size)) {
+    return false;
+  }
+  const auto &meta = SectionAt<SnapshotMeta>(bytes, header.Meta)[0];
+  const auto measures = SectionAt<SnapshotMeasure>(bytes, header.Measures);
+  const auto timelines = SectionAt<SnapshotTimeLine>(bytes, header.TimeLines);
+  const auto notes = SectionAt<NoteRecord>(bytes, header.Notes);
+  const auto links = SectionAt<SnapshotNoteLink>(bytes, header.Links);
+  const auto detached =
+      SectionAt<SnapshotDetachedNote>(bytes, header.Detached);
+  const auto stringsSize = header.Strings.Count;
+
+  for (const auto &string :
+       {meta.SHA256, meta.MD5, meta.BmsPath, meta.Folder, meta.Artist,
+        meta.SubArtist, meta.Genre, meta.Title, meta.SubTitle, meta.Banner,
+        meta.StageFile, meta.BackBmp, meta.Preview}) {
+    if (!InStrings(string, stringsSize)) {
+      return false;
+    }
+  }
+  if (meta.Encoding > static_cast<uint8_t>(TextEncoding::UTF8)) {
+    return false;
+  }
+  for (const auto &table : {header.Wavs, header.Bmps}) {
+    const auto resources = SectionAt<SnapshotResource>(bytes, table);
+    for (size_t i = 0; i < resources.size(); ++i) {
+      if (!InStrings(resources[i].Name, stringsSize) ||
+          (i > 0 && resources[i - 1].Id >= resources[i].Id)) {
+        return false;
+      }
+    }
+  }
+
+  // the measures own consecutive runs of timelines, and the timelines
+  // consecutive runs of notes, with nothing left over
+  if (notes.size() >= NoNoteId / 2 || timelines.size() >= NoNoteId ||
+      links.size() != notes.size() ||
+      detached.size() >= NoNoteId / 2) {
+    return false;
+  }
+  uint64_t nextTimeLine = 0;
+  for (const auto &measure : measures) {
+    if (measure.FirstTimeLine != nextTimeLine ||
+        measure.TimeLineCount > timelines.size() - nextTimeLine) {
+      return false;
+    }
+    nextTimeLine += measure.TimeLineCount;
+  }
+  if (nextTimeLine != timelines.size()) {
+    return false;
+  }
+  const auto noteCount = static_cast<uint32_t>(notes.size());
+  const auto linkCount = noteCount + static_cast<uint32_t>(detached.size());
+  uint64_t nextNote = 0;
+  for (size_t t = 0; t < timelines.size(); ++t) {
+    const auto &timeline = timelines[t];
+    if (timeline.FirstNote != nextNote ||
+        timeline.NoteCount > notes.size() - nextNote) {
+      return false;
+    }
+    nextNote += timeline.NoteCount;
+    for (auto i = timeline.FirstNote; i < nextNote; ++i) {
+      const auto &record = notes[i];
+      const auto &link = links[i];
+      if (record.Timeline != t || record.Kind > NoteKind::Background) {
+        return false;
+      }
+      bool slotFits;
+      switch (link.Slot) {
+      case SnapshotSlot::Note:
+        slotFits = record.Kind <= NoteKind::Landmine;
+        break;
+      case SnapshotSlot::Landmine:
+        slotFits = record.Kind == NoteKind::Landmine;
+        break;
+      case SnapshotSlot::Invisible:
+        slotFits = record.Kind == NoteKind::Invisible;
+        break;
+      case SnapshotSlot::Background:
+        slotFits = record.Kind == NoteKind::Background;
+        break;
+      default:
+        slotFits = false;
+      }
+      if (!slotFits || (link.Slot != SnapshotSlot::Background &&
+                        record.Lane >= TimeLine::MaxLanes)) {
+        return false;
+      }
+      if (record.Partner != NoNoteId &&
+          (!record.IsLongNote() || record.Partner >= noteCount ||
+           !notes[record.Partner].IsLongNote() ||
+           notes[record.Partner].Partner != i)) {
+        return false;
+      }
+      if (link.Link != NoNoteId &&
+          (!record.IsLongNote() || link.Link >= linkCount ||
+           (link.Link < noteCount && !notes[link.Link].IsLongNote()))) {
+        return false;
+      }
+    }
+  }
+  if (nextNote != notes.size()) {
+    return false;
+  }
+  for (size_t k = 0; k < detached.size(); ++k) {
+    const auto &entry = detached[k];
+    if (entry.Link >= noteCount || links[entry.Link].Link != noteCount + k ||
+        (entry.TimeLine != NoNoteId && entry.TimeLine >= timelines.size()) ||
+        entry.Lane >= TimeLine::MaxLanes || entry.Kind > NoteKind::Background) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ChartSnapshot::Open(const std::filesystem::path &file) {
+  Close();
+  if (!Mapped.Open(file) || !Attach(Mapped.GetData(), Mapped.GetSize())) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool ChartSnapshot::Open(const unsigned char *bytes, size_t size) {
+  Close();
+  return Attach(bytes, size);
+}
+
+bool ChartSnapshot::Attach(const unsigned char *bytes, size_t size) {
+  if (!Validate(bytes, size)) {
+    return false;
+  }
+  Bytes = bytes;
+  Header = reinterpret_cast<const SnapshotHeader *>(bytes);
+  return true;
+}
+
+void ChartSnapshot::Close() {
+  Mapped.Close();
+  Bytes = nullptr;
+  Header = nullptr;
+}
+
+bool ChartSnapshot::Matches(uint64_t sourceHash, bool addReadyMeasure) const {
+  return IsOpen() && Header->SourceHash == sourceHash &&
+         ((Header->Flags & SnapshotReadyMeasure) != 0) == addReadyMeasure;
+}
+
+const SnapshotMeta &ChartSnapshot::GetMeta() const {
+  return SectionAt<SnapshotMeta>(Bytes, Header->Meta)[0];
+}
+
+SnapshotArray<SnapshotMeasure> ChartSnapshot::GetMeasures() const {
+  return SectionAt<SnapshotMeasure>(Bytes, Header->Measures);
+}
+
+SnapshotArray<SnapshotTimeLine> ChartSnapshot::GetTimeLines() const {
+  return SectionAt<SnapshotTimeLine>(Bytes, Header->TimeLines);
+}
+
+SnapshotArray<NoteRecord> ChartSnapshot::GetNotes() const {
+  return SectionAt<NoteRecord>(Bytes, Header->Notes);
+}
+
+std::string_view ChartSnapshot::GetString(SnapshotString string) const {
+  return {reinterpret_cast<const char *>(Bytes + Header->Strings.Offset +
+                                         string.Offset),
+          string.Size};
+}
+
+std::string_view ChartSnapshot::FindWav(int id) const {
+  return Find(Header->Wavs, id);
+}
+
+std::string_view ChartSnapshot::FindBmp(int id) const {
+  return Find(Header->Bmps, id);
+}
+
+std::string_view ChartSnapshot::Find(const SnapshotSection &table,
+                                     int id) const {
+  const auto resources = SectionAt<SnapshotResource>(Bytes, table);
+  const auto found = std::lower_bound(
+      resources.begin(), resources.end(), id,
+      [](const SnapshotResource &resource, int key) {
+        return resource.Id < key;
+      });
+  if (found == resources.end() || found->Id != id) {
+    return {};
+  }
+  return GetString(found->Name);
+}
+
+Chart *ChartSnapshot::ToChart() const {
+  auto chart = std::make_unique<Chart>();
+  const auto &meta = GetMeta();
+  const auto text = [this](SnapshotString string) {
+    return std::string(GetString(string));
+  };
+  const auto path = [this](SnapshotString string) {
+    return std::filesystem::u8path(GetString(string));
+  };
+  auto &m = chart->Meta;
+  m.SHA256 = text(meta.SHA256);
+  m.MD5 = text(meta.MD5);
+  m.ContentHash = meta.ContentHash;
+  m.BmsPath = path(meta.BmsPath);
+  m.Folder = path(meta.Folder);
+  m.Artist = text(meta.Artist);
+  m.SubArtist = text(meta.SubArtist);
+  m.Bpm = meta.Bpm;
+  m.Genre = text(meta.Genre);
+  m.Title = text(meta.Title);
+  m.SubTitle = text(meta.SubTitle);
+  m.Rank = meta.Rank;
+  m.Total = meta.Total;
+  m.PlayLength = meta.PlayLength;
+  m.TotalLength = meta.TotalLength;
+  m.Banner = path(meta.Banner);
+  m.StageFile = path(meta.StageFile);
+  m.BackBmp = path(meta.BackBmp);
+  m.Preview = path(meta.Preview);
+  m.BgaPoorDefault = meta.BgaPoorDefault != 0;
+  m.Difficulty = meta.Difficulty;
+  m.PlayLevel = meta.PlayLevel;
+  m.MinBpm = meta.MinBpm;
+  m.MaxBpm = meta.MaxBpm;
+  m.Player = meta.Player;
+  m.KeyMode = meta.KeyMode;
+  m.IsDP = meta.IsDP != 0;
+  m.TotalNotes = meta.TotalNotes;
+  m.TotalLongNotes = meta.TotalLongNotes;
+  m.TotalScratchNotes = meta.TotalScratchNotes;
+  m.TotalBackSpinNotes = meta.TotalBackSpinNotes;
+  m.TotalLandmineNotes = meta.TotalLandmineNotes;
+  m.LnMode = meta.LnMode;
+  m.HasRandom = meta.HasRandom != 0;
+  m.Encoding = static_cast<TextEncoding>(meta.Encoding);
+  for (const auto &[table, section] :
+       {std::make_pair(&chart->WavTable, &Header->Wavs),
+        std::make_pair(&chart->BmpTable, &Header->Bmps)}) {
+    const auto resources = SectionAt<SnapshotResource>(Bytes, *section);
+    table->reserve(resources.size());
+    for (const auto &resource : resources) {
+      table->emplace(resource.Id, GetString(resource.Name));
+    }
+  }
+
+  // the records are the chart's as they are; only the graph is rebuilt
+  const auto records = GetNotes();
+  const auto links = SectionAt<SnapshotNoteLink>(Bytes, Header->Links);
+  chart->Notes.assign(records.begin(), records.end());
+  const auto measures = GetMeasures();
+  const auto timelines = GetTimeLines();
+  chart->Measures.reserve(measures.size());
+  chart->TimeLines.reserve(timelines.size());
+  std::vector<Note *> notes(records.size());
+  auto &arena = chart->Arena;
+  for (const auto &m : measures) {
+    auto measure = arena.New<Measure>();
+    chart->Measures.push_back(measure);
+    measure->Scale = m.Scale;
+    measure->Timing = m.Timing;
+    measure->Pos = m.Pos;
+    measure->TimeLines.reserve(m.TimeLineCount);
+    for (auto t = m.FirstTimeLine; t < m.FirstTimeLine + m.TimeLineCount;
+         ++t) {
+      const auto &tl = timelines[t];
+      auto timeline = arena.New<TimeLine>(TimeLine::MaxLanes, false);
+      measure->TimeLines.push_back(timeline);
+      chart->TimeLines.push_back(timeline);
+      timeline->Bpm = tl.Bpm;
+      timeline->BpmChange = tl.BpmChange != 0;
+      timeline->BpmChangeApplied = tl.BpmChangeApplied != 0;
+      timeline->BgaBase = tl.BgaBase;
+      timeline->BgaLayer = tl.BgaLayer;
+      timeline->BgaPoor = tl.BgaPoor;
+      timeline->StopLength = tl.StopLength;
+      timeline->Scroll = tl.Scroll;
+      timeline->Timing = tl.Timing;
+      timeline->BeatPosition = tl.BeatPosition;
+      timeline->IsFirstInMeasure = tl.IsFirstInMeasure != 0;
+      for (auto i = tl.FirstNote; i < tl.FirstNote + tl.NoteCount; ++i) {
+        const auto &record = records[i];
+        Note *note;
+        if (record.IsLongNote()) {
+          note = arena.New<LongNote>(record.Wav);
+        } else if (record.IsLandmineNote()) {
+          note = arena.New<LandmineNote>(record.Damage);
+          note->Wav = record.Wav;
+        } else {
+          note = arena.New<Note>(record.Wav);
+        }
+        switch (links[i].Slot) {
+        case SnapshotSlot::Note:
+          timeline->SetNote(record.Lane, note);
+          break;
+        case SnapshotSlot::Landmine:
+          timeline->SetLandmineNote(record.Lane,
+                                    static_cast<LandmineNote *>(note));
+          break;
+        case SnapshotSlot::Invisible:
+          timeline->SetInvisibleNote(record.Lane, note);
+          break;
+        case SnapshotSlot::Background:
+          timeline->AddBackgroundNote(note);
+          note->Lane = record.Lane;
+          break;
+        }
+        note->Kind = record.Kind;
+        note->Id = i;
+        notes[i] = note;
+      }
+    }
+  }
+
+  // long notes last, once everything they may point at exists
+  const auto detached =
+      SectionAt<SnapshotDetachedNote>(Bytes, Header->Detached);
+  std::vector<LongNote *> others(detached.size());
+  for (size_t k = 0; k < detached.size(); ++k) {
+    const auto &entry = detached[k];
+    auto other = arena.New<LongNote>(entry.Wav);
+    other->Lane = entry.Lane;
+    other->Kind = entry.Kind;
+    other->Timeline =
+        entry.TimeLine != NoNoteId ? chart->TimeLines[entry.TimeLine] : nullptr;
+    // it points back at the note that points at it, from the other end
+    auto owner = static_cast<LongNote *>(notes[entry.Link]);
+    if (records[entry.Link].Kind == NoteKind::LongHead) {
+      other->Head = owner;
+    } else {
+      other->Tail = owner;
+    }
+    others[k] = other;
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    const auto link = links[i].Link;
+    if (link == NoNoteId) {
+      continue;
+    }
+    auto ln = static_cast<LongNote *>(notes[i]);
+    auto other = link < records.size()
+                     ? static_cast<LongNote *>(notes[link])
+                     : others[link - records.size()];
+    if (records[i].Kind == NoteKind::LongHead) {
+      ln->Tail = other;
+    } else {
+      ln->Head = other;
+    }
+  }
+  return chart.release();
+}
+
+bool ChartSnapshot::LoadOrParse(const std::filesystem::path &chartPath,
+                                const std::filesystem::path &snapshotPath,
+                                Parser &parser, Chart **chart,
+                                bool addReadyMeasure,
+                                std::atomic_bool &bCancelled) {
+  *chart = nullptr;
+  // the source is hashed either way, to check the snapshot against or to
+  // stamp the new one with, and parsed from the same bytes if need be
+  MappedFile mapped;
+  std::vector<unsigned char> buffer;
+  const unsigned char *data = nullptr;
+  size_t size = 0;
+  const auto &options = parser.GetOptions();
+  if (!ReadSource(chartPath, options.UseMemoryMap, mapped, buffer, data,
+                  size)) {
+    return false;
+  }
+  const auto sourceHash = XXHash64(data, size);
+
+  ChartSnapshot snapshot;
+  if (snapshot.Open(snapshotPath) &&
+      snapshot.Matches(sourceHash, addReadyMeasure)) {
+    // a snapshot without the digests the parser would compute is retaken
+    const auto &meta = snapshot.GetMeta();
+    if ((!options.ComputeMD5 || meta.MD5.Size != 0) &&
+        (!options.ComputeSHA256 || meta.SHA256.Size != 0)) {
+      auto loaded = snapshot.ToChart();
+      loaded->Meta.BmsPath = chartPath;
+      loaded->Meta.Folder = chartPath.parent_path();
+      // the same chart as the parse below would give
+      if (options.BuildView) {
+        loaded->View = std::make_unique<ChartView>(*loaded);
+      }
+      *chart = loaded;
+      return true;
+    }
+  }
+  snapshot.Close();
+
+  parser.Parse(data, size, chart, addReadyMeasure, false, bCancelled);
+  auto parsed = *chart;
+  if (parsed == nullptr) {
+    return false;
+  }
+  // the file is closed on return, whatever Options.LazyDigests says
+  parsed->ClearDigestSource();
+  parsed->Meta.ContentHash = sourceHash;
+  parsed->Meta.BmsPath = chartPath;
+  parsed->Meta.Folder = chartPath.parent_path();
+  if (!bCancelled && !parsed->Meta.HasRandom) {
+    Write(*parsed, addReadyMeasure, snapshotPath);
+  }
+  return false;
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+namespace bms_parser {
+ChartView::ChartView(const Chart &chart) {
+  size_t counts[LaneCount] = {};
+  size_t backgroundCount = 0;
+  for (const auto &record : chart.Notes) {
+    if (record.Kind == NoteKind::Background) {
+      ++backgroundCount;
+    } else {
+      ++counts[record.Lane];
+    }
+  }
+  for (int lane = 0; lane < LaneCount; ++lane) {
+    auto &view = Lanes[lane];
+    view.Timing.reserve(counts[lane]);
+    view.BeatPosition.reserve(counts[lane]);
+    view.Wav.reserve(counts[lane]);
+    view.Kind.reserve(counts[lane]);
+    view.Partner.reserve(counts[lane]);
+    view.NoteId.reserve(counts[lane]);
+  }
+  Background.Timing.reserve(backgroundCount);
+  Background.BeatPosition.reserve(backgroundCount);
+  Background.Wav.reserve(backgroundCount);
+  Background.NoteId.reserve(backgroundCount);
+
+  // records are in timeline order already, so appending keeps every array
+  // sorted; a long note's head is always seen before its tail
+  std::vector<uint32_t> laneIndex(chart.Notes.size(), NoNoteId);
+  for (uint32_t id = 0; id < chart.Notes.size(); ++id) {
+    const auto &record = chart.Notes[id];
+    const auto timeline = chart.TimeLines[record.Timeline];
+    if (record.Kind == NoteKind::Background) {
+      Background.Timing.push_back(timeline->Timing);
+      Background.BeatPosition.push_back(timeline->BeatPosition);
+      Background.Wav.push_back(record.Wav);
+      Background.NoteId.push_back(id);
+      continue;
+    }
+    auto &view = Lanes[record.Lane];
+    const auto index = static_cast<uint32_t>(view.size());
+    laneIndex[id] = index;
+    auto partner = NoNoteId;
+    if (record.Kind == NoteKind::LongTail && record.Partner != NoNoteId) {
+      partner = laneIndex[record.Partner];
+      view.Partner[partner] = index;
+    }
+    view.Timing.push_back(timeline->Timing);
+    view.BeatPosition.push_back(timeline->BeatPosition);
+    view.Wav.push_back(record.Wav);
+    view.Kind.push_back(record.Kind);
+    view.Partner.push_back(partner);
+    view.NoteId.push_back(id);
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if BMS_PARSER_X86 && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace bms_parser {
+namespace {
+struct CpuInfo {
+  bool SSE2 = false;
+  bool AVX2 = false;
+  bool SHA = false;
+
+  CpuInfo() {
+#if BMS_PARSER_X86
+    unsigned int regs[4] = {0, 0, 0, 0}; // eax, ebx, ecx, edx
+    auto cpuid = [&regs](unsigned int leaf, unsigned int subleaf) {
+#ifdef _MSC_VER
+      int out[4];
+      __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+      for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned int>(out[i]);
+      }
+#else
+      __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    };
+    cpuid(0, 0);
+    const unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+      return;
+    }
+    cpuid(1, 0);
+    SSE2 = (regs[3] & (1u << 26)) != 0;
+    const bool ssse3 = (regs[2] & (1u << 9)) != 0;
+    const bool sse41 = (regs[2] & (1u << 19)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+    // AVX registers are only usable if the OS saves the YMM state
+    bool ymmEnabled = false;
+    if (osxsave && avx) {
+#ifdef _MSC_VER
+      ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+#else
+      unsigned int xcr0Low, xcr0High;
+      __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+      ymmEnabled = (xcr0Low & 0x6) == 0x6;
+#endif
+    }
+    if (maxLeaf >= 7) {
+      cpuid(7, 0);
+      AVX2 = ymmEnabled && (regs[1] & (1u << 5)) != 0;
+      SHA = ssse3 && sse41 && (regs[1] & (1u << 29)) != 0;
+    }
+#endif
+  }
+};
+
+const CpuInfo &GetCpuInfo() {
+  static const CpuInfo info;
+  return info;
+}
+} // namespace
+
+bool CpuFeatures::HasSSE2() { return GetCpuInfo().SSE2; }
+bool CpuFeatures::HasAVX2() { return GetCpuInfo().AVX2; }
+bool CpuFeatures::HasSHA() { return GetCpuInfo().SHA; }
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+
+namespace bms_parser {
+DigestStream::DigestStream(bool md5, bool sha256)
+    : WantMD5(md5), WantSHA256(sha256) {
+  Sha256.init();
+}
+
+void DigestStream::Update(const unsigned char *bytes, size_t size) {
+  for (size_t offset = 0; offset < size; offset += BlockSize) {
+    const auto length = std::min(BlockSize, size - offset);
+    if (WantMD5) {
+      Md5.update(bytes + offset, static_cast<MD5::size_type>(length));
+    }
+    if (WantSHA256) {
+      Sha256.update(bytes + offset, static_cast<unsigned int>(length));
+    }
+  }
+}
+
+void DigestStream::Finish(std::string &md5, std::string &sha256) {
+  if (WantMD5) {
+    Md5.finalize();
+    md5 = Md5.hexdigest();
+  }
+  if (WantSHA256) {
+    unsigned char digest[SHA256::DIGEST_SIZE];
+    Sha256.final(digest);
+    char buf[2 * SHA256::DIGEST_SIZE + 1];
+    for (unsigned int i = 0; i < SHA256::DIGEST_SIZE; i++) {
+      snprintf(buf + i * 2, 3, "%02x", digest[i]);
+    }
+    sha256 = buf;
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+
+namespace bms_parser {
+namespace {
+struct KeywordEntry {
+  std::string_view Name; // upper case
+  HeaderKeyword Keyword;
+};
+
+// Sorted by name so that each first letter owns one contiguous range.
+// #ELSEIF has no entry of its own: ELSE is a prefix of it and always matched
+// first, so it behaves like #ELSE.
+constexpr KeywordEntry Keywords[] = {
+    {"ARTIST", HeaderKeyword::Artist},
+    {"BACKBMP", HeaderKeyword::BackBmp},
+    {"BANNER", HeaderKeyword::Banner},
+    {"BASE", HeaderKeyword::Base},
+    {"BMP", HeaderKeyword::Bmp},
+    {"BPM", HeaderKeyword::Bpm},
+    {"DIFFICULTY", HeaderKeyword::Difficulty},
+    {"ELSE", HeaderKeyword::Else},
+    {"END IF", HeaderKeyword::EndIf},
+    {"ENDIF", HeaderKeyword::EndIf},
+    {"ENDRANDOM", HeaderKeyword::EndRandom},
+    {"GENRE", HeaderKeyword::Genre},
+    {"IF", HeaderKeyword::If},
+    {"LNMODE", HeaderKeyword::LnMode},
+    {"LNOBJ", HeaderKeyword::LnObj},
+    {"LNTYPE", HeaderKeyword::LnType},
+    {"MIDIFILE", HeaderKeyword::MidiFile},
+    {"PLAYER", HeaderKeyword::Player},
+    {"PLAYLEVEL", HeaderKeyword::PlayLevel},
+    {"PREVIEW", HeaderKeyword::Preview},
+    {"RANDOM", HeaderKeyword::Random},
+    {"RANK", HeaderKeyword::Rank},
+    {"RONDAM", HeaderKeyword::Random}, // common typo
+    {"SCROLL", HeaderKeyword::Scroll},
+    {"STAGEFILE", HeaderKeyword::StageFile},
+    {"STOP", HeaderKeyword::Stop},
+    {"SUBARTIST", HeaderKeyword::SubArtist},
+    {"SUBTITLE", HeaderKeyword::SubTitle},
+    {"TITLE", HeaderKeyword::Title},
+    {"TOTAL", HeaderKeyword::Total},
+    {"VIDEOFILE", HeaderKeyword::VideoFile},
+    {"VOLWAV", HeaderKeyword::VolWav},
+    {"WAV", HeaderKeyword::Wav},
+};
+constexpr size_t KeywordCount = sizeof(Keywords) / sizeof(Keywords[0]);
+
+constexpr bool IsPrefix(std::string_view prefix, std::string_view str) {
+  return prefix.length() <= str.length() &&
+         str.substr(0, prefix.length()) == prefix;
+}
+
+// With no keyword being a prefix of another, a line matches at most one
+// entry and the order of the old if/else chain no longer matters.
+constexpr bool HasUniquePrefixes() {
+  for (size_t i = 0; i < KeywordCount; ++i) {
+    if (i > 0 && Keywords[i - 1].Name >= Keywords[i].Name) {
+      return false; // not sorted
+    }
+    for (size_t j = 0; j < KeywordCount; ++j) {
+      if (i != j && IsPrefix(Keywords[i].Name, Keywords[j].Name)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+static_assert(HasUniquePrefixes(), "keywords must be sorted prefix-free");
+
+struct LetterRange {
+  uint8_t Begin = 0;
+  uint8_t End = 0;
+};
+
+constexpr std::array<LetterRange, 26> BuildLetterIndex() {
+  std::array<LetterRange, 26> index{};
+  for (size_t i = KeywordCount; i-- > 0;) {
+    auto &range = index[Keywords[i].Name[0] - 'A'];
+    if (range.End == 0) {
+      range.End = static_cast<uint8_t>(i + 1);
+    }
+    range.Begin = static_cast<uint8_t>(i);
+  }
+  return index;
+}
+constexpr auto LetterIndex = BuildLetterIndex();
+
+inline char ToUpperAscii(char c) {
+  return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+}
+} // namespace
+
+HeaderKeyword HeaderKeywords::Match(std::string_view text) {
+  if (text.empty()) {
+    return HeaderKeyword::None;
+  }
+  const char first = ToUpperAscii(text[0]);
+  if (first < 'A' || first > 'Z') {
+    return HeaderKeyword::None;
+  }
+  const auto &range = LetterIndex[first - 'A'];
+  for (size_t i = range.Begin; i < range.End; ++i) {
+    const auto name = Keywords[i].Name;
+    if (text.length() < name.length()) {
+      continue;
+    }
+    size_t j = 1;
+    while (j < name.length() && ToUpperAscii(text[j]) == name[j]) {
+      ++j;
+    }
+    if (j == name.length()) {
+      return Keywords[i].Keyword;
+    }
+  }
+  return HeaderKeyword::None;
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace bms_parser {
+LandmineNote::LandmineNote(float Damage) : Note(0) {
+  this->Damage = Damage;
+  Kind = NoteKind::Landmine;
+}
+
+LandmineNote::~LandmineNote() = default;
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace bms_parser {
+bool LongNote::IsTail() const { return Tail == nullptr; }
+
+LongNote::LongNote(int Wav) : Note(Wav) { Kind = NoteKind::LongHead; }
+
+LongNote::~LongNote() {
+  Head = nullptr;
+  Tail = nullptr;
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bms_parser {
+#ifdef _WIN32
+bool MappedFile::Open(const std::filesystem::path &path) {
+  Close();
+  File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                     OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (File == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(File, &fileSize)) {
+    Close();
+    return false;
+  }
+  if (fileSize.QuadPart == 0) {
+    // empty files can't be mapped, but they are still valid input
+    return true;
+  }
+  Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (Mapping == nullptr) {
+    Close();
+    return false;
+  }
+  auto view = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    Close();
+    return false;
+  }
+  Data = static_cast<const unsigned char *>(view);
+  Size = static_cast<size_t>(fileSize.QuadPart);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (Data != nullptr) {
+    UnmapViewOfFile(Data);
+  }
+  if (Mapping != nullptr) {
+    CloseHandle(Mapping);
+  }
+  if (File != INVALID_HANDLE_VALUE) {
+    CloseHandle(File);
+  }
+  Data = nullptr;
+  Size = 0;
+  Mapping = nullptr;
+  File = INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::Open(const std::filesystem::path &path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return false;
+  }
+  if (st.st_size == 0) {
+    // empty files can't be mapped, but they are still valid input
+    close(fd);
+    return true;
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping keeps its own reference to the file
+  close(fd);
+  if (view == MAP_FAILED) {
+    return false;
+  }
+#ifdef MADV_SEQUENTIAL
+  madvise(view, size, MADV_SEQUENTIAL);
+#endif
+  Data = static_cast<const unsigned char *>(view);
+  Size = size;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (Data != nullptr) {
+    munmap(const_cast<unsigned char *>(Data), Size);
+  }
+  Data = nullptr;
+  Size = 0;
+}
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+namespace bms_parser {
+Measure::~Measure() {
+  // the timelines live in the chart's arena; this only frees what they
+  // allocated themselves
+  for (const auto &Timeline : TimeLines) {
+    Timeline->~TimeLine();
+  }
+  TimeLines.clear();
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <vector>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace bms_parser {
+namespace {
+// "BMMC", then the format and parser versions, the entry count, the entries
+// and an XXH64 of everything before it. Numbers are little-endian.
+constexpr uint32_t CacheMagic = 0x434D4D42;
+// bump when the entry layout changes, e.g. when ChartMeta gains a field
+constexpr uint32_t CacheFormat = 2;
+
+class CacheWriter {
+public:
+  std::vector<unsigned char> Bytes;
+
+  void Field(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      Bytes.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+  }
+  void Field(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      Bytes.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+  }
+  void Field(int value) { Field(static_cast<uint32_t>(value)); }
+  void Field(long long value) { Field(static_cast<uint64_t>(value)); }
+  void Field(bool value) { Bytes.push_back(value ? 1 : 0); }
+  void Field(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Field(bits);
+  }
+  void Field(TextEncoding value) {
+    Bytes.push_back(static_cast<unsigned char>(value));
+  }
+  void Field(const std::string &value) {
+    Field(static_cast<uint32_t>(value.size()));
+    Bytes.insert(Bytes.end(), value.begin(), value.end());
+  }
+  void Field(const std::filesystem::path &value) { Field(value.u8string()); }
+};
+
+// Reads what CacheWriter wrote. Running past the end sets Failed and yields
+// zeros from then on, so callers only check once at the end.
+class CacheReader {
+public:
+  CacheReader(const unsigned char *bytes, size_t size)
+      : Bytes(bytes), Size(size) {}
+  bool Failed = false;
+
+  [[nodiscard]] size_t Consumed() const { return Offset; }
+  void Field(uint64_t &value) {
+    value = 0;
+    if (Take(8)) {
+      for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | Bytes[Offset - 8 + i];
+      }
+    }
+  }
+  void Field(uint32_t &value) {
+    value = 0;
+    if (Take(4)) {
+      for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | Bytes[Offset - 4 + i];
+      }
+    }
+  }
+  void Field(int &value) {
+    uint32_t bits;
+    Field(bits);
+    value = static_cast<int>(bits);
+  }
+  void Field(long long &value) {
+    uint64_t bits;
+    Field(bits);
+    value = static_cast<long long>(bits);
+  }
+  void Field(bool &value) { value = Take(1) && Bytes[Offset - 1] != 0; }
+  void Field(double &value) {
+    uint64_t bits;
+    Field(bits);
+    std::memcpy(&value, &bits, sizeof(value));
+  }
+  void Field(TextEncoding &value) {
+    value = static_cast<TextEncoding>(Take(1) ? Bytes[Offset - 1] : 0);
+  }
+  void Field(std::string &value) {
+    uint32_t length;
+    Field(length);
+    value.clear();
+    if (Take(length)) {
+      value.assign(reinterpret_cast<const char *>(Bytes + Offset - length),
+                   length);
+    }
+  }
+  void Field(std::filesystem::path &value) {
+    std::string utf8;
+    Field(utf8);
+    value = std::filesystem::u8path(utf8);
+  }
+
+private:
+  bool Take(size_t count) {
+    if (Failed || Size - Offset < count) {
+      Failed = true;
+      return false;
+    }
+    Offset += count;
+    return true;
+  }
+  const unsigned char *Bytes;
+  size_t Size;
+  size_t Offset = 0;
+};
+
+// every field of an entry, in file order; Meta is const when writing
+template <class Archive, class Identity, class Meta>
+void EntryFields(Archive &archive, Identity &identity, Meta &meta) {
+  archive.Field(identity.Path);
+  archive.Field(identity.Size);
+  archive.Field(identity.ModifiedTime);
+  archive.Field(identity.Inode);
+  archive.Field(identity.Device);
+  archive.Field(meta.SHA256);
+  archive.Field(meta.MD5);
+  archive.Field(meta.ContentHash);
+  archive.Field(meta.BmsPath);
+  archive.Field(meta.Folder);
+  archive.Field(meta.Artist);
+  archive.Field(meta.SubArtist);
+  archive.Field(meta.Bpm);
+  archive.Field(meta.Genre);
+  archive.Field(meta.Title);
+  archive.Field(meta.SubTitle);
+  archive.Field(meta.Rank);
+  archive.Field(meta.Total);
+  archive.Field(meta.PlayLength);
+  archive.Field(meta.TotalLength);
+  archive.Field(meta.Banner);
+  archive.Field(meta.StageFile);
+  archive.Field(meta.BackBmp);
+  archive.Field(meta.Preview);
+  archive.Field(meta.BgaPoorDefault);
+  archive.Field(meta.Difficulty);
+  archive.Field(meta.PlayLevel);
+  archive.Field(meta.MinBpm);
+  archive.Field(meta.MaxBpm);
+  archive.Field(meta.Player);
+  archive.Field(meta.KeyMode);
+  archive.Field(meta.IsDP);
+  archive.Field(meta.TotalNotes);
+  archive.Field(meta.TotalLongNotes);
+  archive.Field(meta.TotalScratchNotes);
+  archive.Field(meta.TotalBackSpinNotes);
+  archive.Field(meta.TotalLandmineNotes);
+  archive.Field(meta.LnMode);
+  archive.Field(meta.Encoding);
+  archive.Field(meta.HasRandom);
+}
+} // namespace
+
+bool FileIdentity::operator==(const FileIdentity &other) const {
+  return Path == other.Path && Size == other.Size &&
+         ModifiedTime == other.ModifiedTime && Inode == other.Inode &&
+         Device == other.Device;
+}
+
+bool FileIdentity::Of(const std::filesystem::path &path,
+                      FileIdentity &identity) {
+  identity = FileIdentity();
+#ifdef _WIN32
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) {
+    return false;
+  }
+  identity.Size = std::filesystem::file_size(path, ec);
+  const auto modified = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return false;
+  }
+  identity.ModifiedTime = static_cast<long long>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          modified.time_since_epoch())
+          .count());
+#else
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) {
+    return false;
+  }
+  identity.Size = static_cast<uint64_t>(status.st_size);
+#ifdef __APPLE__
+  const auto &modified = status.st_mtimespec;
+#else
+  const auto &modified = status.st_mtim;
+#endif
+  identity.ModifiedTime =
+      static_cast<long long>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+  identity.Inode = static_cast<uint64_t>(status.st_ino);
+  identity.Device = static_cast<uint64_t>(status.st_dev);
+#endif
+  identity.Path = path.u8string();
+  return true;
+}
+
+bool MetaCache::Load(const std::filesystem::path &file) {
+  std::unordered_map<std::string, Entry> entries;
+  std::vector<unsigned char> bytes;
+  std::ifstream in(file, std::ios::binary | std::ios::ate);
+  if (in.is_open()) {
+    bytes.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+    if (!in) {
+      bytes.clear();
+    }
+  }
+  bool loaded = false;
+  if (bytes.size() >= 8) {
+    const auto payload = bytes.size() - 8;
+    CacheReader reader(bytes.data(), bytes.size());
+    uint32_t magic, format, version, count;
+    reader.Field(magic);
+    reader.Field(format);
+    reader.Field(version);
+    reader.Field(count);
+    if (magic == CacheMagic && format == CacheFormat &&
+        version == Parser::Version) {
+      entries.reserve(std::min<size_t>(count, payload / 64));
+      for (uint32_t i = 0; i < count && !reader.Failed; ++i) {
+        Entry entry;
+        EntryFields(reader, entry.Identity, entry.Meta);
+        auto key = entry.Identity.Path;
+        entries.emplace(std::move(key), std::move(entry));
+      }
+      uint64_t checksum;
+      reader.Field(checksum);
+      loaded = !reader.Failed && reader.Consumed() == bytes.size() &&
+               checksum == XXHash64(bytes.data(), payload);
+    }
+  }
+  std::lock_guard<std::mutex> lock(Mutex);
+  Entries.clear();
+  if (loaded) {
+    Entries = std::move(entries);
+  }
+  return loaded;
+}
+
+bool MetaCache::Save(const std::filesystem::path &file) const {
+  CacheWriter writer;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    writer.Field(CacheMagic);
+    writer.Field(CacheFormat);
+    writer.Field(Parser::Version);
+    writer.Field(static_cast<uint32_t>(Entries.size()));
+    for (const auto &[path, entry] : Entries) {
+      EntryFields(writer, entry.Identity, entry.Meta);
+    }
+  }
+  writer.Field(XXHash64(writer.Bytes.data(), writer.Bytes.size()));
+
+  auto temporary = file;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(writer.Bytes.data()),
+              static_cast<std::streamsize>(writer.Bytes.size()));
+    if (!out.good()) {
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(temporary, file, ec);
+  return !ec;
+}
+
+bool MetaCache::Find(const std::filesystem::path &path, ChartMeta &meta,
+                     FileIdentity &identity) {
+  if (!FileIdentity::Of(path, identity)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(Mutex);
+  const auto found = Entries.find(identity.Path);
+  if (found == Entries.end() || !(found->second.Identity == identity)) {
+    return false;
+  }
+  found->second.Used = true;
+  meta = found->second.Meta;
+  return true;
+}
+
+void MetaCache::Store(const FileIdentity &identity, const ChartMeta &meta) {
+  if (identity.Path.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(Mutex);
+  auto &entry = Entries[identity.Path];
+  entry.Identity = identity;
+  entry.Meta = meta;
+  entry.Used = true;
+}
+
+size_t MetaCache::RemoveUnused() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  size_t removed = 0;
+  for (auto it = Entries.begin(); it != Entries.end();) {
+    if (it->second.Used) {
+      ++it;
+    } else {
+      it = Entries.erase(it);
+      ++removed;
+    }
+  }
+  return removed;
+}
+
+size_t MetaCache::size() const {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Entries.size();
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+namespace {
+std::string HashMD5(const HashInput &input) {
+  MD5 md5;
+  md5.update(input.Bytes, static_cast<MD5::size_type>(input.Size));
+  md5.finalize();
+  return md5.hexdigest();
+}
+
+#if BMS_PARSER_X86
+constexpr size_t BlockSize = 64;
+
+// A message as the blocks the compression function sees: the whole blocks
+// straight from the input, then one or two padded blocks from Tail.
+struct LaneMessage {
+  const unsigned char *Bytes = nullptr;
+  size_t WholeBlocks = 0;
+  size_t Blocks = 0;
+  size_t Next = 0;
+  unsigned char Tail[2 * BlockSize];
+
+  void Reset(const HashInput &input, bool bigEndianLength) {
+    Bytes = input.Bytes;
+    WholeBlocks = input.Size / BlockSize;
+    Next = 0;
+    const auto rest = input.Size % BlockSize;
+    Blocks = WholeBlocks + (rest < BlockSize - 8 ? 1 : 2);
+    std::memset(Tail, 0, sizeof(Tail));
+    if (rest != 0) {
+      std::memcpy(Tail, Bytes + WholeBlocks * BlockSize, rest);
+    }
+    Tail[rest] = 0x80;
+    auto *length = Tail + (Blocks - WholeBlocks) * BlockSize - 8;
+    const uint64_t bits = static_cast<uint64_t>(input.Size) * 8;
+    for (int i = 0; i < 8; ++i) {
+      const auto shift = bigEndianLength ? 56 - i * 8 : i * 8;
+      length[i] = static_cast<unsigned char>(bits >> shift);
+    }
+  }
+  [[nodiscard]] const unsigned char *Block(size_t index) const {
+    return index < WholeBlocks ? Bytes + index * BlockSize
+                               : Tail + (index - WholeBlocks) * BlockSize;
+  }
+};
+
+// State word w of lane l is State[w][l], so a row loads as one register.
+template <size_t Words> struct LaneState {
+  alignas(32) uint32_t State[Words][HashLanes];
+};
+
+// rows[l] holds eight consecutive words of lane l; afterwards rows[w] holds
+// word w of every lane
+BMS_PARSER_TARGET("avx2")
+inline void Transpose(__m256i *rows) {
+  const auto t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+  const auto t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+  const auto t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+  const auto t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+  const auto t4 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+  const auto t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+  const auto t6 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+  const auto t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+  const auto u0 = _mm256_unpacklo_epi64(t0, t2);
+  const auto u1 = _mm256_unpackhi_epi64(t0, t2);
+  const auto u2 = _mm256_unpacklo_epi64(t1, t3);
+  const auto u3 = _mm256_unpackhi_epi64(t1, t3);
+  const auto u4 = _mm256_unpacklo_epi64(t4, t6);
+  const auto u5 = _mm256_unpackhi_epi64(t4, t6);
+  const auto u6 = _mm256_unpacklo_epi64(t5, t7);
+  const auto u7 = _mm256_unpackhi_epi64(t5, t7);
+  rows[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  rows[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  rows[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  rows[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  rows[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  rows[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  rows[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  rows[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// the sixteen message words of every lane's block, word-major
+BMS_PARSER_TARGET("avx2")
+inline void LoadMessage(const unsigned char *const *blocks, __m256i *words) {
+  for (size_t half = 0; half < 2; ++half) {
+    for (size_t lane = 0; lane < HashLanes; ++lane) {
+      words[half * 8 + lane] = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(blocks[lane] + half * 32));
+    }
+    Transpose(words + half * 8);
+  }
+}
+
+BMS_PARSER_TARGET("avx2")
+inline __m256i RotateLeft(__m256i x, int n) {
+  return _mm256_or_si256(_mm256_slli_epi32(x, n),
+                         _mm256_srli_epi32(x, 32 - n));
+}
+
+struct Md5Lanes {
+  static constexpr size_t Words = 4;
+  static constexpr bool BigEndianLength = false;
+  static constexpr uint32_t Initial[Words] = {0x67452301, 0xefcdab89,
+                                              0x98badcfe, 0x10325476};
+
+  static void Compress(LaneState<Words> &state,
+                       const unsigned char *const *blocks);
+  static std::string HexDigest(const LaneState<Words> &state, size_t lane) {
+    char buf[2 * 16 + 1];
+    for (size_t w = 0; w < Words; ++w) {
+      const auto word = state.State[w][lane];
+      for (size_t b = 0; b < 4; ++b) {
+        snprintf(buf + (w * 4 + b) * 2, 3, "%02x", (word >> (b * 8)) & 0xff);
+      }
+    }
+    return buf;
+  }
+  static std::string &Digest(HashOutput &output) { return output.MD5; }
+};
+
+constexpr uint32_t Md5Constants[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
+    0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
+    0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8,
+    0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92,
+    0xffeff47d, 0x85845dd1, 0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+// one MD5 step: a = b + rotl(a + f + k + m, s)
+#define MD5_LANES_STEP(f, a, b, c, d, i, g, s)                                 \
+  a = _mm256_add_epi32(                                                        \
+      b, RotateLeft(_mm256_add_epi32(                                          \
+                        _mm256_add_epi32(a, f),                                \
+                        _mm256_add_epi32(                                      \
+                            _mm256_set1_epi32(                                 \
+                                static_cast<int>(Md5Constants[i])),            \
+                            m[g])),                                            \
+                    s))
+
+BMS_PARSER_TARGET("avx2")
+void Md5Lanes::Compress(LaneState<Words> &state,
+                        const unsigned char *const *blocks) {
+  __m256i m[16];
+  LoadMessage(blocks, m);
+  const auto ones = _mm256_set1_epi32(-1);
+  auto *rows = reinterpret_cast<__m256i *>(state.State);
+  auto a = _mm256_load_si256(rows);
+  auto b = _mm256_load_si256(rows + 1);
+  auto c = _mm256_load_si256(rows + 2);
+  auto d = _mm256_load_si256(rows + 3);
+  const auto a0 = a, b0 = b, c0 = c, d0 = d;
+#define MD5_F(x, y, z)                                                         \
+  _mm256_or_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z))
+#define MD5_G(x, y, z)                                                         \
+  _mm256_or_si256(_mm256_and_si256(x, z), _mm256_andnot_si256(z, y))
+#define MD5_H(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define MD5_I(x, y, z)                                                         \
+  _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, ones)))
+  for (int i = 0; i < 16; i += 4) {
+    MD5_LANES_STEP(MD5_F(b, c, d), a, b, c, d, i, i, 7);
+    MD5_LANES_STEP(MD5_F(a, b, c), d, a, b, c, i + 1, i + 1, 12);
+    MD5_LANES_STEP(MD5_F(d, a, b), c, d, a, b, i + 2, i + 2, 17);
+    MD5_LANES_STEP(MD5_F(c, d, a), b, c, d, a, i + 3, i + 3, 22);
+  }
+  for (int i = 16; i < 32; i += 4) {
+    MD5_LANES_STEP(MD5_G(b, c, d), a, b, c, d, i, (5 * i + 1) % 16, 5);
+    MD5_LANES_STEP(MD5_G(a, b, c), d, a, b, c, i + 1, (5 * i + 6) % 16, 9);
+    MD5_LANES_STEP(MD5_G(d, a, b), c, d, a, b, i + 2, (5 * i + 11) % 16, 14);
+    MD5_LANES_STEP(MD5_G(c, d, a), b, c, d, a, i + 3, (5 * i + 16) % 16, 20);
+  }
+  for (int i = 32; i < 48; i += 4) {
+    MD5_LANES_STEP(MD5_H(b, c, d), a, b, c, d, i, (3 * i + 5) % 16, 4);
+    MD5_LANES_STEP(MD5_H(a, b, c), d, a, b, c, i + 1, (3 * i + 8) % 16, 11);
+    MD5_LANES_STEP(MD5_H(d, a, b), c, d, a, b, i + 2, (3 * i + 11) % 16, 16);
+    MD5_LANES_STEP(MD5_H(c, d, a), b, c, d, a, i + 3, (3 * i + 14) % 16, 23);
+  }
+  for (int i = 48; i < 64; i += 4) {
+    MD5_LANES_STEP(MD5_I(b, c, d), a, b, c, d, i, (7 * i) % 16, 6);
+    MD5_LANES_STEP(MD5_I(a, b, c), d, a, b, c, i + 1, (7 * i + 7) % 16, 10);
+    MD5_LANES_STEP(MD5_I(d, a, b), c, d, a, b, i + 2, (7 * i + 14) % 16, 15);
+    MD5_LANES_STEP(MD5_I(c, d, a), b, c, d, a, i + 3, (7 * i + 21) % 16, 21);
+  }
+#undef MD5_F
+#undef MD5_G
+#undef MD5_H
+#undef MD5_I
+  _mm256_store_si256(rows, _mm256_add_epi32(a, a0));
+  _mm256_store_si256(rows + 1, _mm256_add_epi32(b, b0));
+  _mm256_store_si256(rows + 2, _mm256_add_epi32(c, c0));
+  _mm256_store_si256(rows + 3, _mm256_add_epi32(d, d0));
+}
+#undef MD5_LANES_STEP
+
+struct Sha256Lanes {
+  static constexpr size_t Words = 8;
+  static constexpr bool BigEndianLength = true;
+  static constexpr uint32_t Initial[Words] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+  static void Compress(LaneState<Words> &state,
+                       const unsigned char *const *blocks);
+  static std::string HexDigest(const LaneState<Words> &state, size_t lane) {
+    char buf[2 * 32 + 1];
+    for (size_t w = 0; w < Words; ++w) {
+      snprintf(buf + w * 8, 9, "%08x",
+               static_cast<unsigned int>(state.State[w][lane]));
+    }
+    return buf;
+  }
+  static std::string &Digest(HashOutput &output) { return output.SHA256; }
+};
+
+constexpr uint32_t Sha256Constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+BMS_PARSER_TARGET("avx2")
+inline __m256i RotateRight(__m256i x, int n) {
+  return _mm256_or_si256(_mm256_srli_epi32(x, n),
+                         _mm256_slli_epi32(x, 32 - n));
+}
+
+BMS_PARSER_TARGET("avx2")
+void Sha256Lanes::Compress(LaneState<Words> &state,
+                           const unsigned char *const *blocks) {
+  __m256i w[16];
+  LoadMessage(blocks, w);
+  const auto byteSwap = _mm256_set_epi64x(
+      0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL,
+      0x0405060700010203ULL);
+  for (auto &word : w) {
+    word = _mm256_shuffle_epi8(word, byteSwap);
+  }
+  auto *rows = reinterpret_cast<__m256i *>(state.State);
+  __m256i v[Words];
+  for (size_t i = 0; i < Words; ++i) {
+    v[i] = _mm256_load_si256(rows + i);
+  }
+  auto a = v[0], b = v[1], c = v[2], d = v[3];
+  auto e = v[4], f = v[5], g = v[6], h = v[7];
+  for (int t = 0; t < 64; ++t) {
+    auto &wt = w[t & 15];
+    if (t >= 16) {
+      const auto w2 = w[(t - 2) & 15];
+      const auto w15 = w[(t - 15) & 15];
+      const auto s0 = _mm256_xor_si256(
+          _mm256_xor_si256(RotateRight(w15, 7), RotateRight(w15, 18)),
+          _mm256_srli_epi32(w15, 3));
+      const auto s1 = _mm256_xor_si256(
+          _mm256_xor_si256(RotateRight(w2, 17), RotateRight(w2, 19)),
+          _mm256_srli_epi32(w2, 10));
+      wt = _mm256_add_epi32(_mm256_add_epi32(wt, s0),
+                            _mm256_add_epi32(w[(t - 7) & 15], s1));
+    }
+    const auto bigSigma1 = _mm256_xor_si256(
+        _mm256_xor_si256(RotateRight(e, 6), RotateRight(e, 11)),
+        RotateRight(e, 25));
+    const auto ch = _mm256_xor_si256(_mm256_and_si256(e, f),
+                                     _mm256_andnot_si256(e, g));
+    const auto t1 = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(h, bigSigma1),
+                         _mm256_add_epi32(ch, wt)),
+        _mm256_set1_epi32(static_cast<int>(Sha256Constants[t])));
+    const auto bigSigma0 = _mm256_xor_si256(
+        _mm256_xor_si256(RotateRight(a, 2), RotateRight(a, 13)),
+        RotateRight(a, 22));
+    const auto maj = _mm256_xor_si256(
+        _mm256_and_si256(a, b),
+        _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+    const auto t2 = _mm256_add_epi32(bigSigma0, maj);
+    h = g;
+    g = f;
+    f = e;
+    e = _mm256_add_epi32(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = _mm256_add_epi32(t1, t2);
+  }
+  const __m256i out[Words] = {a, b, c, d, e, f, g, h};
+  for (size_t i = 0; i < Words; ++i) {
+    _mm256_store_si256(rows + i, _mm256_add_epi32(v[i], out[i]));
+  }
+}
+
+// Feeds the messages through the lanes in order, refilling a lane as soon as
+// its message is done. Lanes left without a message hash a block of zeros.
+template <class Algorithm>
+void RunLanes(const HashInput *inputs, size_t count, HashOutput *outputs) {
+  constexpr size_t Idle = SIZE_MAX;
+  static const unsigned char zeros[BlockSize] = {};
+  LaneState<Algorithm::Words> state;
+  LaneMessage messages[HashLanes];
+  size_t owner[HashLanes];
+  const unsigned char *blocks[HashLanes];
+  size_t next = 0;
+  size_t active = 0;
+  auto refill = [&](size_t lane) {
+    if (next == count) {
+      owner[lane] = Idle;
+      return;
+    }
+    owner[lane] = next;
+    messages[lane].Reset(inputs[next++], Algorithm::BigEndianLength);
+    for (size_t w = 0; w < Algorithm::Words; ++w) {
+      state.State[w][lane] = Algorithm::Initial[w];
+    }
+    ++active;
+  };
+  for (size_t lane = 0; lane < HashLanes; ++lane) {
+    refill(lane);
+  }
+  while (active > 0) {
+    for (size_t lane = 0; lane < HashLanes; ++lane) {
+      blocks[lane] = owner[lane] == Idle
+                         ? zeros
+                         : messages[lane].Block(messages[lane].Next);
+    }
+    Algorithm::Compress(state, blocks);
+    for (size_t lane = 0; lane < HashLanes; ++lane) {
+      if (owner[lane] == Idle ||
+          ++messages[lane].Next < messages[lane].Blocks) {
+        continue;
+      }
+      Algorithm::Digest(outputs[owner[lane]]) =
+          Algorithm::HexDigest(state, lane);
+      --active;
+      refill(lane);
+    }
+  }
+}
+#endif
+} // namespace
+
+void HashMany(const HashInput *inputs, size_t count, HashOutput *outputs,
+              bool wantMD5, bool wantSHA256, HashManyMode mode) {
+#if BMS_PARSER_X86
+  const bool forced = mode == HashManyMode::Lanes;
+  const bool lanes = mode != HashManyMode::Single &&
+                     (count > 1 || forced) && CpuFeatures::HasAVX2();
+  if (lanes && wantMD5) {
+    RunLanes<Md5Lanes>(inputs, count, outputs);
+    wantMD5 = false;
+  }
+  // one SHA-NI stream beats eight AVX2 lanes
+  if (lanes && wantSHA256 && (forced || !CpuFeatures::HasSHA())) {
+    RunLanes<Sha256Lanes>(inputs, count, outputs);
+    wantSHA256 = false;
+  }
+#endif
+  for (size_t i = 0; i < count; ++i) {
+    if (wantMD5) {
+      outputs[i].MD5 = HashMD5(inputs[i]);
+    }
+    if (wantSHA256) {
+      outputs[i].SHA256 = sha256(inputs[i].Bytes, inputs[i].Size);
+    }
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace bms_parser {
+Note::Note(int wav) { Wav = wav; }
+
+Note::~Note() { Timeline = nullptr; }
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+
+namespace bms_parser {
+namespace {
+// Shared by the caller and the jobs. Jobs may start after ParseMany has
+// returned (when the executor was busy and the caller did all the work), so
+// they only touch this, never the caller's stack.
+struct Batch {
+  std::vector<std::filesystem::path> Paths;
+  // indices into Paths, largest file first
+  std::vector<size_t> Order;
+  BatchOptions Options;
+  BatchCallback Callback;
+  std::atomic_bool *Cancelled;
+  std::atomic<size_t> Next{0};
+  // paths a job takes at a time, at most HashLanes
+  size_t GroupSize = 1;
+
+  // set once a callback has thrown; groups taken from then on are only
+  // counted, never parsed
+  std::atomic_bool Stopped{false};
+
+  std::mutex DoneMutex;
+  std::condition_variable DoneChanged;
+  size_t Done = 0;          // guarded by DoneMutex
+  std::exception_ptr Error; // the first callback error, guarded by DoneMutex
+
+  void Fail(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(DoneMutex);
+    if (!Error) {
+      Error = std::move(error);
+    }
+    Stopped = true;
+  }
+  void Finish(size_t count) {
+    std::lock_guard<std::mutex> lock(DoneMutex);
+    Done += count;
+    if (Done == Order.size()) {
+      DoneChanged.notify_all();
+    }
+  }
+};
+
+// A file of the current group, kept in memory from its parse until it has
+// been hashed with the rest of the group. A job keeps its entries for all of
+// its groups, so the read buffers only grow to the largest file it takes.
+struct GroupEntry {
+  MappedFile Mapped;
+  std::vector<unsigned char> Buffer;
+  HashInput Source;
+  Chart *Result = nullptr;
+  std::exception_ptr Error;
+
+  // ready for the next file; the chart must have been handed over or deleted
+  void Reset() {
+    Mapped.Close();
+    Buffer.clear();
+    Source = {};
+    Result = nullptr;
+    Error = nullptr;
+  }
+};
+
+void Load(const std::filesystem::path &path, bool useMemoryMap,
+          GroupEntry &entry) {
+  if (useMemoryMap && entry.Mapped.Open(path)) {
+    entry.Source = {entry.Mapped.GetData(), entry.Mapped.GetSize()};
+    return;
+  }
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open file: " + path.string());
+  }
+  // fails for directories, which open fine but report a bogus size
+  std::error_code ec;
+  const auto fileSize = std::filesystem::file_size(path, ec);
+  if (ec) {
+    throw std::runtime_error("Failed to read file: " + path.string());
+  }
+  entry.Buffer.resize(static_cast<size_t>(fileSize));
+  if (!file.read(reinterpret_cast<char *>(entry.Buffer.data()),
+                 static_cast<std::streamsize>(fileSize))) {
+    throw std::runtime_error("Failed to read file: " + path.string());
+  }
+  entry.Source = {entry.Buffer.data(), entry.Buffer.size()};
+}
+
+// Parses the files of a group one after the other, then hashes them
+// together. Load and parse errors are kept in the entries.
+void ParseGroup(Batch &batch, std::optional<Parser> &parser,
+                GroupEntry *group, size_t first, size_t count,
+                std::vector<HashInput> &sources,
+                std::vector<HashOutput> &digests,
+                std::vector<size_t> &hashed) {
+  const auto &options = batch.Options;
+  sources.clear();
+  hashed.clear();
+  for (size_t i = 0; i < count; ++i) {
+    auto &entry = group[i];
+    if (*batch.Cancelled) {
+      continue;
+    }
+    const auto &path = batch.Paths[batch.Order[first + i]];
+    try {
+      if (!parser) {
+        parser.emplace();
+        auto parseOptions = options.Parse;
+        // the digests are computed for the whole group below, and the
+        // bytes are gone by the time anyone could ask for lazy ones
+        parseOptions.ComputeMD5 = false;
+        parseOptions.ComputeSHA256 = false;
+        parseOptions.LazyDigests = false;
+        parser->SetOptions(parseOptions);
+      }
+      Load(path, options.Parse.UseMemoryMap, entry);
+      parser->Parse(entry.Source.Bytes, entry.Source.Size, &entry.Result,
+                    options.AddReadyMeasure, options.MetaOnly,
+                    *batch.Cancelled);
+      entry.Result->Meta.BmsPath = path;
+      entry.Result->Meta.Folder = path.parent_path();
+    } catch (...) {
+      delete entry.Result;
+      entry.Result = nullptr;
+      entry.Error = std::current_exception();
+      continue;
+    }
+    if (options.Parse.ComputeMD5 || options.Parse.ComputeSHA256) {
+      sources.push_back(entry.Source);
+      hashed.push_back(i);
+    }
+  }
+  if (!*batch.Cancelled && !sources.empty()) {
+    digests.assign(sources.size(), HashOutput());
+    HashMany(sources.data(), sources.size(), digests.data(),
+             options.Parse.ComputeMD5, options.Parse.ComputeSHA256);
+    for (size_t h = 0; h < hashed.size(); ++h) {
+      auto &meta = group[hashed[h]].Result->Meta;
+      meta.MD5 = std::move(digests[h].MD5);
+      meta.SHA256 = std::move(digests[h].SHA256);
+    }
+  }
+}
+
+// Takes paths a group at a time until none are left, reusing one parser for
+// all of them.
+void Drain(Batch &batch) {
+  std::optional<Parser> parser;
+  std::vector<HashInput> sources;
+  std::vector<HashOutput> digests;
+  std::vector<size_t> hashed;
+  std::vector<GroupEntry> group(batch.GroupSize);
+  for (auto first = batch.Next.fetch_add(batch.GroupSize);
+       first < batch.Order.size();
+       first = batch.Next.fetch_add(batch.GroupSize)) {
+    const auto count = std::min(batch.GroupSize, batch.Order.size() - first);
+    // entries before this have been handed to the callback
+    size_t handed = 0;
+    // nothing may escape a job, and every path has to be counted as done
+    // whatever happens, or ParseMany would never return
+    try {
+      if (!batch.Stopped) {
+        ParseGroup(batch, parser, group.data(), first, count, sources, digests,
+                   hashed);
+        for (; handed < count; ++handed) {
+          auto &entry = group[handed];
+          // the chart no longer needs the file, the callback may take a while;
+          // the buffer is kept for the next group
+          entry.Mapped.Close();
+          // the callback owns the chart from here, even if it throws
+          const auto result = entry.Result;
+          entry.Result = nullptr;
+          batch.Callback(batch.Order[first + handed], result, entry.Error);
+        }
+      }
+    } catch (...) {
+      batch.Fail(std::current_exception());
+    }
+    // charts of the group the callback never got
+    for (size_t i = 0; i < count; ++i) {
+      delete group[i].Result;
+      group[i].Reset();
+    }
+    batch.Finish(count);
+  }
+}
+} // namespace
+
+void ParseMany(const std::vector<std::filesystem::path> &paths,
+               const BatchOptions &options, const BatchCallback &callback,
+               std::atomic_bool &bCancelled) {
+  if (paths.empty()) {
+    return;
+  }
+  auto batch = std::make_shared<Batch>();
+  batch->Paths = paths;
+  batch->Options = options;
+  batch->Callback = callback;
+  batch->Cancelled = &bCancelled;
+
+  // biggest first, so that no thread picks up a 5 MB chart at the very end
+  std::vector<std::uintmax_t> sizes(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(paths[i], ec);
+    sizes[i] = ec ? 0 : size;
+  }
+  batch->Order.resize(paths.size());
+  std::iota(batch->Order.begin(), batch->Order.end(), size_t{0});
+  std::stable_sort(
+      batch->Order.begin(), batch->Order.end(),
+      [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+  std::unique_ptr<ThreadPool> ownPool;
+  Executor *pool = options.Pool;
+  if (pool == nullptr) {
+    ownPool = std::make_unique<ThreadPool>();
+    pool = ownPool.get();
+  }
+  // the calling thread drains too, so the batch finishes even if the
+  // executor never gets round to the jobs
+  const auto helpers =
+      std::min<size_t>(std::max(1u, pool->Concurrency()), paths.size()) - 1;
+  // groups big enough to fill the hash lanes, but small enough that every
+  // thread still gets several of them
+  batch->GroupSize =
+      std::clamp<size_t>(paths.size() / ((helpers + 1) * 4), 1, HashLanes);
+  try {
+    for (size_t i = 0; i < helpers; ++i) {
+      pool->Submit([batch] { Drain(*batch); });
+    }
+  } catch (...) {
+    // whatever was not submitted is drained here
+  }
+  Drain(*batch);
+
+  // jobs must not outlive bCancelled, so wait even when a callback threw
+  std::unique_lock<std::mutex> lock(batch->DoneMutex);
+  batch->DoneChanged.wait(
+      lock, [&batch] { return batch->Done == batch->Order.size(); });
+  if (batch->Error) {
+    std::rethrow_exception(batch->Error);
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <condition_variable>
+#include <cwctype>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifndef BMS_PARSER_VERBOSE
+#define BMS_PARSER_VERBOSE 0
+#endif
+
+namespace bms_parser {
+namespace {
+// Work handed to an executor that the submitting thread can still take back.
+// Whoever claims it first runs it; once the owner is done with everything
+// else it runs the job itself if no pool thread has, or waits for the one
+// that did. The executor only ever holds the shared state, so it may get
+// round to the job long after the owner has returned.
+class ClaimableJob {
+public:
+  explicit ClaimableJob(std::function<void()> work)
+      : State(std::make_shared<Shared>()) {
+    State->Work = std::move(work);
+  }
+  ClaimableJob(const ClaimableJob &) = delete;
+  ClaimableJob &operator=(const ClaimableJob &) = delete;
+  ~ClaimableJob() { Finish(); }
+
+  void SubmitTo(Executor &executor) {
+    executor.Submit([state = State] { state->TryRun(); });
+  }
+  void Finish() {
+    if (State->TryRun()) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(State->Mutex);
+    State->DoneChanged.wait(lock, [this] { return State->Done; });
+  }
+
+private:
+  struct Shared {
+    std::function<void()> Work;
+    std::atomic_bool Claimed{false};
+    std::mutex Mutex;
+    std::condition_variable DoneChanged;
+    bool Done = false; // guarded by Mutex
+
+    bool TryRun() {
+      if (Claimed.exchange(true)) {
+        return false;
+      }
+      Work();
+      std::lock_guard<std::mutex> lock(Mutex);
+      Done = true;
+      DoneChanged.notify_all();
+      return true;
+    }
+  };
+  std::shared_ptr<Shared> State;
+};
+
+// Lends the source to the chart's digest getters for the duration of Parse,
+// or for good if the caller keeps the bytes alive.
+class DigestSource {
+public:
+  DigestSource(Chart *chart, const unsigned char *bytes, size_t size,
+               bool keep)
+      : Target(chart), Keep(keep) {
+    Target->SetDigestSource(bytes, size);
+  }
+  DigestSource(const DigestSource &) = delete;
+  DigestSource &operator=(const DigestSource &) = delete;
+  ~DigestSource() {
+    if (!Keep) {
+      Target->ClearDigestSource();
+    }
+  }
+
+private:
+  Chart *Target;
+  bool Keep;
+};
+
+Executor &SharedHashPool() {
+  static ThreadPool pool;
+  return pool;
+}
+} // namespace
+
+enum Channel {
+  LaneAutoplay = 1,
+  SectionRate = 2,
+  BpmChange = 3,
+  BgaPlay = 4,
+  PoorPlay = 6,
+  LayerPlay = 7,
+  BpmChangeExtend = 8,
+  Stop = 9,
+
+  P1KeyBase = 1 * 36 + 1,
+  P2KeyBase = 2 * 36 + 1,
+  P1InvisibleKeyBase = 3 * 36 + 1,
+  P2InvisibleKeyBase = 4 * 36 + 1,
+  P1LongKeyBase = 5 * 36 + 1,
+  P2LongKeyBase = 6 * 36 + 1,
+  P1MineKeyBase = 13 * 36 + 1,
+  P2MineKeyBase = 14 * 36 + 1,
+
+  Scroll = 1020
+};
+
+namespace KeyAssign {
+constexpr int Beat7[] = {0, 1, 2,  3,  4,  7,  -1, 5,  6,
+                         8, 9, 10, 11, 12, 15, -1, 13, 14};
+constexpr int PopN[] = {0, 1, 2, 3, 4, -1, -1, -1, -1,
+                        -1, 5, 6, 7, 8, -1, -1, -1, -1};
+} // namespace KeyAssign
+
+enum ChannelFlag : uint8_t {
+  ChannelScratch = 1 << 0,
+  // lanes 6 and 7 of either side: a 5 key chart is really 7 key
+  ChannelSevenKey = 1 << 1,
+  // any 2P lane: the chart is double play
+  ChannelDoublePlay = 1 << 2,
+};
+
+// What a channel id means, so the measure loop needs a single load instead
+// of walking the lane channel ranges.
+struct ChannelInfo {
+  // channel to dispatch on; the 2P, invisible, long and mine lanes fold into
+  // their 1P base channel
+  int16_t Kind;
+  // Beat7 lane, -1 for channels to ignore. Channels that aren't lanes get 0,
+  // like they always have.
+  int8_t Lane;
+  int8_t PopNLane; // -1 unless it's a lane channel PopN uses
+  uint8_t Flags;
+};
+
+// Channel ids are always base 36, even with #BASE 62
+constexpr int ChannelCount = 36 * 36;
+
+constexpr std::array<ChannelInfo, ChannelCount> BuildChannelTable() {
+  std::array<ChannelInfo, ChannelCount> table{};
+  for (int channel = 0; channel < ChannelCount; ++channel) {
+    table[channel] = {static_cast<int16_t>(channel), 0, -1, 0};
+  }
+  constexpr int laneChannels[][2] = {
+      {P1KeyBase, P2KeyBase},
+      {P1InvisibleKeyBase, P2InvisibleKeyBase},
+      {P1LongKeyBase, P2LongKeyBase},
+      {P1MineKeyBase, P2MineKeyBase},
+  };
+  for (const auto &bases : laneChannels) {
+    for (int side = 0; side < 2; ++side) {
+      for (int key = 0; key < 9; ++key) {
+        const int index = side * 9 + key;
+        const int lane = KeyAssign::Beat7[index];
+        uint8_t flags = 0;
+        if (lane == 7 || lane == 15) {
+          flags |= ChannelScratch;
+        }
+        if (lane == 5 || lane == 6 || lane == 13 || lane == 14) {
+          flags |= ChannelSevenKey;
+        }
+        if (lane >= 8) {
+          flags |= ChannelDoublePlay;
+        }
+        table[bases[side] + key] = {static_cast<int16_t>(bases[0]),
+                                    static_cast<int8_t>(lane),
+                                    static_cast<int8_t>(KeyAssign::PopN[index]),
+                                    flags};
+      }
+    }
+  }
+  return table;
+}
+
+constexpr auto ChannelTable = BuildChannelTable();
+
+inline const ChannelInfo &GetChannelInfo(int channel) {
+  // what a stray sign or space in the id parses to; matches no channel
+  static constexpr ChannelInfo unknown = {-1, 0, -1, 0};
+  return channel >= 0 && channel < ChannelCount ? ChannelTable[channel]
+                                                : unknown;
+}
+
+constexpr int TempKey = 16;
+
+// one channel line: measure number, channel id and the raw data after ':'
+struct ChannelRecord {
+  int Measure;
+  int Channel;
+  std::string_view Data;
+};
+
+// a non-"00" pair whose timeline is only known once the measure is sorted
+struct PairEvent {
+  uint32_t Record; // index into the channel records
+  uint32_t Pair;   // index of the pair in the record's data
+  int Id;
+  uint32_t Timeline;
+};
+
+constexpr uint32_t NoPairEvent = UINT32_MAX;
+
+// the position Pair / Pairs of a pair within its measure, kept as a fraction
+struct PairPosition {
+  uint32_t Pair;
+  uint32_t Pairs;
+  uint32_t Event; // PairEvent to point at the timeline, or NoPairEvent
+
+  bool Before(const PairPosition &other) const {
+    return static_cast<uint64_t>(Pair) * other.Pairs <
+           static_cast<uint64_t>(other.Pair) * Pairs;
+  }
+};
+
+// the channels whose events depend on the previous measures' long notes
+inline bool IsLaneChannel(int kind) {
+  return kind == P1KeyBase || kind == P1InvisibleKeyBase ||
+         kind == P1LongKeyBase || kind == P1MineKeyBase;
+}
+
+// a measure whose timelines are built but whose lane events are not applied
+// yet
+struct MeasureBuild {
+  Measure *Target = nullptr;
+  // position within the measure and timeline, in position order
+  std::vector<std::pair<double, TimeLine *>> TimeLines;
+  // in file order
+  std::vector<PairEvent> LaneEvents;
+  // ChannelSevenKey and ChannelDoublePlay of the measure's lane channels
+  uint8_t ChannelFlags = 0;
+};
+
+// buffers reused from one measure to the next, one set per thread
+struct MeasureScratch {
+  std::vector<PairPosition> Positions;
+  std::vector<PairEvent> Events;
+  std::vector<int> PairIds;
+  std::vector<uint64_t> NonZeroPairs;
+};
+
+// Upgrades the key mode for lanes 6/7 and the 2P side. Both upgrades give
+// the same result in either order, so a measure's flags can be applied in
+// one go.
+void ApplyKeyModeFlags(ChartMeta &meta, uint8_t flags) {
+  if ((flags & ChannelSevenKey) != 0) {
+    if (meta.KeyMode == 5) {
+      meta.KeyMode = 7;
+    } else if (meta.KeyMode == 10) {
+      meta.KeyMode = 14;
+    }
+  }
+  if ((flags & ChannelDoublePlay) != 0) {
+    if (meta.KeyMode == 7) {
+      meta.KeyMode = 14;
+    } else if (meta.KeyMode == 5) {
+      meta.KeyMode = 10;
+    }
+    meta.IsDP = true;
+  }
+}
+
+// below this many measures per thread the threads cost more than they save
+constexpr size_t MinMeasuresPerWorker = 16;
+
+unsigned int MeasureWorkerCount(unsigned int requested, size_t measureCount,
+                                bool metaOnly) {
+  if (metaOnly) {
+    return 1;
+  }
+  if (requested == 0) {
+    requested = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const auto useful = measureCount / MinMeasuresPerWorker;
+  return static_cast<unsigned int>(
+      std::max<size_t>(1, std::min<size_t>(requested, useful)));
+}
+
+Parser::Parser() : BpmTable{}, StopLengthTable{}, ScrollTable{} {
+  std::random_device seeder;
+  Seed = seeder();
+}
+
+void Parser::SetRandomSeed(unsigned int RandomSeed) { Seed = RandomSeed; }
+
+void Parser::ResetState() {
+  BpmTable.clear();
+  StopLengthTable.clear();
+  ScrollTable.clear();
+  UseBase62 = false;
+  Lnobj = -1;
+  Lntype = 1;
+}
+
+int Parser::NoWav = -1;
+int Parser::MetronomeWav = -2;
+
+void Parser::SetOptions(const ParseOptions &Options) {
+  this->Options = Options;
+}
+
+void Parser::Parse(const std::filesystem::path &fpath, Chart **chart,
+                   bool addReadyMeasure, bool metaOnly,
+                   std::atomic_bool &bCancelled) {
+#if BMS_PARSER_VERBOSE == 1
+  auto startTime = std::chrono::high_resolution_clock::now();
+#endif
+  // the mapping (or the buffer) is released as soon as the chart is built
+  MappedFile mapped;
+  std::vector<unsigned char> bytes;
+  const unsigned char *data = nullptr;
+  size_t size = 0;
+#if BMS_PARSER_VERBOSE == 1
+  // measure file read time
+  auto midStartTime = std::chrono::high_resolution_clock::now();
+#endif
+  // the read path hashes each block as it comes in, while it is in cache
+  const bool hashWhileReading = Options.ComputeMD5 || Options.ComputeSHA256;
+  DigestStream digests(Options.ComputeMD5, Options.ComputeSHA256);
+  bool hashed = false;
+  if (Options.UseMemoryMap && mapped.Open(fpath)) {
+    data = mapped.GetData();
+    size = mapped.GetSize();
+  } else {
+    std::ifstream file(fpath, std::ios::binary);
+    if (!file.is_open()) {
+      std::cout << "Failed to open file: " << fpath << std::endl;
+      return;
+    }
+    file.seekg(0, std::ios::end);
+    auto fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    bytes.resize(static_cast<size_t>(fileSize));
+    for (size_t offset = 0; offset < bytes.size();) {
+      const auto length = std::min(DigestStream::BlockSize,
+                                   bytes.size() - offset);
+      file.read(reinterpret_cast<char *>(bytes.data() + offset),
+                static_cast<std::streamsize>(length));
+      const auto got = static_cast<size_t>(file.gcount());
+      if (hashWhileReading) {
+        digests.Update(bytes.data() + offset, got);
+      }
+      offset += got;
+      if (got < length) {
+        bytes.resize(offset); // the file shrank under us
+        break;
+      }
+    }
+    file.close();
+    data = bytes.data();
+    size = bytes.size();
+    hashed = hashWhileReading;
+  }
+#if BMS_PARSER_VERBOSE == 1
+  std::cout << "File read took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::high_resolution_clock::now() - midStartTime)
+                   .count()
+            << "\n";
+#endif
+  ParseBytes(data, size, chart, addReadyMeasure, metaOnly, bCancelled,
+             !hashed);
+  auto new_chart = *chart;
+  if (new_chart != nullptr) {
+    if (hashed && !bCancelled) {
+      digests.Finish(new_chart->Meta.MD5, new_chart->Meta.SHA256);
+    }
+    // the file is closed on return, whatever Options.LazyDigests says
+    new_chart->ClearDigestSource();
+    new_chart->Meta.BmsPath = fpath;
+
+    new_chart->Meta.Folder = fpath.parent_path();
+  }
+#if BMS_PARSER_VERBOSE == 1
+  auto endTime = std::chrono::high_resolution_clock::now();
+  std::cout << "Total parsing+reading took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(endTime -
+                                                                     startTime)
+                   .count()
+            << "\n";
+#endif
+}
+
+void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
+                   bool addReadyMeasure, bool metaOnly,
+                   std::atomic_bool &bCancelled) {
+  Parse(bytes.data(), bytes.size(), chart, addReadyMeasure, metaOnly,
+        bCancelled);
+}
+
+void Parser::Parse(const unsigned char *bytes, size_t size, Chart **chart,
+                   bool addReadyMeasure, bool metaOnly,
+                   std::atomic_bool &bCancelled) {
+  ParseBytes(bytes, size, chart, addReadyMeasure, metaOnly, bCancelled, true);
+}
+
+void Parser::ParseBytes(const unsigned char *bytes, size_t size,
+                        Chart **chart, bool addReadyMeasure, bool metaOnly,
+                        std::atomic_bool &bCancelled, bool hashSource) {
+#if BMS_PARSER_VERBOSE == 1
+  auto startTime = std::chrono::high_resolution_clock::now();
+#endif
+  auto new_chart = new Chart();
+  *chart = new_chart;
+  ResetState();
+
+  if (bCancelled) {
+    return;
+  }
+
+  // channel data points into content, which outlives the measure loop
+  std::vector<ChannelRecord> records;
+
+  // hash while parsing; the jobs are done or skipped before Parse returns
+  DigestSource digestSource(new_chart, bytes, size, Options.LazyDigests);
+  const bool wantMD5 = hashSource && Options.ComputeMD5;
+  const bool wantSHA256 = hashSource && Options.ComputeSHA256;
+  ClaimableJob hashJob(
+      [bytes, size, new_chart, wantMD5, wantSHA256, &bCancelled] {
+        if (!(wantMD5 || wantSHA256) || bCancelled) {
+          return;
+        }
+#if BMS_PARSER_VERBOSE == 1
+        auto startTime = std::chrono::high_resolution_clock::now();
+#endif
+        // one pass for both, rather than each reading the whole source
+        DigestStream digests(wantMD5, wantSHA256);
+        digests.Update(bytes, size);
+        digests.Finish(new_chart->Meta.MD5, new_chart->Meta.SHA256);
+#if BMS_PARSER_VERBOSE == 1
+        std::cout << "Hashing took "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::high_resolution_clock::now() -
+                         startTime)
+                         .count()
+                  << "\n";
+#endif
+      });
+  if ((wantMD5 || wantSHA256) && size >= Options.InlineHashBelow) {
+    hashJob.SubmitTo(Options.HashPool != nullptr ? *Options.HashPool
+                                                 : SharedHashPool());
+  }
+  // runs at memory speed, not worth a job
+  if (Options.ComputeContentHash) {
+    new_chart->GetContentHash();
+  }
+
+  // std::cout<<"file size: "<<size<<std::endl;
+  // bytes to std::string
+#if BMS_PARSER_VERBOSE == 1
+  auto midStartTime = std::chrono::high_resolution_clock::now();
+#endif
+  size_t bomLength = 0;
+  SourceEncoding = TextEncodings::Detect(bytes, size, bomLength);
+  new_chart->Meta.Encoding = SourceEncoding;
+  const auto text = bytes + bomLength;
+  const auto textSize = size - bomLength;
+  std::string decoded;
+  std::string_view content;
+  if (SourceEncoding == TextEncoding::UTF8 || Options.LazyDecode) {
+    // UTF-8 is used as-is; otherwise free-text values are converted one by
+    // one in ParseHeader
+    content = std::string_view(reinterpret_cast<const char *>(text), textSize);
+    DecodeValues = SourceEncoding != TextEncoding::UTF8;
+  } else {
+    TextEncodings::ToUTF8(SourceEncoding, text, textSize, decoded);
+    content = decoded;
+    DecodeValues = false;
+  }
+#if BMS_PARSER_VERBOSE == 1
+  std::cout << "Encoding detection and conversion took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::high_resolution_clock::now() - midStartTime)
+                   .count()
+            << "\n";
+#endif
+  // std::wcout<<content<<std::endl;
+  std::vector<int> RandomStack;
+  std::vector<bool> SkipStack;
+  // init prng with seed
+  std::mt19937_64 Prng(Seed);
+
+  LineScanner lines(content);
+  std::string_view line;
+#if BMS_PARSER_VERBOSE == 1
+  midStartTime = std::chrono::high_resolution_clock::now();
+#endif
+  auto lastMeasure = -1;
+  while (lines.Next(line)) {
+    if (bCancelled) {
+      return;
+    }
+    // std::cout << line << std::endl;
+    if (line.size() <= 1 || line[0] != L'#')
+      continue;
+    if (bCancelled) {
+      return;
+    }
+
+    const auto keyword = HeaderKeywords::Match(line.substr(1));
+    if (keyword == HeaderKeyword::If) // #IF n
+    {
+      if (RandomStack.empty()) {
+        // UE_LOG(LogTemp, Warning, TEXT("RandomStack is empty!"));
+        continue;
+      }
+      const int CurrentRandom = RandomStack.back();
+      const int n = static_cast<int>(ParseLong(Tail(line, 4), 10));
+      SkipStack.push_back(CurrentRandom != n);
+      continue;
+    }
+    if (keyword == HeaderKeyword::Else) { // #ELSEIF ends up here as well
+      if (SkipStack.empty()) {
+        // UE_LOG(LogTemp, Warning, TEXT("SkipStack is empty!"));
+        continue;
+      }
+      const bool CurrentSkip = SkipStack.back();
+      SkipStack.pop_back();
+      SkipStack.push_back(!CurrentSkip);
+      continue;
+    }
+    if (keyword == HeaderKeyword::EndIf) {
+      if (SkipStack.empty()) {
+        // UE_LOG(LogTemp, Warning, TEXT("SkipStack is empty!"));
+        continue;
+      }
+      SkipStack.pop_back();
+      continue;
+    }
+    if (!SkipStack.empty() && SkipStack.back()) {
+      continue;
+    }
+    if (keyword == HeaderKeyword::Random) // #RANDOM n
+    {
+      new_chart->Meta.HasRandom = true;
+      const int n = static_cast<int>(ParseLong(Tail(line, 7), 10));
+      std::uniform_int_distribution<int> dist(1, n);
+      RandomStack.push_back(dist(Prng));
+      continue;
+    }
+    if (keyword == HeaderKeyword::EndRandom) {
+      if (RandomStack.empty()) {
+        // UE_LOG(LogTemp, Warning, TEXT("RandomStack is empty!"));
+        continue;
+      }
+      RandomStack.pop_back();
+      continue;
+    }
+
+    if (line.length() >= 7 &&
+        std::isdigit(static_cast<unsigned char>(line[1])) &&
+        std::isdigit(static_cast<unsigned char>(line[2])) &&
+        std::isdigit(static_cast<unsigned char>(line[3])) &&
+        line[6] == ':') {
+      const int measure = static_cast<int>(ParseLong(line.substr(1, 3), 10));
+      lastMeasure = std::max(lastMeasure, measure);
+      const auto ch = line.substr(4, 2);
+      const int channel = ParseInt(ch, true);
+      const auto value = line.substr(7);
+      records.push_back({measure, channel, value});
+    } else {
+      if (keyword == HeaderKeyword::Wav) {
+        if (metaOnly) {
+          continue;
+        }
+        if (line.length() < 7) {
+          continue;
+        }
+        const auto xx = line.substr(4, 2);
+        const auto value = line.substr(7);
+        ParseHeader(new_chart, HeaderKeyword::Wav, "WAV", xx, value);
+      } else if (keyword == HeaderKeyword::Bmp) {
+        if (metaOnly) {
+          continue;
+        }
+        if (line.length() < 7) {
+          continue;
+        }
+        const auto xx = line.substr(4, 2);
+        const auto value = line.substr(7);
+        ParseHeader(new_chart, HeaderKeyword::Bmp, "BMP", xx, value);
+      } else if (keyword == HeaderKeyword::Stop) {
+        if (line.length() < 8) {
+          continue;
+        }
+        const auto xx = line.substr(5, 2);
+        const auto value = line.substr(8);
+        ParseHeader(new_chart, HeaderKeyword::Stop, "STOP", xx, value);
+      } else if (keyword == HeaderKeyword::Bpm) {
+        if (line.length() > 4 && line[4] == ' ') {
+          const auto value = line.substr(5);
+          ParseHeader(new_chart, HeaderKeyword::Bpm, "BPM", "", value);
+        } else {
+          if (line.length() < 7) {
+            continue;
+          }
+          const auto xx = line.substr(4, 2);
+          const auto value = line.substr(7);
+          ParseHeader(new_chart, HeaderKeyword::Bpm, "BPM", xx, value);
+        }
+      } else if (keyword == HeaderKeyword::Scroll) {
+        if (line.length() < 10) {
+          continue;
+        }
+        const auto xx = line.substr(7, 2);
+        const auto value = line.substr(10);
+        ParseHeader(new_chart, HeaderKeyword::Scroll, "SCROLL", xx, value);
+      } else {
+        std::string_view cmd, xx, value;
+        if (SplitHeader(line, cmd, xx, value)) {
+          if (value.empty()) {
+            value = xx;
+            xx = std::string_view();
+          }
+          ParseHeader(new_chart, keyword, cmd, xx, value);
+        }
+      }
+    }
+  }
+#if BMS_PARSER_VERBOSE == 1
+  std::cout << "Parsing headers took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::high_resolution_clock::now() - midStartTime)
+                   .count()
+            << "\n";
+#endif
+  if (bCancelled) {
+    return;
+  }
+  if (addReadyMeasure) {
+    records.erase(std::remove_if(records.begin(), records.end(),
+                                 [](const ChannelRecord &record) {
+                                   return record.Measure == 0;
+                                 }),
+                  records.end());
+    records.push_back({0, LaneAutoplay, "********"});
+  }
+
+  // bucket the records by measure (a counting sort, so file order is kept
+  // within a measure); measure m owns [measureStart[m], measureStart[m + 1])
+  const auto measureCount = static_cast<size_t>(lastMeasure + 1);
+  std::vector<size_t> measureStart(measureCount + 1, 0);
+  for (const auto &record : records) {
+    if (static_cast<size_t>(record.Measure) < measureCount) {
+      ++measureStart[record.Measure + 1];
+    }
+  }
+  for (size_t i = 0; i < measureCount; ++i) {
+    measureStart[i + 1] += measureStart[i];
+  }
+  std::vector<ChannelRecord> channels(measureStart[measureCount]);
+  {
+    auto next = measureStart;
+    for (const auto &record : records) {
+      if (static_cast<size_t>(record.Measure) < measureCount) {
+        channels[next[record.Measure]++] = record;
+      }
+    }
+  }
+
+  double timePassed = 0;
+  int totalNotes = 0;
+  int totalLongNotes = 0;
+  int totalScratchNotes = 0;
+  int totalBackSpinNotes = 0;
+  int totalLandmineNotes = 0;
+  auto currentBpm = new_chart->Meta.Bpm;
+  auto minBpm = new_chart->Meta.Bpm;
+  auto maxBpm = new_chart->Meta.Bpm;
+  auto lastNote = std::vector<Note *>();
+  lastNote.resize(TempKey, nullptr);
+  auto lnStart = std::vector<LongNote *>();
+  lnStart.resize(TempKey, nullptr);
+#if BMS_PARSER_VERBOSE == 1
+  midStartTime = std::chrono::high_resolution_clock::now();
+#endif
+  double measureBeatPosition = 0;
+  // a metaOnly parse keeps none of its measures, so they go in an arena that
+  // dies with this call instead of bloating the chart
+  ChartArena scratchArena;
+  auto &arena = metaOnly ? scratchArena : new_chart->Arena;
+
+  // Two passes per measure. The first decodes every channel and collects
+  // the position of each pair as an exact fraction; sorting those gives the
+  // measure's timelines in order, with no rounding to split or merge them.
+  // The second pass then applies the pairs in file order, which long note
+  // and LNOBJ pairing depend on. Only the lane events depend on earlier
+  // measures, so they are left in build.LaneEvents for settleMeasure and
+  // everything else is applied here. Reads nothing but the channel records
+  // and the finished header tables, so measures can be built concurrently.
+  const auto buildMeasure = [&](size_t measureIdx, MeasureBuild &build,
+                                MeasureScratch &scratch,
+                                ChartArena &measureArena) {
+    auto &positions = scratch.Positions;
+    auto &pairEvents = scratch.Events;
+    positions.clear();
+    pairEvents.clear();
+    build.TimeLines.clear();
+    build.LaneEvents.clear();
+    build.ChannelFlags = 0;
+    auto measure = measureArena.New<Measure>();
+    build.Target = measure;
+
+    for (auto r = measureStart[measureIdx]; r < measureStart[measureIdx + 1];
+         ++r) {
+      if (bCancelled) {
+        break;
+      }
+      auto channel = channels[r].Channel;
+      const auto data = channels[r].Data;
+      if (channel == SectionRate) {
+        measure->Scale = ParseDouble(data);
+        continue;
+      }
+
+      const auto &info = GetChannelInfo(channel);
+      if (info.Lane == -1) {
+        continue;
+      }
+      channel = info.Kind;
+      build.ChannelFlags |= info.Flags & (ChannelSevenKey | ChannelDoublePlay);
+
+      // mines are always base 36, see ParseInt
+      auto base = UseBase62 ? PairBase::Base62 : PairBase::Base36;
+      if (channel == BpmChange) {
+        base = PairBase::Hex;
+      } else if (channel == P1MineKeyBase) {
+        base = PairBase::Base36;
+      }
+      const auto dataCount = ChannelData::Decode(data, base, scratch.PairIds,
+                                                 scratch.NonZeroPairs);
+      const auto &nonZeroPairs = scratch.NonZeroPairs;
+      const auto pairs = static_cast<uint32_t>(dataCount);
+      if (dataCount != 0 && (nonZeroPairs[0] & 1) == 0 && positions.empty()) {
+        positions.push_back({0, 1, NoPairEvent}); // add ghost timeline
+      }
+      // "00" pairs are skipped entirely
+      for (auto j = ChannelData::NextNonZero(nonZeroPairs, 0, dataCount);
+           j < dataCount;
+           j = ChannelData::NextNonZero(nonZeroPairs, j + 1, dataCount)) {
+        if (bCancelled) {
+          break;
+        }
+        const auto pair = static_cast<uint32_t>(j);
+        if (channel == LaneAutoplay || channel == P1InvisibleKeyBase) {
+          if (metaOnly) {
+            // the timeline still counts for timing
+            positions.push_back({pair, pairs, NoPairEvent});
+            break;
+          }
+        }
+        auto id = scratch.PairIds[j];
+        if (id == ChannelData::Undecoded) {
+          const auto val = data.substr(j * 2, 2);
+          id = base == PairBase::Hex ? ParseHex(val)
+                                     : ParseInt(val, base == PairBase::Base36);
+        }
+        positions.push_back(
+            {pair, pairs, static_cast<uint32_t>(pairEvents.size())});
+        pairEvents.push_back({static_cast<uint32_t>(r), pair, id, 0});
+      }
+    }
+
+    std::sort(positions.begin(), positions.end(),
+              [](const PairPosition &a, const PairPosition &b) {
+                return a.Before(b);
+              });
+    auto &timelines = build.TimeLines;
+    for (size_t i = 0; i < positions.size(); ++i) {
+      const auto &position = positions[i];
+      if (i == 0 || positions[i - 1].Before(position)) {
+        timelines.emplace_back(static_cast<double>(position.Pair) /
+                                   static_cast<double>(position.Pairs),
+                               measureArena.New<TimeLine>(TempKey, metaOnly));
+      }
+      if (position.Event != NoPairEvent) {
+        pairEvents[position.Event].Timeline =
+            static_cast<uint32_t>(timelines.size() - 1);
+      }
+    }
+
+    for (const auto &event : pairEvents) {
+      if (bCancelled) {
+        break;
+      }
+      const auto &record = channels[event.Record];
+      const int channel = GetChannelInfo(record.Channel).Kind;
+      if (IsLaneChannel(channel)) {
+        build.LaneEvents.push_back(event);
+        continue;
+      }
+      const auto id = event.Id;
+      auto timeline = timelines[event.Timeline].second;
+      switch (channel) {
+      case LaneAutoplay:
+        if (record.Data.substr(event.Pair * 2, 2) == "**") {
+          timeline->AddBackgroundNote(measureArena.New<Note>(MetronomeWav));
+          break;
+        }
+        if (id != 0) {
+          auto bgNote =
+              measureArena.New<Note>(ToWaveId(new_chart, id, metaOnly));
+          timeline->AddBackgroundNote(bgNote);
+        }
+
+        break;
+      case BpmChange: {
+        timeline->Bpm = static_cast<double>(id);
+        // std::cout << "BPM_CHANGE: " << timeline->Bpm << ", on measure " <<
+        // measureIdx << std::endl; Debug.Log($"BPM_CHANGE: {timeline.Bpm}, on
+        // measure {measureIdx}");
+        timeline->BpmChange = true;
+        break;
+      }
+      case BgaPlay:
+        timeline->BgaBase = id;
+        break;
+      case PoorPlay:
+        timeline->BgaPoor = id;
+        break;
+      case LayerPlay:
+        timeline->BgaLayer = id;
+        break;
+      case BpmChangeExtend: {
+        // std::cout << "BPM_CHANGE_EXTEND: " << id << ", on measure " <<
+        // measureIdx << std::endl;
+        if (!CheckResourceIdRange(id)) {
+          // UE_LOG(LogTemp, Warning, TEXT("Invalid BPM id: %s"), *val);
+          break;
+        }
+        const auto bpm = BpmTable.find(id);
+        if (bpm != BpmTable.end()) {
+          timeline->Bpm = bpm->second;
+        } else {
+          timeline->Bpm = 0;
+          // std::cout<<"Undefined BPM: "<<id<<std::endl;
+        }
+        // Debug.Log($"BPM_CHANGE_EXTEND: {timeline.Bpm}, on measure
+        // {measureIdx}, {val}");
+        timeline->BpmChange = true;
+        break;
+      }
+      case Scroll: {
+        if (!CheckResourceIdRange(id)) {
+          // UE_LOG(LogTemp, Warning, TEXT("Invalid Scroll id: %s"), *val);
+          break;
+        }
+        const auto scroll = ScrollTable.find(id);
+        if (scroll != ScrollTable.end()) {
+          timeline->Scroll = scroll->second;
+        } else {
+          timeline->Scroll = 1;
+        }
+        // Debug.Log($"SCROLL: {timeline.Scroll}, on measure {measureIdx}");
+        break;
+      }
+      case Stop: {
+        if (!CheckResourceIdRange(id)) {
+          // UE_LOG(LogTemp, Warning, TEXT("Invalid StopLength id: %s"),
+          // *val);
+          break;
+        }
+        const auto stop = StopLengthTable.find(id);
+        if (stop != StopLengthTable.end()) {
+          timeline->StopLength = stop->second;
+        } else {
+          timeline->StopLength = 0;
+        }
+        // Debug.Log($"STOP: {timeline.StopLength}, on measure {measureIdx}");
+        break;
+      }
+      default:
+        break;
+      }
+    }
+  };
+
+  // Everything that carries over from one measure to the next: key mode,
+  // open long notes, note counts and the running time. Has to see the
+  // measures in order.
+  const auto settleMeasure = [&](MeasureBuild &build) {
+    auto measure = build.Target;
+    auto &timelines = build.TimeLines;
+    ApplyKeyModeFlags(new_chart->Meta, build.ChannelFlags);
+
+    for (const auto &event : build.LaneEvents) {
+      if (bCancelled) {
+        break;
+      }
+      const auto &record = channels[event.Record];
+      const auto &info = GetChannelInfo(record.Channel);
+      const int channel = info.Kind;
+      const int laneNumber = info.Lane;
+      const bool isScratch = (info.Flags & ChannelScratch) != 0;
+      const auto id = event.Id;
+      auto timeline = timelines[event.Timeline].second;
+      switch (channel) {
+      case P1KeyBase: {
+        if (id == Lnobj && lastNote[laneNumber] != nullptr) {
+          if (isScratch) {
+            ++totalBackSpinNotes;
+          } else {
+            ++totalLongNotes;
+          }
+
+          auto last = lastNote[laneNumber];
+          lastNote[laneNumber] = nullptr;
+          if (metaOnly) {
+            break;
+          }
+
+          auto lastTimeline = last->Timeline;
+          auto ln = arena.New<LongNote>(last->Wav);
+          ln->Tail = arena.New<LongNote>(NoWav);
+          ln->Tail->Head = ln;
+          lastTimeline->SetNote(laneNumber, ln);
+          timeline->SetNote(laneNumber, ln->Tail);
+        } else {
+          auto note = arena.New<Note>(ToWaveId(new_chart, id, metaOnly));
+          lastNote[laneNumber] = note;
+          ++totalNotes;
+          if (isScratch) {
+            ++totalScratchNotes;
+          }
+          if (metaOnly) {
+            break;
+          }
+          timeline->SetNote(laneNumber, note);
+        }
+      } break;
+      case P1InvisibleKeyBase: {
+        auto invNote = arena.New<Note>(ToWaveId(new_chart, id, metaOnly));
+        timeline->SetInvisibleNote(laneNumber, invNote);
+        break;
+      }
+
+      case P1LongKeyBase:
+        if (Lntype == 1) {
+          if (lnStart[laneNumber] == nullptr) {
+            ++totalNotes;
+            if (isScratch) {
+              ++totalBackSpinNotes;
+            } else {
+              ++totalLongNotes;
+            }
+
+            auto ln = arena.New<LongNote>(ToWaveId(new_chart, id, metaOnly));
+            lnStart[laneNumber] = ln;
+
+            if (metaOnly) {
+              break;
+            }
+
+            timeline->SetNote(laneNumber, ln);
+          } else {
+            if (!metaOnly) {
+              auto tail = arena.New<LongNote>(NoWav);
+              tail->Head = lnStart[laneNumber];
+              lnStart[laneNumber]->Tail = tail;
+              timeline->SetNote(laneNumber, tail);
+            }
+            lnStart[laneNumber] = nullptr;
+          }
+        }
+
+        break;
+      case P1MineKeyBase: {
+        // landmine
+        ++totalLandmineNotes;
+        if (metaOnly) {
+          break;
+        }
+        const auto damage = static_cast<float>(id) / 2.0f;
+        timeline->SetNote(laneNumber, arena.New<LandmineNote>(damage));
+        break;
+      }
+      default:
+        break;
+      }
+    }
+
+    new_chart->Meta.TotalNotes = totalNotes;
+    new_chart->Meta.TotalLongNotes = totalLongNotes;
+    new_chart->Meta.TotalScratchNotes = totalScratchNotes;
+    new_chart->Meta.TotalBackSpinNotes = totalBackSpinNotes;
+    new_chart->Meta.TotalLandmineNotes = totalLandmineNotes;
+
+    auto lastPosition = 0.0;
+
+    measure->Timing = static_cast<long long>(timePassed);
+
+    for (auto &pair : timelines) {
+      if (bCancelled) {
+        break;
+      }
+      const auto position = pair.first;
+      const auto timeline = pair.second;
+
+      // Debug.Log($"measure: {measureIdx}, position: {position}, lastPosition:
+      // {lastPosition} bpm: {bpm} scale: {measure.scale} interval: {240 * 1000
+      // * 1000 * (position - lastPosition) * measure.scale / bpm}");
+      const auto interval =
+          240000000.0 * (position - lastPosition) * measure->Scale / currentBpm;
+      timePassed += interval;
+      timeline->Timing = static_cast<long long>(timePassed);
+      timeline->BeatPosition = measureBeatPosition + position * measure->Scale;
+      if (timeline->BpmChange) {
+        currentBpm = timeline->Bpm;
+        minBpm = std::min(minBpm, timeline->Bpm);
+        maxBpm = std::max(maxBpm, timeline->Bpm);
+      } else {
+        timeline->Bpm = currentBpm;
+      }
+
+      // Debug.Log($"measure: {measureIdx}, position: {position}, lastPosition:
+      // {lastPosition}, bpm: {currentBpm} scale: {measure.Scale} interval:
+      // {interval} stop: {timeline.GetStopDuration()}");
+
+      timePassed += timeline->GetStopDuration();
+      if (!metaOnly) {
+        measure->TimeLines.push_back(timeline);
+      }
+
+      lastPosition = position;
+    }
+
+    if (metaOnly) {
+      for (auto &timeline : timelines) {
+        timeline.second->~TimeLine();
+      }
+      timelines.clear();
+    } else {
+      // a cancel stops the loop early, and the measure only owns the
+      // timelines it got
+      for (auto i = measure->TimeLines.size(); i < timelines.size(); ++i) {
+        timelines[i].second->~TimeLine();
+      }
+    }
+
+    if (!metaOnly && measure->TimeLines.empty()) {
+      auto timeline = arena.New<TimeLine>(TempKey, metaOnly);
+      timeline->Timing = static_cast<long long>(timePassed);
+      timeline->BeatPosition = measureBeatPosition;
+      timeline->Bpm = currentBpm;
+      measure->TimeLines.push_back(timeline);
+    }
+    if (!metaOnly) {
+      measure->TimeLines[0]->IsFirstInMeasure = true;
+    }
+    new_chart->Meta.PlayLength = static_cast<long long>(timePassed);
+    timePassed +=
+        240000000.0 * (1 - lastPosition) * measure->Scale / currentBpm;
+    measureBeatPosition += measure->Scale;
+    if (!metaOnly) {
+      new_chart->Measures.push_back(measure);
+    } else {
+      measure->~Measure();
+    }
+  };
+
+  const auto workers = MeasureWorkerCount(Options.MeasureThreads,
+                                          measureCount, metaOnly);
+  if (workers > 1) {
+    // Build every measure on the workers first, each into its own arena,
+    // then settle them in order here. The output is the same as building
+    // and settling one measure at a time.
+    std::vector<MeasureBuild> builds(measureCount);
+    std::unique_ptr<ChartArena[]> workerArenas(new ChartArena[workers]);
+    std::atomic<size_t> nextMeasure{0};
+    const auto work = [&](unsigned int worker) {
+      MeasureScratch scratch;
+      for (auto measureIdx = nextMeasure++;
+           measureIdx < measureCount && !bCancelled;
+           measureIdx = nextMeasure++) {
+        buildMeasure(measureIdx, builds[measureIdx], scratch,
+                     workerArenas[worker]);
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned int worker = 1; worker < workers; ++worker) {
+      threads.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (unsigned int worker = 0; worker < workers; ++worker) {
+      new_chart->Arena.Adopt(workerArenas[worker]);
+    }
+    for (size_t measureIdx = 0; measureIdx < measureCount; ++measureIdx) {
+      if (bCancelled) {
+        // the chart owns only the settled measures; a worker may have
+        // stopped before building the rest
+        for (auto k = measureIdx; k < measureCount; ++k) {
+          auto &build = builds[k];
+          if (build.Target == nullptr) {
+            continue;
+          }
+          for (auto &pair : build.TimeLines) {
+            pair.second->~TimeLine();
+          }
+          build.Target->~Measure();
+        }
+        return;
+      }
+      settleMeasure(builds[measureIdx]);
+    }
+  } else {
+    MeasureScratch scratch;
+    MeasureBuild build;
+    for (size_t measureIdx = 0; measureIdx < measureCount; ++measureIdx) {
+      if (bCancelled) {
+        return;
+      }
+      buildMeasure(measureIdx, build, scratch, arena);
+      settleMeasure(build);
+    }
+  }
+  if (!metaOnly) {
+    new_chart->BuildNoteRecords();
+    if (Options.BuildView) {
+      new_chart->View = std::make_unique<ChartView>(*new_chart);
+    }
+  }
+#if BMS_PARSER_VERBOSE == 1
+  std::cout << "Reading data field took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::high_resolution_clock::now() - midStartTime)
+                   .count()
+            << "\n";
+#endif
+  new_chart->Meta.TotalLength = static_cast<long long>(timePassed);
+  new_chart->Meta.MinBpm = minBpm;
+  new_chart->Meta.MaxBpm = maxBpm;
+  if (new_chart->Meta.Difficulty == 0) {
+    std::string FullTitle;
+    FullTitle.reserve(new_chart->Meta.Title.length() +
+                      new_chart->Meta.SubTitle.length());
+    std::transform(new_chart->Meta.Title.begin(), new_chart->Meta.Title.end(),
+                   std::back_inserter(FullTitle), ::towlower);
+    std::transform(new_chart->Meta.SubTitle.begin(),
+                   new_chart->Meta.SubTitle.end(),
+                   std::back_inserter(FullTitle), ::towlower);
+    if (FullTitle.find("easy") != std::string::npos) {
+      new_chart->Meta.Difficulty = 1;
+    } else if (FullTitle.find("normal") != std::string::npos) {
+      new_chart->Meta.Difficulty = 2;
+    } else if (FullTitle.find("hyper") != std::string::npos) {
+      new_chart->Meta.Difficulty = 3;
+    } else if (FullTitle.find("another") != std::string::npos) {
+      new_chart->Meta.Difficulty = 4;
+    } else if (FullTitle.find("insane") != std::string::npos) {
+      new_chart->Meta.Difficulty = 5;
+    } else {
+      if (totalNotes < 250) {
+        new_chart->Meta.Difficulty = 1;
+      } else if (totalNotes < 600) {
+        new_chart->Meta.Difficulty = 2;
+      } else if (totalNotes < 1000) {
+        new_chart->Meta.Difficulty = 3;
+      } else if (totalNotes < 2000) {
+        new_chart->Meta.Difficulty = 4;
+      } else {
+        new_chart->Meta.Difficulty = 5;
+      }
+    }
+  }
+
+#if BMS_PARSER_VERBOSE == 1
+  std::cout << "Total parsing time: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::high_resolution_clock::now() - startTime)
+                   .count()
+            << "\n";
+#endif
+}
+
+void Parser::ParseHeader(Chart *Chart, HeaderKeyword keyword,
+                         std::string_view cmd, std::string_view Xx,
+                         std::string_view Value) {
+  // Debug.Log($"cmd: {cmd}, xx: {xx} isXXNull: {xx == null}, value: {value}");
+  switch (keyword) {
+  case HeaderKeyword::Base: { // BASE 62
+    if (Value.empty()) {
+      return; // TODO: handle this
+    }
+    auto base = static_cast<int>(ParseLong(Value, 10));
+    std::wcout << "BASE: " << base << std::endl;
+    if (base != 36 && base != 62) {
+      return; // TODO: handle this
+    }
+    this->UseBase62 = base == 62;
+    break;
+  }
+  case HeaderKeyword::Player:
+    Chart->Meta.Player = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Genre:
+    Chart->Meta.Genre = DecodeText(Value);
+    break;
+  case HeaderKeyword::Title:
+    Chart->Meta.Title = DecodeText(Value);
+    break;
+  case HeaderKeyword::SubTitle:
+    Chart->Meta.SubTitle = DecodeText(Value);
+    break;
+  case HeaderKeyword::Artist:
+    Chart->Meta.Artist = DecodeText(Value);
+    break;
+  case HeaderKeyword::SubArtist:
+    Chart->Meta.SubArtist = DecodeText(Value);
+    break;
+  case HeaderKeyword::Difficulty:
+    Chart->Meta.Difficulty = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Bpm:
+    if (Value.empty()) {
+      return; // TODO: handle this
+    }
+    if (Xx.empty()) {
+      // chart initial bpm
+      Chart->Meta.Bpm = ParseDouble(Value);
+      // std::cout << "MainBPM: " << Chart->Meta.Bpm << std::endl;
+    } else {
+      // Debug.Log($"BPM: {DecodeBase36(xx)} = {double.Parse(value)}");
+      int id = ParseInt(Xx);
+      if (!CheckResourceIdRange(id)) {
+        // UE_LOG(LogTemp, Warning, TEXT("Invalid BPM id: %s"), *Xx);
+        return;
+      }
+      BpmTable[id] = ParseDouble(Value);
+    }
+    break;
+  case HeaderKeyword::Stop: {
+    if (Value.empty() || Xx.empty()) {
+      return; // TODO: handle this
+    }
+    int id = ParseInt(Xx);
+    if (!CheckResourceIdRange(id)) {
+      // UE_LOG(LogTemp, Warning, TEXT("Invalid STOP id: %s"), *Xx);
+      return;
+    }
+    StopLengthTable[id] = ParseDouble(Value);
+    break;
+  }
+  case HeaderKeyword::MidiFile:
+    // TODO: handle this
+    break;
+  case HeaderKeyword::VideoFile:
+    break;
+  case HeaderKeyword::PlayLevel:
+    Chart->Meta.PlayLevel = ParseDouble(Value); // TODO: handle error
+    break;
+  case HeaderKeyword::Rank:
+    Chart->Meta.Rank = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Total: {
+    auto total = ParseDouble(Value);
+    if (total > 0) {
+      Chart->Meta.Total = total;
+    }
+    break;
+  }
+  case HeaderKeyword::VolWav:
+    break;
+  case HeaderKeyword::StageFile:
+    Chart->Meta.StageFile = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::Banner:
+    Chart->Meta.Banner = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::BackBmp:
+    Chart->Meta.BackBmp = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::Preview:
+    Chart->Meta.Preview = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::Wav: {
+    if (Xx.empty() || Value.empty()) {
+      // UE_LOG(LogTemp, Warning, TEXT("WAV command requires two arguments"));
+      return;
+    }
+    int id = ParseInt(Xx);
+    if (!CheckResourceIdRange(id)) {
+      // UE_LOG(LogTemp, Warning, TEXT("Invalid WAV id: %s"), *Xx);
+      return;
+    }
+    Chart->WavTable[id] = DecodeText(Value);
+    break;
+  }
+  case HeaderKeyword::Bmp: {
+    if (Xx.empty() || Value.empty()) {
+      // UE_LOG(LogTemp, Warning, TEXT("BMP command requires two arguments"));
+      return;
+    }
+    int id = ParseInt(Xx);
+    if (!CheckResourceIdRange(id)) {
+      // UE_LOG(LogTemp, Warning, TEXT("Invalid BMP id: %s"), *Xx);
+      return;
+    }
+    Chart->BmpTable[id] = DecodeText(Value);
+    if (Xx == "00") {
+      Chart->Meta.BgaPoorDefault = true;
+    }
+    break;
+  }
+  case HeaderKeyword::LnObj:
+    Lnobj = ParseInt(Value);
+    break;
+  case HeaderKeyword::LnType:
+    Lntype = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::LnMode:
+    Chart->Meta.LnMode = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Scroll: {
+    auto xx = ParseInt(Xx);
+    auto value = ParseDouble(Value);
+    ScrollTable[xx] = value;
+    // std::wcout << "SCROLL: " << xx << " = " << value << std::endl;
+    break;
+  }
+  default:
+    std::cout << "Unknown command: " << cmd << std::endl;
+    break;
+  }
+}
+
+std::string Parser::DecodeText(std::string_view Value) const {
+  if (!DecodeValues) {
+    return std::string(Value);
+  }
+  std::string result;
+  TextEncodings::ToUTF8(SourceEncoding,
+                        reinterpret_cast<const unsigned char *>(Value.data()),
+                        Value.size(), result);
+  return result;
+}
+
+inline bool Parser::CheckResourceIdRange(int Id) const {
+  return Id >= 0 && Id < (UseBase62 ? 62 * 62 : 36 * 36);
+}
+
+inline int Parser::ToWaveId(Chart *Chart, int decoded, bool metaOnly) {
+  if (metaOnly) {
+    return NoWav;
+  }
+  // check range
+  if (!CheckResourceIdRange(decoded)) {
+    // UE_LOG(LogTemp, Warning, TEXT("Invalid wav id: %s"), *Wav);
+    return NoWav;
+  }
+
+  return Chart->WavTable.find(decoded) != Chart->WavTable.end() ? decoded
+                                                                : NoWav;
+}
+
+inline int Parser::ParseHex(std::string_view Str) {
+  auto result = 0;
+  for (size_t i = 0; i < Str.length(); ++i) {
+    auto c = Str[i];
+    if (c >= '0' && c <= '9') {
+      result = result * 16 + c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+      result = result * 16 + c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+      result = result * 16 + c - 'a' + 10;
+    }
+  }
+  return result;
+}
+
+// Same result as strtol, but stops at the end of the view instead of relying
+// on a terminator: channel data and header values point into the middle of
+// the file.
+inline long Parser::ParseLong(std::string_view Str, int Base) {
+  size_t i = 0;
+  while (i < Str.length() && std::isspace(static_cast<unsigned char>(Str[i]))) {
+    ++i;
+  }
+  bool negative = false;
+  if (i < Str.length() && (Str[i] == '+' || Str[i] == '-')) {
+    negative = Str[i] == '-';
+    ++i;
+  }
+  unsigned long result = 0;
+  const unsigned long limit =
+      negative ? static_cast<unsigned long>(LONG_MAX) + 1 : LONG_MAX;
+  bool overflow = false;
+  for (; i < Str.length(); ++i) {
+    const auto c = Str[i];
+    int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'A' && c <= 'Z') {
+      digit = c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'z') {
+      digit = c - 'a' + 10;
+    } else {
+      break;
+    }
+    if (digit >= Base) {
+      break;
+    }
+    if (result > (limit - digit) / Base) {
+      overflow = true;
+    } else {
+      result = result * Base + digit;
+    }
+  }
+  if (overflow) {
+    return negative ? LONG_MIN : LONG_MAX;
+  }
+  return negative ? static_cast<long>(0UL - result) : static_cast<long>(result);
+}
+
+inline double Parser::ParseDouble(std::string_view Str) {
+  // strtod needs a terminated string; values are short enough for the stack
+  char buffer[64];
+  if (Str.length() < sizeof(buffer)) {
+    std::memcpy(buffer, Str.data(), Str.length());
+    buffer[Str.length()] = '\0';
+    return std::strtod(buffer, nullptr);
+  }
+  return std::strtod(std::string(Str).c_str(), nullptr);
+}
+
+inline std::string_view Parser::Tail(std::string_view Line, size_t Pos) {
+  return Pos < Line.length() ? Line.substr(Pos) : std::string_view();
+}
+
+// Splits a generic header line the way ^#([A-Za-z]+?)(\d\d)? +?(.+)? would:
+// a run of letters, an optional two digit index, at least one space and the
+// rest of the line (up to a stray carriage return) as the value.
+inline bool Parser::SplitHeader(std::string_view Line, std::string_view &Cmd,
+                                std::string_view &Xx, std::string_view &Value) {
+  const auto isLetter = [](char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+  };
+  const auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+  size_t i = 1; // skip '#'
+  while (i < Line.length() && isLetter(Line[i])) {
+    ++i;
+  }
+  if (i == 1) {
+    return false;
+  }
+  Cmd = Line.substr(1, i - 1);
+  Xx = std::string_view();
+  if (i + 2 < Line.length() && isDigit(Line[i]) && isDigit(Line[i + 1]) &&
+      Line[i + 2] == ' ') {
+    Xx = Line.substr(i, 2);
+    i += 2;
+  }
+  if (i >= Line.length() || Line[i] != ' ') {
+    return false;
+  }
+  Value = Line.substr(i + 1);
+  Value = Value.substr(0, Value.find('\r'));
+  return true;
+}
+
+inline int Parser::ParseInt(std::string_view Str, bool forceBase36) const {
+  if (forceBase36 || !UseBase62) {
+    auto result = static_cast<int>(ParseLong(Str, 36));
+    // std::wcout << "ParseInt36: " << Str << " = " << result << std::endl;
+    return result;
+  }
+
+  auto result = 0;
+  for (size_t i = 0; i < Str.length(); ++i) {
+    auto c = Str[i];
+    if (c >= '0' && c <= '9') {
+      result = result * 62 + c - '0';
+    } else if (c >= 'A' && c <= 'Z') {
+      result = result * 62 + c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'z') {
+      result = result * 62 + c - 'a' + 36;
+    } else
+      return -1;
+  }
+  // std::wcout << "ParseInt62: " << Str << " = " << result << std::endl;
+  return result;
+}
+#ifdef _WIN32
+std::wstring Parser::utf8_to_path_t(const std::string &input) {
+
+  // Determine the size of the buffer needed
+  int requiredSize =
+      MultiByteToWideChar(65001 /* UTF8 */, 0, input.c_str(), -1, NULL, 0);
+
+  if (requiredSize <= 0) {
+    // Conversion failed, return an empty string
+    return std::wstring();
+  }
+
+  // Create a string with the required size
+  std::wstring result(requiredSize, '\0');
+
+  // Perform the conversion
+  MultiByteToWideChar(65001 /* UTF8 */, 0, input.c_str(), -1, &result[0],
+                      requiredSize);
+
+  // Remove the extra null terminator added by MultiByteToWideChar
+  result.resize(requiredSize - 1);
+
+  return result;
+}
+#else
+std::string Parser::utf8_to_path_t(const std::string &input) { return input; }
+#endif
+
+Parser::~Parser() = default;
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <type_traits>
+
+namespace bms_parser {
+static_assert(std::is_trivially_copyable<NoteState>::value,
+              "Reset clears the states with memset");
+
+PlayState::PlayState(const Chart &chart)
+    : Notes(&chart.Notes), States(chart.Notes.size()) {}
+
+void PlayState::Reset() {
+  if (!States.empty()) {
+    std::memset(States.data(), 0, States.size() * sizeof(NoteState));
+  }
+}
+
+void PlayState::Play(uint32_t id, long long time) {
+  States[id].IsPlayed = true;
+  States[id].PlayedTime = time;
+}
+
+void PlayState::Press(uint32_t id, long long time) {
+  Play(id, time);
+  const auto &record = (*Notes)[id];
+  if (record.Kind != NoteKind::LongHead) {
+    return;
+  }
+  States[id].IsHolding = true;
+  if (record.Partner != NoNoteId) {
+    States[record.Partner].IsHolding = true;
+  }
+}
+
+void PlayState::Release(uint32_t id, long long time) {
+  Play(id, time);
+  States[id].IsHolding = false;
+  States[id].ReleaseTime = time;
+  const auto partner = (*Notes)[id].Partner;
+  if (partner != NoNoteId) {
+    States[partner].IsHolding = false;
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Updated to C++, zedwood.com 2012
+ * Based on Olivier Gay's version
+ * See Modified BSD License below:
+ *
+ * FIPS 180-2 SHA-224/256/384/512 implementation
+ * Issue date:  04/30/2005
+ * http://www.ouah.org/ogay/sha2/
+ *
+ * Copyright (C) 2005, 2007 Olivier Gay <olivier.gay@a3.epfl.ch>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the project nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE PROJECT AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE PROJECT OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// http://www.zedwood.com/article/cpp-sha256-function
+#include <cstring>
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+const unsigned int SHA256::sha256_k[64] = // UL = uint32
+    {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+     0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+     0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+     0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+     0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+     0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+     0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+     0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+     0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+     0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+namespace {
+using uint8 = unsigned char;
+using uint32 = unsigned int;
+using TransformFn = void (*)(uint32 *state, const uint32 *k,
+                             const unsigned char *message,
+                             unsigned int block_nb);
+
+void TransformScalar(uint32 *state, const uint32 *k,
+                     const unsigned char *message, unsigned int block_nb) {
+  uint32 w[64];
+  uint32 wv[8];
+  uint32 t1, t2;
+  const unsigned char *sub_block;
+  int i;
+  int j;
+  for (i = 0; i < static_cast<int>(block_nb); i++) {
+    sub_block = message + (i << 6);
+    for (j = 0; j < 16; j++) {
+      SHA2_PACK32(&sub_block[j << 2], &w[j]);
+    }
+    for (j = 16; j < 64; j++) {
+      w[j] = SHA256_F4(w[j - 2]) + w[j - 7] + SHA256_F3(w[j - 15]) + w[j - 16];
+    }
+    for (j = 0; j < 8; j++) {
+      wv[j] = state[j];
+    }
+    for (j = 0; j < 64; j++) {
+      t1 = wv[7] + SHA256_F2(wv[4]) + SHA2_CH(wv[4], wv[5], wv[6]) + k[j] +
+           w[j];
+      t2 = SHA256_F1(wv[0]) + SHA2_MAJ(wv[0], wv[1], wv[2]);
+      wv[7] = wv[6];
+      wv[6] = wv[5];
+      wv[5] = wv[4];
+      wv[4] = wv[3] + t1;
+      wv[3] = wv[2];
+      wv[2] = wv[1];
+      wv[1] = wv[0];
+      wv[0] = t1 + t2;
+    }
+    for (j = 0; j < 8; j++) {
+      state[j] += wv[j];
+    }
+  }
+}
+
+#if BMS_PARSER_X86
+// sigma0 and sigma1 of the message schedule on four words at once
+BMS_PARSER_TARGET("avx2")
+inline __m128i ScheduleSigma0(__m128i x) {
+  return _mm_xor_si128(
+      _mm_xor_si128(_mm_or_si128(_mm_srli_epi32(x, 7), _mm_slli_epi32(x, 25)),
+                    _mm_or_si128(_mm_srli_epi32(x, 18),
+                                 _mm_slli_epi32(x, 14))),
+      _mm_srli_epi32(x, 3));
+}
+
+BMS_PARSER_TARGET("avx2")
+inline __m128i ScheduleSigma1(__m128i x) {
+  return _mm_xor_si128(
+      _mm_xor_si128(
+          _mm_or_si128(_mm_srli_epi32(x, 17), _mm_slli_epi32(x, 15)),
+          _mm_or_si128(_mm_srli_epi32(x, 19), _mm_slli_epi32(x, 13))),
+      _mm_srli_epi32(x, 10));
+}
+
+// The rounds stay scalar, but the message schedule is expanded four words
+// at a time in vector registers, in between the rounds that consume it.
+BMS_PARSER_TARGET("avx2")
+void TransformAvx2(uint32 *state, const uint32 *k,
+                   const unsigned char *message, unsigned int block_nb) {
+  const __m128i byteSwap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  alignas(16) uint32 wk[16];
+  for (unsigned int block = 0; block < block_nb; ++block) {
+    const auto data = reinterpret_cast<const __m128i *>(message + block * 64);
+    // x0..x3 hold the last 16 schedule words, oldest first
+    __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128(data), byteSwap);
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128(data + 1), byteSwap);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128(data + 2), byteSwap);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128(data + 3), byteSwap);
+    uint32 a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32 e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int t = 0; t < 64; t += 16) {
+      const auto kv = reinterpret_cast<const __m128i *>(k + t);
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk),
+                      _mm_add_epi32(x0, _mm_loadu_si128(kv)));
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk + 4),
+                      _mm_add_epi32(x1, _mm_loadu_si128(kv + 1)));
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk + 8),
+                      _mm_add_epi32(x2, _mm_loadu_si128(kv + 2)));
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk + 12),
+                      _mm_add_epi32(x3, _mm_loadu_si128(kv + 3)));
+      if (t < 48) {
+        // w[i] = s1(w[i-2]) + w[i-7] + s0(w[i-15]) + w[i-16]; the s1 term of
+        // the upper two words needs the lower two, so it takes two steps
+        for (int step = 0; step < 4; ++step) {
+          __m128i next = _mm_add_epi32(
+              _mm_add_epi32(x0, _mm_alignr_epi8(x3, x2, 4)),
+              ScheduleSigma0(_mm_alignr_epi8(x1, x0, 4)));
+          next = _mm_add_epi32(next, ScheduleSigma1(_mm_srli_si128(x3, 8)));
+          next = _mm_add_epi32(next, ScheduleSigma1(_mm_slli_si128(next, 8)));
+          x0 = x1;
+          x1 = x2;
+          x2 = x3;
+          x3 = next;
+        }
+      }
+      for (int j = 0; j < 16; ++j) {
+        const uint32 t1 =
+            h + SHA256_F2(e) + SHA2_CH(e, f, g) + wk[j];
+        const uint32 t2 = SHA256_F1(a) + SHA2_MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+      }
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+// four rounds with the SHA extensions; msg holds the next four words
+#define SHA256_NI_ROUNDS(state0, state1, msg, k)                               \
+  {                                                                            \
+    __m128i wk_ = _mm_add_epi32(                                               \
+        msg, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k)));           \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, wk_);                       \
+    state0 = _mm_sha256rnds2_epu32(state0, state1,                             \
+                                   _mm_shuffle_epi32(wk_, 0x0E));              \
+  }
+
+// extends the schedule after the rounds of group g, which used cur; prev,
+// next and later are the groups around it
+#define SHA256_NI_SCHEDULE(g, prev, cur, next, later)                          \
+  {                                                                            \
+    if ((g) >= 3 && (g) <= 14) {                                               \
+      next = _mm_sha256msg2_epu32(                                             \
+          _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)), cur);            \
+    }                                                                          \
+    if ((g) >= 1 && (g) <= 12) {                                               \
+      later = _mm_sha256msg1_epu32(later, cur);                                \
+    }                                                                          \
+  }
+
+BMS_PARSER_TARGET("sha,sse4.1,ssse3")
+void TransformShaNi(uint32 *state, const uint32 *k,
+                    const unsigned char *message, unsigned int block_nb) {
+  const __m128i byteSwap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  // the instructions want the state as ABEF and CDGH
+  __m128i tmp = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xB1);
+  __m128i state1 = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1B);
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+  for (unsigned int block = 0; block < block_nb; ++block) {
+    const auto data = reinterpret_cast<const __m128i *>(message + block * 64);
+    const __m128i abefSave = state0;
+    const __m128i cdghSave = state1;
+    __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(data), byteSwap);
+    __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(data + 1), byteSwap);
+    __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(data + 2), byteSwap);
+    __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(data + 3), byteSwap);
+    for (int g = 0; g < 16; g += 4) {
+      SHA256_NI_ROUNDS(state0, state1, m0, k + g * 4);
+      SHA256_NI_SCHEDULE(g, m3, m0, m1, m3);
+      SHA256_NI_ROUNDS(state0, state1, m1, k + g * 4 + 4);
+      SHA256_NI_SCHEDULE(g + 1, m0, m1, m2, m0);
+      SHA256_NI_ROUNDS(state0, state1, m2, k + g * 4 + 8);
+      SHA256_NI_SCHEDULE(g + 2, m1, m2, m3, m1);
+      SHA256_NI_ROUNDS(state0, state1, m3, k + g * 4 + 12);
+      SHA256_NI_SCHEDULE(g + 3, m2, m3, m0, m2);
+    }
+    state0 = _mm_add_epi32(state0, abefSave);
+    state1 = _mm_add_epi32(state1, cdghSave);
+  }
+
+  tmp = _mm_shuffle_epi32(state0, 0x1B);
+  state1 = _mm_shuffle_epi32(state1, 0xB1);
+  state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+  state1 = _mm_alignr_epi8(state1, tmp, 8);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(state), state0);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), state1);
+}
+#undef SHA256_NI_ROUNDS
+#undef SHA256_NI_SCHEDULE
+#endif
+
+TransformFn SelectTransform() {
+#if BMS_PARSER_X86
+  if (CpuFeatures::HasSHA()) {
+    return TransformShaNi;
+  }
+  if (CpuFeatures::HasAVX2()) {
+    return TransformAvx2;
+  }
+#endif
+  return TransformScalar;
+}
+
+TransformFn KernelTransform(SHA256Kernel kernel) {
+  switch (kernel) {
+#if BMS_PARSER_X86
+  case SHA256Kernel::ShaNi:
+    return TransformShaNi;
+  case SHA256Kernel::Avx2:
+    return TransformAvx2;
+#endif
+  case SHA256Kernel::Scalar:
+    return TransformScalar;
+  default: {
+    static const TransformFn fastest = SelectTransform();
+    return fastest;
+  }
+  }
+}
+} // namespace
+
+bool SHA256::Supports(SHA256Kernel kernel) {
+  switch (kernel) {
+#if BMS_PARSER_X86
+  case SHA256Kernel::ShaNi:
+    return CpuFeatures::HasSHA();
+  case SHA256Kernel::Avx2:
+    return CpuFeatures::HasAVX2();
+#endif
+  case SHA256Kernel::Auto:
+  case SHA256Kernel::Scalar:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void SHA256::transform(const unsigned char *message, unsigned int block_nb) {
+  KernelTransform(m_kernel)(m_h, sha256_k, message, block_nb);
+}
+
+void SHA256::init(SHA256Kernel kernel) {
+  m_kernel = kernel;
+  m_h[0] = 0x6a09e667;
+  m_h[1] = 0xbb67ae85;
+  m_h[2] = 0x3c6ef372;
+  m_h[3] = 0xa54ff53a;
+  m_h[4] = 0x510e527f;
+  m_h[5] = 0x9b05688c;
+  m_h[6] = 0x1f83d9ab;
+  m_h[7] = 0x5be0cd19;
+  m_len = 0;
+  m_tot_len = 0;
+}
+
+void SHA256::update(const unsigned char *message, unsigned int len) {
+  unsigned int block_nb;
+  unsigned int new_len, rem_len, tmp_len;
+  const unsigned char *shifted_message;
+  tmp_len = SHA224_256_BLOCK_SIZE - m_len;
+  rem_len = len < tmp_len ? len : tmp_len;
+  memcpy(&m_block[m_len], message, rem_len);
+  if (m_len + len < SHA224_256_BLOCK_SIZE) {
+    m_len += len;
+    return;
+  }
+  new_len = len - rem_len;
+  block_nb = new_len / SHA224_256_BLOCK_SIZE;
+  shifted_message = message + rem_len;
+  transform(m_block, 1);
+  transform(shifted_message, block_nb);
+  rem_len = new_len % SHA224_256_BLOCK_SIZE;
+  memcpy(m_block, &shifted_message[block_nb << 6], rem_len);
+  m_len = rem_len;
+  m_tot_len += (block_nb + 1) << 6;
+}
+
+void SHA256::final(unsigned char *digest) {
+  unsigned int block_nb;
+  unsigned int pm_len;
+  unsigned int len_b;
+  int i;
+  block_nb =
+      (1 + ((SHA224_256_BLOCK_SIZE - 9) < (m_len % SHA224_256_BLOCK_SIZE)));
+  len_b = (m_tot_len + m_len) << 3;
+  pm_len = block_nb << 6;
+  memset(m_block + m_len, 0, pm_len - m_len);
+  m_block[m_len] = 0x80;
+  SHA2_UNPACK32(len_b, m_block + pm_len - 4);
+  transform(m_block, block_nb);
+  for (i = 0; i < 8; i++) {
+    SHA2_UNPACK32(m_h[i], &digest[i << 2]);
+  }
+}
+
+std::string sha256(const unsigned char *bytes, size_t size,
+                   SHA256Kernel kernel) {
+  unsigned char digest[SHA256::DIGEST_SIZE];
+  memset(digest, 0, SHA256::DIGEST_SIZE);
+
+  SHA256 ctx = SHA256();
+  ctx.init(kernel);
+  ctx.update(bytes, size);
+  ctx.final(digest);
+
+  char buf[2 * SHA256::DIGEST_SIZE + 1];
+  buf[2 * SHA256::DIGEST_SIZE] = 0;
+  for (unsigned int i = 0; i < SHA256::DIGEST_SIZE; i++) {
+    snprintf(buf + i * 2, 3, "%02x", digest[i]);
+  }
+  return buf;
+}
+
+std::string sha256(const std::vector<unsigned char> &bytes) {
+  return sha256(bytes.data(), bytes.size());
+}
+} // namespace bms_parser
+
+// https://stackoverflow.com/questions/33165171/c-shiftjis-to-utf8-conversion
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+namespace {
+// Shift-JIS to UTF-16 tables, in two levels so the whole thing stays small
+// enough for L1: a lead byte selects a page of double-byte characters, and
+// every other byte is looked up directly in shiftJIS_singleByte. Lead bytes
+// that share a page (the unassigned rows are all spaces) point at one copy.
+constexpr unsigned char shiftJIS_noPage = 0xff;
+constexpr unsigned char shiftJIS_trailFirst = 0x40;
+constexpr unsigned char shiftJIS_trailLast = 0xfc;
+constexpr size_t shiftJIS_pageSize =
+    shiftJIS_trailLast - shiftJIS_trailFirst + 1;
+
+const unsigned char shiftJIS_leadPage[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x01, 0x02, 0x03,
+    0x04, 0x00, 0x00, 0x00, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+    0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+    0x19, 0x1a, 0x1b, 0x1c, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x1d, 0x1e, 0x1f, 0x20,
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff,
+};
+
+const uint16_t shiftJIS_singleByte[256] = {
+    0x0000, 0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008,
+    0x0009, 0x000a, 0x000b, 0x000c, 0x000d, 0x000e, 0x000f, 0x0010, 0x0011,
+    0x0012, 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001a,
+    0x001b, 0x001c, 0x001d, 0x001e, 0x001f, 0x0020, 0x0021, 0x0022, 0x0023,
+    0x0024, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002a, 0x002b, 0x002c,
+    0x002d, 0x002e, 0x002f, 0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035,
+    0x0036, 0x0037, 0x0038, 0x0039, 0x003a, 0x003b, 0x003c, 0x003d, 0x003e,
+    0x003f, 0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004a, 0x004b, 0x004c, 0x004d, 0x004e, 0x004f, 0x0050,
+    0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059,
+    0x005a, 0x005b, 0x00a5, 0x005d, 0x005e, 0x005f, 0x0060, 0x0061, 0x0062,
+    0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x006a, 0x006b,
+    0x006c, 0x006d, 0x006e, 0x006f, 0x0070, 0x0071, 0x0072, 0x0073, 0x0074,
+    0x0075, 0x0076, 0x0077, 0x0078, 0x0079, 0x007a, 0x007b, 0x007c, 0x007d,
+    0x203e, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0xff61,
+    0xff62, 0xff63, 0xff64, 0xff65, 0xff66, 0xff67, 0xff68, 0xff69, 0xff6a,
+    0xff6b, 0xff6c, 0xff6d, 0xff6e, 0xff6f, 0xff70, 0xff71, 0xff72, 0xff73,
+    0xff74, 0xff75, 0xff76, 0xff77, 0xff78, 0xff79, 0xff7a, 0xff7b, 0xff7c,
+    0xff7d, 0xff7e, 0xff7f, 0xff80, 0xff81, 0xff82, 0xff83, 0xff84, 0xff85,
+    0xff86, 0xff87, 0xff88, 0xff89, 0xff8a, 0xff8b, 0xff8c, 0xff8d, 0xff8e,
+    0xff8f, 0xff90, 0xff91, 0xff92, 0xff93, 0xff94, 0xff95, 0xff96, 0xff97,
+    0xff98, 0xff99, 0xff9a, 0xff9b, 0xff9c, 0xff9d, 0xff9e, 0xff9f, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020,
+};
+
+const uint16_t shiftJIS_pages[40][shiftJIS_pageSize] = {
+    {
+        // lead 0x80, 0x85, 0x86, 0x87, 0xeb, 0xec, 0xed, 0xee, 0xef
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    },
+    {
+        // lead 0x81
+        0x3000, 0x3001, 0x3002, 0xff0c, 0xff0e, 0x30fb, 0xff1a, 0xff1b, 0xff1f,
+        0xff01, 0x309b, 0x309c, 0x00b4, 0xff40, 0x00a8, 0xff3e, 0xffe3, 0xff3f,
+        0x30fd, 0x30fe, 0x309d, 0x309e, 0x3003, 0x4edd, 0x3005, 0x3006, 0x3007,
+        0x30fc, 0x2015, 0x2010, 0xff0f, 0x005c, 0x301c, 0x2016, 0xff5c, 0x2026,
+        0x2025, 0x2018, 0x2019, 0x201c, 0x201d, 0xff08, 0xff09, 0x3014, 0x3015,
+        0xff3b, 0xff3d, 0xff5b, 0xff5d, 0x3008, 0x3009, 0x300a, 0x300b, 0x300c,
+        0x300d, 0x300e, 0x300f, 0x3010, 0x3011, 0xff0b, 0x2212, 0x00b1, 0x00d7,
+        0x0020, 0x00f7, 0xff1d, 0x2260, 0xff1c, 0xff1e, 0x2266, 0x2267, 0x221e,
+        0x2234, 0x2642, 0x2640, 0x00b0, 0x2032, 0x2033, 0x2103, 0xffe5, 0xff04,
+        0x00a2, 0x00a3, 0xff05, 0xff03, 0xff06, 0xff0a, 0xff20, 0x00a7, 0x2606,
+        0x2605, 0x25cb, 0x25cf, 0x25ce, 0x25c7, 0x25c6, 0x25a1, 0x25a0, 0x25b3,
+        0x25b2, 0x25bd, 0x25bc, 0x203b, 0x3012, 0x2192, 0x2190, 0x2191, 0x2193,
+        0x3013, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x2208, 0x220b, 0x2286, 0x2287, 0x2282, 0x2283,
+        0x222a, 0x2229, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x2227, 0x2228, 0x00ac, 0x21d2, 0x21d4, 0x2200, 0x2203, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x2220, 0x22a5, 0x2312, 0x2202, 0x2207, 0x2261, 0x2252, 0x226a,
+        0x226b, 0x221a, 0x223d, 0x221d, 0x2235, 0x222b, 0x222c, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x212b, 0x2030, 0x266f, 0x266d,
+        0x266a, 0x2020, 0x2021, 0x00b6, 0x0020, 0x0020, 0x0020, 0x0020, 0x25ef,
+    },
+    {
+        // lead 0x82
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0xff10, 0xff11, 0xff12,
+        0xff13, 0xff14, 0xff15, 0xff16, 0xff17, 0xff18, 0xff19, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0xff21, 0xff22, 0xff23, 0xff24,
+        0xff25, 0xff26, 0xff27, 0xff28, 0xff29, 0xff2a, 0xff2b, 0xff2c, 0xff2d,
+        0xff2e, 0xff2f, 0xff30, 0xff31, 0xff32, 0xff33, 0xff34, 0xff35, 0xff36,
+        0xff37, 0xff38, 0xff39, 0xff3a, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0xff41, 0xff42, 0xff43, 0xff44, 0xff45, 0xff46, 0xff47,
+        0xff48, 0xff49, 0xff4a, 0xff4b, 0xff4c, 0xff4d, 0xff4e, 0xff4f, 0xff50,
+        0xff51, 0xff52, 0xff53, 0xff54, 0xff55, 0xff56, 0xff57, 0xff58, 0xff59,
+        0xff5a, 0x0020, 0x0020, 0x0020, 0x0020, 0x3041, 0x3042, 0x3043, 0x3044,
+        0x3045, 0x3046, 0x3047, 0x3048, 0x3049, 0x304a, 0x304b, 0x304c, 0x304d,
+        0x304e, 0x304f, 0x3050, 0x3051, 0x3052, 0x3053, 0x3054, 0x3055, 0x3056,
+        0x3057, 0x3058, 0x3059, 0x305a, 0x305b, 0x305c, 0x305d, 0x305e, 0x305f,
+        0x3060, 0x3061, 0x3062, 0x3063, 0x3064, 0x3065, 0x3066, 0x3067, 0x3068,
+        0x3069, 0x306a, 0x306b, 0x306c, 0x306d, 0x306e, 0x306f, 0x3070, 0x3071,
+        0x3072, 0x3073, 0x3074, 0x3075, 0x3076, 0x3077, 0x3078, 0x3079, 0x307a,
+        0x307b, 0x307c, 0x307d, 0x307e, 0x307f, 0x3080, 0x3081, 0x3082, 0x3083,
+        0x3084, 0x3085, 0x3086, 0x3087, 0x3088, 0x3089, 0x308a, 0x308b, 0x308c,
+        0x308d, 0x308e, 0x308f, 0x3090, 0x3091, 0x3092, 0x3093, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    },
+    {
+        // lead 0x83
+        0x30a1, 0x30a2, 0x30a3, 0x30a4, 0x30a5, 0x30a6, 0x30a7, 0x30a8, 0x30a9,
+        0x30aa, 0x30ab, 0x30ac, 0x30ad, 0x30ae, 0x30af, 0x30b0, 0x30b1, 0x30b2,
+        0x30b3, 0x30b4, 0x30b5, 0x30b6, 0x30b7, 0x30b8, 0x30b9, 0x30ba, 0x30bb,
+        0x30bc, 0x30bd, 0x30be, 0x30bf, 0x30c0, 0x30c1, 0x30c2, 0x30c3, 0x30c4,
+        0x30c5, 0x30c6, 0x30c7, 0x30c8, 0x30c9, 0x30ca, 0x30cb, 0x30cc, 0x30cd,
+        0x30ce, 0x30cf, 0x30d0, 0x30d1, 0x30d2, 0x30d3, 0x30d4, 0x30d5, 0x30d6,
+        0x30d7, 0x30d8, 0x30d9, 0x30da, 0x30db, 0x30dc, 0x30dd, 0x30de, 0x30df,
+        0x0020, 0x30e0, 0x30e1, 0x30e2, 0x30e3, 0x30e4, 0x30e5, 0x30e6, 0x30e7,
+        0x30e8, 0x30e9, 0x30ea, 0x30eb, 0x30ec, 0x30ed, 0x30ee, 0x30ef, 0x30f0,
+        0x30f1, 0x30f2, 0x30f3, 0x30f4, 0x30f5, 0x30f6, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0391, 0x0392, 0x0393, 0x0394,
+        0x0395, 0x0396, 0x0397, 0x0398, 0x0399, 0x039a, 0x039b, 0x039c, 0x039d,
+        0x039e, 0x039f, 0x03a0, 0x03a1, 0x03a3, 0x03a4, 0x03a5, 0x03a6, 0x03a7,
+        0x03a8, 0x03a9, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x03b1, 0x03b2, 0x03b3, 0x03b4, 0x03b5, 0x03b6, 0x03b7, 0x03b8,
+        0x03b9, 0x03ba, 0x03bb, 0x03bc, 0x03bd, 0x03be, 0x03bf, 0x03c0, 0x03c1,
+        0x03c3, 0x03c4, 0x03c5, 0x03c6, 0x03c7, 0x03c8, 0x03c9, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    },
+    {
+        // lead 0x84
+        0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0401, 0x0416, 0x0417,
+        0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f, 0x0420,
+        0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427, 0x0428, 0x0429,
+        0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435,
+        0x0451, 0x0436, 0x0437, 0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d,
+        0x0020, 0x043e, 0x043f, 0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445,
+        0x0446, 0x0447, 0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e,
+        0x044f, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x2500, 0x2502, 0x250c, 0x2510,
+        0x2518, 0x2514, 0x251c, 0x252c, 0x2524, 0x2534, 0x253c, 0x2501, 0x2503,
+        0x250f, 0x2513, 0x251b, 0x2517, 0x2523, 0x2533, 0x252b, 0x253b, 0x254b,
+        0x2520, 0x252f, 0x2528, 0x2537, 0x253f, 0x251d, 0x2530, 0x2525, 0x2538,
+        0x2542, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    },
+    {
+        // lead 0x88
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x4e9c, 0x5516, 0x5a03, 0x963f,
+        0x54c0, 0x611b, 0x6328, 0x59f6, 0x9022, 0x8475, 0x831c, 0x7a50, 0x60aa,
+        0x63e1, 0x6e25, 0x65ed, 0x8466, 0x82a6, 0x9bf5, 0x6893, 0x5727, 0x65a1,
+        0x6271, 0x5b9b, 0x59d0, 0x867b, 0x98f4, 0x7d62, 0x7dbe, 0x9b8e, 0x6216,
+        0x7c9f, 0x88b7, 0x5b89, 0x5eb5, 0x6309, 0x6697, 0x6848, 0x95c7, 0x978d,
+        0x674f, 0x4ee5, 0x4f0a, 0x4f4d, 0x4f9d, 0x5049, 0x56f2, 0x5937, 0x59d4,
+        0x5a01, 0x5c09, 0x60df, 0x610f, 0x6170, 0x6613, 0x6905, 0x70ba, 0x754f,
+        0x7570, 0x79fb, 0x7dad, 0x7def, 0x80c3, 0x840e, 0x8863, 0x8b02, 0x9055,
+        0x907a, 0x533b, 0x4e95, 0x4ea5, 0x57df, 0x80b2, 0x90c1, 0x78ef, 0x4e00,
+        0x58f1, 0x6ea2, 0x9038, 0x7a32, 0x8328, 0x828b, 0x9c2f, 0x5141, 0x5370,
+        0x54bd, 0x54e1, 0x56e0, 0x59fb, 0x5f15, 0x98f2, 0x6deb, 0x80e4, 0x852d,
+    },
+    {
+        // lead 0x89
+        0x9662, 0x9670, 0x96a0, 0x97fb, 0x540b, 0x53f3, 0x5b87, 0x70cf, 0x7fbd,
+        0x8fc2, 0x96e8, 0x536f, 0x9d5c, 0x7aba, 0x4e11, 0x7893, 0x81fc, 0x6e26,
+        0x5618, 0x5504, 0x6b1d, 0x851a, 0x9c3b, 0x59e5, 0x53a9, 0x6d66, 0x74dc,
+        0x958f, 0x5642, 0x4e91, 0x904b, 0x96f2, 0x834f, 0x990c, 0x53e1, 0x55b6,
+        0x5b30, 0x5f71, 0x6620, 0x66f3, 0x6804, 0x6c38, 0x6cf3, 0x6d29, 0x745b,
+        0x76c8, 0x7a4e, 0x9834, 0x82f1, 0x885b, 0x8a60, 0x92ed, 0x6db2, 0x75ab,
+        0x76ca, 0x99c5, 0x60a6, 0x8b01, 0x8d8a, 0x95b2, 0x698e, 0x53ad, 0x5186,
+        0x0020, 0x5712, 0x5830, 0x5944, 0x5bb4, 0x5ef6, 0x6028, 0x63a9, 0x63f4,
+        0x6cbf, 0x6f14, 0x708e, 0x7114, 0x7159, 0x71d5, 0x733f, 0x7e01, 0x8276,
+        0x82d1, 0x8597, 0x9060, 0x925b, 0x9d1b, 0x5869, 0x65bc, 0x6c5a, 0x7525,
+        0x51f9, 0x592e, 0x5965, 0x5f80, 0x5fdc, 0x62bc, 0x65fa, 0x6a2a, 0x6b27,
+        0x6bb4, 0x738b, 0x7fc1, 0x8956, 0x9d2c, 0x9d0e, 0x9ec4, 0x5ca1, 0x6c96,
+        0x837b, 0x5104, 0x5c4b, 0x61b6, 0x81c6, 0x6876, 0x7261, 0x4e59, 0x4ffa,
+        0x5378, 0x6069, 0x6e29, 0x7a4f, 0x97f3, 0x4e0b, 0x5316, 0x4eee, 0x4f55,
+        0x4f3d, 0x4fa1, 0x4f73, 0x52a0, 0x53ef, 0x5609, 0x590f, 0x5ac1, 0x5bb6,
+        0x5be1, 0x79d1, 0x6687, 0x679c, 0x67b6, 0x6b4c, 0x6cb3, 0x706b, 0x73c2,
+        0x798d, 0x79be, 0x7a3c, 0x7b87, 0x82b1, 0x82db, 0x8304, 0x8377, 0x83ef,
+        0x83d3, 0x8766, 0x8ab2, 0x5629, 0x8ca8, 0x8fe6, 0x904e, 0x971e, 0x868a,
+        0x4fc4, 0x5ce8, 0x6211, 0x7259, 0x753b, 0x81e5, 0x82bd, 0x86fe, 0x8cc0,
+        0x96c5, 0x9913, 0x99d5, 0x4ecb, 0x4f1a, 0x89e3, 0x56de, 0x584a, 0x58ca,
+        0x5efb, 0x5feb, 0x602a, 0x6094, 0x6062, 0x61d0, 0x6212, 0x62d0, 0x6539,
+    },
+    {
+        // lead 0x8a
+        0x9b41, 0x6666, 0x68b0, 0x6d77, 0x7070, 0x754c, 0x7686, 0x7d75, 0x82a5,
+        0x87f9, 0x958b, 0x968e, 0x8c9d, 0x51f1, 0x52be, 0x5916, 0x54b3, 0x5bb3,
+        0x5d16, 0x6168, 0x6982, 0x6daf, 0x788d, 0x84cb, 0x8857, 0x8a72, 0x93a7,
+        0x9ab8, 0x6d6c, 0x99a8, 0x86d9, 0x57a3, 0x67ff, 0x86ce, 0x920e, 0x5283,
+        0x5687, 0x5404, 0x5ed3, 0x62e1, 0x64b9, 0x683c, 0x6838, 0x6bbb, 0x7372,
+        0x78ba, 0x7a6b, 0x899a, 0x89d2, 0x8d6b, 0x8f03, 0x90ed, 0x95a3, 0x9694,
+        0x9769, 0x5b66, 0x5cb3, 0x697d, 0x984d, 0x984e, 0x639b, 0x7b20, 0x6a2b,
+        0x0020, 0x6a7f, 0x68b6, 0x9c0d, 0x6f5f, 0x5272, 0x559d, 0x6070, 0x62ec,
+        0x6d3b, 0x6e07, 0x6ed1, 0x845b, 0x8910, 0x8f44, 0x4e14, 0x9c39, 0x53f6,
+        0x691b, 0x6a3a, 0x9784, 0x682a, 0x515c, 0x7ac3, 0x84b2, 0x91dc, 0x938c,
+        0x565b, 0x9d28, 0x6822, 0x8305, 0x8431, 0x7ca5, 0x5208, 0x82c5, 0x74e6,
+        0x4e7e, 0x4f83, 0x51a0, 0x5bd2, 0x520a, 0x52d8, 0x52e7, 0x5dfb, 0x559a,
+        0x582a, 0x59e6, 0x5b8c, 0x5b98, 0x5bdb, 0x5e72, 0x5e79, 0x60a3, 0x611f,
+        0x6163, 0x61be, 0x63db, 0x6562, 0x67d1, 0x6853, 0x68fa, 0x6b3e, 0x6b53,
+        0x6c57, 0x6f22, 0x6f97, 0x6f45, 0x74b0, 0x7518, 0x76e3, 0x770b, 0x7aff,
+        0x7ba1, 0x7c21, 0x7de9, 0x7f36, 0x7ff0, 0x809d, 0x8266, 0x839e, 0x89b3,
+        0x8acc, 0x8cab, 0x9084, 0x9451, 0x9593, 0x9591, 0x95a2, 0x9665, 0x97d3,
+        0x9928, 0x8218, 0x4e38, 0x542b, 0x5cb8, 0x5dcc, 0x73a9, 0x764c, 0x773c,
+        0x5ca9, 0x7feb, 0x8d0b, 0x96c1, 0x9811, 0x9854, 0x9858, 0x4f01, 0x4f0e,
+        0x5371, 0x559c, 0x5668, 0x57fa, 0x5947, 0x5b09, 0x5bc4, 0x5c90, 0x5e0c,
+        0x5e7e, 0x5fcc, 0x63ee, 0x673a, 0x65d7, 0x65e2, 0x671f, 0x68cb, 0x68c4,
+    },
+    {
+        // lead 0x8b
+        0x6a5f, 0x5e30, 0x6bc5, 0x6c17, 0x6c7d, 0x757f, 0x7948, 0x5b63, 0x7a00,
+        0x7d00, 0x5fbd, 0x898f, 0x8a18, 0x8cb4, 0x8d77, 0x8ecc, 0x8f1d, 0x98e2,
+        0x9a0e, 0x9b3c, 0x4e80, 0x507d, 0x5100, 0x5993, 0x5b9c, 0x622f, 0x6280,
+        0x64ec, 0x6b3a, 0x72a0, 0x7591, 0x7947, 0x7fa9, 0x87fb, 0x8abc, 0x8b70,
+        0x63ac, 0x83ca, 0x97a0, 0x5409, 0x5403, 0x55ab, 0x6854, 0x6a58, 0x8a70,
+        0x7827, 0x6775, 0x9ecd, 0x5374, 0x5ba2, 0x811a, 0x8650, 0x9006, 0x4e18,
+        0x4e45, 0x4ec7, 0x4f11, 0x53ca, 0x5438, 0x5bae, 0x5f13, 0x6025, 0x6551,
+        0x0020, 0x673d, 0x6c42, 0x6c72, 0x6ce3, 0x7078, 0x7403, 0x7a76, 0x7aae,
+        0x7b08, 0x7d1a, 0x7cfe, 0x7d66, 0x65e7, 0x725b, 0x53bb, 0x5c45, 0x5de8,
+        0x62d2, 0x62e0, 0x6319, 0x6e20, 0x865a, 0x8a31, 0x8ddd, 0x92f8, 0x6f01,
+        0x79a6, 0x9b5a, 0x4ea8, 0x4eab, 0x4eac, 0x4f9b, 0x4fa0, 0x50d1, 0x5147,
+        0x7af6, 0x5171, 0x51f6, 0x5354, 0x5321, 0x537f, 0x53eb, 0x55ac, 0x5883,
+        0x5ce1, 0x5f37, 0x5f4a, 0x602f, 0x6050, 0x606d, 0x631f, 0x6559, 0x6a4b,
+        0x6cc1, 0x72c2, 0x72ed, 0x77ef, 0x80f8, 0x8105, 0x8208, 0x854e, 0x90f7,
+        0x93e1, 0x97ff, 0x9957, 0x9a5a, 0x4ef0, 0x51dd, 0x5c2d, 0x6681, 0x696d,
+        0x5c40, 0x66f2, 0x6975, 0x7389, 0x6850, 0x7c81, 0x50c5, 0x52e4, 0x5747,
+        0x5dfe, 0x9326, 0x65a4, 0x6b23, 0x6b3d, 0x7434, 0x7981, 0x79bd, 0x7b4b,
+        0x7dca, 0x82b9, 0x83cc, 0x887f, 0x895f, 0x8b39, 0x8fd1, 0x91d1, 0x541f,
+        0x9280, 0x4e5d, 0x5036, 0x53e5, 0x533a, 0x72d7, 0x7396, 0x77e9, 0x82e6,
+        0x8eaf, 0x99c6, 0x99c8, 0x99d2, 0x5177, 0x611a, 0x865e, 0x55b0, 0x7a7a,
+        0x5076, 0x5bd3, 0x9047, 0x9685, 0x4e32, 0x6adb, 0x91e7, 0x5c51, 0x5c48,
+    },
+    {
+        // lead 0x8c
+        0x6398, 0x7a9f, 0x6c93, 0x9774, 0x8f61, 0x7aaa, 0x718a, 0x9688, 0x7c82,
+        0x6817, 0x7e70, 0x6851, 0x936c, 0x52f2, 0x541b, 0x85ab, 0x8a13, 0x7fa4,
+        0x8ecd, 0x90e1, 0x5366, 0x8888, 0x7941, 0x4fc2, 0x50be, 0x5211, 0x5144,
+        0x5553, 0x572d, 0x73ea, 0x578b, 0x5951, 0x5f62, 0x5f84, 0x6075, 0x6176,
+        0x6167, 0x61a9, 0x63b2, 0x643a, 0x656c, 0x666f, 0x6842, 0x6e13, 0x7566,
+        0x7a3d, 0x7cfb, 0x7d4c, 0x7d99, 0x7e4b, 0x7f6b, 0x830e, 0x834a, 0x86cd,
+        0x8a08, 0x8a63, 0x8b66, 0x8efd, 0x981a, 0x9d8f, 0x82b8, 0x8fce, 0x9be8,
+        0x0020, 0x5287, 0x621f, 0x6483, 0x6fc0, 0x9699, 0x6841, 0x5091, 0x6b20,
+        0x6c7a, 0x6f54, 0x7a74, 0x7d50, 0x8840, 0x8a23, 0x6708, 0x4ef6, 0x5039,
+        0x5026, 0x5065, 0x517c, 0x5238, 0x5263, 0x55a7, 0x570f, 0x5805, 0x5acc,
+        0x5efa, 0x61b2, 0x61f8, 0x62f3, 0x6372, 0x691c, 0x6a29, 0x727d, 0x72ac,
+        0x732e, 0x7814, 0x786f, 0x7d79, 0x770c, 0x80a9, 0x898b, 0x8b19, 0x8ce2,
+        0x8ed2, 0x9063, 0x9375, 0x967a, 0x9855, 0x9a13, 0x9e78, 0x5143, 0x539f,
+        0x53b3, 0x5e7b, 0x5f26, 0x6e1b, 0x6e90, 0x7384, 0x73fe, 0x7d43, 0x8237,
+        0x8a00, 0x8afa, 0x9650, 0x4e4e, 0x500b, 0x53e4, 0x547c, 0x56fa, 0x59d1,
+        0x5b64, 0x5df1, 0x5eab, 0x5f27, 0x6238, 0x6545, 0x67af, 0x6e56, 0x72d0,
+        0x7cca, 0x88b4, 0x80a1, 0x80e1, 0x83f0, 0x864e, 0x8a87, 0x8de8, 0x9237,
+        0x96c7, 0x9867, 0x9f13, 0x4e94, 0x4e92, 0x4f0d, 0x5348, 0x5449, 0x543e,
+        0x5a2f, 0x5f8c, 0x5fa1, 0x609f, 0x68a7, 0x6a8e, 0x745a, 0x7881, 0x8a9e,
+        0x8aa4, 0x8b77, 0x9190, 0x4e5e, 0x9bc9, 0x4ea4, 0x4f7c, 0x4faf, 0x5019,
+        0x5016, 0x5149, 0x516c, 0x529f, 0x52b9, 0x52fe, 0x539a, 0x53e3, 0x5411,
+    },
+    {
+        // lead 0x8d
+        0x540e, 0x5589, 0x5751, 0x57a2, 0x597d, 0x5b54, 0x5b5d, 0x5b8f, 0x5de5,
+        0x5de7, 0x5df7, 0x5e78, 0x5e83, 0x5e9a, 0x5eb7, 0x5f18, 0x6052, 0x614c,
+        0x6297, 0x62d8, 0x63a7, 0x653b, 0x6602, 0x6643, 0x66f4, 0x676d, 0x6821,
+        0x6897, 0x69cb, 0x6c5f, 0x6d2a, 0x6d69, 0x6e2f, 0x6e9d, 0x7532, 0x7687,
+        0x786c, 0x7a3f, 0x7ce0, 0x7d05, 0x7d18, 0x7d5e, 0x7db1, 0x8015, 0x8003,
+        0x80af, 0x80b1, 0x8154, 0x818f, 0x822a, 0x8352, 0x884c, 0x8861, 0x8b1b,
+        0x8ca2, 0x8cfc, 0x90ca, 0x9175, 0x9271, 0x783f, 0x92fc, 0x95a4, 0x964d,
+        0x0020, 0x9805, 0x9999, 0x9ad8, 0x9d3b, 0x525b, 0x52ab, 0x53f7, 0x5408,
+        0x58d5, 0x62f7, 0x6fe0, 0x8c6a, 0x8f5f, 0x9eb9, 0x514b, 0x523b, 0x544a,
+        0x56fd, 0x7a40, 0x9177, 0x9d60, 0x9ed2, 0x7344, 0x6f09, 0x8170, 0x7511,
+        0x5ffd, 0x60da, 0x9aa8, 0x72db, 0x8fbc, 0x6b64, 0x9803, 0x4eca, 0x56f0,
+        0x5764, 0x58be, 0x5a5a, 0x6068, 0x61c7, 0x660f, 0x6606, 0x6839, 0x68b1,
+        0x6df7, 0x75d5, 0x7d3a, 0x826e, 0x9b42, 0x4e9b, 0x4f50, 0x53c9, 0x5506,
+        0x5d6f, 0x5de6, 0x5dee, 0x67fb, 0x6c99, 0x7473, 0x7802, 0x8a50, 0x9396,
+        0x88df, 0x5750, 0x5ea7, 0x632b, 0x50b5, 0x50ac, 0x518d, 0x6700, 0x54c9,
+        0x585e, 0x59bb, 0x5bb0, 0x5f69, 0x624d, 0x63a1, 0x683d, 0x6b73, 0x6e08,
+        0x707d, 0x91c7, 0x7280, 0x7815, 0x7826, 0x796d, 0x658e, 0x7d30, 0x83dc,
+        0x88c1, 0x8f09, 0x969b, 0x5264, 0x5728, 0x6750, 0x7f6a, 0x8ca1, 0x51b4,
+        0x5742, 0x962a, 0x583a, 0x698a, 0x80b4, 0x54b2, 0x5d0e, 0x57fc, 0x7895,
+        0x9dfa, 0x4f5c, 0x524a, 0x548b, 0x643e, 0x6628, 0x6714, 0x67f5, 0x7a84,
+        0x7b56, 0x7d22, 0x932f, 0x685c, 0x9bad, 0x7b39, 0x5319, 0x518a, 0x5237,
+    },
+    {
+        // lead 0x8e
+        0x5bdf, 0x62f6, 0x64ae, 0x64e6, 0x672d, 0x6bba, 0x85a9, 0x96d1, 0x7690,
+        0x9bd6, 0x634c, 0x9306, 0x9bab, 0x76bf, 0x6652, 0x4e09, 0x5098, 0x53c2,
+        0x5c71, 0x60e8, 0x6492, 0x6563, 0x685f, 0x71e6, 0x73ca, 0x7523, 0x7b97,
+        0x7e82, 0x8695, 0x8b83, 0x8cdb, 0x9178, 0x9910, 0x65ac, 0x66ab, 0x6b8b,
+        0x4ed5, 0x4ed4, 0x4f3a, 0x4f7f, 0x523a, 0x53f8, 0x53f2, 0x55e3, 0x56db,
+        0x58eb, 0x59cb, 0x59c9, 0x59ff, 0x5b50, 0x5c4d, 0x5e02, 0x5e2b, 0x5fd7,
+        0x601d, 0x6307, 0x652f, 0x5b5c, 0x65af, 0x65bd, 0x65e8, 0x679d, 0x6b62,
+        0x0020, 0x6b7b, 0x6c0f, 0x7345, 0x7949, 0x79c1, 0x7cf8, 0x7d19, 0x7d2b,
+        0x80a2, 0x8102, 0x81f3, 0x8996, 0x8a5e, 0x8a69, 0x8a66, 0x8a8c, 0x8aee,
+        0x8cc7, 0x8cdc, 0x96cc, 0x98fc, 0x6b6f, 0x4e8b, 0x4f3c, 0x4f8d, 0x5150,
+        0x5b57, 0x5bfa, 0x6148, 0x6301, 0x6642, 0x6b21, 0x6ecb, 0x6cbb, 0x723e,
+        0x74bd, 0x75d4, 0x78c1, 0x793a, 0x800c, 0x8033, 0x81ea, 0x8494, 0x8f9e,
+        0x6c50, 0x9e7f, 0x5f0f, 0x8b58, 0x9d2b, 0x7afa, 0x8ef8, 0x5b8d, 0x96eb,
+        0x4e03, 0x53f1, 0x57f7, 0x5931, 0x5ac9, 0x5ba4, 0x6089, 0x6e7f, 0x6f06,
+        0x75be, 0x8cea, 0x5b9f, 0x8500, 0x7be0, 0x5072, 0x67f4, 0x829d, 0x5c61,
+        0x854a, 0x7e1e, 0x820e, 0x5199, 0x5c04, 0x6368, 0x8d66, 0x659c, 0x716e,
+        0x793e, 0x7d17, 0x8005, 0x8b1d, 0x8eca, 0x906e, 0x86c7, 0x90aa, 0x501f,
+        0x52fa, 0x5c3a, 0x6753, 0x707c, 0x7235, 0x914c, 0x91c8, 0x932b, 0x82e5,
+        0x5bc2, 0x5f31, 0x60f9, 0x4e3b, 0x53d6, 0x5b88, 0x624b, 0x6731, 0x6b8a,
+        0x72e9, 0x73e0, 0x7a2e, 0x816b, 0x8da3, 0x9152, 0x9996, 0x5112, 0x53d7,
+        0x546a, 0x5bff, 0x6388, 0x6a39, 0x7dac, 0x9700, 0x56da, 0x53ce, 0x5468,
+    },
+    {
+        // lead 0x8f
+        0x5b97, 0x5c31, 0x5dde, 0x4fee, 0x6101, 0x62fe, 0x6d32, 0x79c0, 0x79cb,
+        0x7d42, 0x7e4d, 0x7fd2, 0x81ed, 0x821f, 0x8490, 0x8846, 0x8972, 0x8b90,
+        0x8e74, 0x8f2f, 0x9031, 0x914b, 0x916c, 0x96c6, 0x919c, 0x4ec0, 0x4f4f,
+        0x5145, 0x5341, 0x5f93, 0x620e, 0x67d4, 0x6c41, 0x6e0b, 0x7363, 0x7e26,
+        0x91cd, 0x9283, 0x53d4, 0x5919, 0x5bbf, 0x6dd1, 0x795d, 0x7e2e, 0x7c9b,
+        0x587e, 0x719f, 0x51fa, 0x8853, 0x8ff0, 0x4fca, 0x5cfb, 0x6625, 0x77ac,
+        0x7ae3, 0x821c, 0x99ff, 0x51c6, 0x5faa, 0x65ec, 0x696f, 0x6b89, 0x6df3,
+        0x0020, 0x6e96, 0x6f64, 0x76fe, 0x7d14, 0x5de1, 0x9075, 0x9187, 0x9806,
+        0x51e6, 0x521d, 0x6240, 0x6691, 0x66d9, 0x6e1a, 0x5eb6, 0x7dd2, 0x7f72,
+        0x66f8, 0x85af, 0x85f7, 0x8af8, 0x52a9, 0x53d9, 0x5973, 0x5e8f, 0x5f90,
+        0x6055, 0x92e4, 0x9664, 0x50b7, 0x511f, 0x52dd, 0x5320, 0x5347, 0x53ec,
+        0x54e8, 0x5546, 0x5531, 0x5617, 0x5968, 0x59be, 0x5a3c, 0x5bb5, 0x5c06,
+        0x5c0f, 0x5c11, 0x5c1a, 0x5e84, 0x5e8a, 0x5ee0, 0x5f70, 0x627f, 0x6284,
+        0x62db, 0x638c, 0x6377, 0x6607, 0x660c, 0x662d, 0x6676, 0x677e, 0x68a2,
+        0x6a1f, 0x6a35, 0x6cbc, 0x6d88, 0x6e09, 0x6e58, 0x713c, 0x7126, 0x7167,
+        0x75c7, 0x7701, 0x785d, 0x7901, 0x7965, 0x79f0, 0x7ae0, 0x7b11, 0x7ca7,
+        0x7d39, 0x8096, 0x83d6, 0x848b, 0x8549, 0x885d, 0x88f3, 0x8a1f, 0x8a3c,
+        0x8a54, 0x8a73, 0x8c61, 0x8cde, 0x91a4, 0x9266, 0x937e, 0x9418, 0x969c,
+        0x9798, 0x4e0a, 0x4e08, 0x4e1e, 0x4e57, 0x5197, 0x5270, 0x57ce, 0x5834,
+        0x58cc, 0x5b22, 0x5e38, 0x60c5, 0x64fe, 0x6761, 0x6756, 0x6d44, 0x72b6,
+        0x7573, 0x7a63, 0x84b8, 0x8b72, 0x91b8, 0x9320, 0x5631, 0x57f4, 0x98fe,
+    },
+    {
+        // lead 0x90
+        0x62ed, 0x690d, 0x6b96, 0x71ed, 0x7e54, 0x8077, 0x8272, 0x89e6, 0x98df,
+        0x8755, 0x8fb1, 0x5c3b, 0x4f38, 0x4fe1, 0x4fb5, 0x5507, 0x5a20, 0x5bdd,
+        0x5be9, 0x5fc3, 0x614e, 0x632f, 0x65b0, 0x664b, 0x68ee, 0x699b, 0x6d78,
+        0x6df1, 0x7533, 0x75b9, 0x771f, 0x795e, 0x79e6, 0x7d33, 0x81e3, 0x82af,
+        0x85aa, 0x89aa, 0x8a3a, 0x8eab, 0x8f9b, 0x9032, 0x91dd, 0x9707, 0x4eba,
+        0x4ec1, 0x5203, 0x5875, 0x58ec, 0x5c0b, 0x751a, 0x5c3d, 0x814e, 0x8a0a,
+        0x8fc5, 0x9663, 0x976d, 0x7b25, 0x8acf, 0x9808, 0x9162, 0x56f3, 0x53a8,
+        0x0020, 0x9017, 0x5439, 0x5782, 0x5e25, 0x63a8, 0x6c34, 0x708a, 0x7761,
+        0x7c8b, 0x7fe0, 0x8870, 0x9042, 0x9154, 0x9310, 0x9318, 0x968f, 0x745e,
+        0x9ac4, 0x5d07, 0x5d69, 0x6570, 0x67a2, 0x8da8, 0x96db, 0x636e, 0x6749,
+        0x6919, 0x83c5, 0x9817, 0x96c0, 0x88fe, 0x6f84, 0x647a, 0x5bf8, 0x4e16,
+        0x702c, 0x755d, 0x662f, 0x51c4, 0x5236, 0x52e2, 0x59d3, 0x5f81, 0x6027,
+        0x6210, 0x653f, 0x6574, 0x661f, 0x6674, 0x68f2, 0x6816, 0x6b63, 0x6e05,
+        0x7272, 0x751f, 0x76db, 0x7cbe, 0x8056, 0x58f0, 0x88fd, 0x897f, 0x8aa0,
+        0x8a93, 0x8acb, 0x901d, 0x9192, 0x9752, 0x9759, 0x6589, 0x7a0e, 0x8106,
+        0x96bb, 0x5e2d, 0x60dc, 0x621a, 0x65a5, 0x6614, 0x6790, 0x77f3, 0x7a4d,
+        0x7c4d, 0x7e3e, 0x810a, 0x8cac, 0x8d64, 0x8de1, 0x8e5f, 0x78a9, 0x5207,
+        0x62d9, 0x63a5, 0x6442, 0x6298, 0x8a2d, 0x7a83, 0x7bc0, 0x8aac, 0x96ea,
+        0x7d76, 0x820c, 0x8749, 0x4ed9, 0x5148, 0x5343, 0x5360, 0x5ba3, 0x5c02,
+        0x5c16, 0x5ddd, 0x6226, 0x6247, 0x64b0, 0x6813, 0x6834, 0x6cc9, 0x6d45,
+        0x6d17, 0x67d3, 0x6f5c, 0x714e, 0x717d, 0x65cb, 0x7a7f, 0x7bad, 0x7dda,
+    },
+    {
+        // lead 0x91
+        0x7e4a, 0x7fa8, 0x817a, 0x821b, 0x8239, 0x85a6, 0x8a6e, 0x8cce, 0x8df5,
+        0x9078, 0x9077, 0x92ad, 0x9291, 0x9583, 0x9bae, 0x524d, 0x5584, 0x6f38,
+        0x7136, 0x5168, 0x7985, 0x7e55, 0x81b3, 0x7cce, 0x564c, 0x5851, 0x5ca8,
+        0x63aa, 0x66fe, 0x66fd, 0x695a, 0x72d9, 0x758f, 0x758e, 0x790e, 0x7956,
+        0x79df, 0x7c97, 0x7d20, 0x7d44, 0x8607, 0x8a34, 0x963b, 0x9061, 0x9f20,
+        0x50e7, 0x5275, 0x53cc, 0x53e2, 0x5009, 0x55aa, 0x58ee, 0x594f, 0x723d,
+        0x5b8b, 0x5c64, 0x531d, 0x60e3, 0x60f3, 0x635c, 0x6383, 0x633f, 0x63bb,
+        0x0020, 0x64cd, 0x65e9, 0x66f9, 0x5de3, 0x69cd, 0x69fd, 0x6f15, 0x71e5,
+        0x4e89, 0x75e9, 0x76f8, 0x7a93, 0x7cdf, 0x7dcf, 0x7d9c, 0x8061, 0x8349,
+        0x8358, 0x846c, 0x84bc, 0x85fb, 0x88c5, 0x8d70, 0x9001, 0x906d, 0x9397,
+        0x971c, 0x9a12, 0x50cf, 0x5897, 0x618e, 0x81d3, 0x8535, 0x8d08, 0x9020,
+        0x4fc3, 0x5074, 0x5247, 0x5373, 0x606f, 0x6349, 0x675f, 0x6e2c, 0x8db3,
+        0x901f, 0x4fd7, 0x5c5e, 0x8cca, 0x65cf, 0x7d9a, 0x5352, 0x8896, 0x5176,
+        0x63c3, 0x5b58, 0x5b6b, 0x5c0a, 0x640d, 0x6751, 0x905c, 0x4ed6, 0x591a,
+        0x592a, 0x6c70, 0x8a51, 0x553e, 0x5815, 0x59a5, 0x60f0, 0x6253, 0x67c1,
+        0x8235, 0x6955, 0x9640, 0x99c4, 0x9a28, 0x4f53, 0x5806, 0x5bfe, 0x8010,
+        0x5cb1, 0x5e2f, 0x5f85, 0x6020, 0x614b, 0x6234, 0x66ff, 0x6cf0, 0x6ede,
+        0x80ce, 0x817f, 0x82d4, 0x888b, 0x8cb8, 0x9000, 0x902e, 0x968a, 0x9edb,
+        0x9bdb, 0x4ee3, 0x53f0, 0x5927, 0x7b2c, 0x918d, 0x984c, 0x9df9, 0x6edd,
+        0x7027, 0x5353, 0x5544, 0x5b85, 0x6258, 0x629e, 0x62d3, 0x6ca2, 0x6fef,
+        0x7422, 0x8a17, 0x9438, 0x6fc1, 0x8afe, 0x8338, 0x51e7, 0x86f8, 0x53ea,
+    },
+    {
+        // lead 0x92
+        0x53e9, 0x4f46, 0x9054, 0x8fb0, 0x596a, 0x8131, 0x5dfd, 0x7aea, 0x8fbf,
+        0x68da, 0x8c37, 0x72f8, 0x9c48, 0x6a3d, 0x8ab0, 0x4e39, 0x5358, 0x5606,
+        0x5766, 0x62c5, 0x63a2, 0x65e6, 0x6b4e, 0x6de1, 0x6e5b, 0x70ad, 0x77ed,
+        0x7aef, 0x7baa, 0x7dbb, 0x803d, 0x80c6, 0x86cb, 0x8a95, 0x935b, 0x56e3,
+        0x58c7, 0x5f3e, 0x65ad, 0x6696, 0x6a80, 0x6bb5, 0x7537, 0x8ac7, 0x5024,
+        0x77e5, 0x5730, 0x5f1b, 0x6065, 0x667a, 0x6c60, 0x75f4, 0x7a1a, 0x7f6e,
+        0x81f4, 0x8718, 0x9045, 0x99b3, 0x7bc9, 0x755c, 0x7af9, 0x7b51, 0x84c4,
+        0x0020, 0x9010, 0x79e9, 0x7a92, 0x8336, 0x5ae1, 0x7740, 0x4e2d, 0x4ef2,
+        0x5b99, 0x5fe0, 0x62bd, 0x663c, 0x67f1, 0x6ce8, 0x866b, 0x8877, 0x8a3b,
+        0x914e, 0x92f3, 0x99d0, 0x6a17, 0x7026, 0x732a, 0x82e7, 0x8457, 0x8caf,
+        0x4e01, 0x5146, 0x51cb, 0x558b, 0x5bf5, 0x5e16, 0x5e33, 0x5e81, 0x5f14,
+        0x5f35, 0x5f6b, 0x5fb4, 0x61f2, 0x6311, 0x66a2, 0x671d, 0x6f6e, 0x7252,
+        0x753a, 0x773a, 0x8074, 0x8139, 0x8178, 0x8776, 0x8abf, 0x8adc, 0x8d85,
+        0x8df3, 0x929a, 0x9577, 0x9802, 0x9ce5, 0x52c5, 0x6357, 0x76f4, 0x6715,
+        0x6c88, 0x73cd, 0x8cc3, 0x93ae, 0x9673, 0x6d25, 0x589c, 0x690e, 0x69cc,
+        0x8ffd, 0x939a, 0x75db, 0x901a, 0x585a, 0x6802, 0x63b4, 0x69fb, 0x4f43,
+        0x6f2c, 0x67d8, 0x8fbb, 0x8526, 0x7db4, 0x9354, 0x693f, 0x6f70, 0x576a,
+        0x58f7, 0x5b2c, 0x7d2c, 0x722a, 0x540a, 0x91e3, 0x9db4, 0x4ead, 0x4f4e,
+        0x505c, 0x5075, 0x5243, 0x8c9e, 0x5448, 0x5824, 0x5b9a, 0x5e1d, 0x5e95,
+        0x5ead, 0x5ef7, 0x5f1f, 0x608c, 0x62b5, 0x633a, 0x63d0, 0x68af, 0x6c40,
+        0x7887, 0x798e, 0x7a0b, 0x7de0, 0x8247, 0x8a02, 0x8ae6, 0x8e44, 0x9013,
+    },
+    {
+        // lead 0x93
+        0x90b8, 0x912d, 0x91d8, 0x9f0e, 0x6ce5, 0x6458, 0x64e2, 0x6575, 0x6ef4,
+        0x7684, 0x7b1b, 0x9069, 0x93d1, 0x6eba, 0x54f2, 0x5fb9, 0x64a4, 0x8f4d,
+        0x8fed, 0x9244, 0x5178, 0x586b, 0x5929, 0x5c55, 0x5e97, 0x6dfb, 0x7e8f,
+        0x751c, 0x8cbc, 0x8ee2, 0x985b, 0x70b9, 0x4f1d, 0x6bbf, 0x6fb1, 0x7530,
+        0x96fb, 0x514e, 0x5410, 0x5835, 0x5857, 0x59ac, 0x5c60, 0x5f92, 0x6597,
+        0x675c, 0x6e21, 0x767b, 0x83df, 0x8ced, 0x9014, 0x90fd, 0x934d, 0x7825,
+        0x783a, 0x52aa, 0x5ea6, 0x571f, 0x5974, 0x6012, 0x5012, 0x515a, 0x51ac,
+        0x0020, 0x51cd, 0x5200, 0x5510, 0x5854, 0x5858, 0x5957, 0x5b95, 0x5cf6,
+        0x5d8b, 0x60bc, 0x6295, 0x642d, 0x6771, 0x6843, 0x68bc, 0x68df, 0x76d7,
+        0x6dd8, 0x6e6f, 0x6d9b, 0x706f, 0x71c8, 0x5f53, 0x75d8, 0x7977, 0x7b49,
+        0x7b54, 0x7b52, 0x7cd6, 0x7d71, 0x5230, 0x8463, 0x8569, 0x85e4, 0x8a0e,
+        0x8b04, 0x8c46, 0x8e0f, 0x9003, 0x900f, 0x9419, 0x9676, 0x982d, 0x9a30,
+        0x95d8, 0x50cd, 0x52d5, 0x540c, 0x5802, 0x5c0e, 0x61a7, 0x649e, 0x6d1e,
+        0x77b3, 0x7ae5, 0x80f4, 0x8404, 0x9053, 0x9285, 0x5ce0, 0x9d07, 0x533f,
+        0x5f97, 0x5fb3, 0x6d9c, 0x7279, 0x7763, 0x79bf, 0x7be4, 0x6bd2, 0x72ec,
+        0x8aad, 0x6803, 0x6a61, 0x51f8, 0x7a81, 0x6934, 0x5c4a, 0x9cf6, 0x82eb,
+        0x5bc5, 0x9149, 0x701e, 0x5678, 0x5c6f, 0x60c7, 0x6566, 0x6c8c, 0x8c5a,
+        0x9041, 0x9813, 0x5451, 0x66c7, 0x920d, 0x5948, 0x90a3, 0x5185, 0x4e4d,
+        0x51ea, 0x8599, 0x8b0e, 0x7058, 0x637a, 0x934b, 0x6962, 0x99b4, 0x7e04,
+        0x7577, 0x5357, 0x6960, 0x8edf, 0x96e3, 0x6c5d, 0x4e8c, 0x5c3c, 0x5f10,
+        0x8fe9, 0x5302, 0x8cd1, 0x8089, 0x8679, 0x5eff, 0x65e5, 0x4e73, 0x5165,
+    },
+    {
+        // lead 0x94
+        0x5982, 0x5c3f, 0x97ee, 0x4efb, 0x598a, 0x5fcd, 0x8a8d, 0x6fe1, 0x79b0,
+        0x7962, 0x5be7, 0x8471, 0x732b, 0x71b1, 0x5e74, 0x5ff5, 0x637b, 0x649a,
+        0x71c3, 0x7c98, 0x4e43, 0x5efc, 0x4e4b, 0x57dc, 0x56a2, 0x60a9, 0x6fc3,
+        0x7d0d, 0x80fd, 0x8133, 0x81bf, 0x8fb2, 0x8997, 0x86a4, 0x5df4, 0x628a,
+        0x64ad, 0x8987, 0x6777, 0x6ce2, 0x6d3e, 0x7436, 0x7834, 0x5a46, 0x7f75,
+        0x82ad, 0x99ac, 0x4ff3, 0x5ec3, 0x62dd, 0x6392, 0x6557, 0x676f, 0x76c3,
+        0x724c, 0x80cc, 0x80ba, 0x8f29, 0x914d, 0x500d, 0x57f9, 0x5a92, 0x6885,
+        0x0020, 0x6973, 0x7164, 0x72fd, 0x8cb7, 0x58f2, 0x8ce0, 0x966a, 0x9019,
+        0x877f, 0x79e4, 0x77e7, 0x8429, 0x4f2f, 0x5265, 0x535a, 0x62cd, 0x67cf,
+        0x6cca, 0x767d, 0x7b94, 0x7c95, 0x8236, 0x8584, 0x8feb, 0x66dd, 0x6f20,
+        0x7206, 0x7e1b, 0x83ab, 0x99c1, 0x9ea6, 0x51fd, 0x7bb1, 0x7872, 0x7bb8,
+        0x8087, 0x7b48, 0x6ae8, 0x5e61, 0x808c, 0x7551, 0x7560, 0x516b, 0x9262,
+        0x6e8c, 0x767a, 0x9197, 0x9aea, 0x4f10, 0x7f70, 0x629c, 0x7b4f, 0x95a5,
+        0x9ce9, 0x567a, 0x5859, 0x86e4, 0x96bc, 0x4f34, 0x5224, 0x534a, 0x53cd,
+        0x53db, 0x5e06, 0x642c, 0x6591, 0x677f, 0x6c3e, 0x6c4e, 0x7248, 0x72af,
+        0x73ed, 0x7554, 0x7e41, 0x822c, 0x85e9, 0x8ca9, 0x7bc4, 0x91c6, 0x7169,
+        0x9812, 0x98ef, 0x633d, 0x6669, 0x756a, 0x76e4, 0x78d0, 0x8543, 0x86ee,
+        0x532a, 0x5351, 0x5426, 0x5983, 0x5e87, 0x5f7c, 0x60b2, 0x6249, 0x6279,
+        0x62ab, 0x6590, 0x6bd4, 0x6ccc, 0x75b2, 0x76ae, 0x7891, 0x79d8, 0x7dcb,
+        0x7f77, 0x80a5, 0x88ab, 0x8ab9, 0x8cbb, 0x907f, 0x975e, 0x98db, 0x6a0b,
+        0x7c38, 0x5099, 0x5c3e, 0x5fae, 0x6787, 0x6bd8, 0x7435, 0x7709, 0x7f8e,
+    },
+    {
+        // lead 0x95
+        0x9f3b, 0x67ca, 0x7a17, 0x5339, 0x758b, 0x9aed, 0x5f66, 0x819d, 0x83f1,
+        0x8098, 0x5f3c, 0x5fc5, 0x7562, 0x7b46, 0x903c, 0x6867, 0x59eb, 0x5a9b,
+        0x7d10, 0x767e, 0x8b2c, 0x4ff5, 0x5f6a, 0x6a19, 0x6c37, 0x6f02, 0x74e2,
+        0x7968, 0x8868, 0x8a55, 0x8c79, 0x5edf, 0x63cf, 0x75c5, 0x79d2, 0x82d7,
+        0x9328, 0x92f2, 0x849c, 0x86ed, 0x9c2d, 0x54c1, 0x5f6c, 0x658c, 0x6d5c,
+        0x7015, 0x8ca7, 0x8cd3, 0x983b, 0x654f, 0x74f6, 0x4e0d, 0x4ed8, 0x57e0,
+        0x592b, 0x5a66, 0x5bcc, 0x51a8, 0x5e03, 0x5e9c, 0x6016, 0x6276, 0x6577,
+        0x0020, 0x65a7, 0x666e, 0x6d6e, 0x7236, 0x7b26, 0x8150, 0x819a, 0x8299,
+        0x8b5c, 0x8ca0, 0x8ce6, 0x8d74, 0x961c, 0x9644, 0x4fae, 0x64ab, 0x6b66,
+        0x821e, 0x8461, 0x856a, 0x90e8, 0x5c01, 0x6953, 0x98a8, 0x847a, 0x8557,
+        0x4f0f, 0x526f, 0x5fa9, 0x5e45, 0x670d, 0x798f, 0x8179, 0x8907, 0x8986,
+        0x6df5, 0x5f17, 0x6255, 0x6cb8, 0x4ecf, 0x7269, 0x9b92, 0x5206, 0x543b,
+        0x5674, 0x58b3, 0x61a4, 0x626e, 0x711a, 0x596e, 0x7c89, 0x7cde, 0x7d1b,
+        0x96f0, 0x6587, 0x805e, 0x4e19, 0x4f75, 0x5175, 0x5840, 0x5e63, 0x5e73,
+        0x5f0a, 0x67c4, 0x4e26, 0x853d, 0x9589, 0x965b, 0x7c73, 0x9801, 0x50fb,
+        0x58c1, 0x7656, 0x78a7, 0x5225, 0x77a5, 0x8511, 0x7b86, 0x504f, 0x5909,
+        0x7247, 0x7bc7, 0x7de8, 0x8fba, 0x8fd4, 0x904d, 0x4fbf, 0x52c9, 0x5a29,
+        0x5f01, 0x97ad, 0x4fdd, 0x8217, 0x92ea, 0x5703, 0x6355, 0x6b69, 0x752b,
+        0x88dc, 0x8f14, 0x7a42, 0x52df, 0x5893, 0x6155, 0x620a, 0x66ae, 0x6bcd,
+        0x7c3f, 0x83e9, 0x5023, 0x4ff8, 0x5305, 0x5446, 0x5831, 0x5949, 0x5b9d,
+        0x5cf0, 0x5cef, 0x5d29, 0x5e96, 0x62b1, 0x6367, 0x653e, 0x65b9, 0x670b,
+    },
+    {
+        // lead 0x96
+        0x6cd5, 0x6ce1, 0x70f9, 0x7832, 0x7e2b, 0x80de, 0x82b3, 0x840c, 0x84ec,
+        0x8702, 0x8912, 0x8a2a, 0x8c4a, 0x90a6, 0x92d2, 0x98fd, 0x9cf3, 0x9d6c,
+        0x4e4f, 0x4ea1, 0x508d, 0x5256, 0x574a, 0x59a8, 0x5e3d, 0x5fd8, 0x5fd9,
+        0x623f, 0x66b4, 0x671b, 0x67d0, 0x68d2, 0x5192, 0x7d21, 0x80aa, 0x81a8,
+        0x8b00, 0x8c8c, 0x8cbf, 0x927e, 0x9632, 0x5420, 0x982c, 0x5317, 0x50d5,
+        0x535c, 0x58a8, 0x64b2, 0x6734, 0x7267, 0x7766, 0x7a46, 0x91e6, 0x52c3,
+        0x6ca1, 0x6b86, 0x5800, 0x5e4c, 0x5954, 0x672c, 0x7ffb, 0x51e1, 0x76c6,
+        0x0020, 0x6469, 0x78e8, 0x9b54, 0x9ebb, 0x57cb, 0x59b9, 0x6627, 0x679a,
+        0x6bce, 0x54e9, 0x69d9, 0x5e55, 0x819c, 0x6795, 0x9baa, 0x67fe, 0x9c52,
+        0x685d, 0x4ea6, 0x4fe3, 0x53c8, 0x62b9, 0x672b, 0x6cab, 0x8fc4, 0x4fad,
+        0x7e6d, 0x9ebf, 0x4e07, 0x6162, 0x6e80, 0x6f2b, 0x8513, 0x5473, 0x672a,
+        0x9b45, 0x5df3, 0x7b95, 0x5cac, 0x5bc6, 0x871c, 0x6e4a, 0x84d1, 0x7a14,
+        0x8108, 0x5999, 0x7c8d, 0x6c11, 0x7720, 0x52d9, 0x5922, 0x7121, 0x725f,
+        0x77db, 0x9727, 0x9d61, 0x690b, 0x5a7f, 0x5a18, 0x51a5, 0x540d, 0x547d,
+        0x660e, 0x76df, 0x8ff7, 0x9298, 0x9cf4, 0x59ea, 0x725d, 0x6ec5, 0x514d,
+        0x68c9, 0x7dbf, 0x7dec, 0x9762, 0x9eba, 0x6478, 0x6a21, 0x8302, 0x5984,
+        0x5b5f, 0x6bdb, 0x731b, 0x76f2, 0x7db2, 0x8017, 0x8499, 0x5132, 0x6728,
+        0x9ed9, 0x76ee, 0x6762, 0x52ff, 0x9905, 0x5c24, 0x623b, 0x7c7e, 0x8cb0,
+        0x554f, 0x60b6, 0x7d0b, 0x9580, 0x5301, 0x4e5f, 0x51b6, 0x591c, 0x723a,
+        0x8036, 0x91ce, 0x5f25, 0x77e2, 0x5384, 0x5f79, 0x7d04, 0x85ac, 0x8a33,
+        0x8e8d, 0x9756, 0x67f3, 0x85ae, 0x9453, 0x6109, 0x6108, 0x6cb9, 0x7652,
+    },
+    {
+        // lead 0x97
+        0x8aed, 0x8f38, 0x552f, 0x4f51, 0x512a, 0x52c7, 0x53cb, 0x5ba5, 0x5e7d,
+        0x60a0, 0x6182, 0x63d6, 0x6709, 0x67da, 0x6e67, 0x6d8c, 0x7336, 0x7337,
+        0x7531, 0x7950, 0x88d5, 0x8a98, 0x904a, 0x9091, 0x90f5, 0x96c4, 0x878d,
+        0x5915, 0x4e88, 0x4f59, 0x4e0e, 0x8a89, 0x8f3f, 0x9810, 0x50ad, 0x5e7c,
+        0x5996, 0x5bb9, 0x5eb8, 0x63da, 0x63fa, 0x64c1, 0x66dc, 0x694a, 0x69d8,
+        0x6d0b, 0x6eb6, 0x7194, 0x7528, 0x7aaf, 0x7f8a, 0x8000, 0x8449, 0x84c9,
+        0x8981, 0x8b21, 0x8e0a, 0x9065, 0x967d, 0x990a, 0x617e, 0x6291, 0x6b32,
+        0x0020, 0x6c83, 0x6d74, 0x7fcc, 0x7ffc, 0x6dc0, 0x7f85, 0x87ba, 0x88f8,
+        0x6765, 0x83b1, 0x983c, 0x96f7, 0x6d1b, 0x7d61, 0x843d, 0x916a, 0x4e71,
+        0x5375, 0x5d50, 0x6b04, 0x6feb, 0x85cd, 0x862d, 0x89a7, 0x5229, 0x540f,
+        0x5c65, 0x674e, 0x68a8, 0x7406, 0x7483, 0x75e2, 0x88cf, 0x88e1, 0x91cc,
+        0x96e2, 0x9678, 0x5f8b, 0x7387, 0x7acb, 0x844e, 0x63a0, 0x7565, 0x5289,
+        0x6d41, 0x6e9c, 0x7409, 0x7559, 0x786b, 0x7c92, 0x9686, 0x7adc, 0x9f8d,
+        0x4fb6, 0x616e, 0x65c5, 0x865c, 0x4e86, 0x4eae, 0x50da, 0x4e21, 0x51cc,
+        0x5bee, 0x6599, 0x6881, 0x6dbc, 0x731f, 0x7642, 0x77ad, 0x7a1c, 0x7ce7,
+        0x826f, 0x8ad2, 0x907c, 0x91cf, 0x9675, 0x9818, 0x529b, 0x7dd1, 0x502b,
+        0x5398, 0x6797, 0x6dcb, 0x71d0, 0x7433, 0x81e8, 0x8f2a, 0x96a3, 0x9c57,
+        0x9e9f, 0x7460, 0x5841, 0x6d99, 0x7d2f, 0x985e, 0x4ee4, 0x4f36, 0x4f8b,
+        0x51b7, 0x52b1, 0x5dba, 0x601c, 0x73b2, 0x793c, 0x82d3, 0x9234, 0x96b7,
+        0x96f6, 0x970a, 0x9e97, 0x9f62, 0x66a6, 0x6b74, 0x5217, 0x52a3, 0x70c8,
+        0x88c2, 0x5ec9, 0x604b, 0x6190, 0x6f23, 0x7149, 0x7c3e, 0x7df4, 0x806f,
+    },
+    {
+        // lead 0x98
+        0x84ee, 0x9023, 0x932c, 0x5442, 0x9b6f, 0x6ad3, 0x7089, 0x8cc2, 0x8def,
+        0x9732, 0x52b4, 0x5a41, 0x5eca, 0x5f04, 0x6717, 0x697c, 0x6994, 0x6d6a,
+        0x6f0f, 0x7262, 0x72fc, 0x7bed, 0x8001, 0x807e, 0x874b, 0x90ce, 0x516d,
+        0x9e93, 0x7984, 0x808b, 0x9332, 0x8ad6, 0x502d, 0x548c, 0x8a71, 0x6b6a,
+        0x8cc4, 0x8107, 0x60d1, 0x67a0, 0x9df2, 0x4e99, 0x4e98, 0x9c10, 0x8a6b,
+        0x85c1, 0x8568, 0x6900, 0x6e7e, 0x7897, 0x8155, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x5f0c, 0x4e10, 0x4e15, 0x4e2a,
+        0x4e31, 0x4e36, 0x4e3c, 0x4e3f, 0x4e42, 0x4e56, 0x4e58, 0x4e82, 0x4e85,
+        0x8c6b, 0x4e8a, 0x8212, 0x5f0d, 0x4e8e, 0x4e9e, 0x4e9f, 0x4ea0, 0x4ea2,
+        0x4eb0, 0x4eb3, 0x4eb6, 0x4ece, 0x4ecd, 0x4ec4, 0x4ec6, 0x4ec2, 0x4ed7,
+        0x4ede, 0x4eed, 0x4edf, 0x4ef7, 0x4f09, 0x4f5a, 0x4f30, 0x4f5b, 0x4f5d,
+        0x4f57, 0x4f47, 0x4f76, 0x4f88, 0x4f8f, 0x4f98, 0x4f7b, 0x4f69, 0x4f70,
+        0x4f91, 0x4f6f, 0x4f86, 0x4f96, 0x5118, 0x4fd4, 0x4fdf, 0x4fce, 0x4fd8,
+        0x4fdb, 0x4fd1, 0x4fda, 0x4fd0, 0x4fe4, 0x4fe5, 0x501a, 0x5028, 0x5014,
+        0x502a, 0x5025, 0x5005, 0x4f1c, 0x4ff6, 0x5021, 0x5029, 0x502c, 0x4ffe,
+        0x4fef, 0x5011, 0x5006, 0x5043, 0x5047, 0x6703, 0x5055, 0x5050, 0x5048,
+        0x505a, 0x5056, 0x506c, 0x5078, 0x5080, 0x509a, 0x5085, 0x50b4, 0x50b2,
+    },
+    {
+        // lead 0x99
+        0x50c9, 0x50ca, 0x50b3, 0x50c2, 0x50d6, 0x50de, 0x50e5, 0x50ed, 0x50e3,
+        0x50ee, 0x50f9, 0x50f5, 0x5109, 0x5101, 0x5102, 0x5116, 0x5115, 0x5114,
+        0x511a, 0x5121, 0x513a, 0x5137, 0x513c, 0x513b, 0x513f, 0x5140, 0x5152,
+        0x514c, 0x5154, 0x5162, 0x7af8, 0x5169, 0x516a, 0x516e, 0x5180, 0x5182,
+        0x56d8, 0x518c, 0x5189, 0x518f, 0x5191, 0x5193, 0x5195, 0x5196, 0x51a4,
+        0x51a6, 0x51a2, 0x51a9, 0x51aa, 0x51ab, 0x51b3, 0x51b1, 0x51b2, 0x51b0,
+        0x51b5, 0x51bd, 0x51c5, 0x51c9, 0x51db, 0x51e0, 0x8655, 0x51e9, 0x51ed,
+        0x0020, 0x51f0, 0x51f5, 0x51fe, 0x5204, 0x520b, 0x5214, 0x520e, 0x5227,
+        0x522a, 0x522e, 0x5233, 0x5239, 0x524f, 0x5244, 0x524b, 0x524c, 0x525e,
+        0x5254, 0x526a, 0x5274, 0x5269, 0x5273, 0x527f, 0x527d, 0x528d, 0x5294,
+        0x5292, 0x5271, 0x5288, 0x5291, 0x8fa8, 0x8fa7, 0x52ac, 0x52ad, 0x52bc,
+        0x52b5, 0x52c1, 0x52cd, 0x52d7, 0x52de, 0x52e3, 0x52e6, 0x98ed, 0x52e0,
+        0x52f3, 0x52f5, 0x52f8, 0x52f9, 0x5306, 0x5308, 0x7538, 0x530d, 0x5310,
+        0x530f, 0x5315, 0x531a, 0x5323, 0x532f, 0x5331, 0x5333, 0x5338, 0x5340,
+        0x5346, 0x5345, 0x4e17, 0x5349, 0x534d, 0x51d6, 0x535e, 0x5369, 0x536e,
+        0x5918, 0x537b, 0x5377, 0x5382, 0x5396, 0x53a0, 0x53a6, 0x53a5, 0x53ae,
+        0x53b0, 0x53b6, 0x53c3, 0x7c12, 0x96d9, 0x53df, 0x66fc, 0x71ee, 0x53ee,
+        0x53e8, 0x53ed, 0x53fa, 0x5401, 0x543d, 0x5440, 0x542c, 0x542d, 0x543c,
+        0x542e, 0x5436, 0x5429, 0x541d, 0x544e, 0x548f, 0x5475, 0x548e, 0x545f,
+        0x5471, 0x5477, 0x5470, 0x5492, 0x547b, 0x5480, 0x5476, 0x5484, 0x5490,
+        0x5486, 0x54c7, 0x54a2, 0x54b8, 0x54a5, 0x54ac, 0x54c4, 0x54c8, 0x54a8,
+    },
+    {
+        // lead 0x9a
+        0x54ab, 0x54c2, 0x54a4, 0x54be, 0x54bc, 0x54d8, 0x54e5, 0x54e6, 0x550f,
+        0x5514, 0x54fd, 0x54ee, 0x54ed, 0x54fa, 0x54e2, 0x5539, 0x5540, 0x5563,
+        0x554c, 0x552e, 0x555c, 0x5545, 0x5556, 0x5557, 0x5538, 0x5533, 0x555d,
+        0x5599, 0x5580, 0x54af, 0x558a, 0x559f, 0x557b, 0x557e, 0x5598, 0x559e,
+        0x55ae, 0x557c, 0x5583, 0x55a9, 0x5587, 0x55a8, 0x55da, 0x55c5, 0x55df,
+        0x55c4, 0x55dc, 0x55e4, 0x55d4, 0x5614, 0x55f7, 0x5616, 0x55fe, 0x55fd,
+        0x561b, 0x55f9, 0x564e, 0x5650, 0x71df, 0x5634, 0x5636, 0x5632, 0x5638,
+        0x0020, 0x566b, 0x5664, 0x562f, 0x566c, 0x566a, 0x5686, 0x5680, 0x568a,
+        0x56a0, 0x5694, 0x568f, 0x56a5, 0x56ae, 0x56b6, 0x56b4, 0x56c2, 0x56bc,
+        0x56c1, 0x56c3, 0x56c0, 0x56c8, 0x56ce, 0x56d1, 0x56d3, 0x56d7, 0x56ee,
+        0x56f9, 0x5700, 0x56ff, 0x5704, 0x5709, 0x5708, 0x570b, 0x570d, 0x5713,
+        0x5718, 0x5716, 0x55c7, 0x571c, 0x5726, 0x5737, 0x5738, 0x574e, 0x573b,
+        0x5740, 0x574f, 0x5769, 0x57c0, 0x5788, 0x5761, 0x577f, 0x5789, 0x5793,
+        0x57a0, 0x57b3, 0x57a4, 0x57aa, 0x57b0, 0x57c3, 0x57c6, 0x57d4, 0x57d2,
+        0x57d3, 0x580a, 0x57d6, 0x57e3, 0x580b, 0x5819, 0x581d, 0x5872, 0x5821,
+        0x5862, 0x584b, 0x5870, 0x6bc0, 0x5852, 0x583d, 0x5879, 0x5885, 0x58b9,
+        0x589f, 0x58ab, 0x58ba, 0x58de, 0x58bb, 0x58b8, 0x58ae, 0x58c5, 0x58d3,
+        0x58d1, 0x58d7, 0x58d9, 0x58d8, 0x58e5, 0x58dc, 0x58e4, 0x58df, 0x58ef,
+        0x58fa, 0x58f9, 0x58fb, 0x58fc, 0x58fd, 0x5902, 0x590a, 0x5910, 0x591b,
+        0x68a6, 0x5925, 0x592c, 0x592d, 0x5932, 0x5938, 0x593e, 0x7ad2, 0x5955,
+        0x5950, 0x594e, 0x595a, 0x5958, 0x5962, 0x5960, 0x5967, 0x596c, 0x5969,
+    },
+    {
+        // lead 0x9b
+        0x5978, 0x5981, 0x599d, 0x4f5e, 0x4fab, 0x59a3, 0x59b2, 0x59c6, 0x59e8,
+        0x59dc, 0x598d, 0x59d9, 0x59da, 0x5a25, 0x5a1f, 0x5a11, 0x5a1c, 0x5a09,
+        0x5a1a, 0x5a40, 0x5a6c, 0x5a49, 0x5a35, 0x5a36, 0x5a62, 0x5a6a, 0x5a9a,
+        0x5abc, 0x5abe, 0x5acb, 0x5ac2, 0x5abd, 0x5ae3, 0x5ad7, 0x5ae6, 0x5ae9,
+        0x5ad6, 0x5afa, 0x5afb, 0x5b0c, 0x5b0b, 0x5b16, 0x5b32, 0x5ad0, 0x5b2a,
+        0x5b36, 0x5b3e, 0x5b43, 0x5b45, 0x5b40, 0x5b51, 0x5b55, 0x5b5a, 0x5b5b,
+        0x5b65, 0x5b69, 0x5b70, 0x5b73, 0x5b75, 0x5b78, 0x6588, 0x5b7a, 0x5b80,
+        0x0020, 0x5b83, 0x5ba6, 0x5bb8, 0x5bc3, 0x5bc7, 0x5bc9, 0x5bd4, 0x5bd0,
+        0x5be4, 0x5be6, 0x5be2, 0x5bde, 0x5be5, 0x5beb, 0x5bf0, 0x5bf6, 0x5bf3,
+        0x5c05, 0x5c07, 0x5c08, 0x5c0d, 0x5c13, 0x5c20, 0x5c22, 0x5c28, 0x5c38,
+        0x5c39, 0x5c41, 0x5c46, 0x5c4e, 0x5c53, 0x5c50, 0x5c4f, 0x5b71, 0x5c6c,
+        0x5c6e, 0x4e62, 0x5c76, 0x5c79, 0x5c8c, 0x5c91, 0x5c94, 0x599b, 0x5cab,
+        0x5cbb, 0x5cb6, 0x5cbc, 0x5cb7, 0x5cc5, 0x5cbe, 0x5cc7, 0x5cd9, 0x5ce9,
+        0x5cfd, 0x5cfa, 0x5ced, 0x5d8c, 0x5cea, 0x5d0b, 0x5d15, 0x5d17, 0x5d5c,
+        0x5d1f, 0x5d1b, 0x5d11, 0x5d14, 0x5d22, 0x5d1a, 0x5d19, 0x5d18, 0x5d4c,
+        0x5d52, 0x5d4e, 0x5d4b, 0x5d6c, 0x5d73, 0x5d76, 0x5d87, 0x5d84, 0x5d82,
+        0x5da2, 0x5d9d, 0x5dac, 0x5dae, 0x5dbd, 0x5d90, 0x5db7, 0x5dbc, 0x5dc9,
+        0x5dcd, 0x5dd3, 0x5dd2, 0x5dd6, 0x5ddb, 0x5deb, 0x5df2, 0x5df5, 0x5e0b,
+        0x5e1a, 0x5e19, 0x5e11, 0x5e1b, 0x5e36, 0x5e37, 0x5e44, 0x5e43, 0x5e40,
+        0x5e4e, 0x5e57, 0x5e54, 0x5e5f, 0x5e62, 0x5e64, 0x5e47, 0x5e75, 0x5e76,
+        0x5e7a, 0x9ebc, 0x5e7f, 0x5ea0, 0x5ec1, 0x5ec2, 0x5ec8, 0x5ed0, 0x5ecf,
+    },
+    {
+        // lead 0x9c
+        0x5ed6, 0x5ee3, 0x5edd, 0x5eda, 0x5edb, 0x5ee2, 0x5ee1, 0x5ee8, 0x5ee9,
+        0x5eec, 0x5ef1, 0x5ef3, 0x5ef0, 0x5ef4, 0x5ef8, 0x5efe, 0x5f03, 0x5f09,
+        0x5f5d, 0x5f5c, 0x5f0b, 0x5f11, 0x5f16, 0x5f29, 0x5f2d, 0x5f38, 0x5f41,
+        0x5f48, 0x5f4c, 0x5f4e, 0x5f2f, 0x5f51, 0x5f56, 0x5f57, 0x5f59, 0x5f61,
+        0x5f6d, 0x5f73, 0x5f77, 0x5f83, 0x5f82, 0x5f7f, 0x5f8a, 0x5f88, 0x5f91,
+        0x5f87, 0x5f9e, 0x5f99, 0x5f98, 0x5fa0, 0x5fa8, 0x5fad, 0x5fbc, 0x5fd6,
+        0x5ffb, 0x5fe4, 0x5ff8, 0x5ff1, 0x5fdd, 0x60b3, 0x5fff, 0x6021, 0x6060,
+        0x0020, 0x6019, 0x6010, 0x6029, 0x600e, 0x6031, 0x601b, 0x6015, 0x602b,
+        0x6026, 0x600f, 0x603a, 0x605a, 0x6041, 0x606a, 0x6077, 0x605f, 0x604a,
+        0x6046, 0x604d, 0x6063, 0x6043, 0x6064, 0x6042, 0x606c, 0x606b, 0x6059,
+        0x6081, 0x608d, 0x60e7, 0x6083, 0x609a, 0x6084, 0x609b, 0x6096, 0x6097,
+        0x6092, 0x60a7, 0x608b, 0x60e1, 0x60b8, 0x60e0, 0x60d3, 0x60b4, 0x5ff0,
+        0x60bd, 0x60c6, 0x60b5, 0x60d8, 0x614d, 0x6115, 0x6106, 0x60f6, 0x60f7,
+        0x6100, 0x60f4, 0x60fa, 0x6103, 0x6121, 0x60fb, 0x60f1, 0x610d, 0x610e,
+        0x6147, 0x613e, 0x6128, 0x6127, 0x614a, 0x613f, 0x613c, 0x612c, 0x6134,
+        0x613d, 0x6142, 0x6144, 0x6173, 0x6177, 0x6158, 0x6159, 0x615a, 0x616b,
+        0x6174, 0x616f, 0x6165, 0x6171, 0x615f, 0x615d, 0x6153, 0x6175, 0x6199,
+        0x6196, 0x6187, 0x61ac, 0x6194, 0x619a, 0x618a, 0x6191, 0x61ab, 0x61ae,
+        0x61cc, 0x61ca, 0x61c9, 0x61f7, 0x61c8, 0x61c3, 0x61c6, 0x61ba, 0x61cb,
+        0x7f79, 0x61cd, 0x61e6, 0x61e3, 0x61f6, 0x61fa, 0x61f4, 0x61ff, 0x61fd,
+        0x61fc, 0x61fe, 0x6200, 0x6208, 0x6209, 0x620d, 0x620c, 0x6214, 0x621b,
+    },
+    {
+        // lead 0x9d
+        0x621e, 0x6221, 0x622a, 0x622e, 0x6230, 0x6232, 0x6233, 0x6241, 0x624e,
+        0x625e, 0x6263, 0x625b, 0x6260, 0x6268, 0x627c, 0x6282, 0x6289, 0x627e,
+        0x6292, 0x6293, 0x6296, 0x62d4, 0x6283, 0x6294, 0x62d7, 0x62d1, 0x62bb,
+        0x62cf, 0x62ff, 0x62c6, 0x64d4, 0x62c8, 0x62dc, 0x62cc, 0x62ca, 0x62c2,
+        0x62c7, 0x629b, 0x62c9, 0x630c, 0x62ee, 0x62f1, 0x6327, 0x6302, 0x6308,
+        0x62ef, 0x62f5, 0x6350, 0x633e, 0x634d, 0x641c, 0x634f, 0x6396, 0x638e,
+        0x6380, 0x63ab, 0x6376, 0x63a3, 0x638f, 0x6389, 0x639f, 0x63b5, 0x636b,
+        0x0020, 0x6369, 0x63be, 0x63e9, 0x63c0, 0x63c6, 0x63e3, 0x63c9, 0x63d2,
+        0x63f6, 0x63c4, 0x6416, 0x6434, 0x6406, 0x6413, 0x6426, 0x6436, 0x651d,
+        0x6417, 0x6428, 0x640f, 0x6467, 0x646f, 0x6476, 0x644e, 0x652a, 0x6495,
+        0x6493, 0x64a5, 0x64a9, 0x6488, 0x64bc, 0x64da, 0x64d2, 0x64c5, 0x64c7,
+        0x64bb, 0x64d8, 0x64c2, 0x64f1, 0x64e7, 0x8209, 0x64e0, 0x64e1, 0x62ac,
+        0x64e3, 0x64ef, 0x652c, 0x64f6, 0x64f4, 0x64f2, 0x64fa, 0x6500, 0x64fd,
+        0x6518, 0x651c, 0x6505, 0x6524, 0x6523, 0x652b, 0x6534, 0x6535, 0x6537,
+        0x6536, 0x6538, 0x754b, 0x6548, 0x6556, 0x6555, 0x654d, 0x6558, 0x655e,
+        0x655d, 0x6572, 0x6578, 0x6582, 0x6583, 0x8b8a, 0x659b, 0x659f, 0x65ab,
+        0x65b7, 0x65c3, 0x65c6, 0x65c1, 0x65c4, 0x65cc, 0x65d2, 0x65db, 0x65d9,
+        0x65e0, 0x65e1, 0x65f1, 0x6772, 0x660a, 0x6603, 0x65fb, 0x6773, 0x6635,
+        0x6636, 0x6634, 0x661c, 0x664f, 0x6644, 0x6649, 0x6641, 0x665e, 0x665d,
+        0x6664, 0x6667, 0x6668, 0x665f, 0x6662, 0x6670, 0x6683, 0x6688, 0x668e,
+        0x6689, 0x6684, 0x6698, 0x669d, 0x66c1, 0x66b9, 0x66c9, 0x66be, 0x66bc,
+    },
+    {
+        // lead 0x9e
+        0x66c4, 0x66b8, 0x66d6, 0x66da, 0x66e0, 0x663f, 0x66e6, 0x66e9, 0x66f0,
+        0x66f5, 0x66f7, 0x670f, 0x6716, 0x671e, 0x6726, 0x6727, 0x9738, 0x672e,
+        0x673f, 0x6736, 0x6741, 0x6738, 0x6737, 0x6746, 0x675e, 0x6760, 0x6759,
+        0x6763, 0x6764, 0x6789, 0x6770, 0x67a9, 0x677c, 0x676a, 0x678c, 0x678b,
+        0x67a6, 0x67a1, 0x6785, 0x67b7, 0x67ef, 0x67b4, 0x67ec, 0x67b3, 0x67e9,
+        0x67b8, 0x67e4, 0x67de, 0x67dd, 0x67e2, 0x67ee, 0x67b9, 0x67ce, 0x67c6,
+        0x67e7, 0x6a9c, 0x681e, 0x6846, 0x6829, 0x6840, 0x684d, 0x6832, 0x684e,
+        0x0020, 0x68b3, 0x682b, 0x6859, 0x6863, 0x6877, 0x687f, 0x689f, 0x688f,
+        0x68ad, 0x6894, 0x689d, 0x689b, 0x6883, 0x6aae, 0x68b9, 0x6874, 0x68b5,
+        0x68a0, 0x68ba, 0x690f, 0x688d, 0x687e, 0x6901, 0x68ca, 0x6908, 0x68d8,
+        0x6922, 0x6926, 0x68e1, 0x690c, 0x68cd, 0x68d4, 0x68e7, 0x68d5, 0x6936,
+        0x6912, 0x6904, 0x68d7, 0x68e3, 0x6925, 0x68f9, 0x68e0, 0x68ef, 0x6928,
+        0x692a, 0x691a, 0x6923, 0x6921, 0x68c6, 0x6979, 0x6977, 0x695c, 0x6978,
+        0x696b, 0x6954, 0x697e, 0x696e, 0x6939, 0x6974, 0x693d, 0x6959, 0x6930,
+        0x6961, 0x695e, 0x695d, 0x6981, 0x696a, 0x69b2, 0x69ae, 0x69d0, 0x69bf,
+        0x69c1, 0x69d3, 0x69be, 0x69ce, 0x5be8, 0x69ca, 0x69dd, 0x69bb, 0x69c3,
+        0x69a7, 0x6a2e, 0x6991, 0x69a0, 0x699c, 0x6995, 0x69b4, 0x69de, 0x69e8,
+        0x6a02, 0x6a1b, 0x69ff, 0x6b0a, 0x69f9, 0x69f2, 0x69e7, 0x6a05, 0x69b1,
+        0x6a1e, 0x69ed, 0x6a14, 0x69eb, 0x6a0a, 0x6a12, 0x6ac1, 0x6a23, 0x6a13,
+        0x6a44, 0x6a0c, 0x6a72, 0x6a36, 0x6a78, 0x6a47, 0x6a62, 0x6a59, 0x6a66,
+        0x6a48, 0x6a38, 0x6a22, 0x6a90, 0x6a8d, 0x6aa0, 0x6a84, 0x6aa2, 0x6aa3,
+    },
+    {
+        // lead 0x9f
+        0x6a97, 0x8617, 0x6abb, 0x6ac3, 0x6ac2, 0x6ab8, 0x6ab3, 0x6aac, 0x6ade,
+        0x6ad1, 0x6adf, 0x6aaa, 0x6ada, 0x6aea, 0x6afb, 0x6b05, 0x8616, 0x6afa,
+        0x6b12, 0x6b16, 0x9b31, 0x6b1f, 0x6b38, 0x6b37, 0x76dc, 0x6b39, 0x98ee,
+        0x6b47, 0x6b43, 0x6b49, 0x6b50, 0x6b59, 0x6b54, 0x6b5b, 0x6b5f, 0x6b61,
+        0x6b78, 0x6b79, 0x6b7f, 0x6b80, 0x6b84, 0x6b83, 0x6b8d, 0x6b98, 0x6b95,
+        0x6b9e, 0x6ba4, 0x6baa, 0x6bab, 0x6baf, 0x6bb2, 0x6bb1, 0x6bb3, 0x6bb7,
+        0x6bbc, 0x6bc6, 0x6bcb, 0x6bd3, 0x6bdf, 0x6bec, 0x6beb, 0x6bf3, 0x6bef,
+        0x0020, 0x9ebe, 0x6c08, 0x6c13, 0x6c14, 0x6c1b, 0x6c24, 0x6c23, 0x6c5e,
+        0x6c55, 0x6c62, 0x6c6a, 0x6c82, 0x6c8d, 0x6c9a, 0x6c81, 0x6c9b, 0x6c7e,
+        0x6c68, 0x6c73, 0x6c92, 0x6c90, 0x6cc4, 0x6cf1, 0x6cd3, 0x6cbd, 0x6cd7,
+        0x6cc5, 0x6cdd, 0x6cae, 0x6cb1, 0x6cbe, 0x6cba, 0x6cdb, 0x6cef, 0x6cd9,
+        0x6cea, 0x6d1f, 0x884d, 0x6d36, 0x6d2b, 0x6d3d, 0x6d38, 0x6d19, 0x6d35,
+        0x6d33, 0x6d12, 0x6d0c, 0x6d63, 0x6d93, 0x6d64, 0x6d5a, 0x6d79, 0x6d59,
+        0x6d8e, 0x6d95, 0x6fe4, 0x6d85, 0x6df9, 0x6e15, 0x6e0a, 0x6db5, 0x6dc7,
+        0x6de6, 0x6db8, 0x6dc6, 0x6dec, 0x6dde, 0x6dcc, 0x6de8, 0x6dd2, 0x6dc5,
+        0x6dfa, 0x6dd9, 0x6de4, 0x6dd5, 0x6dea, 0x6dee, 0x6e2d, 0x6e6e, 0x6e2e,
+        0x6e19, 0x6e72, 0x6e5f, 0x6e3e, 0x6e23, 0x6e6b, 0x6e2b, 0x6e76, 0x6e4d,
+        0x6e1f, 0x6e43, 0x6e3a, 0x6e4e, 0x6e24, 0x6eff, 0x6e1d, 0x6e38, 0x6e82,
+        0x6eaa, 0x6e98, 0x6ec9, 0x6eb7, 0x6ed3, 0x6ebd, 0x6eaf, 0x6ec4, 0x6eb2,
+        0x6ed4, 0x6ed5, 0x6e8f, 0x6ea5, 0x6ec2, 0x6e9f, 0x6f41, 0x6f11, 0x704c,
+        0x6eec, 0x6ef8, 0x6efe, 0x6f3f, 0x6ef2, 0x6f31, 0x6eef, 0x6f32, 0x6ecc,
+    },
+    {
+        // lead 0xe0
+        0x6f3e, 0x6f13, 0x6ef7, 0x6f86, 0x6f7a, 0x6f78, 0x6f81, 0x6f80, 0x6f6f,
+        0x6f5b, 0x6ff3, 0x6f6d, 0x6f82, 0x6f7c, 0x6f58, 0x6f8e, 0x6f91, 0x6fc2,
+        0x6f66, 0x6fb3, 0x6fa3, 0x6fa1, 0x6fa4, 0x6fb9, 0x6fc6, 0x6faa, 0x6fdf,
+        0x6fd5, 0x6fec, 0x6fd4, 0x6fd8, 0x6ff1, 0x6fee, 0x6fdb, 0x7009, 0x700b,
+        0x6ffa, 0x7011, 0x7001, 0x700f, 0x6ffe, 0x701b, 0x701a, 0x6f74, 0x701d,
+        0x7018, 0x701f, 0x7030, 0x703e, 0x7032, 0x7051, 0x7063, 0x7099, 0x7092,
+        0x70af, 0x70f1, 0x70ac, 0x70b8, 0x70b3, 0x70ae, 0x70df, 0x70cb, 0x70dd,
+        0x0020, 0x70d9, 0x7109, 0x70fd, 0x711c, 0x7119, 0x7165, 0x7155, 0x7188,
+        0x7166, 0x7162, 0x714c, 0x7156, 0x716c, 0x718f, 0x71fb, 0x7184, 0x7195,
+        0x71a8, 0x71ac, 0x71d7, 0x71b9, 0x71be, 0x71d2, 0x71c9, 0x71d4, 0x71ce,
+        0x71e0, 0x71ec, 0x71e7, 0x71f5, 0x71fc, 0x71f9, 0x71ff, 0x720d, 0x7210,
+        0x721b, 0x7228, 0x722d, 0x722c, 0x7230, 0x7232, 0x723b, 0x723c, 0x723f,
+        0x7240, 0x7246, 0x724b, 0x7258, 0x7274, 0x727e, 0x7282, 0x7281, 0x7287,
+        0x7292, 0x7296, 0x72a2, 0x72a7, 0x72b9, 0x72b2, 0x72c3, 0x72c6, 0x72c4,
+        0x72ce, 0x72d2, 0x72e2, 0x72e0, 0x72e1, 0x72f9, 0x72f7, 0x500f, 0x7317,
+        0x730a, 0x731c, 0x7316, 0x731d, 0x7334, 0x732f, 0x7329, 0x7325, 0x733e,
+        0x734e, 0x734f, 0x9ed8, 0x7357, 0x736a, 0x7368, 0x7370, 0x7378, 0x7375,
+        0x737b, 0x737a, 0x73c8, 0x73b3, 0x73ce, 0x73bb, 0x73c0, 0x73e5, 0x73ee,
+        0x73de, 0x74a2, 0x7405, 0x746f, 0x7425, 0x73f8, 0x7432, 0x743a, 0x7455,
+        0x743f, 0x745f, 0x7459, 0x7441, 0x745c, 0x7469, 0x7470, 0x7463, 0x746a,
+        0x7476, 0x747e, 0x748b, 0x749e, 0x74a7, 0x74ca, 0x74cf, 0x74d4, 0x73f1,
+    },
+    {
+        // lead 0xe1
+        0x74e0, 0x74e3, 0x74e7, 0x74e9, 0x74ee, 0x74f2, 0x74f0, 0x74f1, 0x74f8,
+        0x74f7, 0x7504, 0x7503, 0x7505, 0x750c, 0x750e, 0x750d, 0x7515, 0x7513,
+        0x751e, 0x7526, 0x752c, 0x753c, 0x7544, 0x754d, 0x754a, 0x7549, 0x755b,
+        0x7546, 0x755a, 0x7569, 0x7564, 0x7567, 0x756b, 0x756d, 0x7578, 0x7576,
+        0x7586, 0x7587, 0x7574, 0x758a, 0x7589, 0x7582, 0x7594, 0x759a, 0x759d,
+        0x75a5, 0x75a3, 0x75c2, 0x75b3, 0x75c3, 0x75b5, 0x75bd, 0x75b8, 0x75bc,
+        0x75b1, 0x75cd, 0x75ca, 0x75d2, 0x75d9, 0x75e3, 0x75de, 0x75fe, 0x75ff,
+        0x0020, 0x75fc, 0x7601, 0x75f0, 0x75fa, 0x75f2, 0x75f3, 0x760b, 0x760d,
+        0x7609, 0x761f, 0x7627, 0x7620, 0x7621, 0x7622, 0x7624, 0x7634, 0x7630,
+        0x763b, 0x7647, 0x7648, 0x7646, 0x765c, 0x7658, 0x7661, 0x7662, 0x7668,
+        0x7669, 0x766a, 0x7667, 0x766c, 0x7670, 0x7672, 0x7676, 0x7678, 0x767c,
+        0x7680, 0x7683, 0x7688, 0x768b, 0x768e, 0x7696, 0x7693, 0x7699, 0x769a,
+        0x76b0, 0x76b4, 0x76b8, 0x76b9, 0x76ba, 0x76c2, 0x76cd, 0x76d6, 0x76d2,
+        0x76de, 0x76e1, 0x76e5, 0x76e7, 0x76ea, 0x862f, 0x76fb, 0x7708, 0x7707,
+        0x7704, 0x7729, 0x7724, 0x771e, 0x7725, 0x7726, 0x771b, 0x7737, 0x7738,
+        0x7747, 0x775a, 0x7768, 0x776b, 0x775b, 0x7765, 0x777f, 0x777e, 0x7779,
+        0x778e, 0x778b, 0x7791, 0x77a0, 0x779e, 0x77b0, 0x77b6, 0x77b9, 0x77bf,
+        0x77bc, 0x77bd, 0x77bb, 0x77c7, 0x77cd, 0x77d7, 0x77da, 0x77dc, 0x77e3,
+        0x77ee, 0x77fc, 0x780c, 0x7812, 0x7926, 0x7820, 0x792a, 0x7845, 0x788e,
+        0x7874, 0x7886, 0x787c, 0x789a, 0x788c, 0x78a3, 0x78b5, 0x78aa, 0x78af,
+        0x78d1, 0x78c6, 0x78cb, 0x78d4, 0x78be, 0x78bc, 0x78c5, 0x78ca, 0x78ec,
+    },
+    {
+        // lead 0xe2
+        0x78e7, 0x78da, 0x78fd, 0x78f4, 0x7907, 0x7912, 0x7911, 0x7919, 0x792c,
+        0x792b, 0x7940, 0x7960, 0x7957, 0x795f, 0x795a, 0x7955, 0x7953, 0x797a,
+        0x797f, 0x798a, 0x799d, 0x79a7, 0x9f4b, 0x79aa, 0x79ae, 0x79b3, 0x79b9,
+        0x79ba, 0x79c9, 0x79d5, 0x79e7, 0x79ec, 0x79e1, 0x79e3, 0x7a08, 0x7a0d,
+        0x7a18, 0x7a19, 0x7a20, 0x7a1f, 0x7980, 0x7a31, 0x7a3b, 0x7a3e, 0x7a37,
+        0x7a43, 0x7a57, 0x7a49, 0x7a61, 0x7a62, 0x7a69, 0x9f9d, 0x7a70, 0x7a79,
+        0x7a7d, 0x7a88, 0x7a97, 0x7a95, 0x7a98, 0x7a96, 0x7aa9, 0x7ac8, 0x7ab0,
+        0x0020, 0x7ab6, 0x7ac5, 0x7ac4, 0x7abf, 0x9083, 0x7ac7, 0x7aca, 0x7acd,
+        0x7acf, 0x7ad5, 0x7ad3, 0x7ad9, 0x7ada, 0x7add, 0x7ae1, 0x7ae2, 0x7ae6,
+        0x7aed, 0x7af0, 0x7b02, 0x7b0f, 0x7b0a, 0x7b06, 0x7b33, 0x7b18, 0x7b19,
+        0x7b1e, 0x7b35, 0x7b28, 0x7b36, 0x7b50, 0x7b7a, 0x7b04, 0x7b4d, 0x7b0b,
+        0x7b4c, 0x7b45, 0x7b75, 0x7b65, 0x7b74, 0x7b67, 0x7b70, 0x7b71, 0x7b6c,
+        0x7b6e, 0x7b9d, 0x7b98, 0x7b9f, 0x7b8d, 0x7b9c, 0x7b9a, 0x7b8b, 0x7b92,
+        0x7b8f, 0x7b5d, 0x7b99, 0x7bcb, 0x7bc1, 0x7bcc, 0x7bcf, 0x7bb4, 0x7bc6,
+        0x7bdd, 0x7be9, 0x7c11, 0x7c14, 0x7be6, 0x7be5, 0x7c60, 0x7c00, 0x7c07,
+        0x7c13, 0x7bf3, 0x7bf7, 0x7c17, 0x7c0d, 0x7bf6, 0x7c23, 0x7c27, 0x7c2a,
+        0x7c1f, 0x7c37, 0x7c2b, 0x7c3d, 0x7c4c, 0x7c43, 0x7c54, 0x7c4f, 0x7c40,
+        0x7c50, 0x7c58, 0x7c5f, 0x7c64, 0x7c56, 0x7c65, 0x7c6c, 0x7c75, 0x7c83,
+        0x7c90, 0x7ca4, 0x7cad, 0x7ca2, 0x7cab, 0x7ca1, 0x7ca8, 0x7cb3, 0x7cb2,
+        0x7cb1, 0x7cae, 0x7cb9, 0x7cbd, 0x7cc0, 0x7cc5, 0x7cc2, 0x7cd8, 0x7cd2,
+        0x7cdc, 0x7ce2, 0x9b3b, 0x7cef, 0x7cf2, 0x7cf4, 0x7cf6, 0x7cfa, 0x7d06,
+    },
+    {
+        // lead 0xe3
+        0x7d02, 0x7d1c, 0x7d15, 0x7d0a, 0x7d45, 0x7d4b, 0x7d2e, 0x7d32, 0x7d3f,
+        0x7d35, 0x7d46, 0x7d73, 0x7d56, 0x7d4e, 0x7d72, 0x7d68, 0x7d6e, 0x7d4f,
+        0x7d63, 0x7d93, 0x7d89, 0x7d5b, 0x7d8f, 0x7d7d, 0x7d9b, 0x7dba, 0x7dae,
+        0x7da3, 0x7db5, 0x7dc7, 0x7dbd, 0x7dab, 0x7e3d, 0x7da2, 0x7daf, 0x7ddc,
+        0x7db8, 0x7d9f, 0x7db0, 0x7dd8, 0x7ddd, 0x7de4, 0x7dde, 0x7dfb, 0x7df2,
+        0x7de1, 0x7e05, 0x7e0a, 0x7e23, 0x7e21, 0x7e12, 0x7e31, 0x7e1f, 0x7e09,
+        0x7e0b, 0x7e22, 0x7e46, 0x7e66, 0x7e3b, 0x7e35, 0x7e39, 0x7e43, 0x7e37,
+        0x0020, 0x7e32, 0x7e3a, 0x7e67, 0x7e5d, 0x7e56, 0x7e5e, 0x7e59, 0x7e5a,
+        0x7e79, 0x7e6a, 0x7e69, 0x7e7c, 0x7e7b, 0x7e83, 0x7dd5, 0x7e7d, 0x8fae,
+        0x7e7f, 0x7e88, 0x7e89, 0x7e8c, 0x7e92, 0x7e90, 0x7e93, 0x7e94, 0x7e96,
+        0x7e8e, 0x7e9b, 0x7e9c, 0x7f38, 0x7f3a, 0x7f45, 0x7f4c, 0x7f4d, 0x7f4e,
+        0x7f50, 0x7f51, 0x7f55, 0x7f54, 0x7f58, 0x7f5f, 0x7f60, 0x7f68, 0x7f69,
+        0x7f67, 0x7f78, 0x7f82, 0x7f86, 0x7f83, 0x7f88, 0x7f87, 0x7f8c, 0x7f94,
+        0x7f9e, 0x7f9d, 0x7f9a, 0x7fa3, 0x7faf, 0x7fb2, 0x7fb9, 0x7fae, 0x7fb6,
+        0x7fb8, 0x8b71, 0x7fc5, 0x7fc6, 0x7fca, 0x7fd5, 0x7fd4, 0x7fe1, 0x7fe6,
+        0x7fe9, 0x7ff3, 0x7ff9, 0x98dc, 0x8006, 0x8004, 0x800b, 0x8012, 0x8018,
+        0x8019, 0x801c, 0x8021, 0x8028, 0x803f, 0x803b, 0x804a, 0x8046, 0x8052,
+        0x8058, 0x805a, 0x805f, 0x8062, 0x8068, 0x8073, 0x8072, 0x8070, 0x8076,
+        0x8079, 0x807d, 0x807f, 0x8084, 0x8086, 0x8085, 0x809b, 0x8093, 0x809a,
+        0x80ad, 0x5190, 0x80ac, 0x80db, 0x80e5, 0x80d9, 0x80dd, 0x80c4, 0x80da,
+        0x80d6, 0x8109, 0x80ef, 0x80f1, 0x811b, 0x8129, 0x8123, 0x812f, 0x814b,
+    },
+    {
+        // lead 0xe4
+        0x968b, 0x8146, 0x813e, 0x8153, 0x8151, 0x80fc, 0x8171, 0x816e, 0x8165,
+        0x8166, 0x8174, 0x8183, 0x8188, 0x818a, 0x8180, 0x8182, 0x81a0, 0x8195,
+        0x81a4, 0x81a3, 0x815f, 0x8193, 0x81a9, 0x81b0, 0x81b5, 0x81be, 0x81b8,
+        0x81bd, 0x81c0, 0x81c2, 0x81ba, 0x81c9, 0x81cd, 0x81d1, 0x81d9, 0x81d8,
+        0x81c8, 0x81da, 0x81df, 0x81e0, 0x81e7, 0x81fa, 0x81fb, 0x81fe, 0x8201,
+        0x8202, 0x8205, 0x8207, 0x820a, 0x820d, 0x8210, 0x8216, 0x8229, 0x822b,
+        0x8238, 0x8233, 0x8240, 0x8259, 0x8258, 0x825d, 0x825a, 0x825f, 0x8264,
+        0x0020, 0x8262, 0x8268, 0x826a, 0x826b, 0x822e, 0x8271, 0x8277, 0x8278,
+        0x827e, 0x828d, 0x8292, 0x82ab, 0x829f, 0x82bb, 0x82ac, 0x82e1, 0x82e3,
+        0x82df, 0x82d2, 0x82f4, 0x82f3, 0x82fa, 0x8393, 0x8303, 0x82fb, 0x82f9,
+        0x82de, 0x8306, 0x82dc, 0x8309, 0x82d9, 0x8335, 0x8334, 0x8316, 0x8332,
+        0x8331, 0x8340, 0x8339, 0x8350, 0x8345, 0x832f, 0x832b, 0x8317, 0x8318,
+        0x8385, 0x839a, 0x83aa, 0x839f, 0x83a2, 0x8396, 0x8323, 0x838e, 0x8387,
+        0x838a, 0x837c, 0x83b5, 0x8373, 0x8375, 0x83a0, 0x8389, 0x83a8, 0x83f4,
+        0x8413, 0x83eb, 0x83ce, 0x83fd, 0x8403, 0x83d8, 0x840b, 0x83c1, 0x83f7,
+        0x8407, 0x83e0, 0x83f2, 0x840d, 0x8422, 0x8420, 0x83bd, 0x8438, 0x8506,
+        0x83fb, 0x846d, 0x842a, 0x843c, 0x855a, 0x8484, 0x8477, 0x846b, 0x84ad,
+        0x846e, 0x8482, 0x8469, 0x8446, 0x842c, 0x846f, 0x8479, 0x8435, 0x84ca,
+        0x8462, 0x84b9, 0x84bf, 0x849f, 0x84d9, 0x84cd, 0x84bb, 0x84da, 0x84d0,
+        0x84c1, 0x84c6, 0x84d6, 0x84a1, 0x8521, 0x84ff, 0x84f4, 0x8517, 0x8518,
+        0x852c, 0x851f, 0x8515, 0x8514, 0x84fc, 0x8540, 0x8563, 0x8558, 0x8548,
+    },
+    {
+        // lead 0xe5
+        0x8541, 0x8602, 0x854b, 0x8555, 0x8580, 0x85a4, 0x8588, 0x8591, 0x858a,
+        0x85a8, 0x856d, 0x8594, 0x859b, 0x85ea, 0x8587, 0x859c, 0x8577, 0x857e,
+        0x8590, 0x85c9, 0x85ba, 0x85cf, 0x85b9, 0x85d0, 0x85d5, 0x85dd, 0x85e5,
+        0x85dc, 0x85f9, 0x860a, 0x8613, 0x860b, 0x85fe, 0x85fa, 0x8606, 0x8622,
+        0x861a, 0x8630, 0x863f, 0x864d, 0x4e55, 0x8654, 0x865f, 0x8667, 0x8671,
+        0x8693, 0x86a3, 0x86a9, 0x86aa, 0x868b, 0x868c, 0x86b6, 0x86af, 0x86c4,
+        0x86c6, 0x86b0, 0x86c9, 0x8823, 0x86ab, 0x86d4, 0x86de, 0x86e9, 0x86ec,
+        0x0020, 0x86df, 0x86db, 0x86ef, 0x8712, 0x8706, 0x8708, 0x8700, 0x8703,
+        0x86fb, 0x8711, 0x8709, 0x870d, 0x86f9, 0x870a, 0x8734, 0x873f, 0x8737,
+        0x873b, 0x8725, 0x8729, 0x871a, 0x8760, 0x875f, 0x8778, 0x874c, 0x874e,
+        0x8774, 0x8757, 0x8768, 0x876e, 0x8759, 0x8753, 0x8763, 0x876a, 0x8805,
+        0x87a2, 0x879f, 0x8782, 0x87af, 0x87cb, 0x87bd, 0x87c0, 0x87d0, 0x96d6,
+        0x87ab, 0x87c4, 0x87b3, 0x87c7, 0x87c6, 0x87bb, 0x87ef, 0x87f2, 0x87e0,
+        0x880f, 0x880d, 0x87fe, 0x87f6, 0x87f7, 0x880e, 0x87d2, 0x8811, 0x8816,
+        0x8815, 0x8822, 0x8821, 0x8831, 0x8836, 0x8839, 0x8827, 0x883b, 0x8844,
+        0x8842, 0x8852, 0x8859, 0x885e, 0x8862, 0x886b, 0x8881, 0x887e, 0x889e,
+        0x8875, 0x887d, 0x88b5, 0x8872, 0x8882, 0x8897, 0x8892, 0x88ae, 0x8899,
+        0x88a2, 0x888d, 0x88a4, 0x88b0, 0x88bf, 0x88b1, 0x88c3, 0x88c4, 0x88d4,
+        0x88d8, 0x88d9, 0x88dd, 0x88f9, 0x8902, 0x88fc, 0x88f4, 0x88e8, 0x88f2,
+        0x8904, 0x890c, 0x890a, 0x8913, 0x8943, 0x891e, 0x8925, 0x892a, 0x892b,
+        0x8941, 0x8944, 0x893b, 0x8936, 0x8938, 0x894c, 0x891d, 0x8960, 0x895e,
+    },
+    {
+        // lead 0xe6
+        0x8966, 0x8964, 0x896d, 0x896a, 0x896f, 0x8974, 0x8977, 0x897e, 0x8983,
+        0x8988, 0x898a, 0x8993, 0x8998, 0x89a1, 0x89a9, 0x89a6, 0x89ac, 0x89af,
+        0x89b2, 0x89ba, 0x89bd, 0x89bf, 0x89c0, 0x89da, 0x89dc, 0x89dd, 0x89e7,
+        0x89f4, 0x89f8, 0x8a03, 0x8a16, 0x8a10, 0x8a0c, 0x8a1b, 0x8a1d, 0x8a25,
+        0x8a36, 0x8a41, 0x8a5b, 0x8a52, 0x8a46, 0x8a48, 0x8a7c, 0x8a6d, 0x8a6c,
+        0x8a62, 0x8a85, 0x8a82, 0x8a84, 0x8aa8, 0x8aa1, 0x8a91, 0x8aa5, 0x8aa6,
+        0x8a9a, 0x8aa3, 0x8ac4, 0x8acd, 0x8ac2, 0x8ada, 0x8aeb, 0x8af3, 0x8ae7,
+        0x0020, 0x8ae4, 0x8af1, 0x8b14, 0x8ae0, 0x8ae2, 0x8af7, 0x8ade, 0x8adb,
+        0x8b0c, 0x8b07, 0x8b1a, 0x8ae1, 0x8b16, 0x8b10, 0x8b17, 0x8b20, 0x8b33,
+        0x97ab, 0x8b26, 0x8b2b, 0x8b3e, 0x8b28, 0x8b41, 0x8b4c, 0x8b4f, 0x8b4e,
+        0x8b49, 0x8b56, 0x8b5b, 0x8b5a, 0x8b6b, 0x8b5f, 0x8b6c, 0x8b6f, 0x8b74,
+        0x8b7d, 0x8b80, 0x8b8c, 0x8b8e, 0x8b92, 0x8b93, 0x8b96, 0x8b99, 0x8b9a,
+        0x8c3a, 0x8c41, 0x8c3f, 0x8c48, 0x8c4c, 0x8c4e, 0x8c50, 0x8c55, 0x8c62,
+        0x8c6c, 0x8c78, 0x8c7a, 0x8c82, 0x8c89, 0x8c85, 0x8c8a, 0x8c8d, 0x8c8e,
+        0x8c94, 0x8c7c, 0x8c98, 0x621d, 0x8cad, 0x8caa, 0x8cbd, 0x8cb2, 0x8cb3,
+        0x8cae, 0x8cb6, 0x8cc8, 0x8cc1, 0x8ce4, 0x8ce3, 0x8cda, 0x8cfd, 0x8cfa,
+        0x8cfb, 0x8d04, 0x8d05, 0x8d0a, 0x8d07, 0x8d0f, 0x8d0d, 0x8d10, 0x9f4e,
+        0x8d13, 0x8ccd, 0x8d14, 0x8d16, 0x8d67, 0x8d6d, 0x8d71, 0x8d73, 0x8d81,
+        0x8d99, 0x8dc2, 0x8dbe, 0x8dba, 0x8dcf, 0x8dda, 0x8dd6, 0x8dcc, 0x8ddb,
+        0x8dcb, 0x8dea, 0x8deb, 0x8ddf, 0x8de3, 0x8dfc, 0x8e08, 0x8e09, 0x8dff,
+        0x8e1d, 0x8e1e, 0x8e10, 0x8e1f, 0x8e42, 0x8e35, 0x8e30, 0x8e34, 0x8e4a,
+    },
+    {
+        // lead 0xe7
+        0x8e47, 0x8e49, 0x8e4c, 0x8e50, 0x8e48, 0x8e59, 0x8e64, 0x8e60, 0x8e2a,
+        0x8e63, 0x8e55, 0x8e76, 0x8e72, 0x8e7c, 0x8e81, 0x8e87, 0x8e85, 0x8e84,
+        0x8e8b, 0x8e8a, 0x8e93, 0x8e91, 0x8e94, 0x8e99, 0x8eaa, 0x8ea1, 0x8eac,
+        0x8eb0, 0x8ec6, 0x8eb1, 0x8ebe, 0x8ec5, 0x8ec8, 0x8ecb, 0x8edb, 0x8ee3,
+        0x8efc, 0x8efb, 0x8eeb, 0x8efe, 0x8f0a, 0x8f05, 0x8f15, 0x8f12, 0x8f19,
+        0x8f13, 0x8f1c, 0x8f1f, 0x8f1b, 0x8f0c, 0x8f26, 0x8f33, 0x8f3b, 0x8f39,
+        0x8f45, 0x8f42, 0x8f3e, 0x8f4c, 0x8f49, 0x8f46, 0x8f4e, 0x8f57, 0x8f5c,
+        0x0020, 0x8f62, 0x8f63, 0x8f64, 0x8f9c, 0x8f9f, 0x8fa3, 0x8fad, 0x8faf,
+        0x8fb7, 0x8fda, 0x8fe5, 0x8fe2, 0x8fea, 0x8fef, 0x9087, 0x8ff4, 0x9005,
+        0x8ff9, 0x8ffa, 0x9011, 0x9015, 0x9021, 0x900d, 0x901e, 0x9016, 0x900b,
+        0x9027, 0x9036, 0x9035, 0x9039, 0x8ff8, 0x904f, 0x9050, 0x9051, 0x9052,
+        0x900e, 0x9049, 0x903e, 0x9056, 0x9058, 0x905e, 0x9068, 0x906f, 0x9076,
+        0x96a8, 0x9072, 0x9082, 0x907d, 0x9081, 0x9080, 0x908a, 0x9089, 0x908f,
+        0x90a8, 0x90af, 0x90b1, 0x90b5, 0x90e2, 0x90e4, 0x6248, 0x90db, 0x9102,
+        0x9112, 0x9119, 0x9132, 0x9130, 0x914a, 0x9156, 0x9158, 0x9163, 0x9165,
+        0x9169, 0x9173, 0x9172, 0x918b, 0x9189, 0x9182, 0x91a2, 0x91ab, 0x91af,
+        0x91aa, 0x91b5, 0x91b4, 0x91ba, 0x91c0, 0x91c1, 0x91c9, 0x91cb, 0x91d0,
+        0x91d6, 0x91df, 0x91e1, 0x91db, 0x91fc, 0x91f5, 0x91f6, 0x921e, 0x91ff,
+        0x9214, 0x922c, 0x9215, 0x9211, 0x925e, 0x9257, 0x9245, 0x9249, 0x9264,
+        0x9248, 0x9295, 0x923f, 0x924b, 0x9250, 0x929c, 0x9296, 0x9293, 0x929b,
+        0x925a, 0x92cf, 0x92b9, 0x92b7, 0x92e9, 0x930f, 0x92fa, 0x9344, 0x932e,
+    },
+    {
+        // lead 0xe8
+        0x9319, 0x9322, 0x931a, 0x9323, 0x933a, 0x9335, 0x933b, 0x935c, 0x9360,
+        0x937c, 0x936e, 0x9356, 0x93b0, 0x93ac, 0x93ad, 0x9394, 0x93b9, 0x93d6,
+        0x93d7, 0x93e8, 0x93e5, 0x93d8, 0x93c3, 0x93dd, 0x93d0, 0x93c8, 0x93e4,
+        0x941a, 0x9414, 0x9413, 0x9403, 0x9407, 0x9410, 0x9436, 0x942b, 0x9435,
+        0x9421, 0x943a, 0x9441, 0x9452, 0x9444, 0x945b, 0x9460, 0x9462, 0x945e,
+        0x946a, 0x9229, 0x9470, 0x9475, 0x9477, 0x947d, 0x945a, 0x947c, 0x947e,
+        0x9481, 0x947f, 0x9582, 0x9587, 0x958a, 0x9594, 0x9596, 0x9598, 0x9599,
+        0x0020, 0x95a0, 0x95a8, 0x95a7, 0x95ad, 0x95bc, 0x95bb, 0x95b9, 0x95be,
+        0x95ca, 0x6ff6, 0x95c3, 0x95cd, 0x95cc, 0x95d5, 0x95d4, 0x95d6, 0x95dc,
+        0x95e1, 0x95e5, 0x95e2, 0x9621, 0x9628, 0x962e, 0x962f, 0x9642, 0x964c,
+        0x964f, 0x964b, 0x9677, 0x965c, 0x965e, 0x965d, 0x965f, 0x9666, 0x9672,
+        0x966c, 0x968d, 0x9698, 0x9695, 0x9697, 0x96aa, 0x96a7, 0x96b1, 0x96b2,
+        0x96b0, 0x96b4, 0x96b6, 0x96b8, 0x96b9, 0x96ce, 0x96cb, 0x96c9, 0x96cd,
+        0x894d, 0x96dc, 0x970d, 0x96d5, 0x96f9, 0x9704, 0x9706, 0x9708, 0x9713,
+        0x970e, 0x9711, 0x970f, 0x9716, 0x9719, 0x9724, 0x972a, 0x9730, 0x9739,
+        0x973d, 0x973e, 0x9744, 0x9746, 0x9748, 0x9742, 0x9749, 0x975c, 0x9760,
+        0x9764, 0x9766, 0x9768, 0x52d2, 0x976b, 0x9771, 0x9779, 0x9785, 0x977c,
+        0x9781, 0x977a, 0x9786, 0x978b, 0x978f, 0x9790, 0x979c, 0x97a8, 0x97a6,
+        0x97a3, 0x97b3, 0x97b4, 0x97c3, 0x97c6, 0x97c8, 0x97cb, 0x97dc, 0x97ed,
+        0x9f4f, 0x97f2, 0x7adf, 0x97f6, 0x97f5, 0x980f, 0x980c, 0x9838, 0x9824,
+        0x9821, 0x9837, 0x983d, 0x9846, 0x984f, 0x984b, 0x986b, 0x986f, 0x9870,
+    },
+    {
+        // lead 0xe9
+        0x9871, 0x9874, 0x9873, 0x98aa, 0x98af, 0x98b1, 0x98b6, 0x98c4, 0x98c3,
+        0x98c6, 0x98e9, 0x98eb, 0x9903, 0x9909, 0x9912, 0x9914, 0x9918, 0x9921,
+        0x991d, 0x991e, 0x9924, 0x9920, 0x992c, 0x992e, 0x993d, 0x993e, 0x9942,
+        0x9949, 0x9945, 0x9950, 0x994b, 0x9951, 0x9952, 0x994c, 0x9955, 0x9997,
+        0x9998, 0x99a5, 0x99ad, 0x99ae, 0x99bc, 0x99df, 0x99db, 0x99dd, 0x99d8,
+        0x99d1, 0x99ed, 0x99ee, 0x99f1, 0x99f2, 0x99fb, 0x99f8, 0x9a01, 0x9a0f,
+        0x9a05, 0x99e2, 0x9a19, 0x9a2b, 0x9a37, 0x9a45, 0x9a42, 0x9a40, 0x9a43,
+        0x0020, 0x9a3e, 0x9a55, 0x9a4d, 0x9a5b, 0x9a57, 0x9a5f, 0x9a62, 0x9a65,
+        0x9a64, 0x9a69, 0x9a6b, 0x9a6a, 0x9aad, 0x9ab0, 0x9abc, 0x9ac0, 0x9acf,
+        0x9ad1, 0x9ad3, 0x9ad4, 0x9ade, 0x9adf, 0x9ae2, 0x9ae3, 0x9ae6, 0x9aef,
+        0x9aeb, 0x9aee, 0x9af4, 0x9af1, 0x9af7, 0x9afb, 0x9b06, 0x9b18, 0x9b1a,
+        0x9b1f, 0x9b22, 0x9b23, 0x9b25, 0x9b27, 0x9b28, 0x9b29, 0x9b2a, 0x9b2e,
+        0x9b2f, 0x9b32, 0x9b44, 0x9b43, 0x9b4f, 0x9b4d, 0x9b4e, 0x9b51, 0x9b58,
+        0x9b74, 0x9b93, 0x9b83, 0x9b91, 0x9b96, 0x9b97, 0x9b9f, 0x9ba0, 0x9ba8,
+        0x9bb4, 0x9bc0, 0x9bca, 0x9bb9, 0x9bc6, 0x9bcf, 0x9bd1, 0x9bd2, 0x9be3,
+        0x9be2, 0x9be4, 0x9bd4, 0x9be1, 0x9c3a, 0x9bf2, 0x9bf1, 0x9bf0, 0x9c15,
+        0x9c14, 0x9c09, 0x9c13, 0x9c0c, 0x9c06, 0x9c08, 0x9c12, 0x9c0a, 0x9c04,
+        0x9c2e, 0x9c1b, 0x9c25, 0x9c24, 0x9c21, 0x9c30, 0x9c47, 0x9c32, 0x9c46,
+        0x9c3e, 0x9c5a, 0x9c60, 0x9c67, 0x9c76, 0x9c78, 0x9ce7, 0x9cec, 0x9cf0,
+        0x9d09, 0x9d08, 0x9ceb, 0x9d03, 0x9d06, 0x9d2a, 0x9d26, 0x9daf, 0x9d23,
+        0x9d1f, 0x9d44, 0x9d15, 0x9d12, 0x9d41, 0x9d3f, 0x9d3e, 0x9d46, 0x9d48,
+    },
+    {
+        // lead 0xea
+        0x9d5d, 0x9d5e, 0x9d64, 0x9d51, 0x9d50, 0x9d59, 0x9d72, 0x9d89, 0x9d87,
+        0x9dab, 0x9d6f, 0x9d7a, 0x9d9a, 0x9da4, 0x9da9, 0x9db2, 0x9dc4, 0x9dc1,
+        0x9dbb, 0x9db8, 0x9dba, 0x9dc6, 0x9dcf, 0x9dc2, 0x9dd9, 0x9dd3, 0x9df8,
+        0x9de6, 0x9ded, 0x9def, 0x9dfd, 0x9e1a, 0x9e1b, 0x9e1e, 0x9e75, 0x9e79,
+        0x9e7d, 0x9e81, 0x9e88, 0x9e8b, 0x9e8c, 0x9e92, 0x9e95, 0x9e91, 0x9e9d,
+        0x9ea5, 0x9ea9, 0x9eb8, 0x9eaa, 0x9ead, 0x9761, 0x9ecc, 0x9ece, 0x9ecf,
+        0x9ed0, 0x9ed4, 0x9edc, 0x9ede, 0x9edd, 0x9ee0, 0x9ee5, 0x9ee8, 0x9eef,
+        0x0020, 0x9ef4, 0x9ef6, 0x9ef7, 0x9ef9, 0x9efb, 0x9efc, 0x9efd, 0x9f07,
+        0x9f08, 0x76b7, 0x9f15, 0x9f21, 0x9f2c, 0x9f3e, 0x9f4a, 0x9f52, 0x9f54,
+        0x9f63, 0x9f5f, 0x9f60, 0x9f61, 0x9f66, 0x9f67, 0x9f6c, 0x9f6a, 0x9f77,
+        0x9f72, 0x9f76, 0x9f95, 0x9f9c, 0x9fa0, 0x582f, 0x69c7, 0x9059, 0x7464,
+        0x51dc, 0x7199, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+        0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    },
+};
+
+// Bytes below 0x80 convert to themselves, except for 0x5C (YEN SIGN),
+// 0x7E (OVERLINE) and 0x7F (space). Those and every byte >= 0x80 have to go
+// through the table, so the scanners below stop at them.
+inline bool IsIdentityByte(unsigned char c) {
+  return c < 0x80 && c != 0x5C && c != 0x7E && c != 0x7F;
+}
+
+size_t IdentityRunScalar(const unsigned char *input, size_t size) {
+  size_t i = 0;
+  while (i < size && IsIdentityByte(input[i])) {
+    ++i;
+  }
+  return i;
+}
+
+#if BMS_PARSER_X86
+BMS_PARSER_TARGET("sse2")
+size_t IdentityRunSse2(const unsigned char *input, size_t size) {
+  const __m128i yen = _mm_set1_epi8(0x5C);
+  const __m128i overline = _mm_set1_epi8(0x7E);
+  const __m128i del = _mm_set1_epi8(0x7F);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, yen), _mm_cmpeq_epi8(v, overline)),
+        _mm_cmpeq_epi8(v, del));
+    // the sign bit is set for bytes >= 0x80 and for every special match
+    const auto mask =
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(v, special)));
+    if (mask != 0) {
+      return i + CpuFeatures::CountTrailingZeros(mask);
+    }
+  }
+  return i + IdentityRunScalar(input + i, size - i);
+}
+
+BMS_PARSER_TARGET("avx2")
+size_t IdentityRunAvx2(const unsigned char *input, size_t size) {
+  const __m256i yen = _mm256_set1_epi8(0x5C);
+  const __m256i overline = _mm256_set1_epi8(0x7E);
+  const __m256i del = _mm256_set1_epi8(0x7F);
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const __m256i special = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, yen),
+                        _mm256_cmpeq_epi8(v, overline)),
+        _mm256_cmpeq_epi8(v, del));
+    const auto mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_or_si256(v, special)));
+    if (mask != 0) {
+      return i + CpuFeatures::CountTrailingZeros(mask);
+    }
+  }
+  return i + IdentityRunSse2(input + i, size - i);
+}
+#endif
+
+using IdentityRunFn = size_t (*)(const unsigned char *, size_t);
+
+IdentityRunFn SelectIdentityRun() {
+#if BMS_PARSER_X86
+  if (CpuFeatures::HasAVX2()) {
+    return IdentityRunAvx2;
+  }
+  if (CpuFeatures::HasSSE2()) {
+    return IdentityRunSse2;
+  }
+#endif
+  return IdentityRunScalar;
+}
+} // namespace
+
+void ShiftJISConverter::BytesToUTF8(const unsigned char *input, size_t size,
+                                    std::string &result) {
+  static const IdentityRunFn identityRun = SelectIdentityRun();
+  // ShiftJis won't give 4byte UTF8, so max. 3 byte per input char are needed
+  result.resize(size * 3, ' ');
+  size_t indexInput = 0, indexOutput = 0;
+
+  while (indexInput < size) {
+    // bulk-copy plain ASCII, which is nearly all of a BMS file; skip the
+    // scanner while inside a run of double-byte characters
+    if (IsIdentityByte(input[indexInput])) {
+      const size_t run = identityRun(input + indexInput, size - indexInput);
+      std::memcpy(&result[indexOutput], input + indexInput, run);
+      indexInput += run;
+      indexOutput += run;
+      if (indexInput >= size) {
+        break;
+      }
+    }
+
+    uint16_t unicodeValue;
+    const unsigned char lead = input[indexInput++];
+    const unsigned char page = shiftJIS_leadPage[lead];
+    if (page == shiftJIS_noPage) {
+      unicodeValue = shiftJIS_singleByte[lead]; // this is one byte shiftjis
+    } else {
+      // these are two-byte shiftjis
+      if (indexInput >= size) {
+        break;
+      }
+      const unsigned char trail = input[indexInput++];
+      unicodeValue = trail >= shiftJIS_trailFirst && trail <= shiftJIS_trailLast
+                         ? shiftJIS_pages[page][trail - shiftJIS_trailFirst]
+                         : 0x20;
+    }
+
+    // converting to UTF8
+    if (unicodeValue < 0x80) {
+      result[indexOutput++] = unicodeValue;
+    } else if (unicodeValue < 0x800) {
+      result[indexOutput++] = 0xC0 | (unicodeValue >> 6);
+      result[indexOutput++] = 0x80 | (unicodeValue & 0x3f);
+    } else {
+      result[indexOutput++] = 0xE0 | (unicodeValue >> 12);
+      result[indexOutput++] = 0x80 | ((unicodeValue & 0xfff) >> 6);
+      result[indexOutput++] = 0x80 | (unicodeValue & 0x3f);
+    }
+  }
+
+  result.resize(indexOutput);
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+namespace {
+size_t AsciiRunScalar(const unsigned char *input, size_t size) {
+  size_t i = 0;
+  while (i < size && input[i] < 0x80) {
+    ++i;
+  }
+  return i;
+}
+
+#if BMS_PARSER_X86
+BMS_PARSER_TARGET("sse2")
+size_t AsciiRunSse2(const unsigned char *input, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+    if (mask != 0) {
+      return i + CpuFeatures::CountTrailingZeros(mask);
+    }
+  }
+  return i + AsciiRunScalar(input + i, size - i);
+}
+
+BMS_PARSER_TARGET("avx2")
+size_t AsciiRunAvx2(const unsigned char *input, size_t size) {
+  size_t i = 0;
+  // two vectors per step; ASCII is by far the common case
+  for (; i + 64 <= size; i += 64) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0) {
+      break;
+    }
+  }
+  for (; i + 32 <= size; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    if (mask != 0) {
+      return i + CpuFeatures::CountTrailingZeros(mask);
+    }
+  }
+  return i + AsciiRunSse2(input + i, size - i);
+}
+#endif
+
+using AsciiRunFn = size_t (*)(const unsigned char *, size_t);
+
+AsciiRunFn SelectAsciiRun() {
+#if BMS_PARSER_X86
+  if (CpuFeatures::HasAVX2()) {
+    return AsciiRunAvx2;
+  }
+  if (CpuFeatures::HasSSE2()) {
+    return AsciiRunSse2;
+  }
+#endif
+  return AsciiRunScalar;
+}
+
+// Length of the well-formed UTF-8 sequence starting at input (RFC 3629), or
+// 0 if it is malformed. input[0] must be >= 0x80.
+size_t Utf8SequenceLength(const unsigned char *input, size_t size) {
+  const unsigned char lead = input[0];
+  size_t length;
+  unsigned char low = 0x80, high = 0xBF; // bounds of the second byte
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    length = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+    if (lead == 0xE0) {
+      low = 0xA0; // overlong
+    } else if (lead == 0xED) {
+      high = 0x9F; // surrogates
+    }
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    length = 4;
+    if (lead == 0xF0) {
+      low = 0x90; // overlong
+    } else if (lead == 0xF4) {
+      high = 0x8F; // above U+10FFFF
+    }
+  } else {
+    return 0;
+  }
+  if (size < length || input[1] < low || input[1] > high) {
+    return 0;
+  }
+  for (size_t i = 2; i < length; ++i) {
+    if ((input[i] & 0xC0) != 0x80) {
+      return 0;
+    }
+  }
+  return length;
+}
+} // namespace
+
+bool TextEncodings::IsValidUTF8(const unsigned char *input, size_t size,
+                                bool &isAscii) {
+  static const AsciiRunFn asciiRun = SelectAsciiRun();
+  isAscii = true;
+  size_t i = 0;
+  while (i < size) {
+    i += asciiRun(input + i, size - i);
+    if (i >= size) {
+      break;
+    }
+    isAscii = false;
+    const size_t length = Utf8SequenceLength(input + i, size - i);
+    if (length == 0) {
+      return false;
+    }
+    i += length;
+  }
+  return true;
+}
+
+TextEncoding TextEncodings::Detect(const unsigned char *input, size_t size,
+                                   size_t &bomLength) {
+  bomLength = 0;
+  if (size >= 3 && input[0] == 0xEF && input[1] == 0xBB && input[2] == 0xBF) {
+    bomLength = 3;
+    return TextEncoding::UTF8;
+  }
+  bool isAscii;
+  if (IsValidUTF8(input, size, isAscii) && !isAscii) {
+    return TextEncoding::UTF8;
+  }
+  return TextEncoding::ShiftJIS;
+}
+
+void TextEncodings::ToUTF8(TextEncoding encoding, const unsigned char *input,
+                           size_t size, std::string &result) {
+  switch (encoding) {
+  case TextEncoding::UTF8:
+    result.assign(reinterpret_cast<const char *>(input), size);
+    break;
+  case TextEncoding::ShiftJIS:
+  default:
+    ShiftJISConverter::BytesToUTF8(input, size, result);
+    break;
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+namespace bms_parser {
+namespace {
+// the pool and queue of the calling thread, if it is a pool thread
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  Queues.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    Queues.push_back(std::make_unique<Queue>());
+  }
+  Threads.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    Threads.emplace_back([this, i] { Run(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(WakeMutex);
+    Stopping = true;
+  }
+  Wake.notify_all();
+  for (auto &thread : Threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> job) {
+  const auto target = currentPool == this
+                          ? currentQueue
+                          : NextQueue.fetch_add(1, std::memory_order_relaxed) %
+                                Queues.size();
+  // count first so that Pending never drops below the queued jobs
+  Pending.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(Queues[target]->Mutex);
+    Queues[target]->Jobs.push_back(std::move(job));
+  }
+  {
+    // pairs with the wait in Run so the wake-up can't slip in between a
+    // worker's check and its sleep
+    std::lock_guard<std::mutex> lock(WakeMutex);
+  }
+  Wake.notify_one();
+}
+
+bool ThreadPool::TryTake(size_t self, std::function<void()> &job) {
+  {
+    auto &own = *Queues[self];
+    std::lock_guard<std::mutex> lock(own.Mutex);
+    if (!own.Jobs.empty()) {
+      job = std::move(own.Jobs.back());
+      own.Jobs.pop_back();
+      Pending.fetch_sub(1);
+      return true;
+    }
+  }
+  for (size_t i = 1; i < Queues.size(); ++i) {
+    auto &victim = *Queues[(self + i) % Queues.size()];
+    std::lock_guard<std::mutex> lock(victim.Mutex);
+    if (!victim.Jobs.empty()) {
+      job = std::move(victim.Jobs.front());
+      victim.Jobs.pop_front();
+      Pending.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::Run(size_t self) {
+  currentPool = this;
+  currentQueue = self;
+  std::function<void()> job;
+  while (true) {
+    if (TryTake(self, job)) {
+      job();
+      job = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(WakeMutex);
+    Wake.wait(lock, [this] { return Stopping || Pending.load() > 0; });
+    if (Stopping && Pending.load() == 0) {
+      return;
+    }
+  }
+}
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+namespace bms_parser {
+TimeLine::TimeLine([[maybe_unused]] int lanes, [[maybe_unused]] bool metaOnly) {
+  assert(lanes <= MaxLanes);
+}
+
+TimeLine *TimeLine::SetNote(int lane, Note *note) {
+  Notes.Set(lane, note);
+  note->Lane = lane;
+  note->Timeline = this;
+  return this;
+}
+
+TimeLine *TimeLine::SetInvisibleNote(int lane, Note *note) {
+  InvisibleNotes.Set(lane, note);
+  note->Lane = lane;
+  note->Timeline = this;
+  return this;
+}
+
+TimeLine *TimeLine::SetLandmineNote(int lane, LandmineNote *note) {
+  LandmineNotes.Set(lane, note);
+  note->Lane = lane;
+  note->Timeline = this;
+  return this;
+}
+
+TimeLine *TimeLine::AddBackgroundNote(Note *note) {
+  BackgroundNotes.push_back(note);
+  note->Timeline = this;
+  return this;
+}
+
+double TimeLine::GetStopDuration() const {
+  return 1250000.0 * StopLength / Bpm; // 1250000 = 240 * 1000 * 1000 / 192
+}
+
+TimeLine::~TimeLine() = default;
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+namespace bms_parser {
+namespace {
+constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t RotateLeft64(uint64_t x, int n) {
+  return (x << n) | (x >> (64 - n));
+}
+
+// little-endian whatever the host is; compilers turn these into plain loads
+inline uint64_t Read64(const unsigned char *p) {
+  return static_cast<uint64_t>(p[0]) | static_cast<uint64_t>(p[1]) << 8 |
+         static_cast<uint64_t>(p[2]) << 16 | static_cast<uint64_t>(p[3]) << 24 |
+         static_cast<uint64_t>(p[4]) << 32 | static_cast<uint64_t>(p[5]) << 40 |
+         static_cast<uint64_t>(p[6]) << 48 | static_cast<uint64_t>(p[7]) << 56;
+}
+
+inline uint64_t Read32(const unsigned char *p) {
+  return static_cast<uint64_t>(p[0]) | static_cast<uint64_t>(p[1]) << 8 |
+         static_cast<uint64_t>(p[2]) << 16 | static_cast<uint64_t>(p[3]) << 24;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+  acc += input * Prime2;
+  acc = RotateLeft64(acc, 31);
+  return acc * Prime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t value) {
+  acc ^= Round(0, value);
+  return acc * Prime1 + Prime4;
+}
+} // namespace
+
+uint64_t XXHash64(const unsigned char *bytes, size_t size, uint64_t seed) {
+  const unsigned char *p = bytes;
+  const unsigned char *const end = bytes + size;
+  uint64_t hash;
+  if (size >= 32) {
+    uint64_t v1 = seed + Prime1 + Prime2;
+    uint64_t v2 = seed + Prime2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - Prime1;
+    for (; end - p >= 32; p += 32) {
+      v1 = Round(v1, Read64(p));
+      v2 = Round(v2, Read64(p + 8));
+      v3 = Round(v3, Read64(p + 16));
+      v4 = Round(v4, Read64(p + 24));
+    }
+    hash = RotateLeft64(v1, 1) + RotateLeft64(v2, 7) + RotateLeft64(v3, 12) +
+           RotateLeft64(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  } else {
+    hash = seed + Prime5;
+  }
+  hash += static_cast<uint64_t>(size);
+
+  for (; end - p >= 8; p += 8) {
+    hash ^= Round(0, Read64(p));
+    hash = RotateLeft64(hash, 27) * Prime1 + Prime4;
+  }
+  if (end - p >= 4) {
+    hash ^= Read32(p) * Prime1;
+    hash = RotateLeft64(hash, 23) * Prime2 + Prime3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    hash ^= *p * Prime5;
+    hash = RotateLeft64(hash, 11) * Prime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= Prime2;
+  hash ^= hash >> 29;
+  hash *= Prime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+} // namespace bms_parser
+
+/* MD5
+ converted to C++ class by Frank Thilo (thilo@unix-ag.org)
+ for bzflag (http://www.bzflag.org)
+
+   based on:
+
+   md5.h and md5.c
+   reference implemantion of RFC 1321
+
+   Copyright (C) 1991-2, RSA Data Security, Inc. Created 1991. All
+rights reserved.
+
+License to copy and use this software is granted provided that it
+is identified as the "RSA Data Security, Inc. MD5 Message-Digest
+Algorithm" in all material mentioning or referencing this software
+or this function.
+
+License is also granted to make and use derivative works provided
+that such works are identified as "derived from the RSA Data
+Security, Inc. MD5 Message-Digest Algorithm" in all material
+mentioning or referencing the derived work.
+
+RSA Data Security, Inc. makes no representations concerning either
+the merchantability of this software or the suitability of this
+software for any particular purpose. It is provided "as is"
+without express or implied warranty of any kind.
+
+These notices must be retained in any copies of any part of this
+documentation and/or software.
+
+*/
+
+/* interface header */
+
+/* system implementation headers */
+#include <cstdio>
+
+// Constants for MD5Transform routine.
+#define S11 7
+#define S12 12
+#define S13 17
+#define S14 22
+#define S21 5
+#define S22 9
+#define S23 14
+#define S24 20
+#define S31 4
+#define S32 11
+#define S33 16
+#define S34 23
+#define S41 6
+#define S42 10
+#define S43 15
+#define S44 21
+
+///////////////////////////////////////////////
+namespace bms_parser {
+// F, G, H and I are basic MD5 functions.
+inline MD5::uint4 MD5::F(uint4 x, uint4 y, uint4 z) {
+  return (x & y) | (~x & z);
+}
+
+inline MD5::uint4 MD5::G(uint4 x, uint4 y, uint4 z) {
+  return (x & z) | (y & ~z);
+}
+
+inline MD5::uint4 MD5::H(uint4 x, uint4 y, uint4 z) { return x ^ y ^ z; }
+
+inline MD5::uint4 MD5::I(uint4 x, uint4 y, uint4 z) { return y ^ (x | ~z); }
+
+// rotate_left rotates x left n bits.
+inline MD5::uint4 MD5::rotate_left(uint4 x, int n) {
+  return (x << n) | (x >> (32 - n));
+}
+
+// FF, GG, HH, and II transformations for rounds 1, 2, 3, and 4.
+// Rotation is separate from addition to prevent recomputation.
+inline void MD5::FF(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                    uint4 ac) {
+  a = rotate_left(a + F(b, c, d) + x + ac, s) + b;
+}
+
+inline void MD5::GG(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                    uint4 ac) {
+  a = rotate_left(a + G(b, c, d) + x + ac, s) + b;
+}
+
+inline void MD5::HH(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                    uint4 ac) {
+  a = rotate_left(a + H(b, c, d) + x + ac, s) + b;
+}
+
+inline void MD5::II(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                    uint4 ac) {
+  a = rotate_left(a + I(b, c, d) + x + ac, s) + b;
+}
+
+//////////////////////////////////////////////
+
+// default ctor, just initailize
+MD5::MD5() { init(); }
+
+//////////////////////////////////////////////
+
+// nifty shortcut ctor, compute MD5 for string and finalize it right away
+MD5::MD5(const std::string &text) {
+  init();
+  update(text.c_str(), text.length());
+  finalize();
+}
+
+//////////////////////////////
+
+void MD5::init() {
+  finalized = false;
+
+  count[0] = 0;
+  count[1] = 0;
+
+  // load magic initialization constants.
+  state[0] = 0x67452301;
+  state[1] = 0xefcdab89;
+  state[2] = 0x98badcfe;
+  state[3] = 0x10325476;
+}
+
+//////////////////////////////
+
+// decodes input (unsigned char) into output (uint4). Assumes len is a multiple
+// of 4.
+void MD5::decode(uint4 output[], const uint1 input[], size_type len) {
+  for (unsigned int i = 0, j = 0; j < len; i++, j += 4)
+    output[i] = ((uint4)input[j]) | (((uint4)input[j + 1]) << 8) |
+                (((uint4)input[j + 2]) << 16) | (((uint4)input[j + 3]) << 24);
+}
+
+//////////////////////////////
+
+// encodes input (uint4) into output (unsigned char). Assumes len is
+// a multiple of 4.
+void MD5::encode(uint1 output[], const uint4 input[], size_type len) {
+  for (size_type i = 0, j = 0; j < len; i++, j += 4) {
+    output[j] = input[i] & 0xff;
+    output[j + 1] = (input[i] >> 8) & 0xff;
+    output[j + 2] = (input[i] >> 16) & 0xff;
+    output[j + 3] = (input[i] >> 24) & 0xff;
+  }
+}
+
+//////////////////////////////
+
+// apply MD5 algo on a block
+void MD5::transform(const uint1 block[blocksize]) {
+  uint4 a = state[0], b = state[1], c = state[2], d = state[3], x[16];
+  decode(x, block, blocksize);
+
+  /* Round 1 */
+  FF(a, b, c, d, x[0], S11, 0xd76aa478);  /* 1 */
+  FF(d, a, b, c, x[1], S12, 0xe8c7b756);  /* 2 */
+  FF(c, d, a, b, x[2], S13, 0x242070db);  /* 3 */
+  FF(b, c, d, a, x[3], S14, 0xc1bdceee);  /* 4 */
+  FF(a, b, c, d, x[4], S11, 0xf57c0faf);  /* 5 */
+  FF(d, a, b, c, x[5], S12, 0x4787c62a);  /* 6 */
+  FF(c, d, a, b, x[6], S13, 0xa8304613);  /* 7 */
+  FF(b, c, d, a, x[7], S14, 0xfd469501);  /* 8 */
+  FF(a, b, c, d, x[8], S11, 0x698098d8);  /* 9 */
+  FF(d, a, b, c, x[9], S12, 0x8b44f7af);  /* 10 */
+  FF(c, d, a, b, x[10], S13, 0xffff5bb1); /* 11 */
+  FF(b, c, d, a, x[11], S14, 0x895cd7be); /* 12 */
+  FF(a, b, c, d, x[12], S11, 0x6b901122); /* 13 */
+  FF(d, a, b, c, x[13], S12, 0xfd987193); /* 14 */
+  FF(c, d, a, b, x[14], S13, 0xa679438e); /* 15 */
+  FF(b, c, d, a, x[15], S14, 0x49b40821); /* 16 */
+
+  /* Round 2 */
+  GG(a, b, c, d, x[1], S21, 0xf61e2562);  /* 17 */
+  GG(d, a, b, c, x[6], S22, 0xc040b340);  /* 18 */
+  GG(c, d, a, b, x[11], S23, 0x265e5a51); /* 19 */
+  GG(b, c, d, a, x[0], S24, 0xe9b6c7aa);  /* 20 */
+  GG(a, b, c, d, x[5], S21, 0xd62f105d);  /* 21 */
+  GG(d, a, b, c, x[10], S22, 0x2441453);  /* 22 */
+  GG(c, d, a, b, x[15], S23, 0xd8a1e681); /* 23 */
+  GG(b, c, d, a, x[4], S24, 0xe7d3fbc8);  /* 24 */
+  GG(a, b, c, d, x[9], S21, 0x21e1cde6);  /* 25 */
+  GG(d, a, b, c, x[14], S22, 0xc33707d6); /* 26 */
+  GG(c, d, a, b, x[3], S23, 0xf4d50d87);  /* 27 */
+  GG(b, c, d, a, x[8], S24, 0x455a14ed);  /* 28 */
+  GG(a, b, c, d, x[13], S21, 0xa9e3e905); /* 29 */
+  GG(d, a, b, c, x[2], S22, 0xfcefa3f8);  /* 30 */
+  GG(c, d, a, b, x[7], S23, 0x676f02d9);  /* 31 */
+  GG(b, c, d, a, x[12], S24, 0x8d2a4c8a); /* 32 */
+
+  /* Round 3 */
+  HH(a, b, c, d, x[5], S31, 0xfffa3942);  /* 33 */
+  HH(d, a, b, c, x[8], S32, 0x8771f681);  /* 34 */
+  HH(c, d, a, b, x[11], S33, 0x6d9d6122); /* 35 */
+  HH(b, c, d, a, x[14], S34, 0xfde5380c); /* 36 */
+  HH(a, b, c, d, x[1], S31, 0xa4beea44);  /* 37 */
+  HH(d, a, b, c, x[4], S32, 0x4bdecfa9);  /* 38 */
+  HH(c, d, a, b, x[7], S33, 0xf6bb4b60);  /* 39 */
+  HH(b, c, d, a, x[10], S34, 0xbebfbc70); /* 40 */
+  HH(a, b, c, d, x[13], S31, 0x289b7ec6); /* 41 */
+  HH(d, a, b, c, x[0], S32, 0xeaa127fa);  /* 42 */
+  HH(c, d, a, b, x[3], S33, 0xd4ef3085);  /* 43 */
+  HH(b, c, d, a, x[6], S34, 0x4881d05);   /* 44 */
+  HH(a, b, c, d, x[9], S31, 0xd9d4d039);  /* 45 */
+  HH(d, a, b, c, x[12], S32, 0xe6db99e5); /* 46 */
+  HH(c, d, a, b, x[15], S33, 0x1fa27cf8); /* 47 */
+  HH(b, c, d, a, x[2], S34, 0xc4ac5665);  /* 48 */
+
+  /* Round 4 */
+  II(a, b, c, d, x[0], S41, 0xf4292244);  /* 49 */
+  II(d, a, b, c, x[7], S42, 0x432aff97);  /* 50 */
+  II(c, d, a, b, x[14], S43, 0xab9423a7); /* 51 */
+  II(b, c, d, a, x[5], S44, 0xfc93a039);  /* 52 */
+  II(a, b, c, d, x[12], S41, 0x655b59c3); /* 53 */
+  II(d, a, b, c, x[3], S42, 0x8f0ccc92);  /* 54 */
+  II(c, d, a, b, x[10], S43, 0xffeff47d); /* 55 */
+  II(b, c, d, a, x[1], S44, 0x85845dd1);  /* 56 */
+  II(a, b, c, d, x[8], S41, 0x6fa87e4f);  /* 57 */
+  II(d, a, b, c, x[15], S42, 0xfe2ce6e0); /* 58 */
+  II(c, d, a, b, x[6], S43, 0xa3014314);  /* 59 */
+  II(b, c, d, a, x[13], S44, 0x4e0811a1); /* 60 */
+  II(a, b, c, d, x[4], S41, 0xf7537e82);  /* 61 */
+  II(d, a, b, c, x[11], S42, 0xbd3af235); /* 62 */
+  II(c, d, a, b, x[2], S43, 0x2ad7d2bb);  /* 63 */
+  II(b, c, d, a, x[9], S44, 0xeb86d391);  /* 64 */
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+
+  // Zeroize sensitive information.
+  memset(x, 0, sizeof x);
+}
+
+//////////////////////////////
+
+// MD5 block update operation. Continues an MD5 message-digest
+// operation, processing another message block
+void MD5::update(const unsigned char input[], size_type length) {
+  // compute number of bytes mod 64
+  size_type index = count[0] / 8 % blocksize;
+
+  // Update number of bits
+  if ((count[0] += (length << 3)) < (length << 3))
+    count[1]++;
+  count[1] += (length >> 29);
+
+  // number of bytes we need to fill in buffer
+  size_type firstpart = 64 - index;
+
+  size_type i;
+
+  // transform as many times as possible.
+  if (length >= firstpart) {
+    // fill buffer first, transform
+    memcpy(&buffer[index], input, firstpart);
+    transform(buffer);
+
+    // transform chunks of blocksize (64 bytes)
+    for (i = firstpart; i + blocksize <= length; i += blocksize)
+      transform(&input[i]);
+
+    index = 0;
+  } else
+    i = 0;
+
+  // buffer remaining input
+  memcpy(&buffer[index], &input[i], length - i);
+}
+
+//////////////////////////////
+
+// for convenience provide a verson with signed char
+void MD5::update(const char input[], size_type length) {
+  update((const unsigned char *)input, length);
+}
+
+//////////////////////////////
+
+// MD5 finalization. Ends an MD5 message-digest operation, writing the
+// the message digest and zeroizing the context.
+MD5 &MD5::finalize() {
+  static unsigned char padding[64] = {
+      0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+  if (!finalized) {
+    // Save number of bits
+    unsigned char bits[8];
+    encode(bits, count, 8);
+
+    // pad out to 56 mod 64.
+    size_type index = count[0] / 8 % 64;
+    size_type padLen = (index < 56) ? (56 - index) : (120 - index);
+    update(padding, padLen);
+
+    // Append length (before padding)
+    update(bits, 8);
+
+    // Store state in digest
+    encode(digest, state, 16);
+
+    // Zeroize sensitive information.
+    memset(buffer, 0, sizeof buffer);
+    memset(count, 0, sizeof count);
+
+    finalized = true;
+  }
+
+  return *this;
+}
+
+//////////////////////////////
+
+// return hex representation of digest as string
+std::string MD5::hexdigest() const {
+  if (!finalized)
+    return "";
+
+  char buf[33];
+  for (int i = 0; i < 16; i++)
+    snprintf(buf + i * 2, 3, "%02x", digest[i]);
+  buf[32] = 0;
+
+  return buf;
+}
+
+//////////////////////////////
+
+std::ostream &operator<<(std::ostream &out, MD5 md5) {
+  return out << md5.hexdigest();
+}
+
+//////////////////////////////
+
+std::string md5(const std::string str) {
+  MD5 md5 = MD5(str);
+
+  return md5.hexdigest();
+}
+} // namespace bms_parser
+
@@ -0,0 +1,2120 @@
+#pragma once
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#define BMS_PARSER_X86 1
+#else
+#define BMS_PARSER_X86 0
+#endif
+
+// Lets a single function use an instruction set the rest of the translation
+// unit isn't compiled for. Callers must check CpuFeatures first.
+#if defined(__GNUC__) || defined(__clang__)
+#define BMS_PARSER_TARGET(x) __attribute__((target(x)))
+#else
+#define BMS_PARSER_TARGET(x)
+#endif
+
+/**
+ * Runtime CPU feature detection used to pick SIMD kernels.
+ */
+namespace bms_parser {
+namespace CpuFeatures {
+bool HasSSE2();
+bool HasAVX2();
+// SHA-NI together with the SSSE3 and SSE4.1 its kernels need
+bool HasSHA();
+
+inline int CountTrailingZeros(uint32_t x) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, x);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctz(x);
+#endif
+}
+
+inline int CountTrailingZeros64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return static_cast<int>(index);
+#elif defined(_MSC_VER)
+  const auto low = static_cast<uint32_t>(x);
+  return low != 0 ? CountTrailingZeros(low)
+                  : 32 + CountTrailingZeros(static_cast<uint32_t>(x >> 32));
+#else
+  return __builtin_ctzll(x);
+#endif
+}
+} // namespace CpuFeatures
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace bms_parser {
+enum class PairBase {
+  Hex,    // channel 03
+  Base36, // the default, and always for mines
+  Base62, // #BASE 62
+};
+
+/**
+ * Decodes the data of a channel line ("00AB00CD...") a whole line at a time.
+ * "00" pairs are found with SIMD compares and only the remaining pairs are
+ * decoded, through lookup tables.
+ */
+namespace ChannelData {
+// written to ids for pairs the tables can't decode (signs, spaces, '*', ...)
+// so the caller can fall back to the slow path
+constexpr int Undecoded = INT32_MIN;
+
+// Splits data into data.size() / 2 pairs and returns that count. Bit j % 64
+// of nonZero[j / 64] is set unless pair j is exactly "00", and ids[j] holds
+// the decoded value of every such pair. Both vectors are reused between
+// calls; entries for "00" pairs are left unspecified.
+size_t Decode(std::string_view data, PairBase base, std::vector<int> &ids,
+              std::vector<uint64_t> &nonZero);
+
+// index of the first non-"00" pair at or after from, or count if none
+inline size_t NextNonZero(const std::vector<uint64_t> &nonZero, size_t from,
+                          size_t count) {
+  size_t word = from / 64;
+  if (from >= count) {
+    return count;
+  }
+  uint64_t bits = nonZero[word] & (~uint64_t{0} << (from % 64));
+  while (bits == 0) {
+    if (++word * 64 >= count) {
+      return count;
+    }
+    bits = nonZero[word];
+  }
+  return word * 64 + CpuFeatures::CountTrailingZeros64(bits);
+}
+} // namespace ChannelData
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+/**
+ * Monotonic allocator that owns the measures, timelines and notes of a chart.
+ * Allocation bumps a pointer inside the current block and nothing is freed
+ * until the arena itself goes away, at which point the handful of blocks are
+ * released at once.
+ */
+namespace bms_parser {
+class ChartArena {
+public:
+  ChartArena() = default;
+  ChartArena(const ChartArena &) = delete;
+  ChartArena &operator=(const ChartArena &) = delete;
+  ~ChartArena();
+
+  // Constructs a T in the arena. The arena never runs destructors, so an
+  // object that owns heap memory of its own has to be destroyed explicitly.
+  template <typename T, typename... Args> T *New(Args &&...args) {
+    return new (Allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+  }
+
+  // align must be a power of two no larger than alignof(std::max_align_t)
+  void *Allocate(size_t size, size_t align) {
+    const uintptr_t start = (Cursor + align - 1) & ~(uintptr_t{align} - 1);
+    if (start + size > Limit || start < Cursor) {
+      return AllocateSlow(size, align);
+    }
+    Cursor = start + size;
+    return reinterpret_cast<void *>(start);
+  }
+
+  // Takes over the blocks of other, which is left empty. Everything built in
+  // other then lives as long as this arena.
+  void Adopt(ChartArena &other);
+
+  // bytes held in blocks, used or not
+  [[nodiscard]] size_t Capacity() const { return Reserved; }
+
+private:
+  struct Block {
+    Block *Next;
+    size_t Size;
+  };
+  static constexpr size_t FirstBlockSize = 16 * 1024;
+  static constexpr size_t MaxBlockSize = 1024 * 1024;
+
+  void *AllocateSlow(size_t size, size_t align);
+
+  Block *Blocks = nullptr;
+  uintptr_t Cursor = 0;
+  uintptr_t Limit = 0;
+  size_t Reserved = 0;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <type_traits>
+
+namespace bms_parser {
+enum class NoteKind : uint8_t {
+  Normal = 0,
+  LongHead = 1,
+  LongTail = 2,
+  Landmine = 3,
+  Invisible = 4,
+  Background = 5,
+};
+
+// index of a note in Chart::Notes, or NoNoteId for none
+constexpr uint32_t NoNoteId = UINT32_MAX;
+
+/**
+ * Compact copy of a note for loops that only need to look at it. The chart
+ * keeps one per note in Chart::Notes, in timeline order, so judging or
+ * drawing a lane walks contiguous memory and checks the kind with a plain
+ * compare instead of going through the Note object.
+ */
+struct NoteRecord {
+  int32_t Wav;
+  // index into Chart::TimeLines
+  uint32_t Timeline;
+  // the other end of a long note; NoNoteId otherwise
+  uint32_t Partner;
+  // landmine damage; 0 for everything else
+  float Damage;
+  uint8_t Lane;
+  NoteKind Kind;
+
+  [[nodiscard]] bool IsLongNote() const {
+    return Kind == NoteKind::LongHead || Kind == NoteKind::LongTail;
+  }
+  [[nodiscard]] bool IsLandmineNote() const {
+    return Kind == NoteKind::Landmine;
+  }
+};
+static_assert(sizeof(NoteRecord) <= 24, "NoteRecord should stay small");
+static_assert(std::is_trivially_copyable<NoteRecord>::value,
+              "NoteRecord is copied around as plain bytes");
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+namespace bms_parser {
+class TimeLine;
+
+class Note {
+public:
+  int Lane = 0;
+  int Wav = 0;
+  TimeLine *Timeline = nullptr;
+  // set by the subclass; Chart::BuildNoteRecords refines it into head/tail,
+  // invisible and background once the chart is complete
+  NoteKind Kind = NoteKind::Normal;
+  // index of this note's record in Chart::Notes, and of its state in a
+  // PlayState
+  uint32_t Id = NoNoteId;
+
+  // private Note nextNote;
+
+  explicit Note(int Wav);
+
+  virtual ~Note();
+
+  [[nodiscard]] bool IsLongNote() const {
+    return Kind == NoteKind::LongHead || Kind == NoteKind::LongTail;
+  }
+  [[nodiscard]] bool IsLandmineNote() const {
+    return Kind == NoteKind::Landmine;
+  }
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ *
+ */
+namespace bms_parser {
+class LandmineNote : public Note {
+public:
+  float Damage;
+  explicit LandmineNote(float Damage);
+  ~LandmineNote() override;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Fixed lane storage for the notes of a timeline. The slots live inline and
+ * a bit mask records which lanes are occupied, so consumers can walk the
+ * occupied lanes with the mask alone. Indexing and iteration behave like the
+ * vector this replaced: every lane is visited, empty ones as nullptr, and
+ * `lanes[i] = note` still works; the write goes through Set so the mask
+ * stays in sync.
+ */
+namespace bms_parser {
+template <typename T, size_t N> class LaneArray {
+  static_assert(N <= 16, "the occupancy mask is 16 bits");
+
+public:
+  using value_type = T;
+  using const_iterator = const T *;
+
+  // write access to one slot; reads behave like a plain T
+  class Reference {
+  public:
+    Reference(LaneArray &owner, size_t lane) : Owner(owner), Lane(lane) {}
+    Reference &operator=(T value) {
+      Owner.Set(Lane, value);
+      return *this;
+    }
+    Reference &operator=(const Reference &other) {
+      return *this = static_cast<T>(other);
+    }
+    operator T() const { return Owner.Slots[Lane]; }
+    T operator->() const { return Owner.Slots[Lane]; }
+    // lets static_cast reach a derived type, as it does for a plain pointer
+    template <typename U> explicit operator U *() const {
+      return static_cast<U *>(Owner.Slots[Lane]);
+    }
+
+  private:
+    LaneArray &Owner;
+    size_t Lane;
+  };
+
+  [[nodiscard]] T operator[](size_t lane) const { return Slots[lane]; }
+  [[nodiscard]] Reference operator[](size_t lane) { return {*this, lane}; }
+
+  void Set(size_t lane, T value) {
+    Slots[lane] = value;
+    if (value != nullptr) {
+      Occupied |= static_cast<uint16_t>(1u << lane);
+    } else {
+      Occupied &= static_cast<uint16_t>(~(1u << lane));
+    }
+  }
+
+  // bit i is set if lane i holds a note
+  [[nodiscard]] uint16_t Mask() const { return Occupied; }
+  [[nodiscard]] bool Empty() const { return Occupied == 0; }
+  [[nodiscard]] static constexpr size_t size() { return N; }
+
+  [[nodiscard]] const_iterator begin() const { return Slots; }
+  [[nodiscard]] const_iterator end() const { return Slots + N; }
+
+  // calls f(lane, value) for every occupied lane, in lane order
+  template <typename F> void ForEach(F &&f) const {
+    for (uint32_t mask = Occupied; mask != 0; mask &= mask - 1) {
+      const auto lane = CpuFeatures::CountTrailingZeros(mask);
+      f(lane, Slots[lane]);
+    }
+  }
+
+private:
+  T Slots[N] = {};
+  uint16_t Occupied = 0;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/**
+ * A vector that keeps its first N elements inline and only goes to the heap
+ * past that. Only for trivially copyable elements such as pointers.
+ */
+namespace bms_parser {
+template <typename T, size_t N> class SmallVector {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "elements are moved with memcpy");
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  SmallVector() = default;
+  SmallVector(const SmallVector &other) { *this = other; }
+  SmallVector &operator=(const SmallVector &other) {
+    if (this != &other) {
+      clear();
+      reserve(other.Size);
+      std::memcpy(Data, other.Data, other.Size * sizeof(T));
+      Size = other.Size;
+    }
+    return *this;
+  }
+  ~SmallVector() { Release(); }
+
+  void push_back(const T &value) {
+    if (Size == Capacity) {
+      reserve(Capacity * 2);
+    }
+    Data[Size++] = value;
+  }
+
+  void reserve(size_t capacity) {
+    if (capacity <= Capacity) {
+      return;
+    }
+    auto grown = static_cast<T *>(std::malloc(capacity * sizeof(T)));
+    if (grown == nullptr) {
+      throw std::bad_alloc();
+    }
+    std::memcpy(grown, Data, Size * sizeof(T));
+    Release();
+    Data = grown;
+    Capacity = capacity;
+  }
+
+  void clear() { Size = 0; }
+
+  [[nodiscard]] size_t size() const { return Size; }
+  [[nodiscard]] bool empty() const { return Size == 0; }
+  T &operator[](size_t i) { return Data[i]; }
+  const T &operator[](size_t i) const { return Data[i]; }
+  iterator begin() { return Data; }
+  iterator end() { return Data + Size; }
+  [[nodiscard]] const_iterator begin() const { return Data; }
+  [[nodiscard]] const_iterator end() const { return Data + Size; }
+
+private:
+  void Release() {
+    if (Data != Inline) {
+      std::free(Data);
+    }
+  }
+
+  T Inline[N];
+  T *Data = Inline;
+  size_t Size = 0;
+  size_t Capacity = N;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/**
+ *
+ */
+namespace bms_parser {
+class TimeLine {
+public:
+  static constexpr int MaxLanes = 16;
+  // most timelines carry a keysound or two
+  SmallVector<Note *, 2> BackgroundNotes;
+  LaneArray<Note *, MaxLanes> InvisibleNotes;
+  LaneArray<Note *, MaxLanes> Notes;
+  LaneArray<LandmineNote *, MaxLanes> LandmineNotes;
+  double Bpm = 0;
+  bool BpmChange = false;
+  bool BpmChangeApplied = false;
+  int BgaBase = -1;
+  int BgaLayer = -1;
+  int BgaPoor = -1;
+
+  double StopLength = 0;
+  double Scroll = 1;
+
+  // musical timing in microseconds
+  long long Timing = 0;
+
+  // beat position; measure number + position in
+  // measure. 1.25 means 1 measure and 1/4 beat
+  double BeatPosition = 0;
+
+  // lanes must not exceed MaxLanes; the lane storage is always inline
+  explicit TimeLine(int lanes, bool metaOnly);
+
+  TimeLine *SetNote(int lane, Note *note);
+
+  TimeLine *SetInvisibleNote(int lane, Note *note);
+
+  TimeLine *SetLandmineNote(int lane, LandmineNote *note);
+
+  TimeLine *AddBackgroundNote(Note *note);
+
+  [[nodiscard]] double GetStopDuration() const;
+
+  // the notes belong to the chart's arena and are not freed here
+  ~TimeLine();
+  bool IsFirstInMeasure = false;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Struct-of-arrays copy of a chart's notes for loops that scan forward by
+ * lane and time. Each lane holds its notes in chart order, one array per
+ * field, and background notes are kept in a single stream of their own. The
+ * view is a snapshot: it does not follow later edits to the chart.
+ */
+namespace bms_parser {
+class Chart;
+
+struct LaneView {
+  // microseconds, in chart order; ascending unless the chart has negative
+  // or zero BPMs
+  std::vector<long long> Timing;
+  std::vector<double> BeatPosition;
+  std::vector<int32_t> Wav;
+  // Normal, LongHead, LongTail, Landmine or Invisible
+  std::vector<NoteKind> Kind;
+  // index of the other end of a long note in this lane; NoNoteId otherwise
+  std::vector<uint32_t> Partner;
+  // index into Chart::Notes
+  std::vector<uint32_t> NoteId;
+
+  [[nodiscard]] size_t size() const { return Timing.size(); }
+  [[nodiscard]] bool empty() const { return Timing.empty(); }
+};
+
+struct BackgroundView {
+  // microseconds, in chart order; ascending unless the chart has negative
+  // or zero BPMs
+  std::vector<long long> Timing;
+  std::vector<double> BeatPosition;
+  std::vector<int32_t> Wav;
+  // index into Chart::Notes
+  std::vector<uint32_t> NoteId;
+
+  [[nodiscard]] size_t size() const { return Timing.size(); }
+  [[nodiscard]] bool empty() const { return Timing.empty(); }
+};
+
+class ChartView {
+public:
+  static constexpr int LaneCount = TimeLine::MaxLanes;
+  LaneView Lanes[LaneCount];
+  BackgroundView Background;
+
+  // built from Chart::Notes, so the chart's note records must be current
+  explicit ChartView(const Chart &chart);
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vector>
+/**
+ *
+ */
+namespace bms_parser {
+class Measure {
+public:
+  double Scale = 1;
+  long long Timing = 0;
+  double Pos = 0;
+  std::vector<TimeLine *> TimeLines;
+  ~Measure();
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace bms_parser {
+enum class TextEncoding {
+  ShiftJIS = 0,
+  UTF8 = 1,
+};
+
+/**
+ * Detects the text encoding of a chart and converts it to UTF-8. Each
+ * encoding other than UTF-8 is handled by its own decoder in ToUTF8.
+ */
+namespace TextEncodings {
+// Charts that start with a UTF-8 BOM or are valid UTF-8 with at least one
+// non-ASCII character are UTF-8; everything else is treated as Shift-JIS.
+// Pure ASCII stays Shift-JIS so that '\' and '~' keep converting the way
+// they always have. bomLength receives the number of bytes to skip.
+TextEncoding Detect(const unsigned char *input, size_t size,
+                    size_t &bomLength);
+
+// isAscii is set when every byte is below 0x80
+bool IsValidUTF8(const unsigned char *input, size_t size, bool &isAscii);
+
+void ToUTF8(TextEncoding encoding, const unsigned char *input, size_t size,
+            std::string &result);
+} // namespace TextEncodings
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bms_parser {
+class ChartMeta {
+public:
+  std::string SHA256;
+  std::string MD5;
+  uint64_t ContentHash = 0; // XXH64 of the source, 0 if not computed
+  std::filesystem::path BmsPath;
+  std::filesystem::path Folder;
+  std::string Artist;
+  std::string SubArtist;
+  double Bpm = 0;
+  std::string Genre;
+  std::string Title;
+  std::string SubTitle;
+  int Rank = 3;
+  double Total = 100;
+  long long PlayLength = 0; // Timing of the last playable note, in microseconds
+  long long TotalLength = 0;
+  // Timing of the last timeline(including background note, bga change note,
+  // invisible note, ...), in microseconds
+  std::filesystem::path Banner;
+  std::filesystem::path StageFile;
+  std::filesystem::path BackBmp;
+  std::filesystem::path Preview;
+  bool BgaPoorDefault = false;
+  int Difficulty = 0;
+  double PlayLevel = 3;
+  double MinBpm = 0;
+  double MaxBpm = 0;
+  int Player = 1;
+  int KeyMode = 5;
+  bool IsDP = false;
+  int TotalNotes = 0;
+  int TotalLongNotes = 0;
+  int TotalScratchNotes = 0;
+  int TotalBackSpinNotes = 0;
+  int TotalLandmineNotes = 0;
+  int LnMode = 0; // 0: user decides, 1: LN, 2: CN, 3: HCN
+  TextEncoding Encoding = TextEncoding::ShiftJIS; // encoding of the source
+  // the chart has #RANDOM blocks, so another seed may give another chart
+  bool HasRandom = false;
+
+  [[nodiscard]] int GetKeyLaneCount() const { return KeyMode; }
+  [[nodiscard]] int GetScratchLaneCount() const { return IsDP ? 2 : 1; }
+  [[nodiscard]] int GetTotalLaneCount() const {
+    return KeyMode + GetScratchLaneCount();
+  }
+
+  [[nodiscard]] std::vector<int> GetKeyLaneIndices() const {
+    switch (KeyMode) {
+    case 5:
+      return {0, 1, 2, 3, 4};
+    case 7:
+      return {0, 1, 2, 3, 4, 5, 6};
+    case 10:
+      return {0, 1, 2, 3, 4, 8, 9, 10, 11, 12};
+    case 14:
+      return {0, 1, 2, 3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14};
+    default:
+      return {};
+    }
+  }
+
+  [[nodiscard]] std::vector<int> GetScratchLaneIndices() const {
+    if (IsDP) {
+      return {7, 15};
+    }
+    return {7};
+  }
+
+  [[nodiscard]] std::vector<int> GetTotalLaneIndices() const {
+    std::vector<int> Result;
+    std::vector<int> keyLaneIndices = GetKeyLaneIndices();
+    std::vector<int> scratchLaneIndices = GetScratchLaneIndices();
+    Result.insert(Result.end(), keyLaneIndices.begin(), keyLaneIndices.end());
+    Result.insert(Result.end(), scratchLaneIndices.begin(),
+                  scratchLaneIndices.end());
+
+    return Result;
+  }
+};
+
+class Chart {
+public:
+  Chart();
+  ~Chart();
+  // Fills TimeLines and Notes from Measures and numbers the notes. The parser
+  // calls this once the chart is complete; call it again after editing
+  // Measures by hand.
+  void BuildNoteRecords();
+  // The digests of the source, as in Meta. Those the parse did not compute
+  // are computed on first call from the source bytes, if
+  // ParseOptions::LazyDigests kept them, and stay empty (0) otherwise. Safe
+  // to call from several threads at once.
+  const std::string &GetMD5();
+  const std::string &GetSHA256();
+  uint64_t GetContentHash();
+  // Where the digests above come from; the bytes must stay alive until they
+  // have all been asked for, or until the source is cleared. Neither is safe
+  // to call while another thread is in one of the getters.
+  void SetDigestSource(const unsigned char *bytes, size_t size);
+  void ClearDigestSource();
+  ChartMeta Meta;
+  // Measures, their timelines and their notes all live in Arena and go away
+  // with the chart; anything added to Measures must come from it as well.
+  ChartArena Arena;
+  std::vector<Measure *> Measures;
+  // every timeline of every measure, in order
+  std::vector<TimeLine *> TimeLines;
+  // one record per note, grouped by timeline; Note::Id indexes into this
+  std::vector<NoteRecord> Notes;
+  // per-lane arrays of the notes; only built when ParseOptions::BuildView
+  // is set, null otherwise
+  std::unique_ptr<ChartView> View;
+  std::unordered_map<int, std::string> WavTable;
+  std::unordered_map<int, std::string> BmpTable;
+
+private:
+  // an empty source may well have null bytes
+  bool HasSource = false;
+  const unsigned char *SourceBytes = nullptr;
+  size_t SourceSize = 0;
+  std::once_flag MD5Once;
+  std::once_flag SHA256Once;
+  std::once_flag ContentHashOnce;
+};
+} // namespace bms_parser
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ *
+ */
+namespace bms_parser {
+class LongNote : public Note {
+public:
+  ~LongNote() override;
+  LongNote *Tail = nullptr;
+  LongNote *Head = nullptr;
+  [[nodiscard]] bool IsTail() const;
+
+  explicit LongNote(int Wav);
+};
+} // namespace bms_parser
+
+#include <string>
+#include <vector>
+
+// http://www.zedwood.com/article/cpp-sha256-function
+namespace bms_parser {
+// The block functions SHA256 can run on. Auto takes the fastest one this
+// CPU has; naming one is for tests, which hold them against each other.
+enum class SHA256Kernel { Auto, Scalar, Avx2, ShaNi };
+
+class SHA256 {
+  /*
+   * Updated to C++, zedwood.com 2012
+   * Based on Olivier Gay's version
+   * See Modified BSD License below:
+   *
+   * FIPS 180-2 SHA-224/256/384/512 implementation
+   * Issue date:  04/30/2005
+   * http://www.ouah.org/ogay/sha2/
+   *
+   * Copyright (C) 2005, 2007 Olivier Gay <olivier.gay@a3.epfl.ch>
+   * All rights reserved.
+   *
+   * Redistribution and use in source and binary forms, with or without
+   * modification, are permitted provided that the following conditions
+   * are met:
+   * 1. Redistributions of source code must retain the above copyright
+   *    notice, this list of conditions and the following disclaimer.
+   * 2. Redistributions in binary form must reproduce the above copyright
+   *    notice, this list of conditions and the following disclaimer in the
+   *    documentation and/or other materials provided with the distribution.
+   * 3. Neither the name of the project nor the names of its contributors
+   *    may be used to endorse or promote products derived from this software
+   *    without specific prior written permission.
+   *
+   * THIS SOFTWARE IS PROVIDED BY THE PROJECT AND CONTRIBUTORS ``AS IS'' AND
+   * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   * ARE DISCLAIMED.  IN NO EVENT SHALL THE PROJECT OR CONTRIBUTORS BE LIABLE
+   * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+   * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+   * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+   * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+   * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+   * SUCH DAMAGE.
+   */
+protected:
+  using uint8 = unsigned char;
+  using uint32 = unsigned int;
+
+  const static uint32 sha256_k[];
+  static constexpr unsigned int SHA224_256_BLOCK_SIZE = (512 / 8);
+
+public:
+  // kernel must be one the CPU Supports
+  void init(SHA256Kernel kernel = SHA256Kernel::Auto);
+  [[nodiscard]] static bool Supports(SHA256Kernel kernel);
+  void update(const unsigned char *message, unsigned int len);
+  void final(unsigned char *digest);
+  static constexpr unsigned int DIGEST_SIZE = (256 / 8);
+
+protected:
+  void transform(const unsigned char *message, unsigned int block_nb);
+  unsigned int m_tot_len;
+  unsigned int m_len;
+  unsigned char m_block[2 * SHA224_256_BLOCK_SIZE];
+  uint32 m_h[8];
+  SHA256Kernel m_kernel = SHA256Kernel::Auto;
+};
+
+std::string sha256(const unsigned char *bytes, size_t size,
+                   SHA256Kernel kernel = SHA256Kernel::Auto);
+std::string sha256(const std::vector<unsigned char> &bytes);
+
+#define SHA2_SHFR(x, n) (x >> n)
+#define SHA2_ROTR(x, n) ((x >> n) | (x << ((sizeof(x) << 3) - n)))
+#define SHA2_CH(x, y, z) ((x & y) ^ (~x & z))
+#define SHA2_MAJ(x, y, z) ((x & y) ^ (x & z) ^ (y & z))
+#define SHA256_F1(x) (SHA2_ROTR(x, 2) ^ SHA2_ROTR(x, 13) ^ SHA2_ROTR(x, 22))
+#define SHA256_F2(x) (SHA2_ROTR(x, 6) ^ SHA2_ROTR(x, 11) ^ SHA2_ROTR(x, 25))
+#define SHA256_F3(x) (SHA2_ROTR(x, 7) ^ SHA2_ROTR(x, 18) ^ SHA2_SHFR(x, 3))
+#define SHA256_F4(x) (SHA2_ROTR(x, 17) ^ SHA2_ROTR(x, 19) ^ SHA2_SHFR(x, 10))
+#define SHA2_UNPACK32(x, str)                                                  \
+  {                                                                            \
+    *((str) + 3) = (uint8)((x));                                               \
+    *((str) + 2) = (uint8)((x) >> 8);                                          \
+    *((str) + 1) = (uint8)((x) >> 16);                                         \
+    *((str) + 0) = (uint8)((x) >> 24);                                         \
+  }
+#define SHA2_PACK32(str, x)                                                    \
+  {                                                                            \
+    *(x) = ((uint32) * ((str) + 3)) | ((uint32) * ((str) + 2) << 8) |          \
+           ((uint32) * ((str) + 1) << 16) | ((uint32) * ((str) + 0) << 24);    \
+  }
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * XXH64, a fast non-cryptographic 64-bit hash. Meant for cache keys and
+ * change detection, where MD5 or SHA-256 would be many times slower for no
+ * benefit.
+ */
+namespace bms_parser {
+uint64_t XXHash64(const unsigned char *bytes, size_t size, uint64_t seed = 0);
+} // namespace bms_parser
+
+/* MD5
+ converted to C++ class by Frank Thilo (thilo@unix-ag.org)
+ for bzflag (http://www.bzflag.org)
+
+   based on:
+
+   md5.h and md5.c
+   reference implementation of RFC 1321
+
+   Copyright (C) 1991-2, RSA Data Security, Inc. Created 1991. All
+rights reserved.
+
+License to copy and use this software is granted provided that it
+is identified as the "RSA Data Security, Inc. MD5 Message-Digest
+Algorithm" in all material mentioning or referencing this software
+or this function.
+
+License is also granted to make and use derivative works provided
+that such works are identified as "derived from the RSA Data
+Security, Inc. MD5 Message-Digest Algorithm" in all material
+mentioning or referencing the derived work.
+
+RSA Data Security, Inc. makes no representations concerning either
+the merchantability of this software or the suitability of this
+software for any particular purpose. It is provided "as is"
+without express or implied warranty of any kind.
+
+These notices must be retained in any copies of any part of this
+documentation and/or software.
+
+*/
+
+#ifndef BZF_MD5_H
+#define BZF_MD5_H
+
+#include <cstring>
+#include <iostream>
+
+// a small class for calculating MD5 hashes of strings or byte arrays
+// it is not meant to be fast or secure
+//
+// usage: 1) feed it blocks of uchars with update()
+//      2) finalize()
+//      3) get hexdigest() string
+//      or
+//      MD5(std::string).hexdigest()
+//
+// assumes that char is 8 bit and int is 32 bit
+
+namespace bms_parser {
+class MD5 {
+public:
+  typedef unsigned int size_type; // must be 32bit
+
+  MD5();
+  MD5(const std::string &text);
+  void update(const unsigned char *buf, size_type length);
+  void update(const char *buf, size_type length);
+  MD5 &finalize();
+  std::string hexdigest() const;
+  friend std::ostream &operator<<(std::ostream &, MD5 md5);
+
+private:
+  void init();
+  typedef unsigned char uint1; //  8bit
+  typedef unsigned int uint4;  // 32bit
+  enum { blocksize = 64 };     // VC6 won't eat a const static int here
+
+  void transform(const uint1 block[blocksize]);
+  static void decode(uint4 output[], const uint1 input[], size_type len);
+  static void encode(uint1 output[], const uint4 input[], size_type len);
+
+  bool finalized;
+  uint1 buffer[blocksize]; // bytes that didn't fit in last 64 byte chunk
+  uint4 count[2];          // 64bit counter for number of bits (lo, hi)
+  uint4 state[4];          // digest so far
+  uint1 digest[16];        // the result
+
+  // low level logic operations
+  static inline uint4 F(uint4 x, uint4 y, uint4 z);
+  static inline uint4 G(uint4 x, uint4 y, uint4 z);
+  static inline uint4 H(uint4 x, uint4 y, uint4 z);
+  static inline uint4 I(uint4 x, uint4 y, uint4 z);
+  static inline uint4 rotate_left(uint4 x, int n);
+  static inline void FF(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                        uint4 ac);
+  static inline void GG(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                        uint4 ac);
+  static inline void HH(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                        uint4 ac);
+  static inline void II(uint4 &a, uint4 b, uint4 c, uint4 d, uint4 x, uint4 s,
+                        uint4 ac);
+};
+
+std::string md5(const std::string str);
+} // namespace bms_parser
+#endif
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <cstddef>
+#include <filesystem>
+
+/**
+ * Read-only memory mapping of a whole file. The mapping is released when the
+ * object is closed or destroyed, so views into GetData() must not outlive it.
+ */
+namespace bms_parser {
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  // returns false if the file could not be opened or mapped
+  bool Open(const std::filesystem::path &path);
+  void Close();
+
+  [[nodiscard]] const unsigned char *GetData() const { return Data; }
+  [[nodiscard]] size_t GetSize() const { return Size; }
+
+private:
+  const unsigned char *Data = nullptr;
+  size_t Size = 0;
+#ifdef _WIN32
+  HANDLE File = INVALID_HANDLE_VALUE;
+  HANDLE Mapping = nullptr;
+#endif
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <functional>
+
+/**
+ * Where the library runs work it spreads over threads. ThreadPool is the
+ * built-in one; a host engine can implement this to run the same jobs on
+ * its own job system instead.
+ */
+namespace bms_parser {
+class Executor {
+public:
+  virtual ~Executor() = default;
+
+  // Runs job once, on any thread, at some point. Must be callable from any
+  // thread, including from inside a running job. Jobs do not throw.
+  virtual void Submit(std::function<void()> job) = 0;
+
+  // how many jobs can make progress at the same time
+  [[nodiscard]] virtual unsigned int Concurrency() const = 0;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <string_view>
+
+namespace bms_parser {
+enum class HeaderKeyword : uint8_t {
+  None = 0,
+  // control flow
+  If,
+  Else,
+  EndIf,
+  Random,
+  EndRandom,
+  // headers
+  Artist,
+  BackBmp,
+  Banner,
+  Base,
+  Bmp,
+  Bpm,
+  Difficulty,
+  Genre,
+  LnMode,
+  LnObj,
+  LnType,
+  MidiFile,
+  Player,
+  PlayLevel,
+  Preview,
+  Rank,
+  Scroll,
+  StageFile,
+  Stop,
+  SubArtist,
+  SubTitle,
+  Title,
+  Total,
+  VideoFile,
+  VolWav,
+  Wav,
+};
+
+/**
+ * Classifies '#' lines with a compile-time keyword table. Matching is a
+ * case-insensitive prefix match, so "#WAV01" and "#wav01" are both Wav.
+ */
+namespace HeaderKeywords {
+// text is the line without its leading '#'
+HeaderKeyword Match(std::string_view text);
+} // namespace HeaderKeywords
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+/**
+ *
+ */
+namespace bms_parser {
+struct ParseOptions {
+  // Parse(path) maps the file read-only and parses straight from the mapping
+  // instead of copying it into a buffer first. Falls back to reading the file
+  // if it can't be mapped.
+  bool UseMemoryMap = true;
+  // Tokenise the raw bytes and only run the Shift-JIS conversion on free-text
+  // header values (TITLE, ARTIST, WAV/BMP file names, ...). Control and
+  // channel lines are pure ASCII and never get converted, and no converted
+  // copy of the whole file is made.
+  bool LazyDecode = false;
+  // Also fill Chart::View with the notes laid out per lane, for consumers
+  // that stream through lanes in time order. Ignored for metaOnly parses.
+  bool BuildView = false;
+  // Threads to build measures on, 0 for one per core. Timelines and
+  // background notes are built concurrently, then long notes and timing are
+  // settled in measure order, so the chart comes out exactly as with 1.
+  // Small charts and metaOnly parses always use a single thread.
+  unsigned int MeasureThreads = 1;
+  // Digests of the source to compute while parsing, into Meta.MD5,
+  // Meta.SHA256 and Meta.ContentHash (XXH64, for cache keys). Turn them off
+  // when nothing looks at them, e.g. when reloading a chart to play it.
+  bool ComputeMD5 = true;
+  bool ComputeSHA256 = true;
+  bool ComputeContentHash = false;
+  // Parsing from bytes keeps a pointer to them, so that Chart::GetMD5() and
+  // the other getters can compute the digests left out above when first
+  // asked. The bytes must outlive those calls. Parse(path) never keeps its
+  // file, and ParseMany ignores this.
+  bool LazyDigests = false;
+  // Runs the MD5 and SHA-256 of the source while the chart is parsed. Null
+  // uses a pool shared by every parser, started on first use. Whatever the
+  // pool has not picked up by the end of the parse is hashed by the parsing
+  // thread itself, so a busy pool never holds a parse up.
+  Executor *HashPool = nullptr;
+  // Sources smaller than this many bytes are hashed on the parsing thread;
+  // handing them to another thread would cost about as much as hashing them.
+  size_t InlineHashBelow = 32 * 1024;
+};
+
+// A parser can be reused for any number of charts, one at a time.
+class Parser {
+public:
+  Parser();
+  void SetRandomSeed(unsigned int RandomSeed);
+  void SetOptions(const ParseOptions &Options);
+  [[nodiscard]] const ParseOptions &GetOptions() const { return Options; }
+
+  void Parse(const std::filesystem::path &path, Chart **Chart,
+             bool addReadyMeasure, bool metaOnly, std::atomic_bool &bCancelled);
+  ~Parser();
+  void Parse(const std::vector<unsigned char> &bytes, Chart **chart,
+             bool addReadyMeasure, bool metaOnly, std::atomic_bool &bCancelled);
+  // Parses a chart from a contiguous byte range owned by the caller. The
+  // bytes are never copied, so they must stay alive until Parse returns.
+  void Parse(const unsigned char *bytes, size_t size, Chart **chart,
+             bool addReadyMeasure, bool metaOnly, std::atomic_bool &bCancelled);
+  // Bumped whenever a change to the parser changes the ChartMeta it
+  // produces, so that anything cached from an older one is thrown away.
+  static constexpr uint32_t Version = 2;
+  static int NoWav;
+  static int MetronomeWav;
+
+private:
+  ParseOptions Options;
+  // bpmTable
+  std::unordered_map<int, double> BpmTable;
+  std::unordered_map<int, double> StopLengthTable;
+  std::unordered_map<int, double> ScrollTable;
+
+  bool UseBase62 = false;
+  TextEncoding SourceEncoding = TextEncoding::ShiftJIS;
+  // free-text values are still in SourceEncoding and need converting
+  bool DecodeValues = false;
+  int Lnobj = -1;
+  int Lntype = 1;
+  unsigned int Seed;
+  static inline int ParseHex(std::string_view Str);
+  static inline long ParseLong(std::string_view Str, int Base);
+  static inline double ParseDouble(std::string_view Str);
+  static inline std::string_view Tail(std::string_view Line, size_t Pos);
+  static inline bool SplitHeader(std::string_view Line, std::string_view &Cmd,
+                                 std::string_view &Xx,
+                                 std::string_view &Value);
+  // forgets the tables and settings of the previous chart
+  void ResetState();
+  // hashSource is false when the caller hashes the bytes itself
+  void ParseBytes(const unsigned char *bytes, size_t size, Chart **chart,
+                  bool addReadyMeasure, bool metaOnly,
+                  std::atomic_bool &bCancelled, bool hashSource);
+  inline int ParseInt(std::string_view Str, bool forceBase32 = false) const;
+  void ParseHeader(Chart *Chart, HeaderKeyword keyword, std::string_view cmd,
+                   std::string_view Xx, std::string_view Value);
+  inline bool CheckResourceIdRange(int Id) const;
+  std::string DecodeText(std::string_view Value) const;
+  inline int ToWaveId(Chart *Chart, int decoded, bool metaOnly);
+#ifdef _WIN32
+  static std::wstring utf8_to_path_t(const std::string &input);
+#else
+  static std::string utf8_to_path_t(const std::string &input);
+#endif
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Binary image of a fully parsed chart, for loading a chart without parsing
+ * its text again. Everything refers to everything else by index or by
+ * offset, never by pointer, so a snapshot file can be mapped and read where
+ * it lies: the note records are the very NoteRecords of Chart::Notes, and
+ * timelines, measures and the WAV/BMP tables are flat arrays next to them.
+ * A snapshot is tied to the source it was taken of by the source's XXH64,
+ * and to the parser by Parser::Version. It is a cache, written in the byte
+ * order of the machine that took it; anything that does not check out is
+ * rejected, never half read.
+ */
+namespace bms_parser {
+// where an array starts, in bytes from the start of the snapshot, and how
+// many elements it has
+struct SnapshotSection {
+  uint64_t Offset;
+  uint64_t Count;
+};
+
+// a string in the snapshot's string section; not null-terminated
+struct SnapshotString {
+  uint32_t Offset;
+  uint32_t Size;
+};
+
+struct SnapshotHeader {
+  uint32_t Magic;
+  uint32_t Format;
+  uint32_t ParserVersion;
+  uint32_t Flags; // SnapshotReadyMeasure
+  uint64_t SourceHash; // XXH64 of the source the chart was parsed from
+  uint64_t TotalSize;
+  SnapshotSection Meta; // one SnapshotMeta
+  SnapshotSection Measures;
+  SnapshotSection TimeLines;
+  SnapshotSection Notes; // NoteRecord, as in Chart::Notes
+  SnapshotSection Links; // SnapshotNoteLink, one per note
+  SnapshotSection Detached;
+  SnapshotSection Wavs; // SnapshotResource, by ascending Id
+  SnapshotSection Bmps;
+  SnapshotSection Strings; // chars
+  // XXH64 of everything but this field
+  uint64_t Checksum;
+};
+
+// the chart was parsed with addReadyMeasure
+constexpr uint32_t SnapshotReadyMeasure = 1;
+
+struct SnapshotMeta {
+  SnapshotString SHA256, MD5, BmsPath, Folder, Artist, SubArtist, Genre,
+      Title, SubTitle, Banner, StageFile, BackBmp, Preview;
+  uint64_t ContentHash;
+  double Bpm, Total, PlayLevel, MinBpm, MaxBpm;
+  int64_t PlayLength, TotalLength;
+  int32_t Rank, Difficulty, Player, KeyMode, TotalNotes, TotalLongNotes,
+      TotalScratchNotes, TotalBackSpinNotes, TotalLandmineNotes, LnMode;
+  uint8_t BgaPoorDefault, IsDP, HasRandom;
+  uint8_t Encoding; // TextEncoding
+  uint32_t Reserved;
+};
+
+struct SnapshotMeasure {
+  double Scale;
+  double Pos;
+  int64_t Timing;
+  // the measure's timelines, in SnapshotHeader::TimeLines
+  uint32_t FirstTimeLine;
+  uint32_t TimeLineCount;
+};
+
+struct SnapshotTimeLine {
+  double Bpm;
+  double StopLength;
+  double Scroll;
+  double BeatPosition;
+  int64_t Timing;
+  int32_t BgaBase, BgaLayer, BgaPoor;
+  // the timeline's notes, in SnapshotHeader::Notes
+  uint32_t FirstNote;
+  uint32_t NoteCount;
+  uint8_t BpmChange, BpmChangeApplied, IsFirstInMeasure;
+  uint8_t Reserved;
+};
+
+// which of its timeline's lists a note is in
+enum class SnapshotSlot : uint8_t {
+  Note = 0,
+  Landmine = 1, // TimeLine::LandmineNotes; landmines usually sit in Notes
+  Invisible = 2,
+  Background = 3,
+};
+
+// What NoteRecord leaves out: the slot, and the note the LongNote::Head or
+// Tail pointer of a long note points at. That is usually its Partner, but
+// when a later note took the other end's place on the chart, it is an entry
+// of SnapshotHeader::Detached, numbered from the note count on.
+struct SnapshotNoteLink {
+  uint32_t Link; // NoNoteId for none
+  SnapshotSlot Slot;
+  uint8_t Reserved[3];
+};
+
+// the other end of a long note that is no longer on the chart
+struct SnapshotDetachedNote {
+  int32_t Wav;
+  uint32_t TimeLine; // the timeline it was placed on; NoNoteId for none
+  uint32_t Link;     // the note on the chart that points at it
+  uint8_t Lane;
+  NoteKind Kind;
+  uint8_t Reserved[2];
+};
+
+// a WAV or BMP table entry
+struct SnapshotResource {
+  int32_t Id;
+  SnapshotString Name;
+};
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value &&
+                  std::is_trivially_copyable<SnapshotMeta>::value &&
+                  std::is_trivially_copyable<SnapshotMeasure>::value &&
+                  std::is_trivially_copyable<SnapshotTimeLine>::value &&
+                  std::is_trivially_copyable<SnapshotNoteLink>::value &&
+                  std::is_trivially_copyable<SnapshotDetachedNote>::value &&
+                  std::is_trivially_copyable<SnapshotResource>::value,
+              "snapshot sections are read in place");
+static_assert(sizeof(SnapshotMeta) % 8 == 0 &&
+                  sizeof(SnapshotMeasure) == 32 &&
+                  sizeof(SnapshotTimeLine) == 64 &&
+                  sizeof(SnapshotNoteLink) == 8 &&
+                  sizeof(SnapshotDetachedNote) == 16 &&
+                  sizeof(SnapshotResource) == 12,
+              "snapshot records have no implicit padding");
+
+// a section of a snapshot, where it lies
+template <typename T> class SnapshotArray {
+public:
+  SnapshotArray() = default;
+  SnapshotArray(const T *data, size_t size) : Data(data), Size(size) {}
+
+  [[nodiscard]] const T &operator[](size_t i) const { return Data[i]; }
+  [[nodiscard]] const T *begin() const { return Data; }
+  [[nodiscard]] const T *end() const { return Data + Size; }
+  [[nodiscard]] const T *data() const { return Data; }
+  [[nodiscard]] size_t size() const { return Size; }
+  [[nodiscard]] bool empty() const { return Size == 0; }
+
+private:
+  const T *Data = nullptr;
+  size_t Size = 0;
+};
+
+class ChartSnapshot {
+public:
+  static constexpr uint32_t Magic = 0x53434D42; // "BMCS"
+  // bump when a section's layout changes
+  static constexpr uint32_t Format = 1;
+
+  ChartSnapshot() = default;
+  ChartSnapshot(const ChartSnapshot &) = delete;
+  ChartSnapshot &operator=(const ChartSnapshot &) = delete;
+
+  // Lays chart out as a snapshot. The note records must be current, as
+  // after a parse, and Meta.ContentHash must be set for the snapshot to ever
+  // match its source. addReadyMeasure is what the chart was parsed with.
+  // False if the chart is too big to index with 32 bits.
+  static bool Serialize(const Chart &chart, bool addReadyMeasure,
+                        std::vector<unsigned char> &bytes);
+  // Serializes to file, through a temporary file so that a crash never
+  // leaves a half-written snapshot behind.
+  static bool Write(const Chart &chart, bool addReadyMeasure,
+                    const std::filesystem::path &file);
+  // Whether bytes hold a complete, consistent snapshot of this format and
+  // parser version: every section in bounds, every index in range and the
+  // checksum right. bytes must be 8-byte aligned.
+  static bool Validate(const unsigned char *bytes, size_t size);
+
+  // Maps file and validates it. False, and closed, if either fails.
+  bool Open(const std::filesystem::path &file);
+  // Uses the caller's bytes, which must outlive the snapshot.
+  bool Open(const unsigned char *bytes, size_t size);
+  void Close();
+  [[nodiscard]] bool IsOpen() const { return Header != nullptr; }
+
+  // Whether the snapshot was taken of the given source, parsed the same way.
+  [[nodiscard]] bool Matches(uint64_t sourceHash, bool addReadyMeasure) const;
+
+  // The sections of an open snapshot, in place. They stay valid until it is
+  // closed.
+  [[nodiscard]] const SnapshotHeader &GetHeader() const { return *Header; }
+  [[nodiscard]] const SnapshotMeta &GetMeta() const;
+  [[nodiscard]] SnapshotArray<SnapshotMeasure> GetMeasures() const;
+  [[nodiscard]] SnapshotArray<SnapshotTimeLine> GetTimeLines() const;
+  [[nodiscard]] SnapshotArray<NoteRecord> GetNotes() const;
+  [[nodiscard]] std::string_view GetString(SnapshotString string) const;
+  // the WAV or BMP file name for id, empty if there is none
+  [[nodiscard]] std::string_view FindWav(int id) const;
+  [[nodiscard]] std::string_view FindBmp(int id) const;
+
+  // Builds the Chart the snapshot was taken of, measures, timelines and
+  // notes included, without looking at the text. View is left null;
+  // LoadOrParse builds it when the parser's options ask for one.
+  [[nodiscard]] Chart *ToChart() const;
+
+  // Loads the chart at chartPath from the snapshot at snapshotPath if that
+  // was taken of the chart as it is now, and parses the text with parser
+  // otherwise, taking a new snapshot for next time. Charts with #RANDOM are
+  // always parsed, so that every load rolls again. Returns true if the
+  // chart came from the snapshot. *chart is null if the chart could not be
+  // read, and may be partly built if the parse was cancelled.
+  static bool LoadOrParse(const std::filesystem::path &chartPath,
+                          const std::filesystem::path &snapshotPath,
+                          Parser &parser, Chart **chart, bool addReadyMeasure,
+                          std::atomic_bool &bCancelled);
+
+private:
+  [[nodiscard]] std::string_view Find(const SnapshotSection &table,
+                                      int id) const;
+  // validates bytes and reads them from then on
+  bool Attach(const unsigned char *bytes, size_t size);
+
+  MappedFile Mapped;
+  const unsigned char *Bytes = nullptr;
+  const SnapshotHeader *Header = nullptr;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <string>
+
+/**
+ * MD5 and SHA-256 of one message in a single pass. Each block goes through
+ * both hashes before the next one is touched, so the message is read from
+ * memory once and the second hash finds the block still in cache.
+ */
+namespace bms_parser {
+class DigestStream {
+public:
+  // small enough to stay in L1/L2 between the two hashes
+  static constexpr size_t BlockSize = 16 * 1024;
+
+  DigestStream(bool md5, bool sha256);
+  // any size; longer runs are split into blocks
+  void Update(const unsigned char *bytes, size_t size);
+  // stores the lowercase hex digests of the enabled hashes, leaving the
+  // other string alone; no updates after this
+  void Finish(std::string &md5, std::string &sha256);
+
+private:
+  bool WantMD5;
+  bool WantSHA256;
+  MD5 Md5;
+  SHA256 Sha256;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * On-disk store of ChartMeta, so a library scan only parses charts that
+ * changed since the last one. A chart counts as unchanged while its size,
+ * modification time and inode are what they were when it was stored, and
+ * the whole store is dropped when Parser::Version moves on. Checking an
+ * entry costs one stat() of the chart; the chart itself is never opened.
+ */
+namespace bms_parser {
+// what MetaCache compares to decide whether a file changed
+struct FileIdentity {
+  std::string Path; // UTF-8, as given; the cache does not normalise paths
+  uint64_t Size = 0;
+  long long ModifiedTime = 0; // nanoseconds
+  // 0 on Windows, where getting one means opening the file
+  uint64_t Inode = 0;
+  uint64_t Device = 0;
+
+  [[nodiscard]] bool operator==(const FileIdentity &other) const;
+  // stats the file; false if it is missing or not a regular file
+  static bool Of(const std::filesystem::path &path, FileIdentity &identity);
+};
+
+class MetaCache {
+public:
+  MetaCache() = default;
+  MetaCache(const MetaCache &) = delete;
+  MetaCache &operator=(const MetaCache &) = delete;
+
+  // Replaces the entries with those saved in file. A missing, corrupt or
+  // outdated file leaves the cache empty and returns false.
+  bool Load(const std::filesystem::path &file);
+  // Writes every entry to file, through a temporary file so that a crash
+  // never leaves a half-written cache behind.
+  bool Save(const std::filesystem::path &file) const;
+
+  // Fills meta and returns true if the chart at path is cached and has not
+  // changed since. Otherwise fills identity, to be handed to Store once the
+  // chart has been parsed: taking it before the parse means a file edited
+  // during the parse is seen as changed next time.
+  bool Find(const std::filesystem::path &path, ChartMeta &meta,
+            FileIdentity &identity);
+  void Store(const FileIdentity &identity, const ChartMeta &meta);
+  // Drops the entries neither found nor stored since Load, i.e. those of
+  // charts that are gone. Returns how many were dropped.
+  size_t RemoveUnused();
+  [[nodiscard]] size_t size() const;
+
+private:
+  struct Entry {
+    FileIdentity Identity;
+    ChartMeta Meta;
+    bool Used = false;
+  };
+  mutable std::mutex Mutex;
+  std::unordered_map<std::string, Entry> Entries; // by FileIdentity::Path
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Hashes many independent messages together. MD5 and SHA-256 can't be split
+ * up within one message, but eight messages fit side by side in the lanes of
+ * an AVX2 register: every lane runs its own message block by block, and
+ * takes the next message as soon as its current one is done.
+ */
+namespace bms_parser {
+// messages hashed at the same time
+constexpr size_t HashLanes = 8;
+
+struct HashInput {
+  const unsigned char *Bytes = nullptr;
+  size_t Size = 0;
+};
+
+struct HashOutput {
+  std::string MD5;
+  std::string SHA256;
+};
+
+// How HashMany runs. Auto puts MD5 in the AVX2 lanes and leaves SHA-256 to
+// SHA-NI when the CPU has it. Lanes puts both in the lanes whenever the CPU
+// has AVX2, even for one message, and Single hashes one message at a time.
+// The last two are for tests.
+enum class HashManyMode { Auto, Lanes, Single };
+
+// Fills outputs[i] with the lowercase hex digests of inputs[i]; a digest
+// that is not wanted is left empty. Messages of similar length share the
+// lanes best, so sort them by size if you can.
+void HashMany(const HashInput *inputs, size_t count, HashOutput *outputs,
+              bool wantMD5 = true, bool wantSHA256 = true,
+              HashManyMode mode = HashManyMode::Auto);
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+/**
+ * Parses a batch of chart files on an executor and hands each chart to a
+ * callback as soon as it is done.
+ */
+namespace bms_parser {
+struct BatchOptions {
+  ParseOptions Parse;
+  bool AddReadyMeasure = false;
+  bool MetaOnly = false;
+  // Runs the parse jobs. When null, ParseMany starts a ThreadPool with one
+  // thread per core for the duration of the call.
+  Executor *Pool = nullptr;
+};
+
+// Gets the index of the path, the chart and, if the file could not be read
+// or parsing threw, the error (in which case chart is null). Owns the chart from then on, even if it throws.
+// Called on the executor's threads, possibly for several charts at once.
+// Once it has thrown, no more files are started and the paths not yet
+// handed over never reach the callback; ParseMany rethrows the first such
+// exception after every job is done with the batch.
+using BatchCallback = std::function<void(size_t index, Chart *chart,
+                                         std::exception_ptr error)>;
+
+// Returns once the callback has been called for every path. The largest
+// files are started first, and every job keeps one Parser for all the files
+// it takes. Jobs take up to HashLanes files at a time and hash them together
+// with HashMany once they are parsed. Paths not started when bCancelled is
+// set are reported with a null chart and no error.
+void ParseMany(const std::vector<std::filesystem::path> &paths,
+               const BatchOptions &options, const BatchCallback &callback,
+               std::atomic_bool &bCancelled);
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of threads with one job queue each. A job submitted from one of
+ * the pool's threads goes to that thread's queue and is taken newest first;
+ * a thread whose queue runs dry steals the oldest job of another queue, so
+ * uneven jobs do not leave threads idle while work is waiting.
+ */
+namespace bms_parser {
+class ThreadPool final : public Executor {
+public:
+  // 0 starts one thread per core
+  explicit ThreadPool(unsigned int threads = 0);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  // runs every job that is still queued, then joins the threads
+  ~ThreadPool() override;
+
+  void Submit(std::function<void()> job) override;
+  [[nodiscard]] unsigned int Concurrency() const override {
+    return static_cast<unsigned int>(Threads.size());
+  }
+
+private:
+  struct Queue {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Jobs;
+  };
+
+  bool TryTake(size_t self, std::function<void()> &job);
+  void Run(size_t self);
+
+  std::vector<std::unique_ptr<Queue>> Queues;
+  std::vector<std::thread> Threads;
+  // jobs submitted and not taken yet; may briefly run ahead of the queues
+  std::atomic<size_t> Pending{0};
+  std::atomic<size_t> NextQueue{0};
+  std::mutex WakeMutex;
+  std::condition_variable Wake;
+  bool Stopping = false; // guarded by WakeMutex
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <string_view>
+
+/**
+ * Splits a buffer into lines without copying. Lines end at '\n', and a '\r'
+ * right before it (or before the end of the buffer) is dropped. The views
+ * point into the buffer, so they are only valid as long as it is.
+ */
+namespace bms_parser {
+class LineScanner {
+public:
+  explicit LineScanner(std::string_view content)
+      : Cursor(content.data()), End(content.data() + content.size()) {}
+
+  // returns false once every line has been handed out
+  bool Next(std::string_view &line) {
+    if (Cursor >= End) {
+      return false;
+    }
+    // memchr is vectorised by every libc we care about
+    auto newline = static_cast<const char *>(
+        std::memchr(Cursor, '\n', static_cast<size_t>(End - Cursor)));
+    const char *lineEnd = newline != nullptr ? newline : End;
+    line = std::string_view(Cursor, static_cast<size_t>(lineEnd - Cursor));
+    Cursor = newline != nullptr ? newline + 1 : End;
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    return true;
+  }
+
+private:
+  const char *Cursor;
+  const char *End;
+};
+} // namespace bms_parser
+
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Everything that changes while a chart is being played, kept apart from
+ * the parsed chart so that one chart can back several plays at once. The
+ * state of a note lives at its Note::Id, and starting over clears the whole
+ * buffer in one go.
+ */
+namespace bms_parser {
+class Chart;
+
+struct NoteState {
+  long long PlayedTime;
+  // long note tails only
+  long long ReleaseTime;
+  bool IsPlayed;
+  bool IsDead;
+  // set on both ends of a long note while it is held
+  bool IsHolding;
+};
+
+class PlayState {
+public:
+  // the chart has to outlive the state, and its note records be current
+  explicit PlayState(const Chart &chart);
+
+  // back to the state before the first note
+  void Reset();
+
+  [[nodiscard]] size_t size() const { return States.size(); }
+  NoteState &operator[](uint32_t id) { return States[id]; }
+  const NoteState &operator[](uint32_t id) const { return States[id]; }
+
+  void Play(uint32_t id, long long time);
+  // pressing a long note head holds it until its tail is released
+  void Press(uint32_t id, long long time);
+  void Release(uint32_t id, long long time);
+
+private:
+  const std::vector<NoteRecord> *Notes;
+  std::vector<NoteState> States;
+};
+} // namespace bms_parser
+
+// https://stackoverflow.com/questions/33165171/c-shiftjis-to-utf8-conversion
+
+#include <string>
+#include <vector>
+namespace bms_parser {
+namespace ShiftJISConverter {
+void BytesToUTF8(const unsigned char *input, size_t size, std::string &result);
+}
+
+} // namespace bms_parser
+
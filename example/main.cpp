@@ -17,6 +17,8 @@
 #include "bms_parser.hpp"
 #else
 #include "../src/Chart.h"
+#include "../src/MetaCache.h"
+#include "../src/ParseMany.h"
 #include "../src/Parser.h"
 
 #endif
@@ -26,12 +28,10 @@
 #include <codecvt>
 #include <filesystem>
 #include <fstream>
-#include <functional>
 #include <iostream>
 #include <mutex>
 #include <string>
 #include <sys/stat.h>
-#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -41,25 +41,6 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #endif
-void parallel_for(int n, std::function<void(int start, int end)> f) {
-  unsigned int nThreads = std::thread::hardware_concurrency();
-  nThreads = nThreads == 0 ? 1 : nThreads;
-  unsigned int batchSize = n / nThreads;
-  unsigned int remainder = n % nThreads;
-  std::vector<std::thread> threads;
-  for (unsigned int i = 0; i < nThreads; i++) {
-    unsigned int start = i * batchSize;
-    unsigned int end = start + batchSize;
-    if (i == nThreads - 1) {
-      end += remainder;
-    }
-    threads.push_back(std::thread(f, start, end));
-  }
-  for (auto &t : threads) {
-    t.join();
-  }
-}
-
 void parse_single_metadata(const std::filesystem::path &bmsFile) {
   bms_parser::Parser parser;
   bms_parser::Chart *chart;
@@ -255,42 +236,52 @@ bool construct_folder_db(const std::filesystem::path &path) {
                         .wstring());
   }
   sqlite3_finalize(stmt);
+  // files already in the database are only parsed again if they changed
+  bms_parser::MetaCache cache;
+  cache.Load("bms.metacache");
   std::vector<Diff> diffs;
-  std::cout << "Finding new bms files" << std::endl;
-  find_new_bms_files(diffs, oldFiles, path);
-  std::cout << "Found " << diffs.size() << " new bms files" << std::endl;
+  std::cout << "Finding bms files" << std::endl;
+  find_new_bms_files(diffs, {}, path);
+  std::vector<std::filesystem::path> added;
+  std::vector<bms_parser::FileIdentity> identities;
   for (auto &diff : diffs) {
+    bms_parser::ChartMeta meta;
+    bms_parser::FileIdentity identity;
+    if (cache.Find(diff.path, meta, identity) &&
+        oldFiles.count(diff.path.wstring()) != 0) {
+      continue;
+    }
     std::wcout << diff.path << L" " << diff.type << std::endl;
+    added.push_back(diff.path);
+    identities.push_back(identity);
   }
+  std::cout << "Found " << added.size() << " new or changed bms files"
+            << std::endl;
   std::atomic_bool is_committing = false;
   std::atomic_int success_count = 0; // commit every 1000 files
 
   auto startTime = std::chrono::high_resolution_clock::now();
 
   sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr);
-
-  parallel_for(diffs.size(), [&](int start, int end) {
-    for (int i = start; i < end; i++) {
-      if (diffs[i].type == Added) {
-
-        bms_parser::Parser parser;
-        bms_parser::Chart *chart;
-        std::atomic_bool cancel = false;
-        try {
-          parser.Parse(diffs[i].path.wstring(), &chart, false, true, cancel);
-          // std::cout << "Title: " << ws2s(chart->Meta.Title) << std::endl;
-          // std::cout << "SubTitle: " << ws2s(chart->Meta.SubTitle) <<
-          // std::endl; std::cout << "Artist: " << ws2s(chart->Meta.Artist) <<
-          // std::endl;
-        } catch (std::exception &e) {
-          delete chart;
-          std::cerr << "Error parsing " << diffs[i].path << ": " << e.what()
-                    << std::endl;
-          continue;
+  bms_parser::BatchOptions batchOptions;
+  batchOptions.MetaOnly = true;
+  std::atomic_bool cancel = false;
+  bms_parser::ParseMany(
+      added, batchOptions,
+      [&](size_t i, bms_parser::Chart *chart, std::exception_ptr error) {
+        if (error) {
+          try {
+            std::rethrow_exception(error);
+          } catch (std::exception &e) {
+            std::cerr << "Error parsing " << added[i] << ": " << e.what()
+                      << std::endl;
+          } catch (...) {
+            std::cerr << "Error parsing " << added[i] << std::endl;
+          }
+          return;
         }
-
         if (chart == nullptr) {
-          continue;
+          return;
         }
         ++success_count;
         if (success_count % 1000 == 0 && !is_committing) {
@@ -410,12 +401,14 @@ bool construct_folder_db(const std::filesystem::path &path) {
           return;
         }
         sqlite3_finalize(stmt);
+        cache.Store(identities[i], chart->Meta);
         delete chart;
-      }
-    }
-  });
+      },
+      cancel);
 
   sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+  cache.RemoveUnused();
+  cache.Save("bms.metacache");
 
   sqlite3_close(db);
   auto endTime = std::chrono::high_resolution_clock::now();
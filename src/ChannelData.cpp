@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChannelData.h"
+#include <array>
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+namespace {
+constexpr size_t PairsPerWord = 64;
+
+constexpr int Radix(PairBase base) {
+  return base == PairBase::Hex ? 16 : base == PairBase::Base36 ? 36 : 62;
+}
+
+// digit value of every byte, or -1
+constexpr std::array<int8_t, 256> BuildDigitTable(PairBase base) {
+  // base 62 is case sensitive, the others aren't
+  const int lowerBase = base == PairBase::Base62 ? 36 : 10;
+  std::array<int8_t, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    int value = -1;
+    if (c >= '0' && c <= '9') {
+      value = c - '0';
+    } else if (c >= 'A' && c <= 'Z') {
+      value = c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'z') {
+      value = c - 'a' + lowerBase;
+    }
+    table[c] = static_cast<int8_t>(value < Radix(base) ? value : -1);
+  }
+  return table;
+}
+
+constexpr auto HexDigits = BuildDigitTable(PairBase::Hex);
+constexpr auto Base36Digits = BuildDigitTable(PairBase::Base36);
+constexpr auto Base62Digits = BuildDigitTable(PairBase::Base62);
+
+// Each of these handles whole words of 64 pairs (128 bytes) and stores the
+// non-"00" mask of each.
+void NonZeroWordsScalar(const char *data, size_t words, uint64_t *nonZero) {
+  for (size_t w = 0; w < words; ++w) {
+    uint64_t mask = 0;
+    const char *pairs = data + w * PairsPerWord * 2;
+    for (size_t j = 0; j < PairsPerWord; ++j) {
+      if (pairs[j * 2] != '0' || pairs[j * 2 + 1] != '0') {
+        mask |= uint64_t{1} << j;
+      }
+    }
+    nonZero[w] = mask;
+  }
+}
+
+#if BMS_PARSER_X86
+BMS_PARSER_TARGET("sse2")
+void NonZeroWordsSse2(const char *data, size_t words, uint64_t *nonZero) {
+  // a pair is one 16-bit lane; "00" is 0x3030 whichever the byte order
+  const __m128i zeroPair = _mm_set1_epi16(0x3030);
+  for (size_t w = 0; w < words; ++w) {
+    const char *pairs = data + w * PairsPerWord * 2;
+    uint64_t zero = 0;
+    for (size_t k = 0; k < 4; ++k) {
+      const __m128i a =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(pairs + k * 32));
+      const __m128i b = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(pairs + k * 32 + 16));
+      // narrow the 16-bit results to one byte, so one bit per pair
+      const __m128i packed = _mm_packs_epi16(_mm_cmpeq_epi16(a, zeroPair),
+                                             _mm_cmpeq_epi16(b, zeroPair));
+      zero |= static_cast<uint64_t>(
+                  static_cast<uint32_t>(_mm_movemask_epi8(packed)))
+              << (k * 16);
+    }
+    nonZero[w] = ~zero;
+  }
+}
+
+BMS_PARSER_TARGET("avx2")
+void NonZeroWordsAvx2(const char *data, size_t words, uint64_t *nonZero) {
+  const __m256i zeroPair = _mm256_set1_epi16(0x3030);
+  for (size_t w = 0; w < words; ++w) {
+    const char *pairs = data + w * PairsPerWord * 2;
+    uint64_t zero = 0;
+    for (size_t k = 0; k < 2; ++k) {
+      const __m256i a =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pairs + k * 64));
+      const __m256i b = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(pairs + k * 64 + 32));
+      const __m256i packed = _mm256_packs_epi16(
+          _mm256_cmpeq_epi16(a, zeroPair), _mm256_cmpeq_epi16(b, zeroPair));
+      // packs works per 128-bit lane; put the quarters back in order
+      const __m256i ordered = _mm256_permute4x64_epi64(packed, 0xD8);
+      zero |= static_cast<uint64_t>(
+                  static_cast<uint32_t>(_mm256_movemask_epi8(ordered)))
+              << (k * 32);
+    }
+    nonZero[w] = ~zero;
+  }
+}
+#endif
+
+using NonZeroWordsFn = void (*)(const char *, size_t, uint64_t *);
+
+NonZeroWordsFn SelectNonZeroWords() {
+#if BMS_PARSER_X86
+  if (CpuFeatures::HasAVX2()) {
+    return NonZeroWordsAvx2;
+  }
+  if (CpuFeatures::HasSSE2()) {
+    return NonZeroWordsSse2;
+  }
+#endif
+  return NonZeroWordsScalar;
+}
+} // namespace
+
+size_t ChannelData::Decode(std::string_view data, PairBase base,
+                           std::vector<int> &ids,
+                           std::vector<uint64_t> &nonZero) {
+  static const NonZeroWordsFn nonZeroWords = SelectNonZeroWords();
+  const size_t count = data.size() / 2;
+  const size_t fullWords = count / PairsPerWord;
+  ids.resize(count);
+  nonZero.resize((count + PairsPerWord - 1) / PairsPerWord);
+
+  nonZeroWords(data.data(), fullWords, nonZero.data());
+  if (fullWords != nonZero.size()) {
+    // the tail is too short for a vector
+    uint64_t mask = 0;
+    for (size_t j = fullWords * PairsPerWord; j < count; ++j) {
+      if (data[j * 2] != '0' || data[j * 2 + 1] != '0') {
+        mask |= uint64_t{1} << (j % PairsPerWord);
+      }
+    }
+    nonZero[fullWords] = mask;
+  }
+
+  const auto &digits = base == PairBase::Hex      ? HexDigits
+                       : base == PairBase::Base36 ? Base36Digits
+                                                  : Base62Digits;
+  const int radix = Radix(base);
+  for (size_t j = NextNonZero(nonZero, 0, count); j < count;
+       j = NextNonZero(nonZero, j + 1, count)) {
+    const int high = digits[static_cast<unsigned char>(data[j * 2])];
+    const int low = digits[static_cast<unsigned char>(data[j * 2 + 1])];
+    ids[j] = (high | low) < 0 ? Undecoded : high * radix + low;
+  }
+  return count;
+}
+} // namespace bms_parser
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "CpuFeatures.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace bms_parser {
+enum class PairBase {
+  Hex,    // channel 03
+  Base36, // the default, and always for mines
+  Base62, // #BASE 62
+};
+
+/**
+ * Decodes the data of a channel line ("00AB00CD...") a whole line at a time.
+ * "00" pairs are found with SIMD compares and only the remaining pairs are
+ * decoded, through lookup tables.
+ */
+namespace ChannelData {
+// written to ids for pairs the tables can't decode (signs, spaces, '*', ...)
+// so the caller can fall back to the slow path
+constexpr int Undecoded = INT32_MIN;
+
+// Splits data into data.size() / 2 pairs and returns that count. Bit j % 64
+// of nonZero[j / 64] is set unless pair j is exactly "00", and ids[j] holds
+// the decoded value of every such pair. Both vectors are reused between
+// calls; entries for "00" pairs are left unspecified.
+size_t Decode(std::string_view data, PairBase base, std::vector<int> &ids,
+              std::vector<uint64_t> &nonZero);
+
+// index of the first non-"00" pair at or after from, or count if none
+inline size_t NextNonZero(const std::vector<uint64_t> &nonZero, size_t from,
+                          size_t count) {
+  size_t word = from / 64;
+  if (from >= count) {
+    return count;
+  }
+  uint64_t bits = nonZero[word] & (~uint64_t{0} << (from % 64));
+  while (bits == 0) {
+    if (++word * 64 >= count) {
+      return count;
+    }
+    bits = nonZero[word];
+  }
+  return word * 64 + CpuFeatures::CountTrailingZeros64(bits);
+}
+} // namespace ChannelData
+} // namespace bms_parser
@@ -15,14 +15,129 @@
  */
 
 #include "Chart.h"
+#include "LongNote.h"
+#include "SHA256.h"
+#include "XXHash64.h"
+#include "md5.h"
+
 namespace bms_parser {
+namespace {
+NoteRecord MakeRecord(const Note *note, NoteKind kind, uint32_t timeline) {
+  NoteRecord record{};
+  record.Wav = note->Wav;
+  record.Timeline = timeline;
+  record.Partner = NoNoteId;
+  record.Lane = static_cast<uint8_t>(note->Lane);
+  record.Kind = kind;
+  return record;
+}
+} // namespace
+
 Chart::Chart() = default;
 
 Chart::~Chart() {
   for (const auto &measure : Measures) {
-    delete measure;
+    measure->~Measure();
   }
 
   Measures.clear();
 }
+
+const std::string &Chart::GetMD5() {
+  std::call_once(MD5Once, [this] {
+    if (Meta.MD5.empty() && HasSource) {
+      MD5 md5;
+      md5.update(SourceBytes, static_cast<MD5::size_type>(SourceSize));
+      md5.finalize();
+      Meta.MD5 = md5.hexdigest();
+    }
+  });
+  return Meta.MD5;
+}
+
+const std::string &Chart::GetSHA256() {
+  std::call_once(SHA256Once, [this] {
+    if (Meta.SHA256.empty() && HasSource) {
+      Meta.SHA256 = sha256(SourceBytes, SourceSize);
+    }
+  });
+  return Meta.SHA256;
+}
+
+uint64_t Chart::GetContentHash() {
+  std::call_once(ContentHashOnce, [this] {
+    if (Meta.ContentHash == 0 && HasSource) {
+      Meta.ContentHash = XXHash64(SourceBytes, SourceSize);
+    }
+  });
+  return Meta.ContentHash;
+}
+
+void Chart::SetDigestSource(const unsigned char *bytes, size_t size) {
+  HasSource = true;
+  SourceBytes = bytes;
+  SourceSize = size;
+}
+
+void Chart::ClearDigestSource() {
+  HasSource = false;
+  SourceBytes = nullptr;
+  SourceSize = 0;
+}
+
+void Chart::BuildNoteRecords() {
+  TimeLines.clear();
+  Notes.clear();
+  // the note behind each record; Ids left over from an earlier build are
+  // stale, so a head's Id only counts if it points back at that head
+  std::vector<const Note *> numbered;
+  const auto add = [this, &numbered](Note *note, NoteKind kind) {
+    note->Kind = kind;
+    note->Id = static_cast<uint32_t>(Notes.size());
+    numbered.push_back(note);
+    Notes.push_back(
+        MakeRecord(note, kind, static_cast<uint32_t>(TimeLines.size() - 1)));
+    return &Notes.back();
+  };
+  for (const auto &measure : Measures) {
+    for (const auto &timeline : measure->TimeLines) {
+      TimeLines.push_back(timeline);
+      timeline->Notes.ForEach([&](int, Note *note) {
+        if (note->IsLandmineNote()) {
+          add(note, NoteKind::Landmine)->Damage =
+              static_cast<LandmineNote *>(note)->Damage;
+          return;
+        }
+        if (!note->IsLongNote()) {
+          add(note, NoteKind::Normal);
+          return;
+        }
+        auto ln = static_cast<LongNote *>(note);
+        if (ln->Head == nullptr) {
+          // the tail links the pair once it is reached
+          add(ln, NoteKind::LongHead);
+          return;
+        }
+        auto record = add(ln, NoteKind::LongTail);
+        // heads sit on earlier timelines and are numbered by now, unless a
+        // later note took their slot or they were removed from the chart;
+        // then their Id is stale and may name some other note
+        const auto headId = ln->Head->Id;
+        if (headId < ln->Id && numbered[headId] == ln->Head &&
+            Notes[headId].Kind == NoteKind::LongHead) {
+          record->Partner = headId;
+          Notes[headId].Partner = ln->Id;
+        }
+      });
+      timeline->LandmineNotes.ForEach([&](int, LandmineNote *note) {
+        add(note, NoteKind::Landmine)->Damage = note->Damage;
+      });
+      timeline->InvisibleNotes.ForEach(
+          [&](int, Note *note) { add(note, NoteKind::Invisible); });
+      for (const auto &note : timeline->BackgroundNotes) {
+        add(note, NoteKind::Background);
+      }
+    }
+  }
+}
 } // namespace bms_parser
@@ -16,8 +16,15 @@
 
 #pragma once
 
+#include "ChartArena.h"
+#include "ChartView.h"
 #include "Measure.h"
+#include "TextEncoding.h"
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -27,6 +34,7 @@ class ChartMeta {
 public:
   std::string SHA256;
   std::string MD5;
+  uint64_t ContentHash = 0; // XXH64 of the source, 0 if not computed
   std::filesystem::path BmsPath;
   std::filesystem::path Folder;
   std::string Artist;
@@ -59,6 +67,9 @@ public:
   int TotalBackSpinNotes = 0;
   int TotalLandmineNotes = 0;
   int LnMode = 0; // 0: user decides, 1: LN, 2: CN, 3: HCN
+  TextEncoding Encoding = TextEncoding::ShiftJIS; // encoding of the source
+  // the chart has #RANDOM blocks, so another seed may give another chart
+  bool HasRandom = false;
 
   [[nodiscard]] int GetKeyLaneCount() const { return KeyMode; }
   [[nodiscard]] int GetScratchLaneCount() const { return IsDP ? 2 : 1; }
@@ -104,9 +115,44 @@ class Chart {
 public:
   Chart();
   ~Chart();
+  // Fills TimeLines and Notes from Measures and numbers the notes. The parser
+  // calls this once the chart is complete; call it again after editing
+  // Measures by hand.
+  void BuildNoteRecords();
+  // The digests of the source, as in Meta. Those the parse did not compute
+  // are computed on first call from the source bytes, if
+  // ParseOptions::LazyDigests kept them, and stay empty (0) otherwise. Safe
+  // to call from several threads at once.
+  const std::string &GetMD5();
+  const std::string &GetSHA256();
+  uint64_t GetContentHash();
+  // Where the digests above come from; the bytes must stay alive until they
+  // have all been asked for, or until the source is cleared. Neither is safe
+  // to call while another thread is in one of the getters.
+  void SetDigestSource(const unsigned char *bytes, size_t size);
+  void ClearDigestSource();
   ChartMeta Meta;
+  // Measures, their timelines and their notes all live in Arena and go away
+  // with the chart; anything added to Measures must come from it as well.
+  ChartArena Arena;
   std::vector<Measure *> Measures;
+  // every timeline of every measure, in order
+  std::vector<TimeLine *> TimeLines;
+  // one record per note, grouped by timeline; Note::Id indexes into this
+  std::vector<NoteRecord> Notes;
+  // per-lane arrays of the notes; only built when ParseOptions::BuildView
+  // is set, null otherwise
+  std::unique_ptr<ChartView> View;
   std::unordered_map<int, std::string> WavTable;
   std::unordered_map<int, std::string> BmpTable;
+
+private:
+  // an empty source may well have null bytes
+  bool HasSource = false;
+  const unsigned char *SourceBytes = nullptr;
+  size_t SourceSize = 0;
+  std::once_flag MD5Once;
+  std::once_flag SHA256Once;
+  std::once_flag ContentHashOnce;
 };
 } // namespace bms_parser
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChartArena.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace bms_parser {
+ChartArena::~ChartArena() {
+  while (Blocks != nullptr) {
+    Block *next = Blocks->Next;
+    std::free(Blocks);
+    Blocks = next;
+  }
+}
+
+void ChartArena::Adopt(ChartArena &other) {
+  if (other.Blocks == nullptr || &other == this) {
+    return;
+  }
+  Block *last = other.Blocks;
+  while (last->Next != nullptr) {
+    last = last->Next;
+  }
+  // keep allocating from the current block, which has to stay in front
+  if (Blocks == nullptr) {
+    Blocks = other.Blocks;
+    Cursor = other.Cursor;
+    Limit = other.Limit;
+  } else {
+    last->Next = Blocks->Next;
+    Blocks->Next = other.Blocks;
+  }
+  Reserved += other.Reserved;
+  other.Blocks = nullptr;
+  other.Cursor = 0;
+  other.Limit = 0;
+  other.Reserved = 0;
+}
+
+void *ChartArena::AllocateSlow(size_t size, size_t align) {
+  // blocks double up to MaxBlockSize; anything bigger gets a block of its own
+  size_t blockSize =
+      Blocks == nullptr ? FirstBlockSize
+                        : std::min(Blocks->Size * 2, MaxBlockSize);
+  blockSize = std::max(blockSize, sizeof(Block) + size + align);
+  auto block = static_cast<Block *>(std::malloc(blockSize));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  block->Next = Blocks;
+  block->Size = blockSize;
+  Blocks = block;
+  Reserved += blockSize;
+  Cursor = reinterpret_cast<uintptr_t>(block + 1);
+  Limit = reinterpret_cast<uintptr_t>(block) + blockSize;
+  return Allocate(size, align);
+}
+} // namespace bms_parser
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+/**
+ * Monotonic allocator that owns the measures, timelines and notes of a chart.
+ * Allocation bumps a pointer inside the current block and nothing is freed
+ * until the arena itself goes away, at which point the handful of blocks are
+ * released at once.
+ */
+namespace bms_parser {
+class ChartArena {
+public:
+  ChartArena() = default;
+  ChartArena(const ChartArena &) = delete;
+  ChartArena &operator=(const ChartArena &) = delete;
+  ~ChartArena();
+
+  // Constructs a T in the arena. The arena never runs destructors, so an
+  // object that owns heap memory of its own has to be destroyed explicitly.
+  template <typename T, typename... Args> T *New(Args &&...args) {
+    return new (Allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+  }
+
+  // align must be a power of two no larger than alignof(std::max_align_t)
+  void *Allocate(size_t size, size_t align) {
+    const uintptr_t start = (Cursor + align - 1) & ~(uintptr_t{align} - 1);
+    if (start + size > Limit || start < Cursor) {
+      return AllocateSlow(size, align);
+    }
+    Cursor = start + size;
+    return reinterpret_cast<void *>(start);
+  }
+
+  // Takes over the blocks of other, which is left empty. Everything built in
+  // other then lives as long as this arena.
+  void Adopt(ChartArena &other);
+
+  // bytes held in blocks, used or not
+  [[nodiscard]] size_t Capacity() const { return Reserved; }
+
+private:
+  struct Block {
+    Block *Next;
+    size_t Size;
+  };
+  static constexpr size_t FirstBlockSize = 16 * 1024;
+  static constexpr size_t MaxBlockSize = 1024 * 1024;
+
+  void *AllocateSlow(size_t size, size_t align);
+
+  Block *Blocks = nullptr;
+  uintptr_t Cursor = 0;
+  uintptr_t Limit = 0;
+  size_t Reserved = 0;
+};
+} // namespace bms_parser
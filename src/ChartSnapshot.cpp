@@ -0,0 +1,812 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChartSnapshot.h"
+#include "ChartView.h"
+#include "LandmineNote.h"
+#include "LongNote.h"
+#include "XXHash64.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <system_error>
+#include <unordered_map>
+
+namespace bms_parser {
+namespace {
+// every section starts on a multiple of this, so that its records can be
+// read in place
+constexpr size_t SectionAlign = 8;
+
+size_t AlignSection(size_t offset) {
+  return (offset + SectionAlign - 1) & ~(SectionAlign - 1);
+}
+
+// the string section, built while the other sections are laid out
+class SnapshotStrings {
+public:
+  std::string Chars;
+  bool Overflowed = false;
+
+  SnapshotString Add(std::string_view value) {
+    if (value.size() > UINT32_MAX - Chars.size()) {
+      Overflowed = true;
+      return {0, 0};
+    }
+    const SnapshotString string{static_cast<uint32_t>(Chars.size()),
+                                static_cast<uint32_t>(value.size())};
+    Chars.append(value);
+    return string;
+  }
+  SnapshotString AddPath(const std::filesystem::path &value) {
+    return Add(value.u8string());
+  }
+};
+
+SnapshotMeta ToSnapshotMeta(const ChartMeta &meta, SnapshotStrings &strings) {
+  SnapshotMeta snapshot;
+  std::memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.SHA256 = strings.Add(meta.SHA256);
+  snapshot.MD5 = strings.Add(meta.MD5);
+  snapshot.BmsPath = strings.AddPath(meta.BmsPath);
+  snapshot.Folder = strings.AddPath(meta.Folder);
+  snapshot.Artist = strings.Add(meta.Artist);
+  snapshot.SubArtist = strings.Add(meta.SubArtist);
+  snapshot.Genre = strings.Add(meta.Genre);
+  snapshot.Title = strings.Add(meta.Title);
+  snapshot.SubTitle = strings.Add(meta.SubTitle);
+  snapshot.Banner = strings.AddPath(meta.Banner);
+  snapshot.StageFile = strings.AddPath(meta.StageFile);
+  snapshot.BackBmp = strings.AddPath(meta.BackBmp);
+  snapshot.Preview = strings.AddPath(meta.Preview);
+  snapshot.ContentHash = meta.ContentHash;
+  snapshot.Bpm = meta.Bpm;
+  snapshot.Total = meta.Total;
+  snapshot.PlayLevel = meta.PlayLevel;
+  snapshot.MinBpm = meta.MinBpm;
+  snapshot.MaxBpm = meta.MaxBpm;
+  snapshot.PlayLength = meta.PlayLength;
+  snapshot.TotalLength = meta.TotalLength;
+  snapshot.Rank = meta.Rank;
+  snapshot.Difficulty = meta.Difficulty;
+  snapshot.Player = meta.Player;
+  snapshot.KeyMode = meta.KeyMode;
+  snapshot.TotalNotes = meta.TotalNotes;
+  snapshot.TotalLongNotes = meta.TotalLongNotes;
+  snapshot.TotalScratchNotes = meta.TotalScratchNotes;
+  snapshot.TotalBackSpinNotes = meta.TotalBackSpinNotes;
+  snapshot.TotalLandmineNotes = meta.TotalLandmineNotes;
+  snapshot.LnMode = meta.LnMode;
+  snapshot.BgaPoorDefault = meta.BgaPoorDefault;
+  snapshot.IsDP = meta.IsDP;
+  snapshot.HasRandom = meta.HasRandom;
+  snapshot.Encoding = static_cast<uint8_t>(meta.Encoding);
+  return snapshot;
+}
+
+// The snapshot's resource table for table, by ascending id. Ids are unique,
+// so sorting by them alone gives the same bytes every time.
+std::vector<SnapshotResource>
+ToSnapshotTable(const std::unordered_map<int, std::string> &table,
+                SnapshotStrings &strings) {
+  std::vector<SnapshotResource> resources;
+  resources.reserve(table.size());
+  for (const auto &[id, name] : table) {
+    resources.push_back({id, {0, 0}});
+  }
+  std::sort(resources.begin(), resources.end(),
+            [](const SnapshotResource &a, const SnapshotResource &b) {
+              return a.Id < b.Id;
+            });
+  for (auto &resource : resources) {
+    resource.Name = strings.Add(table.at(resource.Id));
+  }
+  return resources;
+}
+
+template <typename T>
+bool InSection(const SnapshotSection &section, size_t size) {
+  return section.Offset % alignof(T) == 0 && section.Offset <= size &&
+         section.Count <= (size - section.Offset) / sizeof(T);
+}
+
+// a section of bytes that InSection has accepted
+template <typename T>
+SnapshotArray<T> SectionAt(const unsigned char *bytes,
+                           const SnapshotSection &section) {
+  return {reinterpret_cast<const T *>(bytes + section.Offset),
+          static_cast<size_t>(section.Count)};
+}
+
+bool InStrings(const SnapshotString &string, uint64_t stringsSize) {
+  return string.Offset <= stringsSize &&
+         string.Size <= stringsSize - string.Offset;
+}
+
+uint64_t SnapshotChecksum(const unsigned char *bytes, size_t size) {
+  const auto header = XXHash64(bytes, offsetof(SnapshotHeader, Checksum));
+  return XXHash64(bytes + sizeof(SnapshotHeader),
+                  size - sizeof(SnapshotHeader), header);
+}
+
+// reads the whole source, mapped if the parser would map it
+bool ReadSource(const std::filesystem::path &path, bool useMemoryMap,
+                MappedFile &mapped, std::vector<unsigned char> &buffer,
+                const unsigned char *&data, size_t &size) {
+  if (useMemoryMap && mapped.Open(path)) {
+    data = mapped.GetData();
+    size = mapped.GetSize();
+    return true;
+  }
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cout << "Failed to open file: " << path << std::endl;
+    return false;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+  data = buffer.data();
+  size = buffer.size();
+  return true;
+}
+} // namespace
+
+bool ChartSnapshot::Serialize(const Chart &chart, bool addReadyMeasure,
+                              std::vector<unsigned char> &bytes) {
+  const auto noteCount = chart.Notes.size();
+  if (noteCount >= NoNoteId / 2 || chart.TimeLines.size() >= NoNoteId) {
+    return false;
+  }
+  // the notes in record order, walked the way BuildNoteRecords numbers them
+  std::vector<const Note *> notes;
+  std::vector<SnapshotNoteLink> links;
+  notes.reserve(noteCount);
+  links.reserve(noteCount);
+  const auto add = [&](const Note *note, SnapshotSlot slot) {
+    SnapshotNoteLink link;
+    std::memset(&link, 0, sizeof(link));
+    link.Link = NoNoteId;
+    link.Slot = slot;
+    notes.push_back(note);
+    links.push_back(link);
+  };
+  std::vector<SnapshotMeasure> measures;
+  std::vector<SnapshotTimeLine> timelines;
+  measures.reserve(chart.Measures.size());
+  timelines.reserve(chart.TimeLines.size());
+  for (const auto &measure : chart.Measures) {
+    SnapshotMeasure m;
+    std::memset(&m, 0, sizeof(m));
+    m.Scale = measure->Scale;
+    m.Pos = measure->Pos;
+    m.Timing = measure->Timing;
+    m.FirstTimeLine = static_cast<uint32_t>(timelines.size());
+    m.TimeLineCount = static_cast<uint32_t>(measure->TimeLines.size());
+    for (const auto &timeline : measure->TimeLines) {
+      if (timelines.size() >= chart.TimeLines.size() ||
+          chart.TimeLines[timelines.size()] != timeline) {
+        return false; // TimeLines is out of date
+      }
+      SnapshotTimeLine t;
+      std::memset(&t, 0, sizeof(t));
+      t.Bpm = timeline->Bpm;
+      t.StopLength = timeline->StopLength;
+      t.Scroll = timeline->Scroll;
+      t.BeatPosition = timeline->BeatPosition;
+      t.Timing = timeline->Timing;
+      t.BgaBase = timeline->BgaBase;
+      t.BgaLayer = timeline->BgaLayer;
+      t.BgaPoor = timeline->BgaPoor;
+      t.BpmChange = timeline->BpmChange;
+      t.BpmChangeApplied = timeline->BpmChangeApplied;
+      t.IsFirstInMeasure = timeline->IsFirstInMeasure;
+      t.FirstNote = static_cast<uint32_t>(notes.size());
+      timeline->Notes.ForEach(
+          [&](int, const Note *note) { add(note, SnapshotSlot::Note); });
+      timeline->LandmineNotes.ForEach([&](int, const LandmineNote *note) {
+        add(note, SnapshotSlot::Landmine);
+      });
+      timeline->InvisibleNotes.ForEach(
+          [&](int, const Note *note) { add(note, SnapshotSlot::Invisible); });
+      for (const auto &note : timeline->BackgroundNotes) {
+        add(note, SnapshotSlot::Background);
+      }
+      t.NoteCount = static_cast<uint32_t>(notes.size() - t.FirstNote);
+      timelines.push_back(t);
+    }
+    measures.push_back(m);
+  }
+  if (timelines.size() != chart.TimeLines.size() ||
+      notes.size() != noteCount) {
+    return false;
+  }
+  for (size_t i = 0; i < noteCount; ++i) {
+    if (notes[i]->Id != i) {
+      return false; // the note records are out of date
+    }
+  }
+
+  // where each long note's Head or Tail points
+  std::vector<SnapshotDetachedNote> detached;
+  std::unordered_map<const Note *, uint32_t> detachedIds;
+  std::unordered_map<const TimeLine *, uint32_t> timelineIds;
+  for (size_t i = 0; i < noteCount; ++i) {
+    const auto &record = chart.Notes[i];
+    if (!record.IsLongNote()) {
+      continue;
+    }
+    const auto ln = static_cast<const LongNote *>(notes[i]);
+    const Note *other = record.Kind == NoteKind::LongHead ? ln->Tail : ln->Head;
+    if (other == nullptr) {
+      continue;
+    }
+    if (other->Id < noteCount && notes[other->Id] == other &&
+        chart.Notes[other->Id].IsLongNote()) {
+      links[i].Link = other->Id;
+      continue;
+    }
+    const auto found = detachedIds.find(other);
+    if (found != detachedIds.end()) {
+      links[i].Link = found->second;
+      continue;
+    }
+    if (timelineIds.empty()) {
+      for (size_t t = 0; t < chart.TimeLines.size(); ++t) {
+        timelineIds.emplace(chart.TimeLines[t], static_cast<uint32_t>(t));
+      }
+    }
+    SnapshotDetachedNote entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.Wav = other->Wav;
+    const auto timeline = timelineIds.find(other->Timeline);
+    entry.TimeLine =
+        timeline != timelineIds.end() ? timeline->second : NoNoteId;
+    entry.Link = static_cast<uint32_t>(i);
+    entry.Lane = static_cast<uint8_t>(other->Lane);
+    entry.Kind = other->Kind;
+    const auto id = static_cast<uint32_t>(noteCount + detached.size());
+    detachedIds.emplace(other, id);
+    detached.push_back(entry);
+    links[i].Link = id;
+  }
+
+  SnapshotStrings strings;
+  const auto meta = ToSnapshotMeta(chart.Meta, strings);
+  const auto wavs = ToSnapshotTable(chart.WavTable, strings);
+  const auto bmps = ToSnapshotTable(chart.BmpTable, strings);
+  if (strings.Overflowed) {
+    return false;
+  }
+
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.Magic = Magic;
+  header.Format = Format;
+  header.ParserVersion = Parser::Version;
+  header.Flags = addReadyMeasure ? SnapshotReadyMeasure : 0;
+  header.SourceHash = chart.Meta.ContentHash;
+  size_t offset = sizeof(SnapshotHeader);
+  const auto place = [&offset](SnapshotSection &section, size_t count,
+                               size_t elementSize) {
+    offset = AlignSection(offset);
+    section.Offset = offset;
+    section.Count = count;
+    offset += count * elementSize;
+  };
+  place(header.Meta, 1, sizeof(SnapshotMeta));
+  place(header.Measures, measures.size(), sizeof(SnapshotMeasure));
+  place(header.TimeLines, timelines.size(), sizeof(SnapshotTimeLine));
+  place(header.Notes, noteCount, sizeof(NoteRecord));
+  place(header.Links, links.size(), sizeof(SnapshotNoteLink));
+  place(header.Detached, detached.size(), sizeof(SnapshotDetachedNote));
+  place(header.Wavs, wavs.size(), sizeof(SnapshotResource));
+  place(header.Bmps, bmps.size(), sizeof(SnapshotResource));
+  place(header.Strings, strings.Chars.size(), 1);
+  header.TotalSize = offset;
+
+  bytes.assign(offset, 0);
+  const auto copy = [&bytes](const SnapshotSection &section, const void *data,
+                             size_t size) {
+    if (size != 0) {
+      std::memcpy(bytes.data() + section.Offset, data, size);
+    }
+  };
+  copy(header.Meta, &meta, sizeof(meta));
+  copy(header.Measures, measures.data(),
+       measures.size() * sizeof(SnapshotMeasure));
+  copy(header.TimeLines, timelines.data(),
+       timelines.size() * sizeof(SnapshotTimeLine));
+  // field by field, so that the padding of the records is written as zeros
+  auto records = bytes.data() + header.Notes.Offset;
+  for (const auto &note : chart.Notes) {
+    NoteRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.Wav = note.Wav;
+    record.Timeline = note.Timeline;
+    record.Partner = note.Partner;
+    record.Damage = note.Damage;
+    record.Lane = note.Lane;
+    record.Kind = note.Kind;
+    std::memcpy(records, &record, sizeof(record));
+    records += sizeof(record);
+  }
+  copy(header.Links, links.data(), links.size() * sizeof(SnapshotNoteLink));
+  copy(header.Detached, detached.data(),
+       detached.size() * sizeof(SnapshotDetachedNote));
+  copy(header.Wavs, wavs.data(), wavs.size() * sizeof(SnapshotResource));
+  copy(header.Bmps, bmps.data(), bmps.size() * sizeof(SnapshotResource));
+  copy(header.Strings, strings.Chars.data(), strings.Chars.size());
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  header.Checksum = SnapshotChecksum(bytes.data(), bytes.size());
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  return true;
+}
+
+bool ChartSnapshot::Write(const Chart &chart, bool addReadyMeasure,
+                          const std::filesystem::path &file) {
+  std::vector<unsigned char> bytes;
+  if (!Serialize(chart, addReadyMeasure, bytes)) {
+    return false;
+  }
+  auto temporary = file;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    if (!out.good()) {
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(temporary, file, ec);
+  return !ec;
+}
+
+bool ChartSnapshot::Validate(const unsigned char *bytes, size_t size) {
+  if (bytes == nullptr || reinterpret_cast<uintptr_t>(bytes) % SectionAlign ||
+      size < sizeof(SnapshotHeader)) {
+    return false;
+  }
+  const auto &header = *reinterpret_cast<const SnapshotHeader *>(bytes);
+  if (header.Magic != Magic || header.Format != Format ||
+      header.ParserVersion != Parser::Version ||
+      (header.Flags & ~SnapshotReadyMeasure) != 0 ||
+      header.TotalSize != size ||
+      header.Checksum != SnapshotChecksum(bytes, size)) {
+    return false;
+  }
+  if (header.Meta.Count != 1 || !InSection<SnapshotMeta>(header.Meta, size) ||
+      !InSection<SnapshotMeasure>(header.Measures, size) ||
+      !InSection<SnapshotTimeLine>(header.TimeLines, size) ||
+      !InSection<NoteRecord>(header.Notes, size) ||
+      !InSection<SnapshotNoteLink>(header.Links, size) ||
+      !InSection<SnapshotDetachedNote>(header.Detached, size) ||
+      !InSection<SnapshotResource>(header.Wavs, size) ||
+      !InSection<SnapshotResource>(header.Bmps, size) ||
+      !InSection<char>(header.Strings, size)) {
+    return false;
+  }
+  const auto &meta = SectionAt<SnapshotMeta>(bytes, header.Meta)[0];
+  const auto measures = SectionAt<SnapshotMeasure>(bytes, header.Measures);
+  const auto timelines = SectionAt<SnapshotTimeLine>(bytes, header.TimeLines);
+  const auto notes = SectionAt<NoteRecord>(bytes, header.Notes);
+  const auto links = SectionAt<SnapshotNoteLink>(bytes, header.Links);
+  const auto detached =
+      SectionAt<SnapshotDetachedNote>(bytes, header.Detached);
+  const auto stringsSize = header.Strings.Count;
+
+  for (const auto &string :
+       {meta.SHA256, meta.MD5, meta.BmsPath, meta.Folder, meta.Artist,
+        meta.SubArtist, meta.Genre, meta.Title, meta.SubTitle, meta.Banner,
+        meta.StageFile, meta.BackBmp, meta.Preview}) {
+    if (!InStrings(string, stringsSize)) {
+      return false;
+    }
+  }
+  if (meta.Encoding > static_cast<uint8_t>(TextEncoding::UTF8)) {
+    return false;
+  }
+  for (const auto &table : {header.Wavs, header.Bmps}) {
+    const auto resources = SectionAt<SnapshotResource>(bytes, table);
+    for (size_t i = 0; i < resources.size(); ++i) {
+      if (!InStrings(resources[i].Name, stringsSize) ||
+          (i > 0 && resources[i - 1].Id >= resources[i].Id)) {
+        return false;
+      }
+    }
+  }
+
+  // the measures own consecutive runs of timelines, and the timelines
+  // consecutive runs of notes, with nothing left over
+  if (notes.size() >= NoNoteId / 2 || timelines.size() >= NoNoteId ||
+      links.size() != notes.size() ||
+      detached.size() >= NoNoteId / 2) {
+    return false;
+  }
+  uint64_t nextTimeLine = 0;
+  for (const auto &measure : measures) {
+    if (measure.FirstTimeLine != nextTimeLine ||
+        measure.TimeLineCount > timelines.size() - nextTimeLine) {
+      return false;
+    }
+    nextTimeLine += measure.TimeLineCount;
+  }
+  if (nextTimeLine != timelines.size()) {
+    return false;
+  }
+  const auto noteCount = static_cast<uint32_t>(notes.size());
+  const auto linkCount = noteCount + static_cast<uint32_t>(detached.size());
+  uint64_t nextNote = 0;
+  for (size_t t = 0; t < timelines.size(); ++t) {
+    const auto &timeline = timelines[t];
+    if (timeline.FirstNote != nextNote ||
+        timeline.NoteCount > notes.size() - nextNote) {
+      return false;
+    }
+    nextNote += timeline.NoteCount;
+    for (auto i = timeline.FirstNote; i < nextNote; ++i) {
+      const auto &record = notes[i];
+      const auto &link = links[i];
+      if (record.Timeline != t || record.Kind > NoteKind::Background) {
+        return false;
+      }
+      bool slotFits;
+      switch (link.Slot) {
+      case SnapshotSlot::Note:
+        slotFits = record.Kind <= NoteKind::Landmine;
+        break;
+      case SnapshotSlot::Landmine:
+        slotFits = record.Kind == NoteKind::Landmine;
+        break;
+      case SnapshotSlot::Invisible:
+        slotFits = record.Kind == NoteKind::Invisible;
+        break;
+      case SnapshotSlot::Background:
+        slotFits = record.Kind == NoteKind::Background;
+        break;
+      default:
+        slotFits = false;
+      }
+      if (!slotFits || (link.Slot != SnapshotSlot::Background &&
+                        record.Lane >= TimeLine::MaxLanes)) {
+        return false;
+      }
+      if (record.Partner != NoNoteId &&
+          (!record.IsLongNote() || record.Partner >= noteCount ||
+           !notes[record.Partner].IsLongNote() ||
+           notes[record.Partner].Partner != i)) {
+        return false;
+      }
+      if (link.Link != NoNoteId &&
+          (!record.IsLongNote() || link.Link >= linkCount ||
+           (link.Link < noteCount && !notes[link.Link].IsLongNote()))) {
+        return false;
+      }
+    }
+  }
+  if (nextNote != notes.size()) {
+    return false;
+  }
+  for (size_t k = 0; k < detached.size(); ++k) {
+    const auto &entry = detached[k];
+    if (entry.Link >= noteCount || links[entry.Link].Link != noteCount + k ||
+        (entry.TimeLine != NoNoteId && entry.TimeLine >= timelines.size()) ||
+        entry.Lane >= TimeLine::MaxLanes || entry.Kind > NoteKind::Background) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ChartSnapshot::Open(const std::filesystem::path &file) {
+  Close();
+  if (!Mapped.Open(file) || !Attach(Mapped.GetData(), Mapped.GetSize())) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool ChartSnapshot::Open(const unsigned char *bytes, size_t size) {
+  Close();
+  return Attach(bytes, size);
+}
+
+bool ChartSnapshot::Attach(const unsigned char *bytes, size_t size) {
+  if (!Validate(bytes, size)) {
+    return false;
+  }
+  Bytes = bytes;
+  Header = reinterpret_cast<const SnapshotHeader *>(bytes);
+  return true;
+}
+
+void ChartSnapshot::Close() {
+  Mapped.Close();
+  Bytes = nullptr;
+  Header = nullptr;
+}
+
+bool ChartSnapshot::Matches(uint64_t sourceHash, bool addReadyMeasure) const {
+  return IsOpen() && Header->SourceHash == sourceHash &&
+         ((Header->Flags & SnapshotReadyMeasure) != 0) == addReadyMeasure;
+}
+
+const SnapshotMeta &ChartSnapshot::GetMeta() const {
+  return SectionAt<SnapshotMeta>(Bytes, Header->Meta)[0];
+}
+
+SnapshotArray<SnapshotMeasure> ChartSnapshot::GetMeasures() const {
+  return SectionAt<SnapshotMeasure>(Bytes, Header->Measures);
+}
+
+SnapshotArray<SnapshotTimeLine> ChartSnapshot::GetTimeLines() const {
+  return SectionAt<SnapshotTimeLine>(Bytes, Header->TimeLines);
+}
+
+SnapshotArray<NoteRecord> ChartSnapshot::GetNotes() const {
+  return SectionAt<NoteRecord>(Bytes, Header->Notes);
+}
+
+std::string_view ChartSnapshot::GetString(SnapshotString string) const {
+  return {reinterpret_cast<const char *>(Bytes + Header->Strings.Offset +
+                                         string.Offset),
+          string.Size};
+}
+
+std::string_view ChartSnapshot::FindWav(int id) const {
+  return Find(Header->Wavs, id);
+}
+
+std::string_view ChartSnapshot::FindBmp(int id) const {
+  return Find(Header->Bmps, id);
+}
+
+std::string_view ChartSnapshot::Find(const SnapshotSection &table,
+                                     int id) const {
+  const auto resources = SectionAt<SnapshotResource>(Bytes, table);
+  const auto found = std::lower_bound(
+      resources.begin(), resources.end(), id,
+      [](const SnapshotResource &resource, int key) {
+        return resource.Id < key;
+      });
+  if (found == resources.end() || found->Id != id) {
+    return {};
+  }
+  return GetString(found->Name);
+}
+
+Chart *ChartSnapshot::ToChart() const {
+  auto chart = std::make_unique<Chart>();
+  const auto &meta = GetMeta();
+  const auto text = [this](SnapshotString string) {
+    return std::string(GetString(string));
+  };
+  const auto path = [this](SnapshotString string) {
+    return std::filesystem::u8path(GetString(string));
+  };
+  auto &m = chart->Meta;
+  m.SHA256 = text(meta.SHA256);
+  m.MD5 = text(meta.MD5);
+  m.ContentHash = meta.ContentHash;
+  m.BmsPath = path(meta.BmsPath);
+  m.Folder = path(meta.Folder);
+  m.Artist = text(meta.Artist);
+  m.SubArtist = text(meta.SubArtist);
+  m.Bpm = meta.Bpm;
+  m.Genre = text(meta.Genre);
+  m.Title = text(meta.Title);
+  m.SubTitle = text(meta.SubTitle);
+  m.Rank = meta.Rank;
+  m.Total = meta.Total;
+  m.PlayLength = meta.PlayLength;
+  m.TotalLength = meta.TotalLength;
+  m.Banner = path(meta.Banner);
+  m.StageFile = path(meta.StageFile);
+  m.BackBmp = path(meta.BackBmp);
+  m.Preview = path(meta.Preview);
+  m.BgaPoorDefault = meta.BgaPoorDefault != 0;
+  m.Difficulty = meta.Difficulty;
+  m.PlayLevel = meta.PlayLevel;
+  m.MinBpm = meta.MinBpm;
+  m.MaxBpm = meta.MaxBpm;
+  m.Player = meta.Player;
+  m.KeyMode = meta.KeyMode;
+  m.IsDP = meta.IsDP != 0;
+  m.TotalNotes = meta.TotalNotes;
+  m.TotalLongNotes = meta.TotalLongNotes;
+  m.TotalScratchNotes = meta.TotalScratchNotes;
+  m.TotalBackSpinNotes = meta.TotalBackSpinNotes;
+  m.TotalLandmineNotes = meta.TotalLandmineNotes;
+  m.LnMode = meta.LnMode;
+  m.HasRandom = meta.HasRandom != 0;
+  m.Encoding = static_cast<TextEncoding>(meta.Encoding);
+  for (const auto &[table, section] :
+       {std::make_pair(&chart->WavTable, &Header->Wavs),
+        std::make_pair(&chart->BmpTable, &Header->Bmps)}) {
+    const auto resources = SectionAt<SnapshotResource>(Bytes, *section);
+    table->reserve(resources.size());
+    for (const auto &resource : resources) {
+      table->emplace(resource.Id, GetString(resource.Name));
+    }
+  }
+
+  // the records are the chart's as they are; only the graph is rebuilt
+  const auto records = GetNotes();
+  const auto links = SectionAt<SnapshotNoteLink>(Bytes, Header->Links);
+  chart->Notes.assign(records.begin(), records.end());
+  const auto measures = GetMeasures();
+  const auto timelines = GetTimeLines();
+  chart->Measures.reserve(measures.size());
+  chart->TimeLines.reserve(timelines.size());
+  std::vector<Note *> notes(records.size());
+  auto &arena = chart->Arena;
+  for (const auto &m : measures) {
+    auto measure = arena.New<Measure>();
+    chart->Measures.push_back(measure);
+    measure->Scale = m.Scale;
+    measure->Timing = m.Timing;
+    measure->Pos = m.Pos;
+    measure->TimeLines.reserve(m.TimeLineCount);
+    for (auto t = m.FirstTimeLine; t < m.FirstTimeLine + m.TimeLineCount;
+         ++t) {
+      const auto &tl = timelines[t];
+      auto timeline = arena.New<TimeLine>(TimeLine::MaxLanes, false);
+      measure->TimeLines.push_back(timeline);
+      chart->TimeLines.push_back(timeline);
+      timeline->Bpm = tl.Bpm;
+      timeline->BpmChange = tl.BpmChange != 0;
+      timeline->BpmChangeApplied = tl.BpmChangeApplied != 0;
+      timeline->BgaBase = tl.BgaBase;
+      timeline->BgaLayer = tl.BgaLayer;
+      timeline->BgaPoor = tl.BgaPoor;
+      timeline->StopLength = tl.StopLength;
+      timeline->Scroll = tl.Scroll;
+      timeline->Timing = tl.Timing;
+      timeline->BeatPosition = tl.BeatPosition;
+      timeline->IsFirstInMeasure = tl.IsFirstInMeasure != 0;
+      for (auto i = tl.FirstNote; i < tl.FirstNote + tl.NoteCount; ++i) {
+        const auto &record = records[i];
+        Note *note;
+        if (record.IsLongNote()) {
+          note = arena.New<LongNote>(record.Wav);
+        } else if (record.IsLandmineNote()) {
+          note = arena.New<LandmineNote>(record.Damage);
+          note->Wav = record.Wav;
+        } else {
+          note = arena.New<Note>(record.Wav);
+        }
+        switch (links[i].Slot) {
+        case SnapshotSlot::Note:
+          timeline->SetNote(record.Lane, note);
+          break;
+        case SnapshotSlot::Landmine:
+          timeline->SetLandmineNote(record.Lane,
+                                    static_cast<LandmineNote *>(note));
+          break;
+        case SnapshotSlot::Invisible:
+          timeline->SetInvisibleNote(record.Lane, note);
+          break;
+        case SnapshotSlot::Background:
+          timeline->AddBackgroundNote(note);
+          note->Lane = record.Lane;
+          break;
+        }
+        note->Kind = record.Kind;
+        note->Id = i;
+        notes[i] = note;
+      }
+    }
+  }
+
+  // long notes last, once everything they may point at exists
+  const auto detached =
+      SectionAt<SnapshotDetachedNote>(Bytes, Header->Detached);
+  std::vector<LongNote *> others(detached.size());
+  for (size_t k = 0; k < detached.size(); ++k) {
+    const auto &entry = detached[k];
+    auto other = arena.New<LongNote>(entry.Wav);
+    other->Lane = entry.Lane;
+    other->Kind = entry.Kind;
+    other->Timeline =
+        entry.TimeLine != NoNoteId ? chart->TimeLines[entry.TimeLine] : nullptr;
+    // it points back at the note that points at it, from the other end
+    auto owner = static_cast<LongNote *>(notes[entry.Link]);
+    if (records[entry.Link].Kind == NoteKind::LongHead) {
+      other->Head = owner;
+    } else {
+      other->Tail = owner;
+    }
+    others[k] = other;
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    const auto link = links[i].Link;
+    if (link == NoNoteId) {
+      continue;
+    }
+    auto ln = static_cast<LongNote *>(notes[i]);
+    auto other = link < records.size()
+                     ? static_cast<LongNote *>(notes[link])
+                     : others[link - records.size()];
+    if (records[i].Kind == NoteKind::LongHead) {
+      ln->Tail = other;
+    } else {
+      ln->Head = other;
+    }
+  }
+  return chart.release();
+}
+
+bool ChartSnapshot::LoadOrParse(const std::filesystem::path &chartPath,
+                                const std::filesystem::path &snapshotPath,
+                                Parser &parser, Chart **chart,
+                                bool addReadyMeasure,
+                                std::atomic_bool &bCancelled) {
+  *chart = nullptr;
+  // the source is hashed either way, to check the snapshot against or to
+  // stamp the new one with, and parsed from the same bytes if need be
+  MappedFile mapped;
+  std::vector<unsigned char> buffer;
+  const unsigned char *data = nullptr;
+  size_t size = 0;
+  const auto &options = parser.GetOptions();
+  if (!ReadSource(chartPath, options.UseMemoryMap, mapped, buffer, data,
+                  size)) {
+    return false;
+  }
+  const auto sourceHash = XXHash64(data, size);
+
+  ChartSnapshot snapshot;
+  if (snapshot.Open(snapshotPath) &&
+      snapshot.Matches(sourceHash, addReadyMeasure)) {
+    // a snapshot without the digests the parser would compute is retaken
+    const auto &meta = snapshot.GetMeta();
+    if ((!options.ComputeMD5 || meta.MD5.Size != 0) &&
+        (!options.ComputeSHA256 || meta.SHA256.Size != 0)) {
+      auto loaded = snapshot.ToChart();
+      loaded->Meta.BmsPath = chartPath;
+      loaded->Meta.Folder = chartPath.parent_path();
+      // the same chart as the parse below would give
+      if (options.BuildView) {
+        loaded->View = std::make_unique<ChartView>(*loaded);
+      }
+      *chart = loaded;
+      return true;
+    }
+  }
+  snapshot.Close();
+
+  parser.Parse(data, size, chart, addReadyMeasure, false, bCancelled);
+  auto parsed = *chart;
+  if (parsed == nullptr) {
+    return false;
+  }
+  // the file is closed on return, whatever Options.LazyDigests says
+  parsed->ClearDigestSource();
+  parsed->Meta.ContentHash = sourceHash;
+  parsed->Meta.BmsPath = chartPath;
+  parsed->Meta.Folder = chartPath.parent_path();
+  if (!bCancelled && !parsed->Meta.HasRandom) {
+    Write(*parsed, addReadyMeasure, snapshotPath);
+  }
+  return false;
+}
+} // namespace bms_parser
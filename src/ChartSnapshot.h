@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Chart.h"
+#include "MappedFile.h"
+#include "NoteRecord.h"
+#include "Parser.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Binary image of a fully parsed chart, for loading a chart without parsing
+ * its text again. Everything refers to everything else by index or by
+ * offset, never by pointer, so a snapshot file can be mapped and read where
+ * it lies: the note records are the very NoteRecords of Chart::Notes, and
+ * timelines, measures and the WAV/BMP tables are flat arrays next to them.
+ * A snapshot is tied to the source it was taken of by the source's XXH64,
+ * and to the parser by Parser::Version. It is a cache, written in the byte
+ * order of the machine that took it; anything that does not check out is
+ * rejected, never half read.
+ */
+namespace bms_parser {
+// where an array starts, in bytes from the start of the snapshot, and how
+// many elements it has
+struct SnapshotSection {
+  uint64_t Offset;
+  uint64_t Count;
+};
+
+// a string in the snapshot's string section; not null-terminated
+struct SnapshotString {
+  uint32_t Offset;
+  uint32_t Size;
+};
+
+struct SnapshotHeader {
+  uint32_t Magic;
+  uint32_t Format;
+  uint32_t ParserVersion;
+  uint32_t Flags; // SnapshotReadyMeasure
+  uint64_t SourceHash; // XXH64 of the source the chart was parsed from
+  uint64_t TotalSize;
+  SnapshotSection Meta; // one SnapshotMeta
+  SnapshotSection Measures;
+  SnapshotSection TimeLines;
+  SnapshotSection Notes; // NoteRecord, as in Chart::Notes
+  SnapshotSection Links; // SnapshotNoteLink, one per note
+  SnapshotSection Detached;
+  SnapshotSection Wavs; // SnapshotResource, by ascending Id
+  SnapshotSection Bmps;
+  SnapshotSection Strings; // chars
+  // XXH64 of everything but this field
+  uint64_t Checksum;
+};
+
+// the chart was parsed with addReadyMeasure
+constexpr uint32_t SnapshotReadyMeasure = 1;
+
+struct SnapshotMeta {
+  SnapshotString SHA256, MD5, BmsPath, Folder, Artist, SubArtist, Genre,
+      Title, SubTitle, Banner, StageFile, BackBmp, Preview;
+  uint64_t ContentHash;
+  double Bpm, Total, PlayLevel, MinBpm, MaxBpm;
+  int64_t PlayLength, TotalLength;
+  int32_t Rank, Difficulty, Player, KeyMode, TotalNotes, TotalLongNotes,
+      TotalScratchNotes, TotalBackSpinNotes, TotalLandmineNotes, LnMode;
+  uint8_t BgaPoorDefault, IsDP, HasRandom;
+  uint8_t Encoding; // TextEncoding
+  uint32_t Reserved;
+};
+
+struct SnapshotMeasure {
+  double Scale;
+  double Pos;
+  int64_t Timing;
+  // the measure's timelines, in SnapshotHeader::TimeLines
+  uint32_t FirstTimeLine;
+  uint32_t TimeLineCount;
+};
+
+struct SnapshotTimeLine {
+  double Bpm;
+  double StopLength;
+  double Scroll;
+  double BeatPosition;
+  int64_t Timing;
+  int32_t BgaBase, BgaLayer, BgaPoor;
+  // the timeline's notes, in SnapshotHeader::Notes
+  uint32_t FirstNote;
+  uint32_t NoteCount;
+  uint8_t BpmChange, BpmChangeApplied, IsFirstInMeasure;
+  uint8_t Reserved;
+};
+
+// which of its timeline's lists a note is in
+enum class SnapshotSlot : uint8_t {
+  Note = 0,
+  Landmine = 1, // TimeLine::LandmineNotes; landmines usually sit in Notes
+  Invisible = 2,
+  Background = 3,
+};
+
+// What NoteRecord leaves out: the slot, and the note the LongNote::Head or
+// Tail pointer of a long note points at. That is usually its Partner, but
+// when a later note took the other end's place on the chart, it is an entry
+// of SnapshotHeader::Detached, numbered from the note count on.
+struct SnapshotNoteLink {
+  uint32_t Link; // NoNoteId for none
+  SnapshotSlot Slot;
+  uint8_t Reserved[3];
+};
+
+// the other end of a long note that is no longer on the chart
+struct SnapshotDetachedNote {
+  int32_t Wav;
+  uint32_t TimeLine; // the timeline it was placed on; NoNoteId for none
+  uint32_t Link;     // the note on the chart that points at it
+  uint8_t Lane;
+  NoteKind Kind;
+  uint8_t Reserved[2];
+};
+
+// a WAV or BMP table entry
+struct SnapshotResource {
+  int32_t Id;
+  SnapshotString Name;
+};
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value &&
+                  std::is_trivially_copyable<SnapshotMeta>::value &&
+                  std::is_trivially_copyable<SnapshotMeasure>::value &&
+                  std::is_trivially_copyable<SnapshotTimeLine>::value &&
+                  std::is_trivially_copyable<SnapshotNoteLink>::value &&
+                  std::is_trivially_copyable<SnapshotDetachedNote>::value &&
+                  std::is_trivially_copyable<SnapshotResource>::value,
+              "snapshot sections are read in place");
+static_assert(sizeof(SnapshotMeta) % 8 == 0 &&
+                  sizeof(SnapshotMeasure) == 32 &&
+                  sizeof(SnapshotTimeLine) == 64 &&
+                  sizeof(SnapshotNoteLink) == 8 &&
+                  sizeof(SnapshotDetachedNote) == 16 &&
+                  sizeof(SnapshotResource) == 12,
+              "snapshot records have no implicit padding");
+
+// a section of a snapshot, where it lies
+template <typename T> class SnapshotArray {
+public:
+  SnapshotArray() = default;
+  SnapshotArray(const T *data, size_t size) : Data(data), Size(size) {}
+
+  [[nodiscard]] const T &operator[](size_t i) const { return Data[i]; }
+  [[nodiscard]] const T *begin() const { return Data; }
+  [[nodiscard]] const T *end() const { return Data + Size; }
+  [[nodiscard]] const T *data() const { return Data; }
+  [[nodiscard]] size_t size() const { return Size; }
+  [[nodiscard]] bool empty() const { return Size == 0; }
+
+private:
+  const T *Data = nullptr;
+  size_t Size = 0;
+};
+
+class ChartSnapshot {
+public:
+  static constexpr uint32_t Magic = 0x53434D42; // "BMCS"
+  // bump when a section's layout changes
+  static constexpr uint32_t Format = 1;
+
+  ChartSnapshot() = default;
+  ChartSnapshot(const ChartSnapshot &) = delete;
+  ChartSnapshot &operator=(const ChartSnapshot &) = delete;
+
+  // Lays chart out as a snapshot. The note records must be current, as
+  // after a parse, and Meta.ContentHash must be set for the snapshot to ever
+  // match its source. addReadyMeasure is what the chart was parsed with.
+  // False if the chart is too big to index with 32 bits.
+  static bool Serialize(const Chart &chart, bool addReadyMeasure,
+                        std::vector<unsigned char> &bytes);
+  // Serializes to file, through a temporary file so that a crash never
+  // leaves a half-written snapshot behind.
+  static bool Write(const Chart &chart, bool addReadyMeasure,
+                    const std::filesystem::path &file);
+  // Whether bytes hold a complete, consistent snapshot of this format and
+  // parser version: every section in bounds, every index in range and the
+  // checksum right. bytes must be 8-byte aligned.
+  static bool Validate(const unsigned char *bytes, size_t size);
+
+  // Maps file and validates it. False, and closed, if either fails.
+  bool Open(const std::filesystem::path &file);
+  // Uses the caller's bytes, which must outlive the snapshot.
+  bool Open(const unsigned char *bytes, size_t size);
+  void Close();
+  [[nodiscard]] bool IsOpen() const { return Header != nullptr; }
+
+  // Whether the snapshot was taken of the given source, parsed the same way.
+  [[nodiscard]] bool Matches(uint64_t sourceHash, bool addReadyMeasure) const;
+
+  // The sections of an open snapshot, in place. They stay valid until it is
+  // closed.
+  [[nodiscard]] const SnapshotHeader &GetHeader() const { return *Header; }
+  [[nodiscard]] const SnapshotMeta &GetMeta() const;
+  [[nodiscard]] SnapshotArray<SnapshotMeasure> GetMeasures() const;
+  [[nodiscard]] SnapshotArray<SnapshotTimeLine> GetTimeLines() const;
+  [[nodiscard]] SnapshotArray<NoteRecord> GetNotes() const;
+  [[nodiscard]] std::string_view GetString(SnapshotString string) const;
+  // the WAV or BMP file name for id, empty if there is none
+  [[nodiscard]] std::string_view FindWav(int id) const;
+  [[nodiscard]] std::string_view FindBmp(int id) const;
+
+  // Builds the Chart the snapshot was taken of, measures, timelines and
+  // notes included, without looking at the text. View is left null;
+  // LoadOrParse builds it when the parser's options ask for one.
+  [[nodiscard]] Chart *ToChart() const;
+
+  // Loads the chart at chartPath from the snapshot at snapshotPath if that
+  // was taken of the chart as it is now, and parses the text with parser
+  // otherwise, taking a new snapshot for next time. Charts with #RANDOM are
+  // always parsed, so that every load rolls again. Returns true if the
+  // chart came from the snapshot. *chart is null if the chart could not be
+  // read, and may be partly built if the parse was cancelled.
+  static bool LoadOrParse(const std::filesystem::path &chartPath,
+                          const std::filesystem::path &snapshotPath,
+                          Parser &parser, Chart **chart, bool addReadyMeasure,
+                          std::atomic_bool &bCancelled);
+
+private:
+  [[nodiscard]] std::string_view Find(const SnapshotSection &table,
+                                      int id) const;
+  // validates bytes and reads them from then on
+  bool Attach(const unsigned char *bytes, size_t size);
+
+  MappedFile Mapped;
+  const unsigned char *Bytes = nullptr;
+  const SnapshotHeader *Header = nullptr;
+};
+} // namespace bms_parser
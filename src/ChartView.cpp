@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChartView.h"
+#include "Chart.h"
+
+namespace bms_parser {
+ChartView::ChartView(const Chart &chart) {
+  size_t counts[LaneCount] = {};
+  size_t backgroundCount = 0;
+  for (const auto &record : chart.Notes) {
+    if (record.Kind == NoteKind::Background) {
+      ++backgroundCount;
+    } else {
+      ++counts[record.Lane];
+    }
+  }
+  for (int lane = 0; lane < LaneCount; ++lane) {
+    auto &view = Lanes[lane];
+    view.Timing.reserve(counts[lane]);
+    view.BeatPosition.reserve(counts[lane]);
+    view.Wav.reserve(counts[lane]);
+    view.Kind.reserve(counts[lane]);
+    view.Partner.reserve(counts[lane]);
+    view.NoteId.reserve(counts[lane]);
+  }
+  Background.Timing.reserve(backgroundCount);
+  Background.BeatPosition.reserve(backgroundCount);
+  Background.Wav.reserve(backgroundCount);
+  Background.NoteId.reserve(backgroundCount);
+
+  // records are in timeline order already, so appending keeps every array
+  // sorted; a long note's head is always seen before its tail
+  std::vector<uint32_t> laneIndex(chart.Notes.size(), NoNoteId);
+  for (uint32_t id = 0; id < chart.Notes.size(); ++id) {
+    const auto &record = chart.Notes[id];
+    const auto timeline = chart.TimeLines[record.Timeline];
+    if (record.Kind == NoteKind::Background) {
+      Background.Timing.push_back(timeline->Timing);
+      Background.BeatPosition.push_back(timeline->BeatPosition);
+      Background.Wav.push_back(record.Wav);
+      Background.NoteId.push_back(id);
+      continue;
+    }
+    auto &view = Lanes[record.Lane];
+    const auto index = static_cast<uint32_t>(view.size());
+    laneIndex[id] = index;
+    auto partner = NoNoteId;
+    if (record.Kind == NoteKind::LongTail && record.Partner != NoNoteId) {
+      partner = laneIndex[record.Partner];
+      view.Partner[partner] = index;
+    }
+    view.Timing.push_back(timeline->Timing);
+    view.BeatPosition.push_back(timeline->BeatPosition);
+    view.Wav.push_back(record.Wav);
+    view.Kind.push_back(record.Kind);
+    view.Partner.push_back(partner);
+    view.NoteId.push_back(id);
+  }
+}
+} // namespace bms_parser
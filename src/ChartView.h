@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "NoteRecord.h"
+#include "TimeLine.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Struct-of-arrays copy of a chart's notes for loops that scan forward by
+ * lane and time. Each lane holds its notes in chart order, one array per
+ * field, and background notes are kept in a single stream of their own. The
+ * view is a snapshot: it does not follow later edits to the chart.
+ */
+namespace bms_parser {
+class Chart;
+
+struct LaneView {
+  // microseconds, in chart order; ascending unless the chart has negative
+  // or zero BPMs
+  std::vector<long long> Timing;
+  std::vector<double> BeatPosition;
+  std::vector<int32_t> Wav;
+  // Normal, LongHead, LongTail, Landmine or Invisible
+  std::vector<NoteKind> Kind;
+  // index of the other end of a long note in this lane; NoNoteId otherwise
+  std::vector<uint32_t> Partner;
+  // index into Chart::Notes
+  std::vector<uint32_t> NoteId;
+
+  [[nodiscard]] size_t size() const { return Timing.size(); }
+  [[nodiscard]] bool empty() const { return Timing.empty(); }
+};
+
+struct BackgroundView {
+  // microseconds, in chart order; ascending unless the chart has negative
+  // or zero BPMs
+  std::vector<long long> Timing;
+  std::vector<double> BeatPosition;
+  std::vector<int32_t> Wav;
+  // index into Chart::Notes
+  std::vector<uint32_t> NoteId;
+
+  [[nodiscard]] size_t size() const { return Timing.size(); }
+  [[nodiscard]] bool empty() const { return Timing.empty(); }
+};
+
+class ChartView {
+public:
+  static constexpr int LaneCount = TimeLine::MaxLanes;
+  LaneView Lanes[LaneCount];
+  BackgroundView Background;
+
+  // built from Chart::Notes, so the chart's note records must be current
+  explicit ChartView(const Chart &chart);
+};
+} // namespace bms_parser
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CpuFeatures.h"
+#if BMS_PARSER_X86 && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace bms_parser {
+namespace {
+struct CpuInfo {
+  bool SSE2 = false;
+  bool AVX2 = false;
+  bool SHA = false;
+
+  CpuInfo() {
+#if BMS_PARSER_X86
+    unsigned int regs[4] = {0, 0, 0, 0}; // eax, ebx, ecx, edx
+    auto cpuid = [&regs](unsigned int leaf, unsigned int subleaf) {
+#ifdef _MSC_VER
+      int out[4];
+      __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+      for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned int>(out[i]);
+      }
+#else
+      __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    };
+    cpuid(0, 0);
+    const unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+      return;
+    }
+    cpuid(1, 0);
+    SSE2 = (regs[3] & (1u << 26)) != 0;
+    const bool ssse3 = (regs[2] & (1u << 9)) != 0;
+    const bool sse41 = (regs[2] & (1u << 19)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+    // AVX registers are only usable if the OS saves the YMM state
+    bool ymmEnabled = false;
+    if (osxsave && avx) {
+#ifdef _MSC_VER
+      ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+#else
+      unsigned int xcr0Low, xcr0High;
+      __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+      ymmEnabled = (xcr0Low & 0x6) == 0x6;
+#endif
+    }
+    if (maxLeaf >= 7) {
+      cpuid(7, 0);
+      AVX2 = ymmEnabled && (regs[1] & (1u << 5)) != 0;
+      SHA = ssse3 && sse41 && (regs[1] & (1u << 29)) != 0;
+    }
+#endif
+  }
+};
+
+const CpuInfo &GetCpuInfo() {
+  static const CpuInfo info;
+  return info;
+}
+} // namespace
+
+bool CpuFeatures::HasSSE2() { return GetCpuInfo().SSE2; }
+bool CpuFeatures::HasAVX2() { return GetCpuInfo().AVX2; }
+bool CpuFeatures::HasSHA() { return GetCpuInfo().SHA; }
+} // namespace bms_parser
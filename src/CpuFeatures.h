@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#define BMS_PARSER_X86 1
+#else
+#define BMS_PARSER_X86 0
+#endif
+
+// Lets a single function use an instruction set the rest of the translation
+// unit isn't compiled for. Callers must check CpuFeatures first.
+#if defined(__GNUC__) || defined(__clang__)
+#define BMS_PARSER_TARGET(x) __attribute__((target(x)))
+#else
+#define BMS_PARSER_TARGET(x)
+#endif
+
+/**
+ * Runtime CPU feature detection used to pick SIMD kernels.
+ */
+namespace bms_parser {
+namespace CpuFeatures {
+bool HasSSE2();
+bool HasAVX2();
+// SHA-NI together with the SSSE3 and SSE4.1 its kernels need
+bool HasSHA();
+
+inline int CountTrailingZeros(uint32_t x) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, x);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctz(x);
+#endif
+}
+
+inline int CountTrailingZeros64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return static_cast<int>(index);
+#elif defined(_MSC_VER)
+  const auto low = static_cast<uint32_t>(x);
+  return low != 0 ? CountTrailingZeros(low)
+                  : 32 + CountTrailingZeros(static_cast<uint32_t>(x >> 32));
+#else
+  return __builtin_ctzll(x);
+#endif
+}
+} // namespace CpuFeatures
+} // namespace bms_parser
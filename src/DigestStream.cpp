@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DigestStream.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace bms_parser {
+DigestStream::DigestStream(bool md5, bool sha256)
+    : WantMD5(md5), WantSHA256(sha256) {
+  Sha256.init();
+}
+
+void DigestStream::Update(const unsigned char *bytes, size_t size) {
+  for (size_t offset = 0; offset < size; offset += BlockSize) {
+    const auto length = std::min(BlockSize, size - offset);
+    if (WantMD5) {
+      Md5.update(bytes + offset, static_cast<MD5::size_type>(length));
+    }
+    if (WantSHA256) {
+      Sha256.update(bytes + offset, static_cast<unsigned int>(length));
+    }
+  }
+}
+
+void DigestStream::Finish(std::string &md5, std::string &sha256) {
+  if (WantMD5) {
+    Md5.finalize();
+    md5 = Md5.hexdigest();
+  }
+  if (WantSHA256) {
+    unsigned char digest[SHA256::DIGEST_SIZE];
+    Sha256.final(digest);
+    char buf[2 * SHA256::DIGEST_SIZE + 1];
+    for (unsigned int i = 0; i < SHA256::DIGEST_SIZE; i++) {
+      snprintf(buf + i * 2, 3, "%02x", digest[i]);
+    }
+    sha256 = buf;
+  }
+}
+} // namespace bms_parser
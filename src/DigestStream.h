@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SHA256.h"
+#include "md5.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * MD5 and SHA-256 of one message in a single pass. Each block goes through
+ * both hashes before the next one is touched, so the message is read from
+ * memory once and the second hash finds the block still in cache.
+ */
+namespace bms_parser {
+class DigestStream {
+public:
+  // small enough to stay in L1/L2 between the two hashes
+  static constexpr size_t BlockSize = 16 * 1024;
+
+  DigestStream(bool md5, bool sha256);
+  // any size; longer runs are split into blocks
+  void Update(const unsigned char *bytes, size_t size);
+  // stores the lowercase hex digests of the enabled hashes, leaving the
+  // other string alone; no updates after this
+  void Finish(std::string &md5, std::string &sha256);
+
+private:
+  bool WantMD5;
+  bool WantSHA256;
+  MD5 Md5;
+  SHA256 Sha256;
+};
+} // namespace bms_parser
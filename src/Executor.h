@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <functional>
+
+/**
+ * Where the library runs work it spreads over threads. ThreadPool is the
+ * built-in one; a host engine can implement this to run the same jobs on
+ * its own job system instead.
+ */
+namespace bms_parser {
+class Executor {
+public:
+  virtual ~Executor() = default;
+
+  // Runs job once, on any thread, at some point. Must be callable from any
+  // thread, including from inside a running job. Jobs do not throw.
+  virtual void Submit(std::function<void()> job) = 0;
+
+  // how many jobs can make progress at the same time
+  [[nodiscard]] virtual unsigned int Concurrency() const = 0;
+};
+} // namespace bms_parser
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HeaderKeyword.h"
+#include <array>
+
+namespace bms_parser {
+namespace {
+struct KeywordEntry {
+  std::string_view Name; // upper case
+  HeaderKeyword Keyword;
+};
+
+// Sorted by name so that each first letter owns one contiguous range.
+// #ELSEIF has no entry of its own: ELSE is a prefix of it and always matched
+// first, so it behaves like #ELSE.
+constexpr KeywordEntry Keywords[] = {
+    {"ARTIST", HeaderKeyword::Artist},
+    {"BACKBMP", HeaderKeyword::BackBmp},
+    {"BANNER", HeaderKeyword::Banner},
+    {"BASE", HeaderKeyword::Base},
+    {"BMP", HeaderKeyword::Bmp},
+    {"BPM", HeaderKeyword::Bpm},
+    {"DIFFICULTY", HeaderKeyword::Difficulty},
+    {"ELSE", HeaderKeyword::Else},
+    {"END IF", HeaderKeyword::EndIf},
+    {"ENDIF", HeaderKeyword::EndIf},
+    {"ENDRANDOM", HeaderKeyword::EndRandom},
+    {"GENRE", HeaderKeyword::Genre},
+    {"IF", HeaderKeyword::If},
+    {"LNMODE", HeaderKeyword::LnMode},
+    {"LNOBJ", HeaderKeyword::LnObj},
+    {"LNTYPE", HeaderKeyword::LnType},
+    {"MIDIFILE", HeaderKeyword::MidiFile},
+    {"PLAYER", HeaderKeyword::Player},
+    {"PLAYLEVEL", HeaderKeyword::PlayLevel},
+    {"PREVIEW", HeaderKeyword::Preview},
+    {"RANDOM", HeaderKeyword::Random},
+    {"RANK", HeaderKeyword::Rank},
+    {"RONDAM", HeaderKeyword::Random}, // common typo
+    {"SCROLL", HeaderKeyword::Scroll},
+    {"STAGEFILE", HeaderKeyword::StageFile},
+    {"STOP", HeaderKeyword::Stop},
+    {"SUBARTIST", HeaderKeyword::SubArtist},
+    {"SUBTITLE", HeaderKeyword::SubTitle},
+    {"TITLE", HeaderKeyword::Title},
+    {"TOTAL", HeaderKeyword::Total},
+    {"VIDEOFILE", HeaderKeyword::VideoFile},
+    {"VOLWAV", HeaderKeyword::VolWav},
+    {"WAV", HeaderKeyword::Wav},
+};
+constexpr size_t KeywordCount = sizeof(Keywords) / sizeof(Keywords[0]);
+
+constexpr bool IsPrefix(std::string_view prefix, std::string_view str) {
+  return prefix.length() <= str.length() &&
+         str.substr(0, prefix.length()) == prefix;
+}
+
+// With no keyword being a prefix of another, a line matches at most one
+// entry and the order of the old if/else chain no longer matters.
+constexpr bool HasUniquePrefixes() {
+  for (size_t i = 0; i < KeywordCount; ++i) {
+    if (i > 0 && Keywords[i - 1].Name >= Keywords[i].Name) {
+      return false; // not sorted
+    }
+    for (size_t j = 0; j < KeywordCount; ++j) {
+      if (i != j && IsPrefix(Keywords[i].Name, Keywords[j].Name)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+static_assert(HasUniquePrefixes(), "keywords must be sorted prefix-free");
+
+struct LetterRange {
+  uint8_t Begin = 0;
+  uint8_t End = 0;
+};
+
+constexpr std::array<LetterRange, 26> BuildLetterIndex() {
+  std::array<LetterRange, 26> index{};
+  for (size_t i = KeywordCount; i-- > 0;) {
+    auto &range = index[Keywords[i].Name[0] - 'A'];
+    if (range.End == 0) {
+      range.End = static_cast<uint8_t>(i + 1);
+    }
+    range.Begin = static_cast<uint8_t>(i);
+  }
+  return index;
+}
+constexpr auto LetterIndex = BuildLetterIndex();
+
+inline char ToUpperAscii(char c) {
+  return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+}
+} // namespace
+
+HeaderKeyword HeaderKeywords::Match(std::string_view text) {
+  if (text.empty()) {
+    return HeaderKeyword::None;
+  }
+  const char first = ToUpperAscii(text[0]);
+  if (first < 'A' || first > 'Z') {
+    return HeaderKeyword::None;
+  }
+  const auto &range = LetterIndex[first - 'A'];
+  for (size_t i = range.Begin; i < range.End; ++i) {
+    const auto name = Keywords[i].Name;
+    if (text.length() < name.length()) {
+      continue;
+    }
+    size_t j = 1;
+    while (j < name.length() && ToUpperAscii(text[j]) == name[j]) {
+      ++j;
+    }
+    if (j == name.length()) {
+      return Keywords[i].Keyword;
+    }
+  }
+  return HeaderKeyword::None;
+}
+} // namespace bms_parser
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace bms_parser {
+enum class HeaderKeyword : uint8_t {
+  None = 0,
+  // control flow
+  If,
+  Else,
+  EndIf,
+  Random,
+  EndRandom,
+  // headers
+  Artist,
+  BackBmp,
+  Banner,
+  Base,
+  Bmp,
+  Bpm,
+  Difficulty,
+  Genre,
+  LnMode,
+  LnObj,
+  LnType,
+  MidiFile,
+  Player,
+  PlayLevel,
+  Preview,
+  Rank,
+  Scroll,
+  StageFile,
+  Stop,
+  SubArtist,
+  SubTitle,
+  Title,
+  Total,
+  VideoFile,
+  VolWav,
+  Wav,
+};
+
+/**
+ * Classifies '#' lines with a compile-time keyword table. Matching is a
+ * case-insensitive prefix match, so "#WAV01" and "#wav01" are both Wav.
+ */
+namespace HeaderKeywords {
+// text is the line without its leading '#'
+HeaderKeyword Match(std::string_view text);
+} // namespace HeaderKeywords
+} // namespace bms_parser
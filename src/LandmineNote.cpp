@@ -16,7 +16,10 @@
 
 #include "LandmineNote.h"
 namespace bms_parser {
-LandmineNote::LandmineNote(float Damage) : Note(0) { this->Damage = Damage; }
+LandmineNote::LandmineNote(float Damage) : Note(0) {
+  this->Damage = Damage;
+  Kind = NoteKind::Landmine;
+}
 
 LandmineNote::~LandmineNote() = default;
 } // namespace bms_parser
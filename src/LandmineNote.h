@@ -26,7 +26,5 @@ public:
   float Damage;
   explicit LandmineNote(float Damage);
   ~LandmineNote() override;
-
-  bool IsLandmineNote() override { return true; }
 };
 } // namespace bms_parser
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "CpuFeatures.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Fixed lane storage for the notes of a timeline. The slots live inline and
+ * a bit mask records which lanes are occupied, so consumers can walk the
+ * occupied lanes with the mask alone. Indexing and iteration behave like the
+ * vector this replaced: every lane is visited, empty ones as nullptr, and
+ * `lanes[i] = note` still works; the write goes through Set so the mask
+ * stays in sync.
+ */
+namespace bms_parser {
+template <typename T, size_t N> class LaneArray {
+  static_assert(N <= 16, "the occupancy mask is 16 bits");
+
+public:
+  using value_type = T;
+  using const_iterator = const T *;
+
+  // write access to one slot; reads behave like a plain T
+  class Reference {
+  public:
+    Reference(LaneArray &owner, size_t lane) : Owner(owner), Lane(lane) {}
+    Reference &operator=(T value) {
+      Owner.Set(Lane, value);
+      return *this;
+    }
+    Reference &operator=(const Reference &other) {
+      return *this = static_cast<T>(other);
+    }
+    operator T() const { return Owner.Slots[Lane]; }
+    T operator->() const { return Owner.Slots[Lane]; }
+    // lets static_cast reach a derived type, as it does for a plain pointer
+    template <typename U> explicit operator U *() const {
+      return static_cast<U *>(Owner.Slots[Lane]);
+    }
+
+  private:
+    LaneArray &Owner;
+    size_t Lane;
+  };
+
+  [[nodiscard]] T operator[](size_t lane) const { return Slots[lane]; }
+  [[nodiscard]] Reference operator[](size_t lane) { return {*this, lane}; }
+
+  void Set(size_t lane, T value) {
+    Slots[lane] = value;
+    if (value != nullptr) {
+      Occupied |= static_cast<uint16_t>(1u << lane);
+    } else {
+      Occupied &= static_cast<uint16_t>(~(1u << lane));
+    }
+  }
+
+  // bit i is set if lane i holds a note
+  [[nodiscard]] uint16_t Mask() const { return Occupied; }
+  [[nodiscard]] bool Empty() const { return Occupied == 0; }
+  [[nodiscard]] static constexpr size_t size() { return N; }
+
+  [[nodiscard]] const_iterator begin() const { return Slots; }
+  [[nodiscard]] const_iterator end() const { return Slots + N; }
+
+  // calls f(lane, value) for every occupied lane, in lane order
+  template <typename F> void ForEach(F &&f) const {
+    for (uint32_t mask = Occupied; mask != 0; mask &= mask - 1) {
+      const auto lane = CpuFeatures::CountTrailingZeros(mask);
+      f(lane, Slots[lane]);
+    }
+  }
+
+private:
+  T Slots[N] = {};
+  uint16_t Occupied = 0;
+};
+} // namespace bms_parser
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstring>
+#include <string_view>
+
+/**
+ * Splits a buffer into lines without copying. Lines end at '\n', and a '\r'
+ * right before it (or before the end of the buffer) is dropped. The views
+ * point into the buffer, so they are only valid as long as it is.
+ */
+namespace bms_parser {
+class LineScanner {
+public:
+  explicit LineScanner(std::string_view content)
+      : Cursor(content.data()), End(content.data() + content.size()) {}
+
+  // returns false once every line has been handed out
+  bool Next(std::string_view &line) {
+    if (Cursor >= End) {
+      return false;
+    }
+    // memchr is vectorised by every libc we care about
+    auto newline = static_cast<const char *>(
+        std::memchr(Cursor, '\n', static_cast<size_t>(End - Cursor)));
+    const char *lineEnd = newline != nullptr ? newline : End;
+    line = std::string_view(Cursor, static_cast<size_t>(lineEnd - Cursor));
+    Cursor = newline != nullptr ? newline + 1 : End;
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    return true;
+  }
+
+private:
+  const char *Cursor;
+  const char *End;
+};
+} // namespace bms_parser
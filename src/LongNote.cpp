@@ -18,28 +18,7 @@
 namespace bms_parser {
 bool LongNote::IsTail() const { return Tail == nullptr; }
 
-LongNote::LongNote(int Wav) : Note(Wav) { Tail = nullptr; }
-
-void LongNote::Press(long long Time) {
-  Play(Time);
-  IsHolding = true;
-  Tail->IsHolding = true;
-}
-
-void LongNote::Release(long long Time) {
-  Play(Time);
-  IsHolding = false;
-  Head->IsHolding = false;
-  ReleaseTime = Time;
-}
-
-void LongNote::MissPress(long long Time) {}
-
-void LongNote::Reset() {
-  Note::Reset();
-  IsHolding = false;
-  ReleaseTime = 0;
-}
+LongNote::LongNote(int Wav) : Note(Wav) { Kind = NoteKind::LongHead; }
 
 LongNote::~LongNote() {
   Head = nullptr;
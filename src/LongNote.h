@@ -24,22 +24,10 @@ namespace bms_parser {
 class LongNote : public Note {
 public:
   ~LongNote() override;
-  LongNote *Tail;
+  LongNote *Tail = nullptr;
   LongNote *Head = nullptr;
-  bool IsHolding = false;
   [[nodiscard]] bool IsTail() const;
-  long long ReleaseTime{};
 
   explicit LongNote(int Wav);
-
-  void Press(long long Time) override;
-
-  void Release(long long Time);
-
-  void MissPress(long long Time);
-
-  void Reset() override;
-
-  bool IsLongNote() override { return true; }
 };
 } // namespace bms_parser
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedFile.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bms_parser {
+#ifdef _WIN32
+bool MappedFile::Open(const std::filesystem::path &path) {
+  Close();
+  File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                     OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (File == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(File, &fileSize)) {
+    Close();
+    return false;
+  }
+  if (fileSize.QuadPart == 0) {
+    // empty files can't be mapped, but they are still valid input
+    return true;
+  }
+  Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (Mapping == nullptr) {
+    Close();
+    return false;
+  }
+  auto view = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    Close();
+    return false;
+  }
+  Data = static_cast<const unsigned char *>(view);
+  Size = static_cast<size_t>(fileSize.QuadPart);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (Data != nullptr) {
+    UnmapViewOfFile(Data);
+  }
+  if (Mapping != nullptr) {
+    CloseHandle(Mapping);
+  }
+  if (File != INVALID_HANDLE_VALUE) {
+    CloseHandle(File);
+  }
+  Data = nullptr;
+  Size = 0;
+  Mapping = nullptr;
+  File = INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::Open(const std::filesystem::path &path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return false;
+  }
+  if (st.st_size == 0) {
+    // empty files can't be mapped, but they are still valid input
+    close(fd);
+    return true;
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping keeps its own reference to the file
+  close(fd);
+  if (view == MAP_FAILED) {
+    return false;
+  }
+#ifdef MADV_SEQUENTIAL
+  madvise(view, size, MADV_SEQUENTIAL);
+#endif
+  Data = static_cast<const unsigned char *>(view);
+  Size = size;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (Data != nullptr) {
+    munmap(const_cast<unsigned char *>(Data), Size);
+  }
+  Data = nullptr;
+  Size = 0;
+}
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+} // namespace bms_parser
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <cstddef>
+#include <filesystem>
+
+/**
+ * Read-only memory mapping of a whole file. The mapping is released when the
+ * object is closed or destroyed, so views into GetData() must not outlive it.
+ */
+namespace bms_parser {
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  // returns false if the file could not be opened or mapped
+  bool Open(const std::filesystem::path &path);
+  void Close();
+
+  [[nodiscard]] const unsigned char *GetData() const { return Data; }
+  [[nodiscard]] size_t GetSize() const { return Size; }
+
+private:
+  const unsigned char *Data = nullptr;
+  size_t Size = 0;
+#ifdef _WIN32
+  HANDLE File = INVALID_HANDLE_VALUE;
+  HANDLE Mapping = nullptr;
+#endif
+};
+} // namespace bms_parser
@@ -18,8 +18,10 @@
 
 namespace bms_parser {
 Measure::~Measure() {
+  // the timelines live in the chart's arena; this only frees what they
+  // allocated themselves
   for (const auto &Timeline : TimeLines) {
-    delete Timeline;
+    Timeline->~TimeLine();
   }
   TimeLines.clear();
 }
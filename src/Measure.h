@@ -17,6 +17,7 @@
 #pragma once
 
 #include "TimeLine.h"
+#include <vector>
 /**
  *
  */
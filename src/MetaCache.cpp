@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MetaCache.h"
+#include "Parser.h"
+#include "XXHash64.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <vector>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace bms_parser {
+namespace {
+// "BMMC", then the format and parser versions, the entry count, the entries
+// and an XXH64 of everything before it. Numbers are little-endian.
+constexpr uint32_t CacheMagic = 0x434D4D42;
+// bump when the entry layout changes, e.g. when ChartMeta gains a field
+constexpr uint32_t CacheFormat = 2;
+
+class CacheWriter {
+public:
+  std::vector<unsigned char> Bytes;
+
+  void Field(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      Bytes.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+  }
+  void Field(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      Bytes.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+  }
+  void Field(int value) { Field(static_cast<uint32_t>(value)); }
+  void Field(long long value) { Field(static_cast<uint64_t>(value)); }
+  void Field(bool value) { Bytes.push_back(value ? 1 : 0); }
+  void Field(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Field(bits);
+  }
+  void Field(TextEncoding value) {
+    Bytes.push_back(static_cast<unsigned char>(value));
+  }
+  void Field(const std::string &value) {
+    Field(static_cast<uint32_t>(value.size()));
+    Bytes.insert(Bytes.end(), value.begin(), value.end());
+  }
+  void Field(const std::filesystem::path &value) { Field(value.u8string()); }
+};
+
+// Reads what CacheWriter wrote. Running past the end sets Failed and yields
+// zeros from then on, so callers only check once at the end.
+class CacheReader {
+public:
+  CacheReader(const unsigned char *bytes, size_t size)
+      : Bytes(bytes), Size(size) {}
+  bool Failed = false;
+
+  [[nodiscard]] size_t Consumed() const { return Offset; }
+  void Field(uint64_t &value) {
+    value = 0;
+    if (Take(8)) {
+      for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | Bytes[Offset - 8 + i];
+      }
+    }
+  }
+  void Field(uint32_t &value) {
+    value = 0;
+    if (Take(4)) {
+      for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | Bytes[Offset - 4 + i];
+      }
+    }
+  }
+  void Field(int &value) {
+    uint32_t bits;
+    Field(bits);
+    value = static_cast<int>(bits);
+  }
+  void Field(long long &value) {
+    uint64_t bits;
+    Field(bits);
+    value = static_cast<long long>(bits);
+  }
+  void Field(bool &value) { value = Take(1) && Bytes[Offset - 1] != 0; }
+  void Field(double &value) {
+    uint64_t bits;
+    Field(bits);
+    std::memcpy(&value, &bits, sizeof(value));
+  }
+  void Field(TextEncoding &value) {
+    value = static_cast<TextEncoding>(Take(1) ? Bytes[Offset - 1] : 0);
+  }
+  void Field(std::string &value) {
+    uint32_t length;
+    Field(length);
+    value.clear();
+    if (Take(length)) {
+      value.assign(reinterpret_cast<const char *>(Bytes + Offset - length),
+                   length);
+    }
+  }
+  void Field(std::filesystem::path &value) {
+    std::string utf8;
+    Field(utf8);
+    value = std::filesystem::u8path(utf8);
+  }
+
+private:
+  bool Take(size_t count) {
+    if (Failed || Size - Offset < count) {
+      Failed = true;
+      return false;
+    }
+    Offset += count;
+    return true;
+  }
+  const unsigned char *Bytes;
+  size_t Size;
+  size_t Offset = 0;
+};
+
+// every field of an entry, in file order; Meta is const when writing
+template <class Archive, class Identity, class Meta>
+void EntryFields(Archive &archive, Identity &identity, Meta &meta) {
+  archive.Field(identity.Path);
+  archive.Field(identity.Size);
+  archive.Field(identity.ModifiedTime);
+  archive.Field(identity.Inode);
+  archive.Field(identity.Device);
+  archive.Field(meta.SHA256);
+  archive.Field(meta.MD5);
+  archive.Field(meta.ContentHash);
+  archive.Field(meta.BmsPath);
+  archive.Field(meta.Folder);
+  archive.Field(meta.Artist);
+  archive.Field(meta.SubArtist);
+  archive.Field(meta.Bpm);
+  archive.Field(meta.Genre);
+  archive.Field(meta.Title);
+  archive.Field(meta.SubTitle);
+  archive.Field(meta.Rank);
+  archive.Field(meta.Total);
+  archive.Field(meta.PlayLength);
+  archive.Field(meta.TotalLength);
+  archive.Field(meta.Banner);
+  archive.Field(meta.StageFile);
+  archive.Field(meta.BackBmp);
+  archive.Field(meta.Preview);
+  archive.Field(meta.BgaPoorDefault);
+  archive.Field(meta.Difficulty);
+  archive.Field(meta.PlayLevel);
+  archive.Field(meta.MinBpm);
+  archive.Field(meta.MaxBpm);
+  archive.Field(meta.Player);
+  archive.Field(meta.KeyMode);
+  archive.Field(meta.IsDP);
+  archive.Field(meta.TotalNotes);
+  archive.Field(meta.TotalLongNotes);
+  archive.Field(meta.TotalScratchNotes);
+  archive.Field(meta.TotalBackSpinNotes);
+  archive.Field(meta.TotalLandmineNotes);
+  archive.Field(meta.LnMode);
+  archive.Field(meta.Encoding);
+  archive.Field(meta.HasRandom);
+}
+} // namespace
+
+bool FileIdentity::operator==(const FileIdentity &other) const {
+  return Path == other.Path && Size == other.Size &&
+         ModifiedTime == other.ModifiedTime && Inode == other.Inode &&
+         Device == other.Device;
+}
+
+bool FileIdentity::Of(const std::filesystem::path &path,
+                      FileIdentity &identity) {
+  identity = FileIdentity();
+#ifdef _WIN32
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) {
+    return false;
+  }
+  identity.Size = std::filesystem::file_size(path, ec);
+  const auto modified = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return false;
+  }
+  identity.ModifiedTime = static_cast<long long>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          modified.time_since_epoch())
+          .count());
+#else
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) {
+    return false;
+  }
+  identity.Size = static_cast<uint64_t>(status.st_size);
+#ifdef __APPLE__
+  const auto &modified = status.st_mtimespec;
+#else
+  const auto &modified = status.st_mtim;
+#endif
+  identity.ModifiedTime =
+      static_cast<long long>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+  identity.Inode = static_cast<uint64_t>(status.st_ino);
+  identity.Device = static_cast<uint64_t>(status.st_dev);
+#endif
+  identity.Path = path.u8string();
+  return true;
+}
+
+bool MetaCache::Load(const std::filesystem::path &file) {
+  std::unordered_map<std::string, Entry> entries;
+  std::vector<unsigned char> bytes;
+  std::ifstream in(file, std::ios::binary | std::ios::ate);
+  if (in.is_open()) {
+    bytes.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+    if (!in) {
+      bytes.clear();
+    }
+  }
+  bool loaded = false;
+  if (bytes.size() >= 8) {
+    const auto payload = bytes.size() - 8;
+    CacheReader reader(bytes.data(), bytes.size());
+    uint32_t magic, format, version, count;
+    reader.Field(magic);
+    reader.Field(format);
+    reader.Field(version);
+    reader.Field(count);
+    if (magic == CacheMagic && format == CacheFormat &&
+        version == Parser::Version) {
+      entries.reserve(std::min<size_t>(count, payload / 64));
+      for (uint32_t i = 0; i < count && !reader.Failed; ++i) {
+        Entry entry;
+        EntryFields(reader, entry.Identity, entry.Meta);
+        auto key = entry.Identity.Path;
+        entries.emplace(std::move(key), std::move(entry));
+      }
+      uint64_t checksum;
+      reader.Field(checksum);
+      loaded = !reader.Failed && reader.Consumed() == bytes.size() &&
+               checksum == XXHash64(bytes.data(), payload);
+    }
+  }
+  std::lock_guard<std::mutex> lock(Mutex);
+  Entries.clear();
+  if (loaded) {
+    Entries = std::move(entries);
+  }
+  return loaded;
+}
+
+bool MetaCache::Save(const std::filesystem::path &file) const {
+  CacheWriter writer;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    writer.Field(CacheMagic);
+    writer.Field(CacheFormat);
+    writer.Field(Parser::Version);
+    writer.Field(static_cast<uint32_t>(Entries.size()));
+    for (const auto &[path, entry] : Entries) {
+      EntryFields(writer, entry.Identity, entry.Meta);
+    }
+  }
+  writer.Field(XXHash64(writer.Bytes.data(), writer.Bytes.size()));
+
+  auto temporary = file;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(writer.Bytes.data()),
+              static_cast<std::streamsize>(writer.Bytes.size()));
+    if (!out.good()) {
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(temporary, file, ec);
+  return !ec;
+}
+
+bool MetaCache::Find(const std::filesystem::path &path, ChartMeta &meta,
+                     FileIdentity &identity) {
+  if (!FileIdentity::Of(path, identity)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(Mutex);
+  const auto found = Entries.find(identity.Path);
+  if (found == Entries.end() || !(found->second.Identity == identity)) {
+    return false;
+  }
+  found->second.Used = true;
+  meta = found->second.Meta;
+  return true;
+}
+
+void MetaCache::Store(const FileIdentity &identity, const ChartMeta &meta) {
+  if (identity.Path.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(Mutex);
+  auto &entry = Entries[identity.Path];
+  entry.Identity = identity;
+  entry.Meta = meta;
+  entry.Used = true;
+}
+
+size_t MetaCache::RemoveUnused() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  size_t removed = 0;
+  for (auto it = Entries.begin(); it != Entries.end();) {
+    if (it->second.Used) {
+      ++it;
+    } else {
+      it = Entries.erase(it);
+      ++removed;
+    }
+  }
+  return removed;
+}
+
+size_t MetaCache::size() const {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Entries.size();
+}
+} // namespace bms_parser
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Chart.h"
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * On-disk store of ChartMeta, so a library scan only parses charts that
+ * changed since the last one. A chart counts as unchanged while its size,
+ * modification time and inode are what they were when it was stored, and
+ * the whole store is dropped when Parser::Version moves on. Checking an
+ * entry costs one stat() of the chart; the chart itself is never opened.
+ */
+namespace bms_parser {
+// what MetaCache compares to decide whether a file changed
+struct FileIdentity {
+  std::string Path; // UTF-8, as given; the cache does not normalise paths
+  uint64_t Size = 0;
+  long long ModifiedTime = 0; // nanoseconds
+  // 0 on Windows, where getting one means opening the file
+  uint64_t Inode = 0;
+  uint64_t Device = 0;
+
+  [[nodiscard]] bool operator==(const FileIdentity &other) const;
+  // stats the file; false if it is missing or not a regular file
+  static bool Of(const std::filesystem::path &path, FileIdentity &identity);
+};
+
+class MetaCache {
+public:
+  MetaCache() = default;
+  MetaCache(const MetaCache &) = delete;
+  MetaCache &operator=(const MetaCache &) = delete;
+
+  // Replaces the entries with those saved in file. A missing, corrupt or
+  // outdated file leaves the cache empty and returns false.
+  bool Load(const std::filesystem::path &file);
+  // Writes every entry to file, through a temporary file so that a crash
+  // never leaves a half-written cache behind.
+  bool Save(const std::filesystem::path &file) const;
+
+  // Fills meta and returns true if the chart at path is cached and has not
+  // changed since. Otherwise fills identity, to be handed to Store once the
+  // chart has been parsed: taking it before the parse means a file edited
+  // during the parse is seen as changed next time.
+  bool Find(const std::filesystem::path &path, ChartMeta &meta,
+            FileIdentity &identity);
+  void Store(const FileIdentity &identity, const ChartMeta &meta);
+  // Drops the entries neither found nor stored since Load, i.e. those of
+  // charts that are gone. Returns how many were dropped.
+  size_t RemoveUnused();
+  [[nodiscard]] size_t size() const;
+
+private:
+  struct Entry {
+    FileIdentity Identity;
+    ChartMeta Meta;
+    bool Used = false;
+  };
+  mutable std::mutex Mutex;
+  std::unordered_map<std::string, Entry> Entries; // by FileIdentity::Path
+};
+} // namespace bms_parser
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MultiHash.h"
+#include "CpuFeatures.h"
+#include "SHA256.h"
+#include "md5.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+namespace {
+std::string HashMD5(const HashInput &input) {
+  MD5 md5;
+  md5.update(input.Bytes, static_cast<MD5::size_type>(input.Size));
+  md5.finalize();
+  return md5.hexdigest();
+}
+
+#if BMS_PARSER_X86
+constexpr size_t BlockSize = 64;
+
+// A message as the blocks the compression function sees: the whole blocks
+// straight from the input, then one or two padded blocks from Tail.
+struct LaneMessage {
+  const unsigned char *Bytes = nullptr;
+  size_t WholeBlocks = 0;
+  size_t Blocks = 0;
+  size_t Next = 0;
+  unsigned char Tail[2 * BlockSize];
+
+  void Reset(const HashInput &input, bool bigEndianLength) {
+    Bytes = input.Bytes;
+    WholeBlocks = input.Size / BlockSize;
+    Next = 0;
+    const auto rest = input.Size % BlockSize;
+    Blocks = WholeBlocks + (rest < BlockSize - 8 ? 1 : 2);
+    std::memset(Tail, 0, sizeof(Tail));
+    if (rest != 0) {
+      std::memcpy(Tail, Bytes + WholeBlocks * BlockSize, rest);
+    }
+    Tail[rest] = 0x80;
+    auto *length = Tail + (Blocks - WholeBlocks) * BlockSize - 8;
+    const uint64_t bits = static_cast<uint64_t>(input.Size) * 8;
+    for (int i = 0; i < 8; ++i) {
+      const auto shift = bigEndianLength ? 56 - i * 8 : i * 8;
+      length[i] = static_cast<unsigned char>(bits >> shift);
+    }
+  }
+  [[nodiscard]] const unsigned char *Block(size_t index) const {
+    return index < WholeBlocks ? Bytes + index * BlockSize
+                               : Tail + (index - WholeBlocks) * BlockSize;
+  }
+};
+
+// State word w of lane l is State[w][l], so a row loads as one register.
+template <size_t Words> struct LaneState {
+  alignas(32) uint32_t State[Words][HashLanes];
+};
+
+// rows[l] holds eight consecutive words of lane l; afterwards rows[w] holds
+// word w of every lane
+BMS_PARSER_TARGET("avx2")
+inline void Transpose(__m256i *rows) {
+  const auto t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+  const auto t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+  const auto t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+  const auto t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+  const auto t4 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+  const auto t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+  const auto t6 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+  const auto t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+  const auto u0 = _mm256_unpacklo_epi64(t0, t2);
+  const auto u1 = _mm256_unpackhi_epi64(t0, t2);
+  const auto u2 = _mm256_unpacklo_epi64(t1, t3);
+  const auto u3 = _mm256_unpackhi_epi64(t1, t3);
+  const auto u4 = _mm256_unpacklo_epi64(t4, t6);
+  const auto u5 = _mm256_unpackhi_epi64(t4, t6);
+  const auto u6 = _mm256_unpacklo_epi64(t5, t7);
+  const auto u7 = _mm256_unpackhi_epi64(t5, t7);
+  rows[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  rows[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  rows[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  rows[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  rows[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  rows[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  rows[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  rows[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// the sixteen message words of every lane's block, word-major
+BMS_PARSER_TARGET("avx2")
+inline void LoadMessage(const unsigned char *const *blocks, __m256i *words) {
+  for (size_t half = 0; half < 2; ++half) {
+    for (size_t lane = 0; lane < HashLanes; ++lane) {
+      words[half * 8 + lane] = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(blocks[lane] + half * 32));
+    }
+    Transpose(words + half * 8);
+  }
+}
+
+BMS_PARSER_TARGET("avx2")
+inline __m256i RotateLeft(__m256i x, int n) {
+  return _mm256_or_si256(_mm256_slli_epi32(x, n),
+                         _mm256_srli_epi32(x, 32 - n));
+}
+
+struct Md5Lanes {
+  static constexpr size_t Words = 4;
+  static constexpr bool BigEndianLength = false;
+  static constexpr uint32_t Initial[Words] = {0x67452301, 0xefcdab89,
+                                              0x98badcfe, 0x10325476};
+
+  static void Compress(LaneState<Words> &state,
+                       const unsigned char *const *blocks);
+  static std::string HexDigest(const LaneState<Words> &state, size_t lane) {
+    char buf[2 * 16 + 1];
+    for (size_t w = 0; w < Words; ++w) {
+      const auto word = state.State[w][lane];
+      for (size_t b = 0; b < 4; ++b) {
+        snprintf(buf + (w * 4 + b) * 2, 3, "%02x", (word >> (b * 8)) & 0xff);
+      }
+    }
+    return buf;
+  }
+  static std::string &Digest(HashOutput &output) { return output.MD5; }
+};
+
+constexpr uint32_t Md5Constants[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
+    0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
+    0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8,
+    0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92,
+    0xffeff47d, 0x85845dd1, 0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+// one MD5 step: a = b + rotl(a + f + k + m, s)
+#define MD5_LANES_STEP(f, a, b, c, d, i, g, s)                                 \
+  a = _mm256_add_epi32(                                                        \
+      b, RotateLeft(_mm256_add_epi32(                                          \
+                        _mm256_add_epi32(a, f),                                \
+                        _mm256_add_epi32(                                      \
+                            _mm256_set1_epi32(                                 \
+                                static_cast<int>(Md5Constants[i])),            \
+                            m[g])),                                            \
+                    s))
+
+BMS_PARSER_TARGET("avx2")
+void Md5Lanes::Compress(LaneState<Words> &state,
+                        const unsigned char *const *blocks) {
+  __m256i m[16];
+  LoadMessage(blocks, m);
+  const auto ones = _mm256_set1_epi32(-1);
+  auto *rows = reinterpret_cast<__m256i *>(state.State);
+  auto a = _mm256_load_si256(rows);
+  auto b = _mm256_load_si256(rows + 1);
+  auto c = _mm256_load_si256(rows + 2);
+  auto d = _mm256_load_si256(rows + 3);
+  const auto a0 = a, b0 = b, c0 = c, d0 = d;
+#define MD5_F(x, y, z)                                                         \
+  _mm256_or_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z))
+#define MD5_G(x, y, z)                                                         \
+  _mm256_or_si256(_mm256_and_si256(x, z), _mm256_andnot_si256(z, y))
+#define MD5_H(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define MD5_I(x, y, z)                                                         \
+  _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, ones)))
+  for (int i = 0; i < 16; i += 4) {
+    MD5_LANES_STEP(MD5_F(b, c, d), a, b, c, d, i, i, 7);
+    MD5_LANES_STEP(MD5_F(a, b, c), d, a, b, c, i + 1, i + 1, 12);
+    MD5_LANES_STEP(MD5_F(d, a, b), c, d, a, b, i + 2, i + 2, 17);
+    MD5_LANES_STEP(MD5_F(c, d, a), b, c, d, a, i + 3, i + 3, 22);
+  }
+  for (int i = 16; i < 32; i += 4) {
+    MD5_LANES_STEP(MD5_G(b, c, d), a, b, c, d, i, (5 * i + 1) % 16, 5);
+    MD5_LANES_STEP(MD5_G(a, b, c), d, a, b, c, i + 1, (5 * i + 6) % 16, 9);
+    MD5_LANES_STEP(MD5_G(d, a, b), c, d, a, b, i + 2, (5 * i + 11) % 16, 14);
+    MD5_LANES_STEP(MD5_G(c, d, a), b, c, d, a, i + 3, (5 * i + 16) % 16, 20);
+  }
+  for (int i = 32; i < 48; i += 4) {
+    MD5_LANES_STEP(MD5_H(b, c, d), a, b, c, d, i, (3 * i + 5) % 16, 4);
+    MD5_LANES_STEP(MD5_H(a, b, c), d, a, b, c, i + 1, (3 * i + 8) % 16, 11);
+    MD5_LANES_STEP(MD5_H(d, a, b), c, d, a, b, i + 2, (3 * i + 11) % 16, 16);
+    MD5_LANES_STEP(MD5_H(c, d, a), b, c, d, a, i + 3, (3 * i + 14) % 16, 23);
+  }
+  for (int i = 48; i < 64; i += 4) {
+    MD5_LANES_STEP(MD5_I(b, c, d), a, b, c, d, i, (7 * i) % 16, 6);
+    MD5_LANES_STEP(MD5_I(a, b, c), d, a, b, c, i + 1, (7 * i + 7) % 16, 10);
+    MD5_LANES_STEP(MD5_I(d, a, b), c, d, a, b, i + 2, (7 * i + 14) % 16, 15);
+    MD5_LANES_STEP(MD5_I(c, d, a), b, c, d, a, i + 3, (7 * i + 21) % 16, 21);
+  }
+#undef MD5_F
+#undef MD5_G
+#undef MD5_H
+#undef MD5_I
+  _mm256_store_si256(rows, _mm256_add_epi32(a, a0));
+  _mm256_store_si256(rows + 1, _mm256_add_epi32(b, b0));
+  _mm256_store_si256(rows + 2, _mm256_add_epi32(c, c0));
+  _mm256_store_si256(rows + 3, _mm256_add_epi32(d, d0));
+}
+#undef MD5_LANES_STEP
+
+struct Sha256Lanes {
+  static constexpr size_t Words = 8;
+  static constexpr bool BigEndianLength = true;
+  static constexpr uint32_t Initial[Words] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+  static void Compress(LaneState<Words> &state,
+                       const unsigned char *const *blocks);
+  static std::string HexDigest(const LaneState<Words> &state, size_t lane) {
+    char buf[2 * 32 + 1];
+    for (size_t w = 0; w < Words; ++w) {
+      snprintf(buf + w * 8, 9, "%08x",
+               static_cast<unsigned int>(state.State[w][lane]));
+    }
+    return buf;
+  }
+  static std::string &Digest(HashOutput &output) { return output.SHA256; }
+};
+
+constexpr uint32_t Sha256Constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+BMS_PARSER_TARGET("avx2")
+inline __m256i RotateRight(__m256i x, int n) {
+  return _mm256_or_si256(_mm256_srli_epi32(x, n),
+                         _mm256_slli_epi32(x, 32 - n));
+}
+
+BMS_PARSER_TARGET("avx2")
+void Sha256Lanes::Compress(LaneState<Words> &state,
+                           const unsigned char *const *blocks) {
+  __m256i w[16];
+  LoadMessage(blocks, w);
+  const auto byteSwap = _mm256_set_epi64x(
+      0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL,
+      0x0405060700010203ULL);
+  for (auto &word : w) {
+    word = _mm256_shuffle_epi8(word, byteSwap);
+  }
+  auto *rows = reinterpret_cast<__m256i *>(state.State);
+  __m256i v[Words];
+  for (size_t i = 0; i < Words; ++i) {
+    v[i] = _mm256_load_si256(rows + i);
+  }
+  auto a = v[0], b = v[1], c = v[2], d = v[3];
+  auto e = v[4], f = v[5], g = v[6], h = v[7];
+  for (int t = 0; t < 64; ++t) {
+    auto &wt = w[t & 15];
+    if (t >= 16) {
+      const auto w2 = w[(t - 2) & 15];
+      const auto w15 = w[(t - 15) & 15];
+      const auto s0 = _mm256_xor_si256(
+          _mm256_xor_si256(RotateRight(w15, 7), RotateRight(w15, 18)),
+          _mm256_srli_epi32(w15, 3));
+      const auto s1 = _mm256_xor_si256(
+          _mm256_xor_si256(RotateRight(w2, 17), RotateRight(w2, 19)),
+          _mm256_srli_epi32(w2, 10));
+      wt = _mm256_add_epi32(_mm256_add_epi32(wt, s0),
+                            _mm256_add_epi32(w[(t - 7) & 15], s1));
+    }
+    const auto bigSigma1 = _mm256_xor_si256(
+        _mm256_xor_si256(RotateRight(e, 6), RotateRight(e, 11)),
+        RotateRight(e, 25));
+    const auto ch = _mm256_xor_si256(_mm256_and_si256(e, f),
+                                     _mm256_andnot_si256(e, g));
+    const auto t1 = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(h, bigSigma1),
+                         _mm256_add_epi32(ch, wt)),
+        _mm256_set1_epi32(static_cast<int>(Sha256Constants[t])));
+    const auto bigSigma0 = _mm256_xor_si256(
+        _mm256_xor_si256(RotateRight(a, 2), RotateRight(a, 13)),
+        RotateRight(a, 22));
+    const auto maj = _mm256_xor_si256(
+        _mm256_and_si256(a, b),
+        _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+    const auto t2 = _mm256_add_epi32(bigSigma0, maj);
+    h = g;
+    g = f;
+    f = e;
+    e = _mm256_add_epi32(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = _mm256_add_epi32(t1, t2);
+  }
+  const __m256i out[Words] = {a, b, c, d, e, f, g, h};
+  for (size_t i = 0; i < Words; ++i) {
+    _mm256_store_si256(rows + i, _mm256_add_epi32(v[i], out[i]));
+  }
+}
+
+// Feeds the messages through the lanes in order, refilling a lane as soon as
+// its message is done. Lanes left without a message hash a block of zeros.
+template <class Algorithm>
+void RunLanes(const HashInput *inputs, size_t count, HashOutput *outputs) {
+  constexpr size_t Idle = SIZE_MAX;
+  static const unsigned char zeros[BlockSize] = {};
+  LaneState<Algorithm::Words> state;
+  LaneMessage messages[HashLanes];
+  size_t owner[HashLanes];
+  const unsigned char *blocks[HashLanes];
+  size_t next = 0;
+  size_t active = 0;
+  auto refill = [&](size_t lane) {
+    if (next == count) {
+      owner[lane] = Idle;
+      return;
+    }
+    owner[lane] = next;
+    messages[lane].Reset(inputs[next++], Algorithm::BigEndianLength);
+    for (size_t w = 0; w < Algorithm::Words; ++w) {
+      state.State[w][lane] = Algorithm::Initial[w];
+    }
+    ++active;
+  };
+  for (size_t lane = 0; lane < HashLanes; ++lane) {
+    refill(lane);
+  }
+  while (active > 0) {
+    for (size_t lane = 0; lane < HashLanes; ++lane) {
+      blocks[lane] = owner[lane] == Idle
+                         ? zeros
+                         : messages[lane].Block(messages[lane].Next);
+    }
+    Algorithm::Compress(state, blocks);
+    for (size_t lane = 0; lane < HashLanes; ++lane) {
+      if (owner[lane] == Idle ||
+          ++messages[lane].Next < messages[lane].Blocks) {
+        continue;
+      }
+      Algorithm::Digest(outputs[owner[lane]]) =
+          Algorithm::HexDigest(state, lane);
+      --active;
+      refill(lane);
+    }
+  }
+}
+#endif
+} // namespace
+
+void HashMany(const HashInput *inputs, size_t count, HashOutput *outputs,
+              bool wantMD5, bool wantSHA256, HashManyMode mode) {
+#if BMS_PARSER_X86
+  const bool forced = mode == HashManyMode::Lanes;
+  const bool lanes = mode != HashManyMode::Single &&
+                     (count > 1 || forced) && CpuFeatures::HasAVX2();
+  if (lanes && wantMD5) {
+    RunLanes<Md5Lanes>(inputs, count, outputs);
+    wantMD5 = false;
+  }
+  // one SHA-NI stream beats eight AVX2 lanes
+  if (lanes && wantSHA256 && (forced || !CpuFeatures::HasSHA())) {
+    RunLanes<Sha256Lanes>(inputs, count, outputs);
+    wantSHA256 = false;
+  }
+#endif
+  for (size_t i = 0; i < count; ++i) {
+    if (wantMD5) {
+      outputs[i].MD5 = HashMD5(inputs[i]);
+    }
+    if (wantSHA256) {
+      outputs[i].SHA256 = sha256(inputs[i].Bytes, inputs[i].Size);
+    }
+  }
+}
+} // namespace bms_parser
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * Hashes many independent messages together. MD5 and SHA-256 can't be split
+ * up within one message, but eight messages fit side by side in the lanes of
+ * an AVX2 register: every lane runs its own message block by block, and
+ * takes the next message as soon as its current one is done.
+ */
+namespace bms_parser {
+// messages hashed at the same time
+constexpr size_t HashLanes = 8;
+
+struct HashInput {
+  const unsigned char *Bytes = nullptr;
+  size_t Size = 0;
+};
+
+struct HashOutput {
+  std::string MD5;
+  std::string SHA256;
+};
+
+// How HashMany runs. Auto puts MD5 in the AVX2 lanes and leaves SHA-256 to
+// SHA-NI when the CPU has it. Lanes puts both in the lanes whenever the CPU
+// has AVX2, even for one message, and Single hashes one message at a time.
+// The last two are for tests.
+enum class HashManyMode { Auto, Lanes, Single };
+
+// Fills outputs[i] with the lowercase hex digests of inputs[i]; a digest
+// that is not wanted is left empty. Messages of similar length share the
+// lanes best, so sort them by size if you can.
+void HashMany(const HashInput *inputs, size_t count, HashOutput *outputs,
+              bool wantMD5 = true, bool wantSHA256 = true,
+              HashManyMode mode = HashManyMode::Auto);
+} // namespace bms_parser
@@ -18,18 +18,5 @@
 namespace bms_parser {
 Note::Note(int wav) { Wav = wav; }
 
-void Note::Play(long long Time) {
-  IsPlayed = true;
-  PlayedTime = Time;
-}
-
-void Note::Press(long long Time) { Play(Time); }
-
-void Note::Reset() {
-  IsPlayed = false;
-  IsDead = false;
-  PlayedTime = 0;
-}
-
 Note::~Note() { Timeline = nullptr; }
 } // namespace bms_parser
@@ -15,6 +15,7 @@
  */
 
 #pragma once
+#include "NoteRecord.h"
 
 namespace bms_parser {
 class TimeLine;
@@ -23,24 +24,25 @@ class Note {
 public:
   int Lane = 0;
   int Wav = 0;
-
-  bool IsPlayed = false;
-  bool IsDead = false;
-  long long PlayedTime = 0;
   TimeLine *Timeline = nullptr;
+  // set by the subclass; Chart::BuildNoteRecords refines it into head/tail,
+  // invisible and background once the chart is complete
+  NoteKind Kind = NoteKind::Normal;
+  // index of this note's record in Chart::Notes, and of its state in a
+  // PlayState
+  uint32_t Id = NoNoteId;
 
   // private Note nextNote;
 
   explicit Note(int Wav);
 
-  void Play(long long Time);
-
-  virtual void Press(long long Time);
-
-  virtual void Reset();
   virtual ~Note();
 
-  virtual bool IsLongNote() { return false; }
-  virtual bool IsLandmineNote() { return false; }
+  [[nodiscard]] bool IsLongNote() const {
+    return Kind == NoteKind::LongHead || Kind == NoteKind::LongTail;
+  }
+  [[nodiscard]] bool IsLandmineNote() const {
+    return Kind == NoteKind::Landmine;
+  }
 };
 } // namespace bms_parser
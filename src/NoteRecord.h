@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+namespace bms_parser {
+enum class NoteKind : uint8_t {
+  Normal = 0,
+  LongHead = 1,
+  LongTail = 2,
+  Landmine = 3,
+  Invisible = 4,
+  Background = 5,
+};
+
+// index of a note in Chart::Notes, or NoNoteId for none
+constexpr uint32_t NoNoteId = UINT32_MAX;
+
+/**
+ * Compact copy of a note for loops that only need to look at it. The chart
+ * keeps one per note in Chart::Notes, in timeline order, so judging or
+ * drawing a lane walks contiguous memory and checks the kind with a plain
+ * compare instead of going through the Note object.
+ */
+struct NoteRecord {
+  int32_t Wav;
+  // index into Chart::TimeLines
+  uint32_t Timeline;
+  // the other end of a long note; NoNoteId otherwise
+  uint32_t Partner;
+  // landmine damage; 0 for everything else
+  float Damage;
+  uint8_t Lane;
+  NoteKind Kind;
+
+  [[nodiscard]] bool IsLongNote() const {
+    return Kind == NoteKind::LongHead || Kind == NoteKind::LongTail;
+  }
+  [[nodiscard]] bool IsLandmineNote() const {
+    return Kind == NoteKind::Landmine;
+  }
+};
+static_assert(sizeof(NoteRecord) <= 24, "NoteRecord should stay small");
+static_assert(std::is_trivially_copyable<NoteRecord>::value,
+              "NoteRecord is copied around as plain bytes");
+} // namespace bms_parser
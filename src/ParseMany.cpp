@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ParseMany.h"
+#include "MappedFile.h"
+#include "MultiHash.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+
+namespace bms_parser {
+namespace {
+// Shared by the caller and the jobs. Jobs may start after ParseMany has
+// returned (when the executor was busy and the caller did all the work), so
+// they only touch this, never the caller's stack.
+struct Batch {
+  std::vector<std::filesystem::path> Paths;
+  // indices into Paths, largest file first
+  std::vector<size_t> Order;
+  BatchOptions Options;
+  BatchCallback Callback;
+  std::atomic_bool *Cancelled;
+  std::atomic<size_t> Next{0};
+  // paths a job takes at a time, at most HashLanes
+  size_t GroupSize = 1;
+
+  // set once a callback has thrown; groups taken from then on are only
+  // counted, never parsed
+  std::atomic_bool Stopped{false};
+
+  std::mutex DoneMutex;
+  std::condition_variable DoneChanged;
+  size_t Done = 0;          // guarded by DoneMutex
+  std::exception_ptr Error; // the first callback error, guarded by DoneMutex
+
+  void Fail(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(DoneMutex);
+    if (!Error) {
+      Error = std::move(error);
+    }
+    Stopped = true;
+  }
+  void Finish(size_t count) {
+    std::lock_guard<std::mutex> lock(DoneMutex);
+    Done += count;
+    if (Done == Order.size()) {
+      DoneChanged.notify_all();
+    }
+  }
+};
+
+// A file of the current group, kept in memory from its parse until it has
+// been hashed with the rest of the group. A job keeps its entries for all of
+// its groups, so the read buffers only grow to the largest file it takes.
+struct GroupEntry {
+  MappedFile Mapped;
+  std::vector<unsigned char> Buffer;
+  HashInput Source;
+  Chart *Result = nullptr;
+  std::exception_ptr Error;
+
+  // ready for the next file; the chart must have been handed over or deleted
+  void Reset() {
+    Mapped.Close();
+    Buffer.clear();
+    Source = {};
+    Result = nullptr;
+    Error = nullptr;
+  }
+};
+
+void Load(const std::filesystem::path &path, bool useMemoryMap,
+          GroupEntry &entry) {
+  if (useMemoryMap && entry.Mapped.Open(path)) {
+    entry.Source = {entry.Mapped.GetData(), entry.Mapped.GetSize()};
+    return;
+  }
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open file: " + path.string());
+  }
+  // fails for directories, which open fine but report a bogus size
+  std::error_code ec;
+  const auto fileSize = std::filesystem::file_size(path, ec);
+  if (ec) {
+    throw std::runtime_error("Failed to read file: " + path.string());
+  }
+  entry.Buffer.resize(static_cast<size_t>(fileSize));
+  if (!file.read(reinterpret_cast<char *>(entry.Buffer.data()),
+                 static_cast<std::streamsize>(fileSize))) {
+    throw std::runtime_error("Failed to read file: " + path.string());
+  }
+  entry.Source = {entry.Buffer.data(), entry.Buffer.size()};
+}
+
+// Parses the files of a group one after the other, then hashes them
+// together. Load and parse errors are kept in the entries.
+void ParseGroup(Batch &batch, std::optional<Parser> &parser,
+                GroupEntry *group, size_t first, size_t count,
+                std::vector<HashInput> &sources,
+                std::vector<HashOutput> &digests,
+                std::vector<size_t> &hashed) {
+  const auto &options = batch.Options;
+  sources.clear();
+  hashed.clear();
+  for (size_t i = 0; i < count; ++i) {
+    auto &entry = group[i];
+    if (*batch.Cancelled) {
+      continue;
+    }
+    const auto &path = batch.Paths[batch.Order[first + i]];
+    try {
+      if (!parser) {
+        parser.emplace();
+        auto parseOptions = options.Parse;
+        // the digests are computed for the whole group below, and the
+        // bytes are gone by the time anyone could ask for lazy ones
+        parseOptions.ComputeMD5 = false;
+        parseOptions.ComputeSHA256 = false;
+        parseOptions.LazyDigests = false;
+        parser->SetOptions(parseOptions);
+      }
+      Load(path, options.Parse.UseMemoryMap, entry);
+      parser->Parse(entry.Source.Bytes, entry.Source.Size, &entry.Result,
+                    options.AddReadyMeasure, options.MetaOnly,
+                    *batch.Cancelled);
+      entry.Result->Meta.BmsPath = path;
+      entry.Result->Meta.Folder = path.parent_path();
+    } catch (...) {
+      delete entry.Result;
+      entry.Result = nullptr;
+      entry.Error = std::current_exception();
+      continue;
+    }
+    if (options.Parse.ComputeMD5 || options.Parse.ComputeSHA256) {
+      sources.push_back(entry.Source);
+      hashed.push_back(i);
+    }
+  }
+  if (!*batch.Cancelled && !sources.empty()) {
+    digests.assign(sources.size(), HashOutput());
+    HashMany(sources.data(), sources.size(), digests.data(),
+             options.Parse.ComputeMD5, options.Parse.ComputeSHA256);
+    for (size_t h = 0; h < hashed.size(); ++h) {
+      auto &meta = group[hashed[h]].Result->Meta;
+      meta.MD5 = std::move(digests[h].MD5);
+      meta.SHA256 = std::move(digests[h].SHA256);
+    }
+  }
+}
+
+// Takes paths a group at a time until none are left, reusing one parser for
+// all of them.
+void Drain(Batch &batch) {
+  std::optional<Parser> parser;
+  std::vector<HashInput> sources;
+  std::vector<HashOutput> digests;
+  std::vector<size_t> hashed;
+  std::vector<GroupEntry> group(batch.GroupSize);
+  for (auto first = batch.Next.fetch_add(batch.GroupSize);
+       first < batch.Order.size();
+       first = batch.Next.fetch_add(batch.GroupSize)) {
+    const auto count = std::min(batch.GroupSize, batch.Order.size() - first);
+    // entries before this have been handed to the callback
+    size_t handed = 0;
+    // nothing may escape a job, and every path has to be counted as done
+    // whatever happens, or ParseMany would never return
+    try {
+      if (!batch.Stopped) {
+        ParseGroup(batch, parser, group.data(), first, count, sources, digests,
+                   hashed);
+        for (; handed < count; ++handed) {
+          auto &entry = group[handed];
+          // the chart no longer needs the file, the callback may take a while;
+          // the buffer is kept for the next group
+          entry.Mapped.Close();
+          // the callback owns the chart from here, even if it throws
+          const auto result = entry.Result;
+          entry.Result = nullptr;
+          batch.Callback(batch.Order[first + handed], result, entry.Error);
+        }
+      }
+    } catch (...) {
+      batch.Fail(std::current_exception());
+    }
+    // charts of the group the callback never got
+    for (size_t i = 0; i < count; ++i) {
+      delete group[i].Result;
+      group[i].Reset();
+    }
+    batch.Finish(count);
+  }
+}
+} // namespace
+
+void ParseMany(const std::vector<std::filesystem::path> &paths,
+               const BatchOptions &options, const BatchCallback &callback,
+               std::atomic_bool &bCancelled) {
+  if (paths.empty()) {
+    return;
+  }
+  auto batch = std::make_shared<Batch>();
+  batch->Paths = paths;
+  batch->Options = options;
+  batch->Callback = callback;
+  batch->Cancelled = &bCancelled;
+
+  // biggest first, so that no thread picks up a 5 MB chart at the very end
+  std::vector<std::uintmax_t> sizes(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(paths[i], ec);
+    sizes[i] = ec ? 0 : size;
+  }
+  batch->Order.resize(paths.size());
+  std::iota(batch->Order.begin(), batch->Order.end(), size_t{0});
+  std::stable_sort(
+      batch->Order.begin(), batch->Order.end(),
+      [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+  std::unique_ptr<ThreadPool> ownPool;
+  Executor *pool = options.Pool;
+  if (pool == nullptr) {
+    ownPool = std::make_unique<ThreadPool>();
+    pool = ownPool.get();
+  }
+  // the calling thread drains too, so the batch finishes even if the
+  // executor never gets round to the jobs
+  const auto helpers =
+      std::min<size_t>(std::max(1u, pool->Concurrency()), paths.size()) - 1;
+  // groups big enough to fill the hash lanes, but small enough that every
+  // thread still gets several of them
+  batch->GroupSize =
+      std::clamp<size_t>(paths.size() / ((helpers + 1) * 4), 1, HashLanes);
+  try {
+    for (size_t i = 0; i < helpers; ++i) {
+      pool->Submit([batch] { Drain(*batch); });
+    }
+  } catch (...) {
+    // whatever was not submitted is drained here
+  }
+  Drain(*batch);
+
+  // jobs must not outlive bCancelled, so wait even when a callback threw
+  std::unique_lock<std::mutex> lock(batch->DoneMutex);
+  batch->DoneChanged.wait(
+      lock, [&batch] { return batch->Done == batch->Order.size(); });
+  if (batch->Error) {
+    std::rethrow_exception(batch->Error);
+  }
+}
+} // namespace bms_parser
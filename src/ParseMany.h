@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Chart.h"
+#include "Executor.h"
+#include "Parser.h"
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+/**
+ * Parses a batch of chart files on an executor and hands each chart to a
+ * callback as soon as it is done.
+ */
+namespace bms_parser {
+struct BatchOptions {
+  ParseOptions Parse;
+  bool AddReadyMeasure = false;
+  bool MetaOnly = false;
+  // Runs the parse jobs. When null, ParseMany starts a ThreadPool with one
+  // thread per core for the duration of the call.
+  Executor *Pool = nullptr;
+};
+
+// Gets the index of the path, the chart and, if the file could not be read
+// or parsing threw, the error (in which case chart is null). Owns the chart from then on, even if it throws.
+// Called on the executor's threads, possibly for several charts at once.
+// Once it has thrown, no more files are started and the paths not yet
+// handed over never reach the callback; ParseMany rethrows the first such
+// exception after every job is done with the batch.
+using BatchCallback = std::function<void(size_t index, Chart *chart,
+                                         std::exception_ptr error)>;
+
+// Returns once the callback has been called for every path. The largest
+// files are started first, and every job keeps one Parser for all the files
+// it takes. Jobs take up to HashLanes files at a time and hash them together
+// with HashMany once they are parsed. Paths not started when bCancelled is
+// set are reported with a null chart and no error.
+void ParseMany(const std::vector<std::filesystem::path> &paths,
+               const BatchOptions &options, const BatchCallback &callback,
+               std::atomic_bool &bCancelled);
+} // namespace bms_parser
@@ -15,45 +15,118 @@
  */
 
 #include "Parser.h"
+#include "ChannelData.h"
+#include "DigestStream.h"
+#include "HeaderKeyword.h"
 #include "LandmineNote.h"
+#include "LineScanner.h"
 #include "LongNote.h"
+#include "MappedFile.h"
 #include "Measure.h"
 #include "Note.h"
-#include "ShiftJISConverter.h"
+#include "TextEncoding.h"
+#include "ThreadPool.h"
 #include "TimeLine.h"
+#include <condition_variable>
 #include <cwctype>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <thread>
 
-#include "SHA256.h"
-#include "md5.h"
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <climits>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <regex>
-#include <sstream>
 
 #ifndef BMS_PARSER_VERBOSE
 #define BMS_PARSER_VERBOSE 0
 #endif
 
 namespace bms_parser {
-class threadRAII {
-  std::thread th;
-
+namespace {
+// Work handed to an executor that the submitting thread can still take back.
+// Whoever claims it first runs it; once the owner is done with everything
+// else it runs the job itself if no pool thread has, or waits for the one
+// that did. The executor only ever holds the shared state, so it may get
+// round to the job long after the owner has returned.
+class ClaimableJob {
 public:
-  explicit threadRAII(std::thread &&_th) { th = std::move(_th); }
+  explicit ClaimableJob(std::function<void()> work)
+      : State(std::make_shared<Shared>()) {
+    State->Work = std::move(work);
+  }
+  ClaimableJob(const ClaimableJob &) = delete;
+  ClaimableJob &operator=(const ClaimableJob &) = delete;
+  ~ClaimableJob() { Finish(); }
+
+  void SubmitTo(Executor &executor) {
+    executor.Submit([state = State] { state->TryRun(); });
+  }
+  void Finish() {
+    if (State->TryRun()) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(State->Mutex);
+    State->DoneChanged.wait(lock, [this] { return State->Done; });
+  }
+
+private:
+  struct Shared {
+    std::function<void()> Work;
+    std::atomic_bool Claimed{false};
+    std::mutex Mutex;
+    std::condition_variable DoneChanged;
+    bool Done = false; // guarded by Mutex
+
+    bool TryRun() {
+      if (Claimed.exchange(true)) {
+        return false;
+      }
+      Work();
+      std::lock_guard<std::mutex> lock(Mutex);
+      Done = true;
+      DoneChanged.notify_all();
+      return true;
+    }
+  };
+  std::shared_ptr<Shared> State;
+};
 
-  ~threadRAII() {
-    if (th.joinable()) {
-      th.join();
+// Lends the source to the chart's digest getters for the duration of Parse,
+// or for good if the caller keeps the bytes alive.
+class DigestSource {
+public:
+  DigestSource(Chart *chart, const unsigned char *bytes, size_t size,
+               bool keep)
+      : Target(chart), Keep(keep) {
+    Target->SetDigestSource(bytes, size);
+  }
+  DigestSource(const DigestSource &) = delete;
+  DigestSource &operator=(const DigestSource &) = delete;
+  ~DigestSource() {
+    if (!Keep) {
+      Target->ClearDigestSource();
     }
   }
+
+private:
+  Chart *Target;
+  bool Keep;
 };
 
+Executor &SharedHashPool() {
+  static ThreadPool pool;
+  return pool;
+}
+} // namespace
+
 enum Channel {
   LaneAutoplay = 1,
   SectionRate = 2,
@@ -77,12 +150,175 @@ enum Channel {
 };
 
 namespace KeyAssign {
-int Beat7[] = {0, 1, 2, 3, 4, 7, -1, 5, 6, 8, 9, 10, 11, 12, 15, -1, 13, 14};
-int PopN[] = {0, 1, 2, 3, 4, -1, -1, -1, -1, -1, 5, 6, 7, 8, -1, -1, -1, -1};
+constexpr int Beat7[] = {0, 1, 2,  3,  4,  7,  -1, 5,  6,
+                         8, 9, 10, 11, 12, 15, -1, 13, 14};
+constexpr int PopN[] = {0, 1, 2, 3, 4, -1, -1, -1, -1,
+                        -1, 5, 6, 7, 8, -1, -1, -1, -1};
 } // namespace KeyAssign
 
+enum ChannelFlag : uint8_t {
+  ChannelScratch = 1 << 0,
+  // lanes 6 and 7 of either side: a 5 key chart is really 7 key
+  ChannelSevenKey = 1 << 1,
+  // any 2P lane: the chart is double play
+  ChannelDoublePlay = 1 << 2,
+};
+
+// What a channel id means, so the measure loop needs a single load instead
+// of walking the lane channel ranges.
+struct ChannelInfo {
+  // channel to dispatch on; the 2P, invisible, long and mine lanes fold into
+  // their 1P base channel
+  int16_t Kind;
+  // Beat7 lane, -1 for channels to ignore. Channels that aren't lanes get 0,
+  // like they always have.
+  int8_t Lane;
+  int8_t PopNLane; // -1 unless it's a lane channel PopN uses
+  uint8_t Flags;
+};
+
+// Channel ids are always base 36, even with #BASE 62
+constexpr int ChannelCount = 36 * 36;
+
+constexpr std::array<ChannelInfo, ChannelCount> BuildChannelTable() {
+  std::array<ChannelInfo, ChannelCount> table{};
+  for (int channel = 0; channel < ChannelCount; ++channel) {
+    table[channel] = {static_cast<int16_t>(channel), 0, -1, 0};
+  }
+  constexpr int laneChannels[][2] = {
+      {P1KeyBase, P2KeyBase},
+      {P1InvisibleKeyBase, P2InvisibleKeyBase},
+      {P1LongKeyBase, P2LongKeyBase},
+      {P1MineKeyBase, P2MineKeyBase},
+  };
+  for (const auto &bases : laneChannels) {
+    for (int side = 0; side < 2; ++side) {
+      for (int key = 0; key < 9; ++key) {
+        const int index = side * 9 + key;
+        const int lane = KeyAssign::Beat7[index];
+        uint8_t flags = 0;
+        if (lane == 7 || lane == 15) {
+          flags |= ChannelScratch;
+        }
+        if (lane == 5 || lane == 6 || lane == 13 || lane == 14) {
+          flags |= ChannelSevenKey;
+        }
+        if (lane >= 8) {
+          flags |= ChannelDoublePlay;
+        }
+        table[bases[side] + key] = {static_cast<int16_t>(bases[0]),
+                                    static_cast<int8_t>(lane),
+                                    static_cast<int8_t>(KeyAssign::PopN[index]),
+                                    flags};
+      }
+    }
+  }
+  return table;
+}
+
+constexpr auto ChannelTable = BuildChannelTable();
+
+inline const ChannelInfo &GetChannelInfo(int channel) {
+  // what a stray sign or space in the id parses to; matches no channel
+  static constexpr ChannelInfo unknown = {-1, 0, -1, 0};
+  return channel >= 0 && channel < ChannelCount ? ChannelTable[channel]
+                                                : unknown;
+}
+
 constexpr int TempKey = 16;
 
+// one channel line: measure number, channel id and the raw data after ':'
+struct ChannelRecord {
+  int Measure;
+  int Channel;
+  std::string_view Data;
+};
+
+// a non-"00" pair whose timeline is only known once the measure is sorted
+struct PairEvent {
+  uint32_t Record; // index into the channel records
+  uint32_t Pair;   // index of the pair in the record's data
+  int Id;
+  uint32_t Timeline;
+};
+
+constexpr uint32_t NoPairEvent = UINT32_MAX;
+
+// the position Pair / Pairs of a pair within its measure, kept as a fraction
+struct PairPosition {
+  uint32_t Pair;
+  uint32_t Pairs;
+  uint32_t Event; // PairEvent to point at the timeline, or NoPairEvent
+
+  bool Before(const PairPosition &other) const {
+    return static_cast<uint64_t>(Pair) * other.Pairs <
+           static_cast<uint64_t>(other.Pair) * Pairs;
+  }
+};
+
+// the channels whose events depend on the previous measures' long notes
+inline bool IsLaneChannel(int kind) {
+  return kind == P1KeyBase || kind == P1InvisibleKeyBase ||
+         kind == P1LongKeyBase || kind == P1MineKeyBase;
+}
+
+// a measure whose timelines are built but whose lane events are not applied
+// yet
+struct MeasureBuild {
+  Measure *Target = nullptr;
+  // position within the measure and timeline, in position order
+  std::vector<std::pair<double, TimeLine *>> TimeLines;
+  // in file order
+  std::vector<PairEvent> LaneEvents;
+  // ChannelSevenKey and ChannelDoublePlay of the measure's lane channels
+  uint8_t ChannelFlags = 0;
+};
+
+// buffers reused from one measure to the next, one set per thread
+struct MeasureScratch {
+  std::vector<PairPosition> Positions;
+  std::vector<PairEvent> Events;
+  std::vector<int> PairIds;
+  std::vector<uint64_t> NonZeroPairs;
+};
+
+// Upgrades the key mode for lanes 6/7 and the 2P side. Both upgrades give
+// the same result in either order, so a measure's flags can be applied in
+// one go.
+void ApplyKeyModeFlags(ChartMeta &meta, uint8_t flags) {
+  if ((flags & ChannelSevenKey) != 0) {
+    if (meta.KeyMode == 5) {
+      meta.KeyMode = 7;
+    } else if (meta.KeyMode == 10) {
+      meta.KeyMode = 14;
+    }
+  }
+  if ((flags & ChannelDoublePlay) != 0) {
+    if (meta.KeyMode == 7) {
+      meta.KeyMode = 14;
+    } else if (meta.KeyMode == 5) {
+      meta.KeyMode = 10;
+    }
+    meta.IsDP = true;
+  }
+}
+
+// below this many measures per thread the threads cost more than they save
+constexpr size_t MinMeasuresPerWorker = 16;
+
+unsigned int MeasureWorkerCount(unsigned int requested, size_t measureCount,
+                                bool metaOnly) {
+  if (metaOnly) {
+    return 1;
+  }
+  if (requested == 0) {
+    requested = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const auto useful = measureCount / MinMeasuresPerWorker;
+  return static_cast<unsigned int>(
+      std::max<size_t>(1, std::min<size_t>(requested, useful)));
+}
+
 Parser::Parser() : BpmTable{}, StopLengthTable{}, ScrollTable{} {
   std::random_device seeder;
   Seed = seeder();
@@ -90,21 +326,20 @@ Parser::Parser() : BpmTable{}, StopLengthTable{}, ScrollTable{} {
 
 void Parser::SetRandomSeed(unsigned int RandomSeed) { Seed = RandomSeed; }
 
+void Parser::ResetState() {
+  BpmTable.clear();
+  StopLengthTable.clear();
+  ScrollTable.clear();
+  UseBase62 = false;
+  Lnobj = -1;
+  Lntype = 1;
+}
+
 int Parser::NoWav = -1;
 int Parser::MetronomeWav = -2;
 
-inline bool Parser::MatchHeader(const std::string_view &str,
-                                const std::string_view &headerUpper) {
-  auto size = headerUpper.length();
-  if (str.length() < size) {
-    return false;
-  }
-  for (size_t i = 0; i < size; ++i) {
-    if (std::towupper(str[i]) != headerUpper[i]) {
-      return false;
-    }
-  }
-  return true;
+void Parser::SetOptions(const ParseOptions &Options) {
+  this->Options = Options;
 }
 
 void Parser::Parse(const std::filesystem::path &fpath, Chart **chart,
@@ -113,22 +348,52 @@ void Parser::Parse(const std::filesystem::path &fpath, Chart **chart,
 #if BMS_PARSER_VERBOSE == 1
   auto startTime = std::chrono::high_resolution_clock::now();
 #endif
+  // the mapping (or the buffer) is released as soon as the chart is built
+  MappedFile mapped;
   std::vector<unsigned char> bytes;
-  std::ifstream file(fpath, std::ios::binary);
-  if (!file.is_open()) {
-    std::cout << "Failed to open file: " << fpath << std::endl;
-    return;
-  }
+  const unsigned char *data = nullptr;
+  size_t size = 0;
 #if BMS_PARSER_VERBOSE == 1
   // measure file read time
   auto midStartTime = std::chrono::high_resolution_clock::now();
 #endif
-  file.seekg(0, std::ios::end);
-  auto size = file.tellg();
-  file.seekg(0, std::ios::beg);
-  bytes.resize(static_cast<size_t>(size));
-  file.read(reinterpret_cast<char *>(bytes.data()), size);
-  file.close();
+  // the read path hashes each block as it comes in, while it is in cache
+  const bool hashWhileReading = Options.ComputeMD5 || Options.ComputeSHA256;
+  DigestStream digests(Options.ComputeMD5, Options.ComputeSHA256);
+  bool hashed = false;
+  if (Options.UseMemoryMap && mapped.Open(fpath)) {
+    data = mapped.GetData();
+    size = mapped.GetSize();
+  } else {
+    std::ifstream file(fpath, std::ios::binary);
+    if (!file.is_open()) {
+      std::cout << "Failed to open file: " << fpath << std::endl;
+      return;
+    }
+    file.seekg(0, std::ios::end);
+    auto fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    bytes.resize(static_cast<size_t>(fileSize));
+    for (size_t offset = 0; offset < bytes.size();) {
+      const auto length = std::min(DigestStream::BlockSize,
+                                   bytes.size() - offset);
+      file.read(reinterpret_cast<char *>(bytes.data() + offset),
+                static_cast<std::streamsize>(length));
+      const auto got = static_cast<size_t>(file.gcount());
+      if (hashWhileReading) {
+        digests.Update(bytes.data() + offset, got);
+      }
+      offset += got;
+      if (got < length) {
+        bytes.resize(offset); // the file shrank under us
+        break;
+      }
+    }
+    file.close();
+    data = bytes.data();
+    size = bytes.size();
+    hashed = hashWhileReading;
+  }
 #if BMS_PARSER_VERBOSE == 1
   std::cout << "File read took "
             << std::chrono::duration_cast<std::chrono::microseconds>(
@@ -136,9 +401,15 @@ void Parser::Parse(const std::filesystem::path &fpath, Chart **chart,
                    .count()
             << "\n";
 #endif
-  Parse(bytes, chart, addReadyMeasure, metaOnly, bCancelled);
+  ParseBytes(data, size, chart, addReadyMeasure, metaOnly, bCancelled,
+             !hashed);
   auto new_chart = *chart;
   if (new_chart != nullptr) {
+    if (hashed && !bCancelled) {
+      digests.Finish(new_chart->Meta.MD5, new_chart->Meta.SHA256);
+    }
+    // the file is closed on return, whatever Options.LazyDigests says
+    new_chart->ClearDigestSource();
     new_chart->Meta.BmsPath = fpath;
 
     new_chart->Meta.Folder = fpath.parent_path();
@@ -156,63 +427,91 @@ void Parser::Parse(const std::filesystem::path &fpath, Chart **chart,
 void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
                    bool addReadyMeasure, bool metaOnly,
                    std::atomic_bool &bCancelled) {
+  Parse(bytes.data(), bytes.size(), chart, addReadyMeasure, metaOnly,
+        bCancelled);
+}
+
+void Parser::Parse(const unsigned char *bytes, size_t size, Chart **chart,
+                   bool addReadyMeasure, bool metaOnly,
+                   std::atomic_bool &bCancelled) {
+  ParseBytes(bytes, size, chart, addReadyMeasure, metaOnly, bCancelled, true);
+}
+
+void Parser::ParseBytes(const unsigned char *bytes, size_t size,
+                        Chart **chart, bool addReadyMeasure, bool metaOnly,
+                        std::atomic_bool &bCancelled, bool hashSource) {
 #if BMS_PARSER_VERBOSE == 1
   auto startTime = std::chrono::high_resolution_clock::now();
 #endif
   auto new_chart = new Chart();
   *chart = new_chart;
-
-  static std::regex headerRegex(R"(^#([A-Za-z]+?)(\d\d)? +?(.+)?)");
+  ResetState();
 
   if (bCancelled) {
     return;
   }
 
-  auto measures =
-      std::unordered_map<int, std::vector<std::pair<int, std::string>>>();
-
-  // compute hash in separate thread
-  std::thread md5Thread([&bytes, new_chart] {
-#if BMS_PARSER_VERBOSE == 1
-    auto startTime = std::chrono::high_resolution_clock::now();
-#endif
-    MD5 md5;
-    md5.update(bytes.data(), bytes.size());
-    md5.finalize();
-    new_chart->Meta.MD5 = md5.hexdigest();
-#if BMS_PARSER_VERBOSE == 1
-    std::cout << "Hashing MD5 took "
-              << std::chrono::duration_cast<std::chrono::microseconds>(
-                     std::chrono::high_resolution_clock::now() - startTime)
-                     .count()
-              << "\n";
-#endif
-  });
-  threadRAII md5RAII(std::move(md5Thread));
-  std::thread sha256Thread([&bytes, new_chart] {
+  // channel data points into content, which outlives the measure loop
+  std::vector<ChannelRecord> records;
+
+  // hash while parsing; the jobs are done or skipped before Parse returns
+  DigestSource digestSource(new_chart, bytes, size, Options.LazyDigests);
+  const bool wantMD5 = hashSource && Options.ComputeMD5;
+  const bool wantSHA256 = hashSource && Options.ComputeSHA256;
+  ClaimableJob hashJob(
+      [bytes, size, new_chart, wantMD5, wantSHA256, &bCancelled] {
+        if (!(wantMD5 || wantSHA256) || bCancelled) {
+          return;
+        }
 #if BMS_PARSER_VERBOSE == 1
-    auto startTime = std::chrono::high_resolution_clock::now();
+        auto startTime = std::chrono::high_resolution_clock::now();
 #endif
-    new_chart->Meta.SHA256 = sha256(bytes);
+        // one pass for both, rather than each reading the whole source
+        DigestStream digests(wantMD5, wantSHA256);
+        digests.Update(bytes, size);
+        digests.Finish(new_chart->Meta.MD5, new_chart->Meta.SHA256);
 #if BMS_PARSER_VERBOSE == 1
-    std::cout << "Hashing SHA256 took "
-              << std::chrono::duration_cast<std::chrono::microseconds>(
-                     std::chrono::high_resolution_clock::now() - startTime)
-                     .count()
-              << "\n";
+        std::cout << "Hashing took "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::high_resolution_clock::now() -
+                         startTime)
+                         .count()
+                  << "\n";
 #endif
-  });
-  threadRAII sha256RAII(std::move(sha256Thread));
+      });
+  if ((wantMD5 || wantSHA256) && size >= Options.InlineHashBelow) {
+    hashJob.SubmitTo(Options.HashPool != nullptr ? *Options.HashPool
+                                                 : SharedHashPool());
+  }
+  // runs at memory speed, not worth a job
+  if (Options.ComputeContentHash) {
+    new_chart->GetContentHash();
+  }
 
   // std::cout<<"file size: "<<size<<std::endl;
   // bytes to std::string
 #if BMS_PARSER_VERBOSE == 1
   auto midStartTime = std::chrono::high_resolution_clock::now();
 #endif
-  std::string content;
-  ShiftJISConverter::BytesToUTF8(bytes.data(), bytes.size(), content);
+  size_t bomLength = 0;
+  SourceEncoding = TextEncodings::Detect(bytes, size, bomLength);
+  new_chart->Meta.Encoding = SourceEncoding;
+  const auto text = bytes + bomLength;
+  const auto textSize = size - bomLength;
+  std::string decoded;
+  std::string_view content;
+  if (SourceEncoding == TextEncoding::UTF8 || Options.LazyDecode) {
+    // UTF-8 is used as-is; otherwise free-text values are converted one by
+    // one in ParseHeader
+    content = std::string_view(reinterpret_cast<const char *>(text), textSize);
+    DecodeValues = SourceEncoding != TextEncoding::UTF8;
+  } else {
+    TextEncodings::ToUTF8(SourceEncoding, text, textSize, decoded);
+    content = decoded;
+    DecodeValues = false;
+  }
 #if BMS_PARSER_VERBOSE == 1
-  std::cout << "ShiftJIS-UTF8 conversion took "
+  std::cout << "Encoding detection and conversion took "
             << std::chrono::duration_cast<std::chrono::microseconds>(
                    std::chrono::high_resolution_clock::now() - midStartTime)
                    .count()
@@ -224,16 +523,13 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
   // init prng with seed
   std::mt19937_64 Prng(Seed);
 
-  std::string line;
-  std::istringstream stream(content);
+  LineScanner lines(content);
+  std::string_view line;
 #if BMS_PARSER_VERBOSE == 1
   midStartTime = std::chrono::high_resolution_clock::now();
 #endif
   auto lastMeasure = -1;
-  while (std::getline(stream, line)) {
-    if (!line.empty() && line.back() == '\r') {
-      line.pop_back();
-    }
+  while (lines.Next(line)) {
     if (bCancelled) {
       return;
     }
@@ -244,19 +540,19 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
       return;
     }
 
-    if (MatchHeader(line, "#IF")) // #IF n
+    const auto keyword = HeaderKeywords::Match(line.substr(1));
+    if (keyword == HeaderKeyword::If) // #IF n
     {
       if (RandomStack.empty()) {
         // UE_LOG(LogTemp, Warning, TEXT("RandomStack is empty!"));
         continue;
       }
       const int CurrentRandom = RandomStack.back();
-      const int n =
-          static_cast<int>(std::strtol(line.substr(4).c_str(), nullptr, 10));
+      const int n = static_cast<int>(ParseLong(Tail(line, 4), 10));
       SkipStack.push_back(CurrentRandom != n);
       continue;
     }
-    if (MatchHeader(line, "#ELSE")) {
+    if (keyword == HeaderKeyword::Else) { // #ELSEIF ends up here as well
       if (SkipStack.empty()) {
         // UE_LOG(LogTemp, Warning, TEXT("SkipStack is empty!"));
         continue;
@@ -266,20 +562,7 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
       SkipStack.push_back(!CurrentSkip);
       continue;
     }
-    if (MatchHeader(line, "#ELSEIF")) {
-      if (SkipStack.empty()) {
-        // UE_LOG(LogTemp, Warning, TEXT("SkipStack is empty!"));
-        continue;
-      }
-      const bool CurrentSkip = SkipStack.back();
-      SkipStack.pop_back();
-      const int CurrentRandom = RandomStack.back();
-      const int n =
-          static_cast<int>(std::strtol(line.substr(8).c_str(), nullptr, 10));
-      SkipStack.push_back(CurrentSkip && CurrentRandom != n);
-      continue;
-    }
-    if (MatchHeader(line, "#ENDIF") || MatchHeader(line, "#END IF")) {
+    if (keyword == HeaderKeyword::EndIf) {
       if (SkipStack.empty()) {
         // UE_LOG(LogTemp, Warning, TEXT("SkipStack is empty!"));
         continue;
@@ -290,16 +573,15 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
     if (!SkipStack.empty() && SkipStack.back()) {
       continue;
     }
-    if (MatchHeader(line, "#RANDOM") ||
-        MatchHeader(line, "#RONDAM")) // #RANDOM n
+    if (keyword == HeaderKeyword::Random) // #RANDOM n
     {
-      const int n =
-          static_cast<int>(std::strtol(line.substr(7).c_str(), nullptr, 10));
+      new_chart->Meta.HasRandom = true;
+      const int n = static_cast<int>(ParseLong(Tail(line, 7), 10));
       std::uniform_int_distribution<int> dist(1, n);
       RandomStack.push_back(dist(Prng));
       continue;
     }
-    if (MatchHeader(line, "#ENDRANDOM")) {
+    if (keyword == HeaderKeyword::EndRandom) {
       if (RandomStack.empty()) {
         // UE_LOG(LogTemp, Warning, TEXT("RandomStack is empty!"));
         continue;
@@ -308,22 +590,19 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
       continue;
     }
 
-    if (line.length() >= 7 && std::isdigit(static_cast<unsigned char>(line[1])) &&
+    if (line.length() >= 7 &&
+        std::isdigit(static_cast<unsigned char>(line[1])) &&
         std::isdigit(static_cast<unsigned char>(line[2])) &&
         std::isdigit(static_cast<unsigned char>(line[3])) &&
         line[6] == ':') {
-      const int measure =
-          static_cast<int>(std::strtol(line.substr(1, 3).c_str(), nullptr, 10));
+      const int measure = static_cast<int>(ParseLong(line.substr(1, 3), 10));
       lastMeasure = std::max(lastMeasure, measure);
-      const std::string ch = line.substr(4, 2);
-      const int channel = ParseInt(ch);
-      const std::string value = line.substr(7);
-      if (measures.find(measure) == measures.end()) {
-        measures[measure] = std::vector<std::pair<int, std::string>>();
-      }
-      measures[measure].emplace_back(channel, value);
+      const auto ch = line.substr(4, 2);
+      const int channel = ParseInt(ch, true);
+      const auto value = line.substr(7);
+      records.push_back({measure, channel, value});
     } else {
-      if (MatchHeader(line, "#WAV")) {
+      if (keyword == HeaderKeyword::Wav) {
         if (metaOnly) {
           continue;
         }
@@ -332,8 +611,8 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
         }
         const auto xx = line.substr(4, 2);
         const auto value = line.substr(7);
-        ParseHeader(new_chart, "WAV", xx, value);
-      } else if (MatchHeader(line, "#BMP")) {
+        ParseHeader(new_chart, HeaderKeyword::Wav, "WAV", xx, value);
+      } else if (keyword == HeaderKeyword::Bmp) {
         if (metaOnly) {
           continue;
         }
@@ -342,44 +621,41 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
         }
         const auto xx = line.substr(4, 2);
         const auto value = line.substr(7);
-        ParseHeader(new_chart, "BMP", xx, value);
-      } else if (MatchHeader(line, "#STOP")) {
+        ParseHeader(new_chart, HeaderKeyword::Bmp, "BMP", xx, value);
+      } else if (keyword == HeaderKeyword::Stop) {
         if (line.length() < 8) {
           continue;
         }
         const auto xx = line.substr(5, 2);
         const auto value = line.substr(8);
-        ParseHeader(new_chart, "STOP", xx, value);
-      } else if (MatchHeader(line, "#BPM")) {
-        if (line.substr(4).rfind(' ', 0) == 0) {
+        ParseHeader(new_chart, HeaderKeyword::Stop, "STOP", xx, value);
+      } else if (keyword == HeaderKeyword::Bpm) {
+        if (line.length() > 4 && line[4] == ' ') {
           const auto value = line.substr(5);
-          ParseHeader(new_chart, "BPM", "", value);
+          ParseHeader(new_chart, HeaderKeyword::Bpm, "BPM", "", value);
         } else {
           if (line.length() < 7) {
             continue;
           }
           const auto xx = line.substr(4, 2);
           const auto value = line.substr(7);
-          ParseHeader(new_chart, "BPM", xx, value);
+          ParseHeader(new_chart, HeaderKeyword::Bpm, "BPM", xx, value);
         }
-      } else if (MatchHeader(line, "#SCROLL")) {
+      } else if (keyword == HeaderKeyword::Scroll) {
         if (line.length() < 10) {
           continue;
         }
         const auto xx = line.substr(7, 2);
         const auto value = line.substr(10);
-        ParseHeader(new_chart, "SCROLL", xx, value);
+        ParseHeader(new_chart, HeaderKeyword::Scroll, "SCROLL", xx, value);
       } else {
-        std::smatch matcher;
-
-        if (std::regex_search(line, matcher, headerRegex)) {
-          std::string xx = matcher[2].str();
-          std::string value = matcher[3].str();
+        std::string_view cmd, xx, value;
+        if (SplitHeader(line, cmd, xx, value)) {
           if (value.empty()) {
             value = xx;
-            xx = "";
+            xx = std::string_view();
           }
-          ParseHeader(new_chart, matcher[1].str(), xx, value);
+          ParseHeader(new_chart, keyword, cmd, xx, value);
         }
       }
     }
@@ -395,8 +671,34 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
     return;
   }
   if (addReadyMeasure) {
-    measures[0] = std::vector<std::pair<int, std::string>>();
-    measures[0].emplace_back(LaneAutoplay, "********");
+    records.erase(std::remove_if(records.begin(), records.end(),
+                                 [](const ChannelRecord &record) {
+                                   return record.Measure == 0;
+                                 }),
+                  records.end());
+    records.push_back({0, LaneAutoplay, "********"});
+  }
+
+  // bucket the records by measure (a counting sort, so file order is kept
+  // within a measure); measure m owns [measureStart[m], measureStart[m + 1])
+  const auto measureCount = static_cast<size_t>(lastMeasure + 1);
+  std::vector<size_t> measureStart(measureCount + 1, 0);
+  for (const auto &record : records) {
+    if (static_cast<size_t>(record.Measure) < measureCount) {
+      ++measureStart[record.Measure + 1];
+    }
+  }
+  for (size_t i = 0; i < measureCount; ++i) {
+    measureStart[i + 1] += measureStart[i];
+  }
+  std::vector<ChannelRecord> channels(measureStart[measureCount]);
+  {
+    auto next = measureStart;
+    for (const auto &record : records) {
+      if (static_cast<size_t>(record.Measure) < measureCount) {
+        channels[next[record.Measure]++] = record;
+      }
+    }
   }
 
   double timePassed = 0;
@@ -416,277 +718,307 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
   midStartTime = std::chrono::high_resolution_clock::now();
 #endif
   double measureBeatPosition = 0;
-  for (auto measureIdx = 0; measureIdx <= lastMeasure; ++measureIdx) {
-    if (bCancelled) {
-      return;
-    }
-    if (measures.find(measureIdx) == measures.end()) {
-      measures[measureIdx] = std::vector<std::pair<int, std::string>>();
-    }
-
-    // gcd (int, int)
-    auto measure = new Measure();
-
-    // NOTE: this should be an ordered map
-    auto timelines = std::map<double, TimeLine *>();
-
-    for (auto &pair : measures[measureIdx]) {
+  // a metaOnly parse keeps none of its measures, so they go in an arena that
+  // dies with this call instead of bloating the chart
+  ChartArena scratchArena;
+  auto &arena = metaOnly ? scratchArena : new_chart->Arena;
+
+  // Two passes per measure. The first decodes every channel and collects
+  // the position of each pair as an exact fraction; sorting those gives the
+  // measure's timelines in order, with no rounding to split or merge them.
+  // The second pass then applies the pairs in file order, which long note
+  // and LNOBJ pairing depend on. Only the lane events depend on earlier
+  // measures, so they are left in build.LaneEvents for settleMeasure and
+  // everything else is applied here. Reads nothing but the channel records
+  // and the finished header tables, so measures can be built concurrently.
+  const auto buildMeasure = [&](size_t measureIdx, MeasureBuild &build,
+                                MeasureScratch &scratch,
+                                ChartArena &measureArena) {
+    auto &positions = scratch.Positions;
+    auto &pairEvents = scratch.Events;
+    positions.clear();
+    pairEvents.clear();
+    build.TimeLines.clear();
+    build.LaneEvents.clear();
+    build.ChannelFlags = 0;
+    auto measure = measureArena.New<Measure>();
+    build.Target = measure;
+
+    for (auto r = measureStart[measureIdx]; r < measureStart[measureIdx + 1];
+         ++r) {
       if (bCancelled) {
         break;
       }
-      auto channel = pair.first;
-      auto &data = pair.second;
+      auto channel = channels[r].Channel;
+      const auto data = channels[r].Data;
       if (channel == SectionRate) {
-        measure->Scale = std::strtod(data.c_str(), nullptr);
+        measure->Scale = ParseDouble(data);
         continue;
       }
 
-      auto laneNumber = 0; // NOTE: This is intentionally set to 0, not -1!
-      if (channel >= P1KeyBase && channel < P1KeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P1KeyBase];
-        channel = P1KeyBase;
-      } else if (channel >= P2KeyBase && channel < P2KeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P2KeyBase + 9];
-        channel = P1KeyBase;
-      } else if (channel >= P1InvisibleKeyBase &&
-                 channel < P1InvisibleKeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P1InvisibleKeyBase];
-        channel = P1InvisibleKeyBase;
-      } else if (channel >= P2InvisibleKeyBase &&
-                 channel < P2InvisibleKeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P2InvisibleKeyBase + 9];
-        channel = P1InvisibleKeyBase;
-      } else if (channel >= P1LongKeyBase && channel < P1LongKeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P1LongKeyBase];
-        channel = P1LongKeyBase;
-      } else if (channel >= P2LongKeyBase && channel < P2LongKeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P2LongKeyBase + 9];
-        channel = P1LongKeyBase;
-      } else if (channel >= P1MineKeyBase && channel < P1MineKeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P1MineKeyBase];
-        channel = P1MineKeyBase;
-      } else if (channel >= P2MineKeyBase && channel < P2MineKeyBase + 9) {
-        laneNumber = KeyAssign::Beat7[channel - P2MineKeyBase + 9];
-        channel = P1MineKeyBase;
-      }
-
-      if (laneNumber == -1) {
+      const auto &info = GetChannelInfo(channel);
+      if (info.Lane == -1) {
         continue;
       }
-      const bool isScratch = laneNumber == 7 || laneNumber == 15;
-      if (laneNumber == 5 || laneNumber == 6 || laneNumber == 13 ||
-          laneNumber == 14) {
-        if (new_chart->Meta.KeyMode == 5) {
-          new_chart->Meta.KeyMode = 7;
-        } else if (new_chart->Meta.KeyMode == 10) {
-          new_chart->Meta.KeyMode = 14;
-        }
+      channel = info.Kind;
+      build.ChannelFlags |= info.Flags & (ChannelSevenKey | ChannelDoublePlay);
+
+      // mines are always base 36, see ParseInt
+      auto base = UseBase62 ? PairBase::Base62 : PairBase::Base36;
+      if (channel == BpmChange) {
+        base = PairBase::Hex;
+      } else if (channel == P1MineKeyBase) {
+        base = PairBase::Base36;
       }
-      if (laneNumber >= 8) {
-        if (new_chart->Meta.KeyMode == 7) {
-          new_chart->Meta.KeyMode = 14;
-        } else if (new_chart->Meta.KeyMode == 5) {
-          new_chart->Meta.KeyMode = 10;
-        }
-        new_chart->Meta.IsDP = true;
+      const auto dataCount = ChannelData::Decode(data, base, scratch.PairIds,
+                                                 scratch.NonZeroPairs);
+      const auto &nonZeroPairs = scratch.NonZeroPairs;
+      const auto pairs = static_cast<uint32_t>(dataCount);
+      if (dataCount != 0 && (nonZeroPairs[0] & 1) == 0 && positions.empty()) {
+        positions.push_back({0, 1, NoPairEvent}); // add ghost timeline
       }
-
-      const auto dataCount = data.length() / 2;
-      for (size_t j = 0; j < dataCount; ++j) {
+      // "00" pairs are skipped entirely
+      for (auto j = ChannelData::NextNonZero(nonZeroPairs, 0, dataCount);
+           j < dataCount;
+           j = ChannelData::NextNonZero(nonZeroPairs, j + 1, dataCount)) {
         if (bCancelled) {
           break;
         }
-        std::string val = data.substr(j * 2, 2);
-        if (val == "00") {
-          if (timelines.empty() && j == 0) {
-            auto timeline = new TimeLine(TempKey, metaOnly);
-            timelines[0] = timeline; // add ghost timeline
-          }
-
-          continue;
-        }
-
-        const auto g = Gcd(j, dataCount);
-        // ReSharper disable PossibleLossOfFraction
-
-        const auto position =
-            static_cast<double>(j / g) /
-            static_cast<double>(dataCount / g); // NOLINT(*-integer-division)
-
-        if (timelines.find(position) == timelines.end()) {
-          timelines[position] = new TimeLine(TempKey, metaOnly);
-        }
-
-        auto timeline = timelines[position];
+        const auto pair = static_cast<uint32_t>(j);
         if (channel == LaneAutoplay || channel == P1InvisibleKeyBase) {
           if (metaOnly) {
+            // the timeline still counts for timing
+            positions.push_back({pair, pairs, NoPairEvent});
             break;
           }
         }
-        switch (channel) {
-        case LaneAutoplay:
-          if (val == "**") {
-            timeline->AddBackgroundNote(new Note{MetronomeWav});
-            break;
-          }
-          if (ParseInt(val) != 0) {
-            auto bgNote = new Note{ToWaveId(new_chart, val, metaOnly)};
-            timeline->AddBackgroundNote(bgNote);
-          }
+        auto id = scratch.PairIds[j];
+        if (id == ChannelData::Undecoded) {
+          const auto val = data.substr(j * 2, 2);
+          id = base == PairBase::Hex ? ParseHex(val)
+                                     : ParseInt(val, base == PairBase::Base36);
+        }
+        positions.push_back(
+            {pair, pairs, static_cast<uint32_t>(pairEvents.size())});
+        pairEvents.push_back({static_cast<uint32_t>(r), pair, id, 0});
+      }
+    }
 
-          break;
-        case BpmChange: {
-          int bpm = ParseHex(val);
-          timeline->Bpm = static_cast<double>(bpm);
-          // std::cout << "BPM_CHANGE: " << timeline->Bpm << ", on measure " <<
-          // measureIdx << std::endl; Debug.Log($"BPM_CHANGE: {timeline.Bpm}, on
-          // measure {measureIdx}");
-          timeline->BpmChange = true;
+    std::sort(positions.begin(), positions.end(),
+              [](const PairPosition &a, const PairPosition &b) {
+                return a.Before(b);
+              });
+    auto &timelines = build.TimeLines;
+    for (size_t i = 0; i < positions.size(); ++i) {
+      const auto &position = positions[i];
+      if (i == 0 || positions[i - 1].Before(position)) {
+        timelines.emplace_back(static_cast<double>(position.Pair) /
+                                   static_cast<double>(position.Pairs),
+                               measureArena.New<TimeLine>(TempKey, metaOnly));
+      }
+      if (position.Event != NoPairEvent) {
+        pairEvents[position.Event].Timeline =
+            static_cast<uint32_t>(timelines.size() - 1);
+      }
+    }
+
+    for (const auto &event : pairEvents) {
+      if (bCancelled) {
+        break;
+      }
+      const auto &record = channels[event.Record];
+      const int channel = GetChannelInfo(record.Channel).Kind;
+      if (IsLaneChannel(channel)) {
+        build.LaneEvents.push_back(event);
+        continue;
+      }
+      const auto id = event.Id;
+      auto timeline = timelines[event.Timeline].second;
+      switch (channel) {
+      case LaneAutoplay:
+        if (record.Data.substr(event.Pair * 2, 2) == "**") {
+          timeline->AddBackgroundNote(measureArena.New<Note>(MetronomeWav));
           break;
         }
-        case BgaPlay:
-          timeline->BgaBase = ParseInt(val);
+        if (id != 0) {
+          auto bgNote =
+              measureArena.New<Note>(ToWaveId(new_chart, id, metaOnly));
+          timeline->AddBackgroundNote(bgNote);
+        }
+
+        break;
+      case BpmChange: {
+        timeline->Bpm = static_cast<double>(id);
+        // std::cout << "BPM_CHANGE: " << timeline->Bpm << ", on measure " <<
+        // measureIdx << std::endl; Debug.Log($"BPM_CHANGE: {timeline.Bpm}, on
+        // measure {measureIdx}");
+        timeline->BpmChange = true;
+        break;
+      }
+      case BgaPlay:
+        timeline->BgaBase = id;
+        break;
+      case PoorPlay:
+        timeline->BgaPoor = id;
+        break;
+      case LayerPlay:
+        timeline->BgaLayer = id;
+        break;
+      case BpmChangeExtend: {
+        // std::cout << "BPM_CHANGE_EXTEND: " << id << ", on measure " <<
+        // measureIdx << std::endl;
+        if (!CheckResourceIdRange(id)) {
+          // UE_LOG(LogTemp, Warning, TEXT("Invalid BPM id: %s"), *val);
           break;
-        case PoorPlay:
-          timeline->BgaPoor = ParseInt(val);
+        }
+        const auto bpm = BpmTable.find(id);
+        if (bpm != BpmTable.end()) {
+          timeline->Bpm = bpm->second;
+        } else {
+          timeline->Bpm = 0;
+          // std::cout<<"Undefined BPM: "<<id<<std::endl;
+        }
+        // Debug.Log($"BPM_CHANGE_EXTEND: {timeline.Bpm}, on measure
+        // {measureIdx}, {val}");
+        timeline->BpmChange = true;
+        break;
+      }
+      case Scroll: {
+        if (!CheckResourceIdRange(id)) {
+          // UE_LOG(LogTemp, Warning, TEXT("Invalid Scroll id: %s"), *val);
           break;
-        case LayerPlay:
-          timeline->BgaLayer = ParseInt(val);
+        }
+        const auto scroll = ScrollTable.find(id);
+        if (scroll != ScrollTable.end()) {
+          timeline->Scroll = scroll->second;
+        } else {
+          timeline->Scroll = 1;
+        }
+        // Debug.Log($"SCROLL: {timeline.Scroll}, on measure {measureIdx}");
+        break;
+      }
+      case Stop: {
+        if (!CheckResourceIdRange(id)) {
+          // UE_LOG(LogTemp, Warning, TEXT("Invalid StopLength id: %s"),
+          // *val);
           break;
-        case BpmChangeExtend: {
-          const auto id = ParseInt(val);
-          // std::cout << "BPM_CHANGE_EXTEND: " << id << ", on measure " <<
-          // measureIdx << std::endl;
-          if (!CheckResourceIdRange(id)) {
-            // UE_LOG(LogTemp, Warning, TEXT("Invalid BPM id: %s"), *val);
-            break;
-          }
-          if (BpmTable.find(id) != BpmTable.end()) {
-            timeline->Bpm = BpmTable[id];
+        }
+        const auto stop = StopLengthTable.find(id);
+        if (stop != StopLengthTable.end()) {
+          timeline->StopLength = stop->second;
+        } else {
+          timeline->StopLength = 0;
+        }
+        // Debug.Log($"STOP: {timeline.StopLength}, on measure {measureIdx}");
+        break;
+      }
+      default:
+        break;
+      }
+    }
+  };
+
+  // Everything that carries over from one measure to the next: key mode,
+  // open long notes, note counts and the running time. Has to see the
+  // measures in order.
+  const auto settleMeasure = [&](MeasureBuild &build) {
+    auto measure = build.Target;
+    auto &timelines = build.TimeLines;
+    ApplyKeyModeFlags(new_chart->Meta, build.ChannelFlags);
+
+    for (const auto &event : build.LaneEvents) {
+      if (bCancelled) {
+        break;
+      }
+      const auto &record = channels[event.Record];
+      const auto &info = GetChannelInfo(record.Channel);
+      const int channel = info.Kind;
+      const int laneNumber = info.Lane;
+      const bool isScratch = (info.Flags & ChannelScratch) != 0;
+      const auto id = event.Id;
+      auto timeline = timelines[event.Timeline].second;
+      switch (channel) {
+      case P1KeyBase: {
+        if (id == Lnobj && lastNote[laneNumber] != nullptr) {
+          if (isScratch) {
+            ++totalBackSpinNotes;
           } else {
-            timeline->Bpm = 0;
-            // std::cout<<"Undefined BPM: "<<id<<std::endl;
+            ++totalLongNotes;
           }
-          // Debug.Log($"BPM_CHANGE_EXTEND: {timeline.Bpm}, on measure
-          // {measureIdx}, {val}");
-          timeline->BpmChange = true;
-          break;
-        }
-        case Scroll: {
-          const auto id = ParseInt(val);
-          if (!CheckResourceIdRange(id)) {
-            // UE_LOG(LogTemp, Warning, TEXT("Invalid Scroll id: %s"), *val);
+
+          auto last = lastNote[laneNumber];
+          lastNote[laneNumber] = nullptr;
+          if (metaOnly) {
             break;
           }
-          if (ScrollTable.find(id) != ScrollTable.end()) {
-            timeline->Scroll = ScrollTable[id];
-          } else {
-            timeline->Scroll = 1;
+
+          auto lastTimeline = last->Timeline;
+          auto ln = arena.New<LongNote>(last->Wav);
+          ln->Tail = arena.New<LongNote>(NoWav);
+          ln->Tail->Head = ln;
+          lastTimeline->SetNote(laneNumber, ln);
+          timeline->SetNote(laneNumber, ln->Tail);
+        } else {
+          auto note = arena.New<Note>(ToWaveId(new_chart, id, metaOnly));
+          lastNote[laneNumber] = note;
+          ++totalNotes;
+          if (isScratch) {
+            ++totalScratchNotes;
           }
-          // Debug.Log($"SCROLL: {timeline.Scroll}, on measure {measureIdx}");
-          break;
-        }
-        case Stop: {
-          const auto id = ParseInt(val);
-          if (!CheckResourceIdRange(id)) {
-            // UE_LOG(LogTemp, Warning, TEXT("Invalid StopLength id: %s"),
-            // *val);
+          if (metaOnly) {
             break;
           }
-          if (StopLengthTable.find(id) != StopLengthTable.end()) {
-            timeline->StopLength = StopLengthTable[id];
-          } else {
-            timeline->StopLength = 0;
-          }
-          // Debug.Log($"STOP: {timeline.StopLength}, on measure {measureIdx}");
-          break;
+          timeline->SetNote(laneNumber, note);
         }
-        case P1KeyBase: {
-          const auto ch = ParseInt(val);
-          if (ch == Lnobj && lastNote[laneNumber] != nullptr) {
+      } break;
+      case P1InvisibleKeyBase: {
+        auto invNote = arena.New<Note>(ToWaveId(new_chart, id, metaOnly));
+        timeline->SetInvisibleNote(laneNumber, invNote);
+        break;
+      }
+
+      case P1LongKeyBase:
+        if (Lntype == 1) {
+          if (lnStart[laneNumber] == nullptr) {
+            ++totalNotes;
             if (isScratch) {
               ++totalBackSpinNotes;
             } else {
               ++totalLongNotes;
             }
 
-            auto last = lastNote[laneNumber];
-            lastNote[laneNumber] = nullptr;
+            auto ln = arena.New<LongNote>(ToWaveId(new_chart, id, metaOnly));
+            lnStart[laneNumber] = ln;
+
             if (metaOnly) {
               break;
             }
 
-            auto lastTimeline = last->Timeline;
-            auto ln = new LongNote{last->Wav};
-            delete last;
-            ln->Tail = new LongNote{NoWav};
-            ln->Tail->Head = ln;
-            lastTimeline->SetNote(laneNumber, ln);
-            timeline->SetNote(laneNumber, ln->Tail);
+            timeline->SetNote(laneNumber, ln);
           } else {
-            auto note = new Note{ToWaveId(new_chart, val, metaOnly)};
-            lastNote[laneNumber] = note;
-            ++totalNotes;
-            if (isScratch) {
-              ++totalScratchNotes;
+            if (!metaOnly) {
+              auto tail = arena.New<LongNote>(NoWav);
+              tail->Head = lnStart[laneNumber];
+              lnStart[laneNumber]->Tail = tail;
+              timeline->SetNote(laneNumber, tail);
             }
-            if (metaOnly) {
-              delete note; // this is intended
-              break;
-            }
-            timeline->SetNote(laneNumber, note);
+            lnStart[laneNumber] = nullptr;
           }
-        } break;
-        case P1InvisibleKeyBase: {
-          auto invNote = new Note{ToWaveId(new_chart, val, metaOnly)};
-          timeline->SetInvisibleNote(laneNumber, invNote);
-          break;
         }
 
-        case P1LongKeyBase:
-          if (Lntype == 1) {
-            if (lnStart[laneNumber] == nullptr) {
-              ++totalNotes;
-              if (isScratch) {
-                ++totalBackSpinNotes;
-              } else {
-                ++totalLongNotes;
-              }
-
-              auto ln = new LongNote{ToWaveId(new_chart, val, metaOnly)};
-              lnStart[laneNumber] = ln;
-
-              if (metaOnly) {
-                delete ln; // this is intended
-                break;
-              }
-
-              timeline->SetNote(laneNumber, ln);
-            } else {
-              if (!metaOnly) {
-                auto tail = new LongNote{NoWav};
-                tail->Head = lnStart[laneNumber];
-                lnStart[laneNumber]->Tail = tail;
-                timeline->SetNote(laneNumber, tail);
-              }
-              lnStart[laneNumber] = nullptr;
-            }
-          }
-
-          break;
-        case P1MineKeyBase: {
-          // landmine
-          ++totalLandmineNotes;
-          if (metaOnly) {
-            break;
-          }
-          const auto damage = static_cast<float>(ParseInt(val, true)) / 2.0f;
-          timeline->SetNote(laneNumber, new LandmineNote{damage});
-          break;
-        }
-        default:
+        break;
+      case P1MineKeyBase: {
+        // landmine
+        ++totalLandmineNotes;
+        if (metaOnly) {
           break;
         }
+        const auto damage = static_cast<float>(id) / 2.0f;
+        timeline->SetNote(laneNumber, arena.New<LandmineNote>(damage));
+        break;
+      }
+      default:
+        break;
       }
     }
 
@@ -737,13 +1069,19 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
 
     if (metaOnly) {
       for (auto &timeline : timelines) {
-        delete timeline.second;
+        timeline.second->~TimeLine();
       }
       timelines.clear();
+    } else {
+      // a cancel stops the loop early, and the measure only owns the
+      // timelines it got
+      for (auto i = measure->TimeLines.size(); i < timelines.size(); ++i) {
+        timelines[i].second->~TimeLine();
+      }
     }
 
     if (!metaOnly && measure->TimeLines.empty()) {
-      auto timeline = new TimeLine(TempKey, metaOnly);
+      auto timeline = arena.New<TimeLine>(TempKey, metaOnly);
       timeline->Timing = static_cast<long long>(timePassed);
       timeline->BeatPosition = measureBeatPosition;
       timeline->Bpm = currentBpm;
@@ -759,7 +1097,73 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
     if (!metaOnly) {
       new_chart->Measures.push_back(measure);
     } else {
-      delete measure;
+      measure->~Measure();
+    }
+  };
+
+  const auto workers = MeasureWorkerCount(Options.MeasureThreads,
+                                          measureCount, metaOnly);
+  if (workers > 1) {
+    // Build every measure on the workers first, each into its own arena,
+    // then settle them in order here. The output is the same as building
+    // and settling one measure at a time.
+    std::vector<MeasureBuild> builds(measureCount);
+    std::unique_ptr<ChartArena[]> workerArenas(new ChartArena[workers]);
+    std::atomic<size_t> nextMeasure{0};
+    const auto work = [&](unsigned int worker) {
+      MeasureScratch scratch;
+      for (auto measureIdx = nextMeasure++;
+           measureIdx < measureCount && !bCancelled;
+           measureIdx = nextMeasure++) {
+        buildMeasure(measureIdx, builds[measureIdx], scratch,
+                     workerArenas[worker]);
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned int worker = 1; worker < workers; ++worker) {
+      threads.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (unsigned int worker = 0; worker < workers; ++worker) {
+      new_chart->Arena.Adopt(workerArenas[worker]);
+    }
+    for (size_t measureIdx = 0; measureIdx < measureCount; ++measureIdx) {
+      if (bCancelled) {
+        // the chart owns only the settled measures; a worker may have
+        // stopped before building the rest
+        for (auto k = measureIdx; k < measureCount; ++k) {
+          auto &build = builds[k];
+          if (build.Target == nullptr) {
+            continue;
+          }
+          for (auto &pair : build.TimeLines) {
+            pair.second->~TimeLine();
+          }
+          build.Target->~Measure();
+        }
+        return;
+      }
+      settleMeasure(builds[measureIdx]);
+    }
+  } else {
+    MeasureScratch scratch;
+    MeasureBuild build;
+    for (size_t measureIdx = 0; measureIdx < measureCount; ++measureIdx) {
+      if (bCancelled) {
+        return;
+      }
+      buildMeasure(measureIdx, build, scratch, arena);
+      settleMeasure(build);
+    }
+  }
+  if (!metaOnly) {
+    new_chart->BuildNoteRecords();
+    if (Options.BuildView) {
+      new_chart->View = std::make_unique<ChartView>(*new_chart);
     }
   }
 #if BMS_PARSER_VERBOSE == 1
@@ -815,43 +1219,51 @@ void Parser::Parse(const std::vector<unsigned char> &bytes, Chart **chart,
 #endif
 }
 
-void Parser::ParseHeader(Chart *Chart, std::string_view cmd,
-                         std::string_view Xx, const std::string &Value) {
+void Parser::ParseHeader(Chart *Chart, HeaderKeyword keyword,
+                         std::string_view cmd, std::string_view Xx,
+                         std::string_view Value) {
   // Debug.Log($"cmd: {cmd}, xx: {xx} isXXNull: {xx == null}, value: {value}");
-  // BASE 62
-  if (MatchHeader(cmd, "BASE")) {
+  switch (keyword) {
+  case HeaderKeyword::Base: { // BASE 62
     if (Value.empty()) {
       return; // TODO: handle this
     }
-    auto base = static_cast<int>(std::strtol(Value.c_str(), nullptr, 10));
+    auto base = static_cast<int>(ParseLong(Value, 10));
     std::wcout << "BASE: " << base << std::endl;
     if (base != 36 && base != 62) {
       return; // TODO: handle this
     }
     this->UseBase62 = base == 62;
-  } else if (MatchHeader(cmd, "PLAYER")) {
-    Chart->Meta.Player =
-        static_cast<int>(std::strtol(Value.c_str(), nullptr, 10));
-  } else if (MatchHeader(cmd, "GENRE")) {
-    Chart->Meta.Genre = Value;
-  } else if (MatchHeader(cmd, "TITLE")) {
-    Chart->Meta.Title = Value;
-  } else if (MatchHeader(cmd, "SUBTITLE")) {
-    Chart->Meta.SubTitle = Value;
-  } else if (MatchHeader(cmd, "ARTIST")) {
-    Chart->Meta.Artist = Value;
-  } else if (MatchHeader(cmd, "SUBARTIST")) {
-    Chart->Meta.SubArtist = Value;
-  } else if (MatchHeader(cmd, "DIFFICULTY")) {
-    Chart->Meta.Difficulty =
-        static_cast<int>(std::strtol(Value.c_str(), nullptr, 10));
-  } else if (MatchHeader(cmd, "BPM")) {
+    break;
+  }
+  case HeaderKeyword::Player:
+    Chart->Meta.Player = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Genre:
+    Chart->Meta.Genre = DecodeText(Value);
+    break;
+  case HeaderKeyword::Title:
+    Chart->Meta.Title = DecodeText(Value);
+    break;
+  case HeaderKeyword::SubTitle:
+    Chart->Meta.SubTitle = DecodeText(Value);
+    break;
+  case HeaderKeyword::Artist:
+    Chart->Meta.Artist = DecodeText(Value);
+    break;
+  case HeaderKeyword::SubArtist:
+    Chart->Meta.SubArtist = DecodeText(Value);
+    break;
+  case HeaderKeyword::Difficulty:
+    Chart->Meta.Difficulty = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Bpm:
     if (Value.empty()) {
       return; // TODO: handle this
     }
     if (Xx.empty()) {
       // chart initial bpm
-      Chart->Meta.Bpm = std::strtod(Value.c_str(), nullptr);
+      Chart->Meta.Bpm = ParseDouble(Value);
       // std::cout << "MainBPM: " << Chart->Meta.Bpm << std::endl;
     } else {
       // Debug.Log($"BPM: {DecodeBase36(xx)} = {double.Parse(value)}");
@@ -860,9 +1272,10 @@ void Parser::ParseHeader(Chart *Chart, std::string_view cmd,
         // UE_LOG(LogTemp, Warning, TEXT("Invalid BPM id: %s"), *Xx);
         return;
       }
-      BpmTable[id] = std::strtod(Value.c_str(), nullptr);
+      BpmTable[id] = ParseDouble(Value);
     }
-  } else if (MatchHeader(cmd, "STOP")) {
+    break;
+  case HeaderKeyword::Stop: {
     if (Value.empty() || Xx.empty()) {
       return; // TODO: handle this
     }
@@ -871,31 +1284,42 @@ void Parser::ParseHeader(Chart *Chart, std::string_view cmd,
       // UE_LOG(LogTemp, Warning, TEXT("Invalid STOP id: %s"), *Xx);
       return;
     }
-    StopLengthTable[id] = std::strtod(Value.c_str(), nullptr);
-  } else if (MatchHeader(cmd, "MIDIFILE")) {
+    StopLengthTable[id] = ParseDouble(Value);
+    break;
+  }
+  case HeaderKeyword::MidiFile:
     // TODO: handle this
-  } else if (MatchHeader(cmd, "VIDEOFILE")) {
-  } else if (MatchHeader(cmd, "PLAYLEVEL")) {
-    Chart->Meta.PlayLevel =
-        std::strtod(Value.c_str(), nullptr); // TODO: handle error
-  } else if (MatchHeader(cmd, "RANK")) {
-    Chart->Meta.Rank =
-        static_cast<int>(std::strtol(Value.c_str(), nullptr, 10));
-  } else if (MatchHeader(cmd, "TOTAL")) {
-    auto total = std::strtod(Value.c_str(), nullptr);
+    break;
+  case HeaderKeyword::VideoFile:
+    break;
+  case HeaderKeyword::PlayLevel:
+    Chart->Meta.PlayLevel = ParseDouble(Value); // TODO: handle error
+    break;
+  case HeaderKeyword::Rank:
+    Chart->Meta.Rank = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Total: {
+    auto total = ParseDouble(Value);
     if (total > 0) {
       Chart->Meta.Total = total;
     }
-  } else if (MatchHeader(cmd, "VOLWAV")) {
-  } else if (MatchHeader(cmd, "STAGEFILE")) {
-    Chart->Meta.StageFile = utf8_to_path_t(Value);
-  } else if (MatchHeader(cmd, "BANNER")) {
-    Chart->Meta.Banner = utf8_to_path_t(Value);
-  } else if (MatchHeader(cmd, "BACKBMP")) {
-    Chart->Meta.BackBmp = utf8_to_path_t(Value);
-  } else if (MatchHeader(cmd, "PREVIEW")) {
-    Chart->Meta.Preview = utf8_to_path_t(Value);
-  } else if (MatchHeader(cmd, "WAV")) {
+    break;
+  }
+  case HeaderKeyword::VolWav:
+    break;
+  case HeaderKeyword::StageFile:
+    Chart->Meta.StageFile = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::Banner:
+    Chart->Meta.Banner = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::BackBmp:
+    Chart->Meta.BackBmp = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::Preview:
+    Chart->Meta.Preview = utf8_to_path_t(DecodeText(Value));
+    break;
+  case HeaderKeyword::Wav: {
     if (Xx.empty() || Value.empty()) {
       // UE_LOG(LogTemp, Warning, TEXT("WAV command requires two arguments"));
       return;
@@ -905,8 +1329,10 @@ void Parser::ParseHeader(Chart *Chart, std::string_view cmd,
       // UE_LOG(LogTemp, Warning, TEXT("Invalid WAV id: %s"), *Xx);
       return;
     }
-    Chart->WavTable[id] = Value;
-  } else if (MatchHeader(cmd, "BMP")) {
+    Chart->WavTable[id] = DecodeText(Value);
+    break;
+  }
+  case HeaderKeyword::Bmp: {
     if (Xx.empty() || Value.empty()) {
       // UE_LOG(LogTemp, Warning, TEXT("BMP command requires two arguments"));
       return;
@@ -916,51 +1342,53 @@ void Parser::ParseHeader(Chart *Chart, std::string_view cmd,
       // UE_LOG(LogTemp, Warning, TEXT("Invalid BMP id: %s"), *Xx);
       return;
     }
-    Chart->BmpTable[id] = Value;
+    Chart->BmpTable[id] = DecodeText(Value);
     if (Xx == "00") {
       Chart->Meta.BgaPoorDefault = true;
     }
-  } else if (MatchHeader(cmd, "LNOBJ")) {
+    break;
+  }
+  case HeaderKeyword::LnObj:
     Lnobj = ParseInt(Value);
-  } else if (MatchHeader(cmd, "LNTYPE")) {
-    Lntype = static_cast<int>(std::strtol(Value.c_str(), nullptr, 10));
-  } else if (MatchHeader(cmd, "LNMODE")) {
-    Chart->Meta.LnMode =
-        static_cast<int>(std::strtol(Value.c_str(), nullptr, 10));
-  } else if (MatchHeader(cmd, "SCROLL")) {
+    break;
+  case HeaderKeyword::LnType:
+    Lntype = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::LnMode:
+    Chart->Meta.LnMode = static_cast<int>(ParseLong(Value, 10));
+    break;
+  case HeaderKeyword::Scroll: {
     auto xx = ParseInt(Xx);
-    auto value = std::strtod(Value.c_str(), nullptr);
+    auto value = ParseDouble(Value);
     ScrollTable[xx] = value;
     // std::wcout << "SCROLL: " << xx << " = " << value << std::endl;
-  } else {
+    break;
+  }
+  default:
     std::cout << "Unknown command: " << cmd << std::endl;
+    break;
   }
 }
 
-inline unsigned long long Parser::Gcd(unsigned long long A,
-                                      unsigned long long B) {
-  while (true) {
-    if (B == 0) {
-      return A;
-    }
-    auto a1 = A;
-    A = B;
-    B = a1 % B;
+std::string Parser::DecodeText(std::string_view Value) const {
+  if (!DecodeValues) {
+    return std::string(Value);
   }
+  std::string result;
+  TextEncodings::ToUTF8(SourceEncoding,
+                        reinterpret_cast<const unsigned char *>(Value.data()),
+                        Value.size(), result);
+  return result;
 }
 
 inline bool Parser::CheckResourceIdRange(int Id) const {
   return Id >= 0 && Id < (UseBase62 ? 62 * 62 : 36 * 36);
 }
 
-inline int Parser::ToWaveId(Chart *Chart, std::string_view Wav, bool metaOnly) {
+inline int Parser::ToWaveId(Chart *Chart, int decoded, bool metaOnly) {
   if (metaOnly) {
     return NoWav;
   }
-  if (Wav.empty()) {
-    return NoWav;
-  }
-  auto decoded = ParseInt(Wav);
   // check range
   if (!CheckResourceIdRange(decoded)) {
     // UE_LOG(LogTemp, Warning, TEXT("Invalid wav id: %s"), *Wav);
@@ -986,9 +1414,99 @@ inline int Parser::ParseHex(std::string_view Str) {
   return result;
 }
 
+// Same result as strtol, but stops at the end of the view instead of relying
+// on a terminator: channel data and header values point into the middle of
+// the file.
+inline long Parser::ParseLong(std::string_view Str, int Base) {
+  size_t i = 0;
+  while (i < Str.length() && std::isspace(static_cast<unsigned char>(Str[i]))) {
+    ++i;
+  }
+  bool negative = false;
+  if (i < Str.length() && (Str[i] == '+' || Str[i] == '-')) {
+    negative = Str[i] == '-';
+    ++i;
+  }
+  unsigned long result = 0;
+  const unsigned long limit =
+      negative ? static_cast<unsigned long>(LONG_MAX) + 1 : LONG_MAX;
+  bool overflow = false;
+  for (; i < Str.length(); ++i) {
+    const auto c = Str[i];
+    int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'A' && c <= 'Z') {
+      digit = c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'z') {
+      digit = c - 'a' + 10;
+    } else {
+      break;
+    }
+    if (digit >= Base) {
+      break;
+    }
+    if (result > (limit - digit) / Base) {
+      overflow = true;
+    } else {
+      result = result * Base + digit;
+    }
+  }
+  if (overflow) {
+    return negative ? LONG_MIN : LONG_MAX;
+  }
+  return negative ? static_cast<long>(0UL - result) : static_cast<long>(result);
+}
+
+inline double Parser::ParseDouble(std::string_view Str) {
+  // strtod needs a terminated string; values are short enough for the stack
+  char buffer[64];
+  if (Str.length() < sizeof(buffer)) {
+    std::memcpy(buffer, Str.data(), Str.length());
+    buffer[Str.length()] = '\0';
+    return std::strtod(buffer, nullptr);
+  }
+  return std::strtod(std::string(Str).c_str(), nullptr);
+}
+
+inline std::string_view Parser::Tail(std::string_view Line, size_t Pos) {
+  return Pos < Line.length() ? Line.substr(Pos) : std::string_view();
+}
+
+// Splits a generic header line the way ^#([A-Za-z]+?)(\d\d)? +?(.+)? would:
+// a run of letters, an optional two digit index, at least one space and the
+// rest of the line (up to a stray carriage return) as the value.
+inline bool Parser::SplitHeader(std::string_view Line, std::string_view &Cmd,
+                                std::string_view &Xx, std::string_view &Value) {
+  const auto isLetter = [](char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+  };
+  const auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+  size_t i = 1; // skip '#'
+  while (i < Line.length() && isLetter(Line[i])) {
+    ++i;
+  }
+  if (i == 1) {
+    return false;
+  }
+  Cmd = Line.substr(1, i - 1);
+  Xx = std::string_view();
+  if (i + 2 < Line.length() && isDigit(Line[i]) && isDigit(Line[i + 1]) &&
+      Line[i + 2] == ' ') {
+    Xx = Line.substr(i, 2);
+    i += 2;
+  }
+  if (i >= Line.length() || Line[i] != ' ') {
+    return false;
+  }
+  Value = Line.substr(i + 1);
+  Value = Value.substr(0, Value.find('\r'));
+  return true;
+}
+
 inline int Parser::ParseInt(std::string_view Str, bool forceBase36) const {
   if (forceBase36 || !UseBase62) {
-    auto result = static_cast<int>(std::strtol(Str.data(), nullptr, 36));
+    auto result = static_cast<int>(ParseLong(Str, 36));
     // std::wcout << "ParseInt36: " << Str << " = " << result << std::endl;
     return result;
   }
@@ -19,7 +19,11 @@
 #include <windows.h>
 #endif
 #include "Chart.h"
+#include "Executor.h"
+#include "HeaderKeyword.h"
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <string>
@@ -28,39 +32,101 @@
  *
  */
 namespace bms_parser {
+struct ParseOptions {
+  // Parse(path) maps the file read-only and parses straight from the mapping
+  // instead of copying it into a buffer first. Falls back to reading the file
+  // if it can't be mapped.
+  bool UseMemoryMap = true;
+  // Tokenise the raw bytes and only run the Shift-JIS conversion on free-text
+  // header values (TITLE, ARTIST, WAV/BMP file names, ...). Control and
+  // channel lines are pure ASCII and never get converted, and no converted
+  // copy of the whole file is made.
+  bool LazyDecode = false;
+  // Also fill Chart::View with the notes laid out per lane, for consumers
+  // that stream through lanes in time order. Ignored for metaOnly parses.
+  bool BuildView = false;
+  // Threads to build measures on, 0 for one per core. Timelines and
+  // background notes are built concurrently, then long notes and timing are
+  // settled in measure order, so the chart comes out exactly as with 1.
+  // Small charts and metaOnly parses always use a single thread.
+  unsigned int MeasureThreads = 1;
+  // Digests of the source to compute while parsing, into Meta.MD5,
+  // Meta.SHA256 and Meta.ContentHash (XXH64, for cache keys). Turn them off
+  // when nothing looks at them, e.g. when reloading a chart to play it.
+  bool ComputeMD5 = true;
+  bool ComputeSHA256 = true;
+  bool ComputeContentHash = false;
+  // Parsing from bytes keeps a pointer to them, so that Chart::GetMD5() and
+  // the other getters can compute the digests left out above when first
+  // asked. The bytes must outlive those calls. Parse(path) never keeps its
+  // file, and ParseMany ignores this.
+  bool LazyDigests = false;
+  // Runs the MD5 and SHA-256 of the source while the chart is parsed. Null
+  // uses a pool shared by every parser, started on first use. Whatever the
+  // pool has not picked up by the end of the parse is hashed by the parsing
+  // thread itself, so a busy pool never holds a parse up.
+  Executor *HashPool = nullptr;
+  // Sources smaller than this many bytes are hashed on the parsing thread;
+  // handing them to another thread would cost about as much as hashing them.
+  size_t InlineHashBelow = 32 * 1024;
+};
+
+// A parser can be reused for any number of charts, one at a time.
 class Parser {
 public:
   Parser();
   void SetRandomSeed(unsigned int RandomSeed);
+  void SetOptions(const ParseOptions &Options);
+  [[nodiscard]] const ParseOptions &GetOptions() const { return Options; }
 
   void Parse(const std::filesystem::path &path, Chart **Chart,
              bool addReadyMeasure, bool metaOnly, std::atomic_bool &bCancelled);
   ~Parser();
   void Parse(const std::vector<unsigned char> &bytes, Chart **chart,
              bool addReadyMeasure, bool metaOnly, std::atomic_bool &bCancelled);
+  // Parses a chart from a contiguous byte range owned by the caller. The
+  // bytes are never copied, so they must stay alive until Parse returns.
+  void Parse(const unsigned char *bytes, size_t size, Chart **chart,
+             bool addReadyMeasure, bool metaOnly, std::atomic_bool &bCancelled);
+  // Bumped whenever a change to the parser changes the ChartMeta it
+  // produces, so that anything cached from an older one is thrown away.
+  static constexpr uint32_t Version = 2;
   static int NoWav;
   static int MetronomeWav;
 
 private:
+  ParseOptions Options;
   // bpmTable
   std::unordered_map<int, double> BpmTable;
   std::unordered_map<int, double> StopLengthTable;
   std::unordered_map<int, double> ScrollTable;
 
   bool UseBase62 = false;
+  TextEncoding SourceEncoding = TextEncoding::ShiftJIS;
+  // free-text values are still in SourceEncoding and need converting
+  bool DecodeValues = false;
   int Lnobj = -1;
   int Lntype = 1;
   unsigned int Seed;
   static inline int ParseHex(std::string_view Str);
+  static inline long ParseLong(std::string_view Str, int Base);
+  static inline double ParseDouble(std::string_view Str);
+  static inline std::string_view Tail(std::string_view Line, size_t Pos);
+  static inline bool SplitHeader(std::string_view Line, std::string_view &Cmd,
+                                 std::string_view &Xx,
+                                 std::string_view &Value);
+  // forgets the tables and settings of the previous chart
+  void ResetState();
+  // hashSource is false when the caller hashes the bytes itself
+  void ParseBytes(const unsigned char *bytes, size_t size, Chart **chart,
+                  bool addReadyMeasure, bool metaOnly,
+                  std::atomic_bool &bCancelled, bool hashSource);
   inline int ParseInt(std::string_view Str, bool forceBase32 = false) const;
-  void ParseHeader(Chart *Chart, std::string_view cmd, std::string_view Xx,
-                   const std::string &Value);
-  static inline bool MatchHeader(const std::string_view &str,
-                                 const std::string_view &headerUpper);
-  static inline unsigned long long Gcd(unsigned long long A,
-                                       unsigned long long B);
+  void ParseHeader(Chart *Chart, HeaderKeyword keyword, std::string_view cmd,
+                   std::string_view Xx, std::string_view Value);
   inline bool CheckResourceIdRange(int Id) const;
-  inline int ToWaveId(Chart *Chart, std::string_view Wav, bool metaOnly);
+  std::string DecodeText(std::string_view Value) const;
+  inline int ToWaveId(Chart *Chart, int decoded, bool metaOnly);
 #ifdef _WIN32
   static std::wstring utf8_to_path_t(const std::string &input);
 #else
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PlayState.h"
+#include "Chart.h"
+#include <cstring>
+#include <type_traits>
+
+namespace bms_parser {
+static_assert(std::is_trivially_copyable<NoteState>::value,
+              "Reset clears the states with memset");
+
+PlayState::PlayState(const Chart &chart)
+    : Notes(&chart.Notes), States(chart.Notes.size()) {}
+
+void PlayState::Reset() {
+  if (!States.empty()) {
+    std::memset(States.data(), 0, States.size() * sizeof(NoteState));
+  }
+}
+
+void PlayState::Play(uint32_t id, long long time) {
+  States[id].IsPlayed = true;
+  States[id].PlayedTime = time;
+}
+
+void PlayState::Press(uint32_t id, long long time) {
+  Play(id, time);
+  const auto &record = (*Notes)[id];
+  if (record.Kind != NoteKind::LongHead) {
+    return;
+  }
+  States[id].IsHolding = true;
+  if (record.Partner != NoNoteId) {
+    States[record.Partner].IsHolding = true;
+  }
+}
+
+void PlayState::Release(uint32_t id, long long time) {
+  Play(id, time);
+  States[id].IsHolding = false;
+  States[id].ReleaseTime = time;
+  const auto partner = (*Notes)[id].Partner;
+  if (partner != NoNoteId) {
+    States[partner].IsHolding = false;
+  }
+}
+} // namespace bms_parser
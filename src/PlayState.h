@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "NoteRecord.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Everything that changes while a chart is being played, kept apart from
+ * the parsed chart so that one chart can back several plays at once. The
+ * state of a note lives at its Note::Id, and starting over clears the whole
+ * buffer in one go.
+ */
+namespace bms_parser {
+class Chart;
+
+struct NoteState {
+  long long PlayedTime;
+  // long note tails only
+  long long ReleaseTime;
+  bool IsPlayed;
+  bool IsDead;
+  // set on both ends of a long note while it is held
+  bool IsHolding;
+};
+
+class PlayState {
+public:
+  // the chart has to outlive the state, and its note records be current
+  explicit PlayState(const Chart &chart);
+
+  // back to the state before the first note
+  void Reset();
+
+  [[nodiscard]] size_t size() const { return States.size(); }
+  NoteState &operator[](uint32_t id) { return States[id]; }
+  const NoteState &operator[](uint32_t id) const { return States[id]; }
+
+  void Play(uint32_t id, long long time);
+  // pressing a long note head holds it until its tail is released
+  void Press(uint32_t id, long long time);
+  void Release(uint32_t id, long long time);
+
+private:
+  const std::vector<NoteRecord> *Notes;
+  std::vector<NoteState> States;
+};
+} // namespace bms_parser
@@ -37,7 +37,11 @@
 
 // http://www.zedwood.com/article/cpp-sha256-function
 #include "SHA256.h"
+#include "CpuFeatures.h"
 #include <cstring>
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
 
 namespace bms_parser {
 const unsigned int SHA256::sha256_k[64] = // UL = uint32
@@ -53,7 +57,15 @@ const unsigned int SHA256::sha256_k[64] = // UL = uint32
      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
 
-void SHA256::transform(const unsigned char *message, unsigned int block_nb) {
+namespace {
+using uint8 = unsigned char;
+using uint32 = unsigned int;
+using TransformFn = void (*)(uint32 *state, const uint32 *k,
+                             const unsigned char *message,
+                             unsigned int block_nb);
+
+void TransformScalar(uint32 *state, const uint32 *k,
+                     const unsigned char *message, unsigned int block_nb) {
   uint32 w[64];
   uint32 wv[8];
   uint32 t1, t2;
@@ -69,11 +81,11 @@ void SHA256::transform(const unsigned char *message, unsigned int block_nb) {
       w[j] = SHA256_F4(w[j - 2]) + w[j - 7] + SHA256_F3(w[j - 15]) + w[j - 16];
     }
     for (j = 0; j < 8; j++) {
-      wv[j] = m_h[j];
+      wv[j] = state[j];
     }
     for (j = 0; j < 64; j++) {
-      t1 = wv[7] + SHA256_F2(wv[4]) + SHA2_CH(wv[4], wv[5], wv[6]) +
-           sha256_k[j] + w[j];
+      t1 = wv[7] + SHA256_F2(wv[4]) + SHA2_CH(wv[4], wv[5], wv[6]) + k[j] +
+           w[j];
       t2 = SHA256_F1(wv[0]) + SHA2_MAJ(wv[0], wv[1], wv[2]);
       wv[7] = wv[6];
       wv[6] = wv[5];
@@ -85,12 +97,219 @@ void SHA256::transform(const unsigned char *message, unsigned int block_nb) {
       wv[0] = t1 + t2;
     }
     for (j = 0; j < 8; j++) {
-      m_h[j] += wv[j];
+      state[j] += wv[j];
+    }
+  }
+}
+
+#if BMS_PARSER_X86
+// sigma0 and sigma1 of the message schedule on four words at once
+BMS_PARSER_TARGET("avx2")
+inline __m128i ScheduleSigma0(__m128i x) {
+  return _mm_xor_si128(
+      _mm_xor_si128(_mm_or_si128(_mm_srli_epi32(x, 7), _mm_slli_epi32(x, 25)),
+                    _mm_or_si128(_mm_srli_epi32(x, 18),
+                                 _mm_slli_epi32(x, 14))),
+      _mm_srli_epi32(x, 3));
+}
+
+BMS_PARSER_TARGET("avx2")
+inline __m128i ScheduleSigma1(__m128i x) {
+  return _mm_xor_si128(
+      _mm_xor_si128(
+          _mm_or_si128(_mm_srli_epi32(x, 17), _mm_slli_epi32(x, 15)),
+          _mm_or_si128(_mm_srli_epi32(x, 19), _mm_slli_epi32(x, 13))),
+      _mm_srli_epi32(x, 10));
+}
+
+// The rounds stay scalar, but the message schedule is expanded four words
+// at a time in vector registers, in between the rounds that consume it.
+BMS_PARSER_TARGET("avx2")
+void TransformAvx2(uint32 *state, const uint32 *k,
+                   const unsigned char *message, unsigned int block_nb) {
+  const __m128i byteSwap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  alignas(16) uint32 wk[16];
+  for (unsigned int block = 0; block < block_nb; ++block) {
+    const auto data = reinterpret_cast<const __m128i *>(message + block * 64);
+    // x0..x3 hold the last 16 schedule words, oldest first
+    __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128(data), byteSwap);
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128(data + 1), byteSwap);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128(data + 2), byteSwap);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128(data + 3), byteSwap);
+    uint32 a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32 e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int t = 0; t < 64; t += 16) {
+      const auto kv = reinterpret_cast<const __m128i *>(k + t);
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk),
+                      _mm_add_epi32(x0, _mm_loadu_si128(kv)));
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk + 4),
+                      _mm_add_epi32(x1, _mm_loadu_si128(kv + 1)));
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk + 8),
+                      _mm_add_epi32(x2, _mm_loadu_si128(kv + 2)));
+      _mm_store_si128(reinterpret_cast<__m128i *>(wk + 12),
+                      _mm_add_epi32(x3, _mm_loadu_si128(kv + 3)));
+      if (t < 48) {
+        // w[i] = s1(w[i-2]) + w[i-7] + s0(w[i-15]) + w[i-16]; the s1 term of
+        // the upper two words needs the lower two, so it takes two steps
+        for (int step = 0; step < 4; ++step) {
+          __m128i next = _mm_add_epi32(
+              _mm_add_epi32(x0, _mm_alignr_epi8(x3, x2, 4)),
+              ScheduleSigma0(_mm_alignr_epi8(x1, x0, 4)));
+          next = _mm_add_epi32(next, ScheduleSigma1(_mm_srli_si128(x3, 8)));
+          next = _mm_add_epi32(next, ScheduleSigma1(_mm_slli_si128(next, 8)));
+          x0 = x1;
+          x1 = x2;
+          x2 = x3;
+          x3 = next;
+        }
+      }
+      for (int j = 0; j < 16; ++j) {
+        const uint32 t1 =
+            h + SHA256_F2(e) + SHA2_CH(e, f, g) + wk[j];
+        const uint32 t2 = SHA256_F1(a) + SHA2_MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+      }
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+// four rounds with the SHA extensions; msg holds the next four words
+#define SHA256_NI_ROUNDS(state0, state1, msg, k)                               \
+  {                                                                            \
+    __m128i wk_ = _mm_add_epi32(                                               \
+        msg, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k)));           \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, wk_);                       \
+    state0 = _mm_sha256rnds2_epu32(state0, state1,                             \
+                                   _mm_shuffle_epi32(wk_, 0x0E));              \
+  }
+
+// extends the schedule after the rounds of group g, which used cur; prev,
+// next and later are the groups around it
+#define SHA256_NI_SCHEDULE(g, prev, cur, next, later)                          \
+  {                                                                            \
+    if ((g) >= 3 && (g) <= 14) {                                               \
+      next = _mm_sha256msg2_epu32(                                             \
+          _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)), cur);            \
+    }                                                                          \
+    if ((g) >= 1 && (g) <= 12) {                                               \
+      later = _mm_sha256msg1_epu32(later, cur);                                \
+    }                                                                          \
+  }
+
+BMS_PARSER_TARGET("sha,sse4.1,ssse3")
+void TransformShaNi(uint32 *state, const uint32 *k,
+                    const unsigned char *message, unsigned int block_nb) {
+  const __m128i byteSwap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  // the instructions want the state as ABEF and CDGH
+  __m128i tmp = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xB1);
+  __m128i state1 = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1B);
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+  for (unsigned int block = 0; block < block_nb; ++block) {
+    const auto data = reinterpret_cast<const __m128i *>(message + block * 64);
+    const __m128i abefSave = state0;
+    const __m128i cdghSave = state1;
+    __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(data), byteSwap);
+    __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(data + 1), byteSwap);
+    __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(data + 2), byteSwap);
+    __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(data + 3), byteSwap);
+    for (int g = 0; g < 16; g += 4) {
+      SHA256_NI_ROUNDS(state0, state1, m0, k + g * 4);
+      SHA256_NI_SCHEDULE(g, m3, m0, m1, m3);
+      SHA256_NI_ROUNDS(state0, state1, m1, k + g * 4 + 4);
+      SHA256_NI_SCHEDULE(g + 1, m0, m1, m2, m0);
+      SHA256_NI_ROUNDS(state0, state1, m2, k + g * 4 + 8);
+      SHA256_NI_SCHEDULE(g + 2, m1, m2, m3, m1);
+      SHA256_NI_ROUNDS(state0, state1, m3, k + g * 4 + 12);
+      SHA256_NI_SCHEDULE(g + 3, m2, m3, m0, m2);
     }
+    state0 = _mm_add_epi32(state0, abefSave);
+    state1 = _mm_add_epi32(state1, cdghSave);
   }
+
+  tmp = _mm_shuffle_epi32(state0, 0x1B);
+  state1 = _mm_shuffle_epi32(state1, 0xB1);
+  state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+  state1 = _mm_alignr_epi8(state1, tmp, 8);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(state), state0);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), state1);
+}
+#undef SHA256_NI_ROUNDS
+#undef SHA256_NI_SCHEDULE
+#endif
+
+TransformFn SelectTransform() {
+#if BMS_PARSER_X86
+  if (CpuFeatures::HasSHA()) {
+    return TransformShaNi;
+  }
+  if (CpuFeatures::HasAVX2()) {
+    return TransformAvx2;
+  }
+#endif
+  return TransformScalar;
 }
 
-void SHA256::init() {
+TransformFn KernelTransform(SHA256Kernel kernel) {
+  switch (kernel) {
+#if BMS_PARSER_X86
+  case SHA256Kernel::ShaNi:
+    return TransformShaNi;
+  case SHA256Kernel::Avx2:
+    return TransformAvx2;
+#endif
+  case SHA256Kernel::Scalar:
+    return TransformScalar;
+  default: {
+    static const TransformFn fastest = SelectTransform();
+    return fastest;
+  }
+  }
+}
+} // namespace
+
+bool SHA256::Supports(SHA256Kernel kernel) {
+  switch (kernel) {
+#if BMS_PARSER_X86
+  case SHA256Kernel::ShaNi:
+    return CpuFeatures::HasSHA();
+  case SHA256Kernel::Avx2:
+    return CpuFeatures::HasAVX2();
+#endif
+  case SHA256Kernel::Auto:
+  case SHA256Kernel::Scalar:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void SHA256::transform(const unsigned char *message, unsigned int block_nb) {
+  KernelTransform(m_kernel)(m_h, sha256_k, message, block_nb);
+}
+
+void SHA256::init(SHA256Kernel kernel) {
+  m_kernel = kernel;
   m_h[0] = 0x6a09e667;
   m_h[1] = 0xbb67ae85;
   m_h[2] = 0x3c6ef372;
@@ -143,13 +362,14 @@ void SHA256::final(unsigned char *digest) {
   }
 }
 
-std::string sha256(const std::vector<unsigned char> &bytes) {
+std::string sha256(const unsigned char *bytes, size_t size,
+                   SHA256Kernel kernel) {
   unsigned char digest[SHA256::DIGEST_SIZE];
   memset(digest, 0, SHA256::DIGEST_SIZE);
 
   SHA256 ctx = SHA256();
-  ctx.init();
-  ctx.update(bytes.data(), bytes.size());
+  ctx.init(kernel);
+  ctx.update(bytes, size);
   ctx.final(digest);
 
   char buf[2 * SHA256::DIGEST_SIZE + 1];
@@ -159,4 +379,8 @@ std::string sha256(const std::vector<unsigned char> &bytes) {
   }
   return buf;
 }
+
+std::string sha256(const std::vector<unsigned char> &bytes) {
+  return sha256(bytes.data(), bytes.size());
+}
 } // namespace bms_parser
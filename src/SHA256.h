@@ -4,6 +4,10 @@
 
 // http://www.zedwood.com/article/cpp-sha256-function
 namespace bms_parser {
+// The block functions SHA256 can run on. Auto takes the fastest one this
+// CPU has; naming one is for tests, which hold them against each other.
+enum class SHA256Kernel { Auto, Scalar, Avx2, ShaNi };
+
 class SHA256 {
   /*
    * Updated to C++, zedwood.com 2012
@@ -49,7 +53,9 @@ protected:
   static constexpr unsigned int SHA224_256_BLOCK_SIZE = (512 / 8);
 
 public:
-  void init();
+  // kernel must be one the CPU Supports
+  void init(SHA256Kernel kernel = SHA256Kernel::Auto);
+  [[nodiscard]] static bool Supports(SHA256Kernel kernel);
   void update(const unsigned char *message, unsigned int len);
   void final(unsigned char *digest);
   static constexpr unsigned int DIGEST_SIZE = (256 / 8);
@@ -60,8 +66,11 @@ protected:
   unsigned int m_len;
   unsigned char m_block[2 * SHA224_256_BLOCK_SIZE];
   uint32 m_h[8];
+  SHA256Kernel m_kernel = SHA256Kernel::Auto;
 };
 
+std::string sha256(const unsigned char *bytes, size_t size,
+                   SHA256Kernel kernel = SHA256Kernel::Auto);
 std::string sha256(const std::vector<unsigned char> &bytes);
 
 #define SHA2_SHFR(x, n) (x >> n)
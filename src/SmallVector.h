@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/**
+ * A vector that keeps its first N elements inline and only goes to the heap
+ * past that. Only for trivially copyable elements such as pointers.
+ */
+namespace bms_parser {
+template <typename T, size_t N> class SmallVector {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "elements are moved with memcpy");
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  SmallVector() = default;
+  SmallVector(const SmallVector &other) { *this = other; }
+  SmallVector &operator=(const SmallVector &other) {
+    if (this != &other) {
+      clear();
+      reserve(other.Size);
+      std::memcpy(Data, other.Data, other.Size * sizeof(T));
+      Size = other.Size;
+    }
+    return *this;
+  }
+  ~SmallVector() { Release(); }
+
+  void push_back(const T &value) {
+    if (Size == Capacity) {
+      reserve(Capacity * 2);
+    }
+    Data[Size++] = value;
+  }
+
+  void reserve(size_t capacity) {
+    if (capacity <= Capacity) {
+      return;
+    }
+    auto grown = static_cast<T *>(std::malloc(capacity * sizeof(T)));
+    if (grown == nullptr) {
+      throw std::bad_alloc();
+    }
+    std::memcpy(grown, Data, Size * sizeof(T));
+    Release();
+    Data = grown;
+    Capacity = capacity;
+  }
+
+  void clear() { Size = 0; }
+
+  [[nodiscard]] size_t size() const { return Size; }
+  [[nodiscard]] bool empty() const { return Size == 0; }
+  T &operator[](size_t i) { return Data[i]; }
+  const T &operator[](size_t i) const { return Data[i]; }
+  iterator begin() { return Data; }
+  iterator end() { return Data + Size; }
+  [[nodiscard]] const_iterator begin() const { return Data; }
+  [[nodiscard]] const_iterator end() const { return Data + Size; }
+
+private:
+  void Release() {
+    if (Data != Inline) {
+      std::free(Data);
+    }
+  }
+
+  T Inline[N];
+  T *Data = Inline;
+  size_t Size = 0;
+  size_t Capacity = N;
+};
+} // namespace bms_parser
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextEncoding.h"
+#include "CpuFeatures.h"
+#include "ShiftJISConverter.h"
+#if BMS_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace bms_parser {
+namespace {
+size_t AsciiRunScalar(const unsigned char *input, size_t size) {
+  size_t i = 0;
+  while (i < size && input[i] < 0x80) {
+    ++i;
+  }
+  return i;
+}
+
+#if BMS_PARSER_X86
+BMS_PARSER_TARGET("sse2")
+size_t AsciiRunSse2(const unsigned char *input, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+    if (mask != 0) {
+      return i + CpuFeatures::CountTrailingZeros(mask);
+    }
+  }
+  return i + AsciiRunScalar(input + i, size - i);
+}
+
+BMS_PARSER_TARGET("avx2")
+size_t AsciiRunAvx2(const unsigned char *input, size_t size) {
+  size_t i = 0;
+  // two vectors per step; ASCII is by far the common case
+  for (; i + 64 <= size; i += 64) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0) {
+      break;
+    }
+  }
+  for (; i + 32 <= size; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    if (mask != 0) {
+      return i + CpuFeatures::CountTrailingZeros(mask);
+    }
+  }
+  return i + AsciiRunSse2(input + i, size - i);
+}
+#endif
+
+using AsciiRunFn = size_t (*)(const unsigned char *, size_t);
+
+AsciiRunFn SelectAsciiRun() {
+#if BMS_PARSER_X86
+  if (CpuFeatures::HasAVX2()) {
+    return AsciiRunAvx2;
+  }
+  if (CpuFeatures::HasSSE2()) {
+    return AsciiRunSse2;
+  }
+#endif
+  return AsciiRunScalar;
+}
+
+// Length of the well-formed UTF-8 sequence starting at input (RFC 3629), or
+// 0 if it is malformed. input[0] must be >= 0x80.
+size_t Utf8SequenceLength(const unsigned char *input, size_t size) {
+  const unsigned char lead = input[0];
+  size_t length;
+  unsigned char low = 0x80, high = 0xBF; // bounds of the second byte
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    length = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+    if (lead == 0xE0) {
+      low = 0xA0; // overlong
+    } else if (lead == 0xED) {
+      high = 0x9F; // surrogates
+    }
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    length = 4;
+    if (lead == 0xF0) {
+      low = 0x90; // overlong
+    } else if (lead == 0xF4) {
+      high = 0x8F; // above U+10FFFF
+    }
+  } else {
+    return 0;
+  }
+  if (size < length || input[1] < low || input[1] > high) {
+    return 0;
+  }
+  for (size_t i = 2; i < length; ++i) {
+    if ((input[i] & 0xC0) != 0x80) {
+      return 0;
+    }
+  }
+  return length;
+}
+} // namespace
+
+bool TextEncodings::IsValidUTF8(const unsigned char *input, size_t size,
+                                bool &isAscii) {
+  static const AsciiRunFn asciiRun = SelectAsciiRun();
+  isAscii = true;
+  size_t i = 0;
+  while (i < size) {
+    i += asciiRun(input + i, size - i);
+    if (i >= size) {
+      break;
+    }
+    isAscii = false;
+    const size_t length = Utf8SequenceLength(input + i, size - i);
+    if (length == 0) {
+      return false;
+    }
+    i += length;
+  }
+  return true;
+}
+
+TextEncoding TextEncodings::Detect(const unsigned char *input, size_t size,
+                                   size_t &bomLength) {
+  bomLength = 0;
+  if (size >= 3 && input[0] == 0xEF && input[1] == 0xBB && input[2] == 0xBF) {
+    bomLength = 3;
+    return TextEncoding::UTF8;
+  }
+  bool isAscii;
+  if (IsValidUTF8(input, size, isAscii) && !isAscii) {
+    return TextEncoding::UTF8;
+  }
+  return TextEncoding::ShiftJIS;
+}
+
+void TextEncodings::ToUTF8(TextEncoding encoding, const unsigned char *input,
+                           size_t size, std::string &result) {
+  switch (encoding) {
+  case TextEncoding::UTF8:
+    result.assign(reinterpret_cast<const char *>(input), size);
+    break;
+  case TextEncoding::ShiftJIS:
+  default:
+    ShiftJISConverter::BytesToUTF8(input, size, result);
+    break;
+  }
+}
+} // namespace bms_parser
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace bms_parser {
+enum class TextEncoding {
+  ShiftJIS = 0,
+  UTF8 = 1,
+};
+
+/**
+ * Detects the text encoding of a chart and converts it to UTF-8. Each
+ * encoding other than UTF-8 is handled by its own decoder in ToUTF8.
+ */
+namespace TextEncodings {
+// Charts that start with a UTF-8 BOM or are valid UTF-8 with at least one
+// non-ASCII character are UTF-8; everything else is treated as Shift-JIS.
+// Pure ASCII stays Shift-JIS so that '\' and '~' keep converting the way
+// they always have. bomLength receives the number of bytes to skip.
+TextEncoding Detect(const unsigned char *input, size_t size,
+                    size_t &bomLength);
+
+// isAscii is set when every byte is below 0x80
+bool IsValidUTF8(const unsigned char *input, size_t size, bool &isAscii);
+
+void ToUTF8(TextEncoding encoding, const unsigned char *input, size_t size,
+            std::string &result);
+} // namespace TextEncodings
+} // namespace bms_parser
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace bms_parser {
+namespace {
+// the pool and queue of the calling thread, if it is a pool thread
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  Queues.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    Queues.push_back(std::make_unique<Queue>());
+  }
+  Threads.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    Threads.emplace_back([this, i] { Run(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(WakeMutex);
+    Stopping = true;
+  }
+  Wake.notify_all();
+  for (auto &thread : Threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> job) {
+  const auto target = currentPool == this
+                          ? currentQueue
+                          : NextQueue.fetch_add(1, std::memory_order_relaxed) %
+                                Queues.size();
+  // count first so that Pending never drops below the queued jobs
+  Pending.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(Queues[target]->Mutex);
+    Queues[target]->Jobs.push_back(std::move(job));
+  }
+  {
+    // pairs with the wait in Run so the wake-up can't slip in between a
+    // worker's check and its sleep
+    std::lock_guard<std::mutex> lock(WakeMutex);
+  }
+  Wake.notify_one();
+}
+
+bool ThreadPool::TryTake(size_t self, std::function<void()> &job) {
+  {
+    auto &own = *Queues[self];
+    std::lock_guard<std::mutex> lock(own.Mutex);
+    if (!own.Jobs.empty()) {
+      job = std::move(own.Jobs.back());
+      own.Jobs.pop_back();
+      Pending.fetch_sub(1);
+      return true;
+    }
+  }
+  for (size_t i = 1; i < Queues.size(); ++i) {
+    auto &victim = *Queues[(self + i) % Queues.size()];
+    std::lock_guard<std::mutex> lock(victim.Mutex);
+    if (!victim.Jobs.empty()) {
+      job = std::move(victim.Jobs.front());
+      victim.Jobs.pop_front();
+      Pending.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::Run(size_t self) {
+  currentPool = this;
+  currentQueue = self;
+  std::function<void()> job;
+  while (true) {
+    if (TryTake(self, job)) {
+      job();
+      job = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(WakeMutex);
+    Wake.wait(lock, [this] { return Stopping || Pending.load() > 0; });
+    if (Stopping && Pending.load() == 0) {
+      return;
+    }
+  }
+}
+} // namespace bms_parser
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Executor.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of threads with one job queue each. A job submitted from one of
+ * the pool's threads goes to that thread's queue and is taken newest first;
+ * a thread whose queue runs dry steals the oldest job of another queue, so
+ * uneven jobs do not leave threads idle while work is waiting.
+ */
+namespace bms_parser {
+class ThreadPool final : public Executor {
+public:
+  // 0 starts one thread per core
+  explicit ThreadPool(unsigned int threads = 0);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  // runs every job that is still queued, then joins the threads
+  ~ThreadPool() override;
+
+  void Submit(std::function<void()> job) override;
+  [[nodiscard]] unsigned int Concurrency() const override {
+    return static_cast<unsigned int>(Threads.size());
+  }
+
+private:
+  struct Queue {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Jobs;
+  };
+
+  bool TryTake(size_t self, std::function<void()> &job);
+  void Run(size_t self);
+
+  std::vector<std::unique_ptr<Queue>> Queues;
+  std::vector<std::thread> Threads;
+  // jobs submitted and not taken yet; may briefly run ahead of the queues
+  std::atomic<size_t> Pending{0};
+  std::atomic<size_t> NextQueue{0};
+  std::mutex WakeMutex;
+  std::condition_variable Wake;
+  bool Stopping = false; // guarded by WakeMutex
+};
+} // namespace bms_parser
@@ -15,32 +15,28 @@
  */
 
 #include "TimeLine.h"
+#include <cassert>
 namespace bms_parser {
-TimeLine::TimeLine(int lanes, bool metaOnly) {
-  if (metaOnly) {
-    return;
-  }
-  Notes.resize(lanes, nullptr);
-  InvisibleNotes.resize(lanes, nullptr);
-  LandmineNotes.resize(lanes, nullptr);
+TimeLine::TimeLine([[maybe_unused]] int lanes, [[maybe_unused]] bool metaOnly) {
+  assert(lanes <= MaxLanes);
 }
 
 TimeLine *TimeLine::SetNote(int lane, Note *note) {
-  Notes[lane] = note;
+  Notes.Set(lane, note);
   note->Lane = lane;
   note->Timeline = this;
   return this;
 }
 
 TimeLine *TimeLine::SetInvisibleNote(int lane, Note *note) {
-  InvisibleNotes[lane] = note;
+  InvisibleNotes.Set(lane, note);
   note->Lane = lane;
   note->Timeline = this;
   return this;
 }
 
 TimeLine *TimeLine::SetLandmineNote(int lane, LandmineNote *note) {
-  LandmineNotes[lane] = note;
+  LandmineNotes.Set(lane, note);
   note->Lane = lane;
   note->Timeline = this;
   return this;
@@ -56,22 +52,5 @@ double TimeLine::GetStopDuration() const {
   return 1250000.0 * StopLength / Bpm; // 1250000 = 240 * 1000 * 1000 / 192
 }
 
-TimeLine::~TimeLine() {
-  for (const auto &note : Notes) {
-    delete note;
-  }
-  Notes.clear();
-  for (const auto &note : InvisibleNotes) {
-    delete note;
-  }
-  InvisibleNotes.clear();
-  for (const auto &note : LandmineNotes) {
-    delete note;
-  }
-  LandmineNotes.clear();
-  for (const auto &note : BackgroundNotes) {
-    delete note;
-  }
-  BackgroundNotes.clear();
-}
+TimeLine::~TimeLine() = default;
 } // namespace bms_parser
@@ -17,8 +17,9 @@
 #pragma once
 
 #include "LandmineNote.h"
+#include "LaneArray.h"
 #include "Note.h"
-#include <vector>
+#include "SmallVector.h"
 
 /**
  *
@@ -26,10 +27,12 @@
 namespace bms_parser {
 class TimeLine {
 public:
-  std::vector<Note *> BackgroundNotes;
-  std::vector<Note *> InvisibleNotes;
-  std::vector<Note *> Notes;
-  std::vector<LandmineNote *> LandmineNotes;
+  static constexpr int MaxLanes = 16;
+  // most timelines carry a keysound or two
+  SmallVector<Note *, 2> BackgroundNotes;
+  LaneArray<Note *, MaxLanes> InvisibleNotes;
+  LaneArray<Note *, MaxLanes> Notes;
+  LaneArray<LandmineNote *, MaxLanes> LandmineNotes;
   double Bpm = 0;
   bool BpmChange = false;
   bool BpmChangeApplied = false;
@@ -47,6 +50,7 @@ public:
   // measure. 1.25 means 1 measure and 1/4 beat
   double BeatPosition = 0;
 
+  // lanes must not exceed MaxLanes; the lane storage is always inline
   explicit TimeLine(int lanes, bool metaOnly);
 
   TimeLine *SetNote(int lane, Note *note);
@@ -59,6 +63,7 @@ public:
 
   [[nodiscard]] double GetStopDuration() const;
 
+  // the notes belong to the chart's arena and are not freed here
   ~TimeLine();
   bool IsFirstInMeasure = false;
 };
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "XXHash64.h"
+
+namespace bms_parser {
+namespace {
+constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t RotateLeft64(uint64_t x, int n) {
+  return (x << n) | (x >> (64 - n));
+}
+
+// little-endian whatever the host is; compilers turn these into plain loads
+inline uint64_t Read64(const unsigned char *p) {
+  return static_cast<uint64_t>(p[0]) | static_cast<uint64_t>(p[1]) << 8 |
+         static_cast<uint64_t>(p[2]) << 16 | static_cast<uint64_t>(p[3]) << 24 |
+         static_cast<uint64_t>(p[4]) << 32 | static_cast<uint64_t>(p[5]) << 40 |
+         static_cast<uint64_t>(p[6]) << 48 | static_cast<uint64_t>(p[7]) << 56;
+}
+
+inline uint64_t Read32(const unsigned char *p) {
+  return static_cast<uint64_t>(p[0]) | static_cast<uint64_t>(p[1]) << 8 |
+         static_cast<uint64_t>(p[2]) << 16 | static_cast<uint64_t>(p[3]) << 24;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+  acc += input * Prime2;
+  acc = RotateLeft64(acc, 31);
+  return acc * Prime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t value) {
+  acc ^= Round(0, value);
+  return acc * Prime1 + Prime4;
+}
+} // namespace
+
+uint64_t XXHash64(const unsigned char *bytes, size_t size, uint64_t seed) {
+  const unsigned char *p = bytes;
+  const unsigned char *const end = bytes + size;
+  uint64_t hash;
+  if (size >= 32) {
+    uint64_t v1 = seed + Prime1 + Prime2;
+    uint64_t v2 = seed + Prime2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - Prime1;
+    for (; end - p >= 32; p += 32) {
+      v1 = Round(v1, Read64(p));
+      v2 = Round(v2, Read64(p + 8));
+      v3 = Round(v3, Read64(p + 16));
+      v4 = Round(v4, Read64(p + 24));
+    }
+    hash = RotateLeft64(v1, 1) + RotateLeft64(v2, 7) + RotateLeft64(v3, 12) +
+           RotateLeft64(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  } else {
+    hash = seed + Prime5;
+  }
+  hash += static_cast<uint64_t>(size);
+
+  for (; end - p >= 8; p += 8) {
+    hash ^= Round(0, Read64(p));
+    hash = RotateLeft64(hash, 27) * Prime1 + Prime4;
+  }
+  if (end - p >= 4) {
+    hash ^= Read32(p) * Prime1;
+    hash = RotateLeft64(hash, 23) * Prime2 + Prime3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    hash ^= *p * Prime5;
+    hash = RotateLeft64(hash, 11) * Prime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= Prime2;
+  hash ^= hash >> 29;
+  hash *= Prime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+} // namespace bms_parser
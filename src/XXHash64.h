@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2024 VioletXF, khoeun03
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * XXH64, a fast non-cryptographic 64-bit hash. Meant for cache keys and
+ * change detection, where MD5 or SHA-256 would be many times slower for no
+ * benefit.
+ */
+namespace bms_parser {
+uint64_t XXHash64(const unsigned char *bytes, size_t size, uint64_t seed = 0);
+} // namespace bms_parser
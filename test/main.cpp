@@ -2,13 +2,27 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #if WITH_AMALGAMATION
 #include "bms_parser.hpp"
 #else
 #include "../src/Chart.h"
+#include "../src/ChartSnapshot.h"
+#include "../src/LongNote.h"
+#include "../src/MetaCache.h"
+#include "../src/MultiHash.h"
+#include "../src/ParseMany.h"
 #include "../src/Parser.h"
+#include "../src/PlayState.h"
+#include "../src/SHA256.h"
+#include "../src/ThreadPool.h"
+#include "../src/md5.h"
 
 #endif
 
@@ -33,6 +47,162 @@
 std::string ws2s(const std::wstring &wstr) {
   return std::string().assign(wstr.begin(), wstr.end());
 }
+int check_chart(bms_parser::Chart *chart,
+                const std::filesystem::path &output_path);
+int test_chart(const std::filesystem::path &input,
+               const std::filesystem::path &output_path,
+               const bms_parser::ParseOptions &options, bool fromMemory) {
+  bms_parser::Chart *chart;
+  std::atomic_bool cancel = false;
+  bms_parser::Parser parser;
+  parser.SetOptions(options);
+  // outlives the checks, which may hash it through the chart's getters
+  std::string bytes;
+  if (fromMemory) {
+    // parse from a caller-owned buffer through the byte range overload
+    std::ifstream file(input, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>());
+    parser.Parse(reinterpret_cast<const unsigned char *>(bytes.data()),
+                 bytes.size(), &chart, false, false, cancel);
+  } else {
+    parser.Parse(input.wstring(), &chart, false, false, cancel);
+  }
+  return check_chart(chart, output_path);
+}
+int check_chart(bms_parser::Chart *chart,
+                const std::filesystem::path &output_path) {
+  std::ifstream ifs(output_path);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.rfind("md5: ", 0) == 0) {
+      auto out = line.substr(5);
+      ASSERT_EQ(out, chart->GetMD5(), "md5: ");
+    } else if (line.rfind("sha256: ", 0) == 0) {
+      auto out = line.substr(8);
+      ASSERT_EQ(out, chart->GetSHA256(), "sha256: ");
+    } else if (line.rfind("encoding: ", 0) == 0) {
+      auto out = line.substr(10) == "utf8"
+                     ? static_cast<int>(bms_parser::TextEncoding::UTF8)
+                     : static_cast<int>(bms_parser::TextEncoding::ShiftJIS);
+      ASSERT_EQ(out, static_cast<int>(chart->Meta.Encoding), "encoding: ");
+    } else if (line.rfind("title: ", 0) == 0) {
+      auto out = line.substr(7);
+      ASSERT_EQ(out, chart->Meta.Title, "title: ");
+    } else if (line.rfind("artist: ", 0) == 0) {
+      auto out = line.substr(8);
+      ASSERT_EQ(out, chart->Meta.Artist, "artist: ");
+    } else if (line.rfind("genre: ", 0) == 0) {
+      auto out = line.substr(7);
+      ASSERT_EQ(out, chart->Meta.Genre, "genre: ");
+    } else if (line.rfind("subartist: ", 0) == 0) {
+      auto out = line.substr(11);
+      ASSERT_EQ(out, chart->Meta.SubArtist, "subartist: ");
+    } else if (line.rfind("total: ", 0) == 0) {
+      auto out = std::stod(line.substr(7));
+      ASSERT_EQ(out, chart->Meta.Total, "total: ");
+    } else if (line.rfind("total_notes: ", 0) == 0) {
+      auto out = std::stoi(line.substr(13));
+      ASSERT_EQ(out, chart->Meta.TotalNotes, "total_notes: ");
+    } else if (line.rfind("total_backspin_notes: ", 0) == 0) {
+      auto out = std::stoi(line.substr(22));
+      ASSERT_EQ(out, chart->Meta.TotalBackSpinNotes,
+                "total_backspin_notes: ");
+    } else if (line.rfind("total_long_notes: ", 0) == 0) {
+      auto out = std::stoi(line.substr(18));
+      ASSERT_EQ(out, chart->Meta.TotalLongNotes, "total_long_notes: ");
+    } else if (line.rfind("total_scratch_notes: ", 0) == 0) {
+      auto out = std::stoi(line.substr(21));
+      ASSERT_EQ(out, chart->Meta.TotalScratchNotes,
+                "total_scratch_notes: ");
+    } else if (line.rfind("total_landmine_notes: ", 0) == 0) {
+      auto out = std::stoi(line.substr(22));
+      ASSERT_EQ(out, chart->Meta.TotalLandmineNotes,
+                "total_landmine_notes: ");
+    } else if (line.rfind("min_bpm: ", 0) == 0) {
+      auto out = std::stod(line.substr(9));
+      ASSERT_EQ(out, chart->Meta.MinBpm, "min_bpm: ");
+    } else if (line.rfind("max_bpm: ", 0) == 0) {
+      auto out = std::stod(line.substr(9));
+      ASSERT_EQ(out, chart->Meta.MaxBpm, "max_bpm: ");
+    } else if (line.rfind("bpm: ", 0) == 0) {
+      auto out = std::stod(line.substr(5));
+      ASSERT_EQ(out, chart->Meta.Bpm, "bpm: ");
+    } else if (line.rfind("minbpm: ", 0) == 0) {
+      auto out = std::stod(line.substr(8));
+      ASSERT_EQ(out, chart->Meta.MinBpm, "minbpm: ");
+    } else if (line.rfind("maxbpm: ", 0) == 0) {
+      auto out = std::stod(line.substr(8));
+      ASSERT_EQ(out, chart->Meta.MaxBpm, "maxbpm: ");
+    } else if (line.rfind("is_dp: ", 0) == 0) {
+      auto out = line.substr(7) == "true";
+      ASSERT_EQ(out, chart->Meta.IsDP, "is_dp: ");
+    } else if (line.rfind("key_mode: ", 0) == 0) {
+      auto out = std::stoi(line.substr(10));
+      ASSERT_EQ(out, chart->Meta.KeyMode, "key_mode: ");
+    } else if (line.rfind("difficulty: ", 0) == 0) {
+      auto out = std::stoi(line.substr(12));
+      ASSERT_EQ(out, chart->Meta.Difficulty, "difficulty: ");
+    } else if (line.rfind("playlevel: ", 0) == 0) {
+      auto out = std::stoi(line.substr(11));
+      ASSERT_EQ(out, chart->Meta.PlayLevel, "playlevel: ");
+    } else if (line.rfind("player: ", 0) == 0) {
+      auto out = std::stoi(line.substr(8));
+      ASSERT_EQ(out, chart->Meta.Player, "player: ");
+    } else if (line.rfind("rank: ", 0) == 0) {
+      auto out = std::stoi(line.substr(6));
+      ASSERT_EQ(out, chart->Meta.Rank, "rank: ");
+    } else if (line.rfind("playlength: ", 0) == 0) {
+      auto out = std::stoi(line.substr(11));
+      ASSERT_EQ(out, chart->Meta.PlayLength, "playlength: ");
+    } else if (line.rfind("long_note_pairs: ", 0) == 0) {
+      // heads whose tail links back to them, in the same lane
+      size_t pairs = 0;
+      for (uint32_t id = 0; id < chart->Notes.size(); ++id) {
+        const auto &head = chart->Notes[id];
+        if (head.Kind != bms_parser::NoteKind::LongHead ||
+            head.Partner == bms_parser::NoNoteId) {
+          continue;
+        }
+        const auto &tail = chart->Notes[head.Partner];
+        if (tail.Kind == bms_parser::NoteKind::LongTail &&
+            tail.Partner == id && tail.Lane == head.Lane &&
+            tail.Timeline > head.Timeline) {
+          ++pairs;
+        }
+      }
+      auto out = std::stoul(line.substr(17));
+      ASSERT_EQ(out, pairs, "long_note_pairs: ");
+    }
+  }
+  if (chart->View) {
+    size_t viewNotes = chart->View->Background.size();
+    for (const auto &lane : chart->View->Lanes) {
+      viewNotes += lane.size();
+    }
+    ASSERT_EQ(chart->Notes.size(), viewNotes, "view notes: ");
+  }
+  delete chart;
+  std::cout << "\tPass" << std::endl;
+  return 0;
+}
+// the value of a "key: value" line of an .output file, empty if none
+std::string output_value(const std::filesystem::path &output_path,
+                         const std::string &key) {
+  std::ifstream ifs(output_path);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.rfind(key + ": ", 0) == 0) {
+      return line.substr(key.size() + 2);
+    }
+  }
+  return "";
+}
+std::vector<unsigned char> read_bytes(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>());
+}
 int main() {
   // read inputs from ./testcases/*.bme
   std::vector<std::filesystem::path> inputs;
@@ -42,99 +212,440 @@ int main() {
     }
   }
 
+  bms_parser::ParseOptions readOptions;
+  readOptions.UseMemoryMap = false;
+  bms_parser::ParseOptions lazyOptions;
+  lazyOptions.LazyDecode = true;
+  bms_parser::ParseOptions viewOptions;
+  viewOptions.BuildView = true;
+  bms_parser::ParseOptions parallelOptions;
+  parallelOptions.MeasureThreads = 4;
+  // nothing hashed during the parse, the getters hash the caller's buffer
+  bms_parser::ParseOptions digestOptions;
+  digestOptions.ComputeMD5 = false;
+  digestOptions.ComputeSHA256 = false;
+  digestOptions.LazyDigests = true;
+  struct Config {
+    std::string name;
+    bms_parser::ParseOptions options;
+    bool fromMemory;
+  };
+  std::vector<Config> configs = {
+      {"default", bms_parser::ParseOptions(), false},
+      {"read", readOptions, false},
+      {"memory", bms_parser::ParseOptions(), true},
+      {"lazy", lazyOptions, false},
+      {"view", viewOptions, false},
+      {"parallel", parallelOptions, false},
+      {"digests", digestOptions, true},
+  };
+
   for (auto &input : inputs) {
     std::filesystem::path output_path = input;
     output_path.replace_extension(".output");
     if (std::filesystem::exists(output_path)) {
-      std::cout << "Testing " << input << "..." << std::endl;
-      bms_parser::Chart *chart;
-      std::atomic_bool cancel = false;
-      bms_parser::Parser parser;
-      parser.Parse(input.wstring(), &chart, false, false, cancel);
-      std::ifstream ifs(output_path);
-      std::string line;
-      while (std::getline(ifs, line)) {
-        if (line.rfind("md5: ", 0) == 0) {
-          auto out = line.substr(5);
-          ASSERT_EQ(out, chart->Meta.MD5, "md5: ");
-        } else if (line.rfind("sha256: ", 0) == 0) {
-          auto out = line.substr(8);
-          ASSERT_EQ(out, chart->Meta.SHA256, "sha256: ");
-        } else if (line.rfind("title: ", 0) == 0) {
-          auto out = line.substr(7);
-          ASSERT_EQ(out, chart->Meta.Title, "title: ");
-        } else if (line.rfind("artist: ", 0) == 0) {
-          auto out = line.substr(8);
-          ASSERT_EQ(out, chart->Meta.Artist, "artist: ");
-        } else if (line.rfind("genre: ", 0) == 0) {
-          auto out = line.substr(7);
-          ASSERT_EQ(out, chart->Meta.Genre, "genre: ");
-        } else if (line.rfind("subartist: ", 0) == 0) {
-          auto out = line.substr(11);
-          ASSERT_EQ(out, chart->Meta.SubArtist, "subartist: ");
-        } else if (line.rfind("total: ", 0) == 0) {
-          auto out = std::stod(line.substr(7));
-          ASSERT_EQ(out, chart->Meta.Total, "total: ");
-        } else if (line.rfind("total_notes: ", 0) == 0) {
-          auto out = std::stoi(line.substr(13));
-          ASSERT_EQ(out, chart->Meta.TotalNotes, "total_notes: ");
-        } else if (line.rfind("total_backspin_notes: ", 0) == 0) {
-          auto out = std::stoi(line.substr(22));
-          ASSERT_EQ(out, chart->Meta.TotalBackSpinNotes,
-                    "total_backspin_notes: ");
-        } else if (line.rfind("total_long_notes: ", 0) == 0) {
-          auto out = std::stoi(line.substr(18));
-          ASSERT_EQ(out, chart->Meta.TotalLongNotes, "total_long_notes: ");
-        } else if (line.rfind("total_scratch_notes: ", 0) == 0) {
-          auto out = std::stoi(line.substr(21));
-          ASSERT_EQ(out, chart->Meta.TotalScratchNotes,
-                    "total_scratch_notes: ");
-        } else if (line.rfind("total_landmine_notes: ", 0) == 0) {
-          auto out = std::stoi(line.substr(22));
-          ASSERT_EQ(out, chart->Meta.TotalLandmineNotes,
-                    "total_landmine_notes: ");
-        } else if (line.rfind("min_bpm: ", 0) == 0) {
-          auto out = std::stod(line.substr(9));
-          ASSERT_EQ(out, chart->Meta.MinBpm, "min_bpm: ");
-        } else if (line.rfind("max_bpm: ", 0) == 0) {
-          auto out = std::stod(line.substr(9));
-          ASSERT_EQ(out, chart->Meta.MaxBpm, "max_bpm: ");
-        } else if (line.rfind("bpm: ", 0) == 0) {
-          auto out = std::stod(line.substr(5));
-          ASSERT_EQ(out, chart->Meta.Bpm, "bpm: ");
-        } else if (line.rfind("minbpm: ", 0) == 0) {
-          auto out = std::stod(line.substr(8));
-          ASSERT_EQ(out, chart->Meta.MinBpm, "minbpm: ");
-        } else if (line.rfind("maxbpm: ", 0) == 0) {
-          auto out = std::stod(line.substr(8));
-          ASSERT_EQ(out, chart->Meta.MaxBpm, "maxbpm: ");
-        } else if (line.rfind("is_dp: ", 0) == 0) {
-          auto out = line.substr(7) == "true";
-          ASSERT_EQ(out, chart->Meta.IsDP, "is_dp: ");
-        } else if (line.rfind("key_mode: ", 0) == 0) {
-          auto out = std::stoi(line.substr(10));
-          ASSERT_EQ(out, chart->Meta.KeyMode, "key_mode: ");
-        } else if (line.rfind("difficulty: ", 0) == 0) {
-          auto out = std::stoi(line.substr(12));
-          ASSERT_EQ(out, chart->Meta.Difficulty, "difficulty: ");
-        } else if (line.rfind("playlevel: ", 0) == 0) {
-          auto out = std::stoi(line.substr(11));
-          ASSERT_EQ(out, chart->Meta.PlayLevel, "playlevel: ");
-        } else if (line.rfind("player: ", 0) == 0) {
-          auto out = std::stoi(line.substr(8));
-          ASSERT_EQ(out, chart->Meta.Player, "player: ");
-        } else if (line.rfind("rank: ", 0) == 0) {
-          auto out = std::stoi(line.substr(6));
-          ASSERT_EQ(out, chart->Meta.Rank, "rank: ");
-        } else if (line.rfind("playlength: ", 0) == 0) {
-          auto out = std::stoi(line.substr(11));
-          ASSERT_EQ(out, chart->Meta.PlayLength, "playlength: ");
+      for (auto &config : configs) {
+        std::cout << "Testing " << input << " (" << config.name << ")..."
+                  << std::endl;
+        if (test_chart(input, output_path, config.options,
+                       config.fromMemory) != 0) {
+          return 1;
         }
       }
-      delete chart;
-      std::cout << "\tPass" << std::endl;
     }
   }
 
+  // every SHA-256 kernel this CPU runs, on the charts and on messages of
+  // one to many blocks with the padding on either side of a block boundary
+  const std::pair<bms_parser::SHA256Kernel, const char *> kernels[] = {
+      {bms_parser::SHA256Kernel::Scalar, "scalar"},
+      {bms_parser::SHA256Kernel::Avx2, "avx2"},
+      {bms_parser::SHA256Kernel::ShaNi, "sha-ni"}};
+  std::vector<std::vector<unsigned char>> messages;
+  for (const size_t size : {0, 1, 55, 56, 63, 64, 119, 120, 128, 4099, 8199}) {
+    std::vector<unsigned char> message(size);
+    for (size_t i = 0; i < size; ++i) {
+      message[i] = static_cast<unsigned char>(i * 131 + size);
+    }
+    messages.push_back(std::move(message));
+  }
+  for (const auto &[kernel, name] : kernels) {
+    if (!bms_parser::SHA256::Supports(kernel)) {
+      continue;
+    }
+    std::cout << "Testing SHA-256 (" << name << ")..." << std::endl;
+    for (auto &input : inputs) {
+      std::filesystem::path output_path = input;
+      output_path.replace_extension(".output");
+      const auto expected = output_value(output_path, "sha256");
+      if (expected.empty()) {
+        continue;
+      }
+      const auto bytes = read_bytes(input);
+      ASSERT_EQ(expected,
+                bms_parser::sha256(bytes.data(), bytes.size(), kernel),
+                "sha256: ");
+    }
+    for (const auto &message : messages) {
+      ASSERT_EQ(bms_parser::sha256(message.data(), message.size(),
+                                   bms_parser::SHA256Kernel::Scalar),
+                bms_parser::sha256(message.data(), message.size(), kernel),
+                "sha256 of " + std::to_string(message.size()) + " bytes: ");
+    }
+  }
+
+  // HashMany on 2 to 9 of the same messages, so that lanes are refilled
+  // and left idle, both in the lanes and one message at a time
+  const std::pair<bms_parser::HashManyMode, const char *> modes[] = {
+      {bms_parser::HashManyMode::Lanes, "lanes"},
+      {bms_parser::HashManyMode::Single, "single"}};
+  for (const auto &[mode, name] : modes) {
+    std::cout << "Testing HashMany (" << name << ")..." << std::endl;
+    for (size_t count = 2; count <= 9; ++count) {
+      std::vector<bms_parser::HashInput> hashInputs;
+      for (size_t i = 0; i < count; ++i) {
+        const auto &message = messages[(count + i) % messages.size()];
+        hashInputs.push_back({message.data(), message.size()});
+      }
+      std::vector<bms_parser::HashOutput> hashOutputs(count);
+      bms_parser::HashMany(hashInputs.data(), count, hashOutputs.data(),
+                           true, true, mode);
+      for (size_t i = 0; i < count; ++i) {
+        const auto &input = hashInputs[i];
+        bms_parser::MD5 md5;
+        md5.update(input.Bytes, static_cast<bms_parser::MD5::size_type>(
+                                    input.Size));
+        md5.finalize();
+        ASSERT_EQ(md5.hexdigest(), hashOutputs[i].MD5,
+                  "md5 of " + std::to_string(input.Size) + " bytes: ");
+        ASSERT_EQ(bms_parser::sha256(input.Bytes, input.Size,
+                                     bms_parser::SHA256Kernel::Scalar),
+                  hashOutputs[i].SHA256,
+                  "sha256 of " + std::to_string(input.Size) + " bytes: ");
+      }
+    }
+  }
+
+  // an LNOBJ long note on lane 0 and a plain note on lane 1
+  {
+    std::cout << "Testing play state..." << std::endl;
+    const std::string source = "#PLAYER 1\n#BPM 120\n#WAV01 a.wav\n"
+                               "#WAV02 b.wav\n#LNOBJ ZZ\n"
+                               "#00111:0100ZZ00\n#00112:02\n";
+    bms_parser::Parser parser;
+    bms_parser::Chart *chart;
+    std::atomic_bool cancel = false;
+    parser.Parse(reinterpret_cast<const unsigned char *>(source.data()),
+                 source.size(), &chart, false, false, cancel);
+    ASSERT_EQ(3u, chart->Notes.size(), "play state notes: ");
+    uint32_t head = bms_parser::NoNoteId;
+    uint32_t tail = bms_parser::NoNoteId;
+    uint32_t normal = bms_parser::NoNoteId;
+    for (uint32_t id = 0; id < chart->Notes.size(); ++id) {
+      switch (chart->Notes[id].Kind) {
+      case bms_parser::NoteKind::LongHead:
+        head = id;
+        break;
+      case bms_parser::NoteKind::LongTail:
+        tail = id;
+        break;
+      case bms_parser::NoteKind::Normal:
+        normal = id;
+        break;
+      default:
+        break;
+      }
+    }
+    ASSERT_EQ(tail, chart->Notes[head].Partner, "head partner: ");
+    ASSERT_EQ(head, chart->Notes[tail].Partner, "tail partner: ");
+    const bool hasNormal = normal != bms_parser::NoNoteId;
+    ASSERT_EQ(true, hasNormal, "normal note: ");
+    bms_parser::PlayState state(*chart);
+    ASSERT_EQ(chart->Notes.size(), state.size(), "play state size: ");
+    state.Press(head, 1000);
+    ASSERT_EQ(true, state[head].IsPlayed, "head played: ");
+    ASSERT_EQ(1000, state[head].PlayedTime, "head played time: ");
+    ASSERT_EQ(true, state[head].IsHolding, "head holding: ");
+    ASSERT_EQ(true, state[tail].IsHolding, "tail holding: ");
+    state.Release(tail, 2000);
+    ASSERT_EQ(false, state[head].IsHolding, "head released: ");
+    ASSERT_EQ(false, state[tail].IsHolding, "tail released: ");
+    ASSERT_EQ(true, state[tail].IsPlayed, "tail played: ");
+    ASSERT_EQ(2000, state[tail].ReleaseTime, "tail release time: ");
+    state.Press(normal, 3000);
+    ASSERT_EQ(true, state[normal].IsPlayed, "normal played: ");
+    ASSERT_EQ(3000, state[normal].PlayedTime, "normal played time: ");
+    ASSERT_EQ(false, state[normal].IsHolding, "normal not holding: ");
+    state.Reset();
+    for (uint32_t id = 0; id < state.size(); ++id) {
+      const auto &note = state[id];
+      const bool cleared = !note.IsPlayed && !note.IsDead &&
+                           !note.IsHolding && note.PlayedTime == 0 &&
+                           note.ReleaseTime == 0;
+      ASSERT_EQ(true, cleared, "reset: ");
+    }
+    delete chart;
+  }
+
+  // rebuilding the records after a head is taken off the chart must not pair
+  // its tail with whichever head inherited the old Id
+  {
+    const std::string source = "#PLAYER 1\n#BPM 120\n#WAV01 a.wav\n"
+                               "#WAV02 b.wav\n#LNOBJ ZZ\n"
+                               "#00111:0100ZZ00\n#00112:000200ZZ\n";
+    bms_parser::Parser parser;
+    bms_parser::Chart *chart;
+    std::atomic_bool cancel = false;
+    parser.Parse(reinterpret_cast<const unsigned char *>(source.data()),
+                 source.size(), &chart, false, false, cancel);
+    ASSERT_EQ(4u, chart->Notes.size(), "rebuild notes: ");
+    const auto &first = chart->Notes[0];
+    const bool firstIsHead = first.Kind == bms_parser::NoteKind::LongHead;
+    ASSERT_EQ(true, firstIsHead, "rebuild first head: ");
+    chart->TimeLines[first.Timeline]->Notes[first.Lane] = nullptr;
+    chart->BuildNoteRecords();
+    ASSERT_EQ(3u, chart->Notes.size(), "rebuilt notes: ");
+    uint32_t pairs = 0;
+    for (uint32_t id = 0; id < chart->Notes.size(); ++id) {
+      const auto &record = chart->Notes[id];
+      if (record.Partner == bms_parser::NoNoteId) {
+        continue;
+      }
+      ++pairs;
+      const bool sameLane = chart->Notes[record.Partner].Lane == record.Lane;
+      ASSERT_EQ(true, sameLane, "rebuilt partner lane: ");
+      ASSERT_EQ(id, chart->Notes[record.Partner].Partner,
+                "rebuilt partner link: ");
+    }
+    ASSERT_EQ(2u, pairs, "rebuilt pairs: ");
+    delete chart;
+  }
+
+  // the same charts again through ParseMany, with fewer threads than charts
+  std::vector<std::filesystem::path> batchInputs;
+  for (auto &input : inputs) {
+    std::filesystem::path output_path = input;
+    output_path.replace_extension(".output");
+    if (std::filesystem::exists(output_path)) {
+      batchInputs.push_back(input);
+    }
+  }
+  bms_parser::ThreadPool pool(2);
+  bms_parser::BatchOptions batchOptions;
+  batchOptions.Pool = &pool;
+  std::vector<bms_parser::Chart *> batchCharts(batchInputs.size(), nullptr);
+  std::mutex batchMutex;
+  std::atomic_bool cancel = false;
+  bms_parser::ParseMany(
+      batchInputs, batchOptions,
+      [&](size_t index, bms_parser::Chart *chart, std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        batchCharts[index] = error ? nullptr : chart;
+      },
+      cancel);
+  std::vector<bms_parser::ChartMeta> batchMetas;
+  for (size_t i = 0; i < batchInputs.size(); ++i) {
+    std::cout << "Testing " << batchInputs[i] << " (batch)..." << std::endl;
+    if (batchCharts[i] == nullptr) {
+      std::cerr << "no chart" << std::endl;
+      return 1;
+    }
+    std::filesystem::path output_path = batchInputs[i];
+    output_path.replace_extension(".output");
+    batchMetas.push_back(batchCharts[i]->Meta); // check_chart deletes it
+    if (check_chart(batchCharts[i], output_path) != 0) {
+      return 1;
+    }
+  }
+
+  // a throwing callback stops the batch and comes out of ParseMany
+  {
+    std::cout << "Testing batch callback error..." << std::endl;
+    std::atomic_int calls = 0;
+    bool rethrown = false;
+    try {
+      bms_parser::ParseMany(
+          batchInputs, batchOptions,
+          [&](size_t, bms_parser::Chart *chart, std::exception_ptr) {
+            delete chart;
+            ++calls;
+            throw std::runtime_error("callback failed");
+          },
+          cancel);
+    } catch (const std::runtime_error &) {
+      rethrown = true;
+    }
+    ASSERT_EQ(true, rethrown, "callback error rethrown: ");
+    const bool stopped = calls < static_cast<int>(batchInputs.size());
+    ASSERT_EQ(true, stopped, "batch stopped: ");
+  }
+
+  // paths that cannot be read come back as errors naming them
+  {
+    std::cout << "Testing batch unreadable paths..." << std::endl;
+    const std::vector<std::filesystem::path> unreadable = {
+        "./testcases/missing.bme", "./testcases"};
+    std::vector<std::string> messages(unreadable.size());
+    std::vector<bool> charts(unreadable.size(), false);
+    std::mutex unreadableMutex;
+    bms_parser::ParseMany(
+        unreadable, batchOptions,
+        [&](size_t index, bms_parser::Chart *chart, std::exception_ptr error) {
+          std::lock_guard<std::mutex> lock(unreadableMutex);
+          charts[index] = chart != nullptr;
+          delete chart;
+          try {
+            if (error) {
+              std::rethrow_exception(error);
+            }
+          } catch (const std::runtime_error &e) {
+            messages[index] = e.what();
+          }
+        },
+        cancel);
+    for (size_t i = 0; i < unreadable.size(); ++i) {
+      const bool named =
+          messages[i].find(unreadable[i].string()) != std::string::npos;
+      ASSERT_EQ(true, named, "unreadable path error: ");
+      const bool chart = charts[i];
+      ASSERT_EQ(false, chart, "unreadable path chart: ");
+    }
+  }
+
+  // the batch results through a MetaCache written to disk and read back
+  const auto cacheFile =
+      std::filesystem::temp_directory_path() / "bms_parser_test.metacache";
+  {
+    bms_parser::MetaCache cache;
+    for (size_t i = 0; i < batchInputs.size(); ++i) {
+      bms_parser::ChartMeta meta;
+      bms_parser::FileIdentity identity;
+      ASSERT_EQ(false, cache.Find(batchInputs[i], meta, identity),
+                "metacache miss: ");
+      cache.Store(identity, batchMetas[i]);
+    }
+    ASSERT_EQ(true, cache.Save(cacheFile), "metacache save: ");
+  }
+  bms_parser::MetaCache cache;
+  ASSERT_EQ(true, cache.Load(cacheFile), "metacache load: ");
+  ASSERT_EQ(batchInputs.size(), cache.size(), "metacache size: ");
+  for (size_t i = 0; i < batchInputs.size(); ++i) {
+    std::cout << "Testing " << batchInputs[i] << " (metacache)..."
+              << std::endl;
+    bms_parser::ChartMeta meta;
+    bms_parser::FileIdentity identity;
+    ASSERT_EQ(true, cache.Find(batchInputs[i], meta, identity),
+              "metacache hit: ");
+    ASSERT_EQ(batchMetas[i].Title, meta.Title, "title: ");
+    ASSERT_EQ(batchMetas[i].SHA256, meta.SHA256, "sha256: ");
+    ASSERT_EQ(batchMetas[i].TotalNotes, meta.TotalNotes,
+              "total_notes: ");
+    ASSERT_EQ(batchMetas[i].MaxBpm, meta.MaxBpm, "max_bpm: ");
+  }
+  // a truncated cache is rejected rather than half read
+  std::filesystem::resize_file(cacheFile,
+                               std::filesystem::file_size(cacheFile) - 1);
+  ASSERT_EQ(false, cache.Load(cacheFile), "metacache truncated: ");
+  ASSERT_EQ(0u, cache.size(), "metacache emptied: ");
+  std::filesystem::remove(cacheFile);
+
+  // the first load parses and takes a snapshot, the second comes from it
+  const auto snapshotFile =
+      std::filesystem::temp_directory_path() / "bms_parser_test.snapshot";
+  for (const auto &input : batchInputs) {
+    std::cout << "Testing " << input << " (snapshot)..." << std::endl;
+    std::filesystem::remove(snapshotFile);
+    bms_parser::Parser parser;
+    parser.SetOptions(viewOptions);
+    bms_parser::Chart *parsed;
+    bms_parser::Chart *loaded;
+    ASSERT_EQ(false,
+              bms_parser::ChartSnapshot::LoadOrParse(
+                  input, snapshotFile, parser, &parsed, false, cancel),
+              "snapshot miss: ");
+    // charts with #RANDOM are parsed every time
+    ASSERT_EQ(!parsed->Meta.HasRandom,
+              bms_parser::ChartSnapshot::LoadOrParse(
+                  input, snapshotFile, parser, &loaded, false, cancel),
+              "snapshot hit: ");
+    ASSERT_EQ(parsed->Measures.size(), loaded->Measures.size(),
+              "snapshot measures: ");
+    ASSERT_EQ(parsed->TimeLines.size(), loaded->TimeLines.size(),
+              "snapshot timelines: ");
+    ASSERT_EQ(parsed->Notes.size(), loaded->Notes.size(), "snapshot notes: ");
+    ASSERT_EQ(parsed->WavTable.size(), loaded->WavTable.size(),
+              "snapshot wavs: ");
+    // the note a long note's Head or Tail points at: its id, NoNoteId for
+    // none, or NoNoteId - 1 for a note that is not on the chart any more
+    const auto target = [](const bms_parser::Chart *chart,
+                           const bms_parser::Note *note) {
+      if (note == nullptr) {
+        return bms_parser::NoNoteId;
+      }
+      if (note->Id < chart->Notes.size()) {
+        const auto &record = chart->Notes[note->Id];
+        if (chart->TimeLines[record.Timeline]->Notes[record.Lane] == note) {
+          return note->Id;
+        }
+      }
+      return bms_parser::NoNoteId - 1;
+    };
+    const auto longNoteAt = [](const bms_parser::Chart *chart, uint32_t id) {
+      const auto &record = chart->Notes[id];
+      return static_cast<const bms_parser::LongNote *>(
+          chart->TimeLines[record.Timeline]->Notes[record.Lane]);
+    };
+    size_t linkMismatches = 0;
+    for (uint32_t id = 0; id < parsed->Notes.size(); ++id) {
+      const auto &record = parsed->Notes[id];
+      if (!record.IsLongNote()) {
+        continue;
+      }
+      const auto parsedNote = longNoteAt(parsed, id);
+      const auto loadedNote = longNoteAt(loaded, id);
+      const auto &loadedRecord = loaded->Notes[id];
+      if (loadedRecord.Kind != record.Kind ||
+          loadedRecord.Partner != record.Partner ||
+          target(loaded, loadedNote->Head) !=
+              target(parsed, parsedNote->Head) ||
+          target(loaded, loadedNote->Tail) !=
+              target(parsed, parsedNote->Tail)) {
+        ++linkMismatches;
+      }
+    }
+    ASSERT_EQ(0u, linkMismatches, "snapshot long note links: ");
+    // check_chart counts the view's notes against the chart's
+    const bool hasView = loaded->View != nullptr;
+    ASSERT_EQ(true, hasView, "snapshot view: ");
+    delete parsed;
+    std::filesystem::path output_path = input;
+    output_path.replace_extension(".output");
+    if (check_chart(loaded, output_path) != 0) {
+      return 1;
+    }
+  }
+  // a snapshot that fails validation is parsed over, not loaded
+  const std::filesystem::path snapshotInput = "./testcases/example.bme";
+  bms_parser::Parser parser;
+  bms_parser::Chart *reparsed;
+  bms_parser::ChartSnapshot::LoadOrParse(snapshotInput, snapshotFile, parser,
+                                         &reparsed, false, cancel);
+  delete reparsed;
+  {
+    std::fstream file(snapshotFile,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(sizeof(bms_parser::SnapshotHeader));
+    file.put('\xff');
+  }
+  bms_parser::ChartSnapshot snapshot;
+  ASSERT_EQ(false, snapshot.Open(snapshotFile), "snapshot corrupt: ");
+  ASSERT_EQ(false,
+            bms_parser::ChartSnapshot::LoadOrParse(snapshotInput, snapshotFile,
+                                                   parser, &reparsed, false,
+                                                   cancel),
+            "snapshot reparse: ");
+  delete reparsed;
+  std::filesystem::remove(snapshotFile);
+
   return 0;
 }
\ No newline at end of file